@@ -0,0 +1,436 @@
+/** @file
+ * Implementacja interfejsu alloc.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+
+/** @brief długość pierwszej porcji pamięci areny
+ */
+#define ARENA_FIRST_CHUNK (1 << 16)
+
+/** @brief największa długość porcji pamięci areny, dłuższe dostają tylko duże bloki
+ */
+#define ARENA_MAX_CHUNK (1 << 26)
+
+/** @brief wyrównanie bloków przydzielanych z areny
+ */
+#define ARENA_ALIGNMENT 16
+
+/** @brief docelowa długość płyty, z której klasa puli wycina bloki
+ */
+#define SLAB_BYTES (1 << 16)
+
+/** @brief największy blok przydzielany z płyt, większe pochodzą wprost z alokatora bazowego
+ */
+#define SLAB_MAX_BLOCK (1 << 18)
+
+/** @brief początkowy rozmiar tablicy haszującej klas puli
+ */
+#define SLAB_INITIAL_CLASSES 32
+
+/** @brief przydziela wyzerowany blok na stercie
+ * param[in] context 	- nieużywany
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL
+ */
+static void* heap_alloc(void* context, size_t size){
+	(void)context;
+	return calloc(1, size);
+}
+
+/** @brief powiększa blok na stercie
+ * param[in] context 	- nieużywany
+ * param[in] ptr 	- powiększany blok lub NULL
+ * param[in] old_size 	- nieużywany
+ * param[in] size 	- nowa długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL
+ */
+static void* heap_realloc(void* context, void* ptr, size_t old_size, size_t size){
+	(void)context;
+	(void)old_size;
+	return realloc(ptr, size);
+}
+
+/** @brief zwalnia blok na stercie
+ * param[in] context 	- nieużywany
+ * param[in] ptr 	- zwalniany blok
+ * param[in] size 	- nieużywany
+ */
+static void heap_free(void* context, void* ptr, size_t size){
+	(void)context;
+	(void)size;
+	free(ptr);
+}
+
+/** @brief alokator korzystający z calloc, realloc i free
+ */
+const allocator heap_allocator = {heap_alloc, heap_realloc, heap_free, NULL};
+
+/** @brief Nagłówek porcji pamięci areny, leży na jej początku.
+ */
+typedef struct arena_chunk{
+	struct arena_chunk* next; 	///< poprzednio pobrana porcja lub NULL
+	uint64_t size; 			///< długość porcji razem z nagłówkiem
+} arena_chunk;
+
+/** @brief Struktura areny.
+ */
+struct arena{
+	allocator base; 	///< alokator, z którego pochodzą porcje pamięci
+	arena_chunk* chunks; 	///< ostatnio pobrana porcja
+	char* top; 		///< pierwszy wolny bajt ostatniej porcji
+	char* end; 		///< koniec ostatniej porcji
+	void* last; 		///< ostatnio przydzielony blok, można go powiększyć w miejscu
+	uint64_t reserved; 	///< łączna długość porcji
+};
+
+/** @brief zaokrągla liczbę w górę do wielokrotności ARENA_ALIGNMENT
+ * param[in] n 	- zaokrąglana liczba
+ *
+ * @return najmniejsza wielokrotność ARENA_ALIGNMENT niemniejsza od n
+ */
+static uint64_t align_up(uint64_t n){
+	return (n+ARENA_ALIGNMENT-1) & ~(uint64_t)(ARENA_ALIGNMENT-1);
+}
+
+/** @brief pobiera z alokatora bazowego porcję pamięci mieszczącą blok
+ * Porcje rosną dwukrotnie do ARENA_MAX_CHUNK.
+ * param[in] base 	- alokator bazowy
+ * param[in] previous 	- długość poprzedniej porcji lub 0
+ * param[in] size 	- długość bloku, który ma się zmieścić
+ *
+ * @return wskaźnik na porcję lub NULL
+ */
+static arena_chunk* new_chunk(const allocator* base, uint64_t previous, uint64_t size){
+	uint64_t chunk_size = previous == 0? ARENA_FIRST_CHUNK : 2*previous;
+	if(chunk_size > ARENA_MAX_CHUNK)
+		chunk_size = ARENA_MAX_CHUNK;
+	uint64_t needed = align_up(sizeof(arena_chunk))+size;
+	if(needed < size)
+		return NULL;
+	if(chunk_size < needed)
+		chunk_size = needed;
+	arena_chunk* c = allocator_alloc(base, chunk_size);
+	if(c != NULL)
+		c->size = chunk_size;
+	return c;
+}
+
+/** @brief dołącza porcję pamięci do areny i ustawia w niej wskaźnik wolnej pamięci
+ * param[in,out] a 	- arena
+ * param[in] c 		- dołączana porcja
+ */
+static void push_chunk(arena* a, arena_chunk* c){
+	c->next = a->chunks;
+	a->chunks = c;
+	a->top = (char*)c+align_up(sizeof(arena_chunk));
+	a->end = (char*)c+c->size;
+	a->reserved += c->size;
+}
+
+/** @brief przydziela wyzerowany blok z areny
+ * Pamięć porcji jest wyzerowana i nigdy nie jest używana ponownie.
+ * param[in] context 	- arena
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL
+ */
+static void* arena_alloc(void* context, size_t size){
+	arena* a = context;
+	uint64_t aligned = align_up(size);
+	if(aligned < size)
+		return NULL;
+	if((uint64_t)(a->end-a->top) < aligned){
+		arena_chunk* c = new_chunk(&a->base, a->chunks->size, aligned);
+		if(c == NULL)
+			return NULL;
+		push_chunk(a, c);
+	}
+	void* block = a->top;
+	a->top += aligned;
+	a->last = block;
+	return block;
+}
+
+/** @brief powiększa blok z areny
+ * Ostatnio przydzielony blok powiększamy w miejscu, jeżeli mieści się w porcji,
+ * pozostałe przepisujemy do nowego bloku, a stary zostaje w arenie. Przy
+ * zmniejszaniu w miejscu zerujemy zwolnioną końcówkę bloku, bo arena_alloc
+ * oddaje pamięć od wskaźnika top bez zerowania.
+ * param[in] context 	- arena
+ * param[in] ptr 	- powiększany blok lub NULL
+ * param[in] old_size 	- dotychczasowa długość bloku w bajtach
+ * param[in] size 	- nowa długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL
+ */
+static void* arena_realloc(void* context, void* ptr, size_t old_size, size_t size){
+	arena* a = context;
+	if(ptr != NULL && ptr == a->last && align_up(size) >= size &&
+	   (uint64_t)(a->end-(char*)ptr) >= align_up(size)){
+		if(size < old_size)
+			memset((char*)ptr+size, 0, a->top-((char*)ptr+size));
+		a->top = (char*)ptr+align_up(size);
+		return ptr;
+	}
+	void* block = arena_alloc(context, size);
+	if(block != NULL && ptr != NULL)
+		memcpy(block, ptr, old_size < size? old_size : size);
+	return block;
+}
+
+/** @brief tworzy pustą arenę
+ * param[in] base 	- alokator, z którego arena bierze porcje pamięci
+ *
+ * @return wskaźnik na arenę lub NULL, jeżeli nie udało się przydzielić pamięci
+ */
+arena* arena_new(const allocator* base){
+	arena_chunk* c = new_chunk(base, 0, align_up(sizeof(arena)));
+	if(c == NULL)
+		return NULL;
+	arena* a = (arena*)((char*)c+align_up(sizeof(arena_chunk)));
+	a->base = *base;
+	a->chunks = NULL;
+	a->reserved = 0;
+	push_chunk(a, c);
+	a->top += align_up(sizeof(arena));
+	a->last = NULL;
+	return a;
+}
+
+/** @brief zwraca alokator przydzielający bloki z areny
+ * param[in] a 	- arena
+ *
+ * @return alokator areny
+ */
+allocator arena_allocator(arena* a){
+	allocator r = {arena_alloc, arena_realloc, NULL, a};
+	return r;
+}
+
+/** @brief zwraca łączną długość porcji pamięci pobranych przez arenę
+ * param[in] a 	- arena
+ *
+ * @return liczba bajtów
+ */
+uint64_t arena_reserved(const arena* a){
+	return a->reserved;
+}
+
+/** @brief zwalnia całą pamięć areny
+ * Struktura areny leży w pierwszej porcji, więc kopiujemy alokator bazowy.
+ * param[in] a 	- arena
+ */
+void arena_delete(arena* a){
+	allocator base = a->base;
+	arena_chunk* c = a->chunks;
+	while(c != NULL){
+		arena_chunk* next = c->next;
+		allocator_free(&base, c, c->size);
+		c = next;
+	}
+}
+
+/** @brief Struktura opisująca klasę bloków jednej długości w puli.
+ */
+typedef struct{
+	uint64_t size; 		///< długość bloków klasy, 0 oznacza wolne miejsce w tablicy klas
+	void* free_list; 	///< zwolnione bloki, każdy wskazuje na kolejny
+	char* top; 		///< pierwszy niewycięty blok ostatniej płyty
+	char* end; 		///< koniec ostatniej płyty
+} slab_class;
+
+/** @brief Struktura puli bloków pogrupowanych według długości.
+ */
+struct slab_pool{
+	allocator base; 	///< alokator bazowy areny, tablicy klas i dużych bloków
+	arena* slabs; 		///< arena, z której pochodzą płyty
+	slab_class* classes; 	///< tablica haszująca klas, kluczem jest długość bloku
+	uint64_t capacity; 	///< rozmiar tablicy classes, potęga dwójki
+	uint64_t no_classes; 	///< liczba klas
+	uint64_t large; 	///< łączna długość dużych bloków
+};
+
+/** @brief wyszukuje w tablicy haszującej miejsce klasy bloków o zadanej długości
+ * param[in] classes 	- tablica klas
+ * param[in] capacity 	- rozmiar tablicy, potęga dwójki
+ * param[in] size 	- długość bloków, wielokrotność ARENA_ALIGNMENT
+ *
+ * @return miejsce klasy lub wolne miejsce, w którym należy ją utworzyć
+ */
+static slab_class* find_class(slab_class* classes, uint64_t capacity, uint64_t size){
+	uint64_t i = (size/ARENA_ALIGNMENT*0x9e3779b97f4a7c15ULL >> 32) & (capacity-1);
+	while(classes[i].size != 0 && classes[i].size != size)
+		i = (i+1) & (capacity-1);
+	return &classes[i];
+}
+
+/** @brief zwraca klasę bloków o zadanej długości, tworzy ją jeżeli nie istnieje
+ * param[in,out] p 	- pula
+ * param[in] size 	- długość bloków, wielokrotność ARENA_ALIGNMENT
+ *
+ * @return wskaźnik na klasę lub NULL, jeżeli zabrakło pamięci
+ */
+static slab_class* get_class(slab_pool* p, uint64_t size){
+	slab_class* c = find_class(p->classes, p->capacity, size);
+	if(c->size == size)
+		return c;
+	if(2*(p->no_classes+1) > p->capacity){
+		uint64_t capacity = 2*p->capacity;
+		slab_class* classes = allocator_alloc(&p->base, capacity*sizeof(slab_class));
+		if(classes == NULL)
+			return NULL;
+		for(uint64_t i=0;i<p->capacity;i++){
+			if(p->classes[i].size != 0)
+				*find_class(classes, capacity, p->classes[i].size) = p->classes[i];
+		}
+		allocator_free(&p->base, p->classes, p->capacity*sizeof(slab_class));
+		p->classes = classes;
+		p->capacity = capacity;
+		c = find_class(classes, capacity, size);
+	}
+	c->size = size;
+	p->no_classes++;
+	return c;
+}
+
+/** @brief przydziela wyzerowany blok z puli
+ * Blok bierze z listy zwolnionych bloków swojej klasy lub wycina z płyty klasy,
+ * więc bloki jednej długości leżą obok siebie.
+ * param[in] context 	- pula
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL
+ */
+static void* slab_pool_alloc(void* context, size_t size){
+	slab_pool* p = context;
+	uint64_t aligned = align_up(size == 0? 1 : size);
+	if(aligned > SLAB_MAX_BLOCK){
+		void* block = allocator_alloc(&p->base, size);
+		if(block != NULL)
+			p->large += size;
+		return block;
+	}
+	slab_class* c = get_class(p, aligned);
+	if(c == NULL)
+		return NULL;
+	if(c->free_list != NULL){
+		void* block = c->free_list;
+		c->free_list = *(void**)block;
+		memset(block, 0, aligned);
+		return block;
+	}
+	if(c->top == c->end){
+		uint64_t blocks = SLAB_BYTES/aligned;
+		if(blocks == 0)
+			blocks = 1;
+		allocator slabs = arena_allocator(p->slabs);
+		c->top = allocator_alloc(&slabs, blocks*aligned);
+		if(c->top == NULL){
+			c->end = NULL;
+			return NULL;
+		}
+		c->end = c->top+blocks*aligned;
+	}
+	void* block = c->top;
+	c->top += aligned;
+	return block;
+}
+
+/** @brief oddaje blok do puli
+ * param[in] context 	- pula
+ * param[in] ptr 	- zwalniany blok
+ * param[in] size 	- długość bloku w bajtach
+ */
+static void slab_pool_free(void* context, void* ptr, size_t size){
+	slab_pool* p = context;
+	uint64_t aligned = align_up(size == 0? 1 : size);
+	if(aligned > SLAB_MAX_BLOCK){
+		p->large -= size;
+		allocator_free(&p->base, ptr, size);
+		return;
+	}
+	slab_class* c = find_class(p->classes, p->capacity, aligned);
+	*(void**)ptr = c->free_list;
+	c->free_list = ptr;
+}
+
+/** @brief powiększa blok z puli, przepisując go do bloku nowej klasy
+ * param[in] context 	- pula
+ * param[in] ptr 	- powiększany blok lub NULL
+ * param[in] old_size 	- dotychczasowa długość bloku w bajtach
+ * param[in] size 	- nowa długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL
+ */
+static void* slab_pool_realloc(void* context, void* ptr, size_t old_size, size_t size){
+	void* block = slab_pool_alloc(context, size);
+	if(block != NULL && ptr != NULL){
+		memcpy(block, ptr, old_size < size? old_size : size);
+		slab_pool_free(context, ptr, old_size);
+	}
+	return block;
+}
+
+/** @brief tworzy pustą pulę bloków
+ * param[in] base 	- alokator, z którego pula bierze pamięć
+ *
+ * @return wskaźnik na pulę lub NULL, jeżeli nie udało się przydzielić pamięci
+ */
+slab_pool* slab_pool_new(const allocator* base){
+	arena* slabs = arena_new(base);
+	if(slabs == NULL)
+		return NULL;
+	allocator slab_alloc = arena_allocator(slabs);
+	slab_pool* p = allocator_alloc(&slab_alloc, sizeof(slab_pool));
+	slab_class* classes = allocator_alloc(base, SLAB_INITIAL_CLASSES*sizeof(slab_class));
+	if(p == NULL || classes == NULL){
+		allocator_free(base, classes, SLAB_INITIAL_CLASSES*sizeof(slab_class));
+		arena_delete(slabs);
+		return NULL;
+	}
+	p->base = *base;
+	p->slabs = slabs;
+	p->classes = classes;
+	p->capacity = SLAB_INITIAL_CLASSES;
+	p->no_classes = 0;
+	p->large = 0;
+	return p;
+}
+
+/** @brief zwraca alokator przydzielający bloki z puli
+ * param[in] p 	- pula
+ *
+ * @return alokator puli
+ */
+allocator slab_pool_allocator(slab_pool* p){
+	allocator r = {slab_pool_alloc, slab_pool_realloc, slab_pool_free, p};
+	return r;
+}
+
+/** @brief zwraca łączną długość pamięci pobranej przez pulę z alokatora bazowego
+ * param[in] p 	- pula
+ *
+ * @return liczba bajtów
+ */
+uint64_t slab_pool_reserved(const slab_pool* p){
+	return arena_reserved(p->slabs)+p->capacity*sizeof(slab_class)+p->large;
+}
+
+/** @brief zwalnia płyty puli i tablicę klas
+ * Struktura puli leży w jej arenie, więc kopiujemy potrzebne pola.
+ * param[in] p 	- pula
+ */
+void slab_pool_delete(slab_pool* p){
+	allocator base = p->base;
+	allocator_free(&base, p->classes, p->capacity*sizeof(slab_class));
+	arena_delete(p->slabs);
+}
@@ -0,0 +1,140 @@
+/** @file
+ * Interfejs alokatorów pamięci stanu gry
+ *
+ * Każda gra przydziela pamięć na planszę, tablice graczy i kolory obszarów
+ * przez alokator: stertę, alokator podany przez użytkownika, arenę, pulę
+ * bloków lub plik odwzorowany w pamięci.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Struktura opisująca alokator pamięci.
+ * Odpowiada typowi gamma_allocator_t z gamma.h.
+ */
+typedef struct{
+	void* (*alloc)(void* context, size_t size); 	///< zwraca wyzerowany blok lub NULL
+	void* (*realloc)(void* context, void* ptr, size_t old_size,
+			 size_t size); 			///< powiększa blok, dopisana część nie musi być
+							///< wyzerowana; przy błędzie zwraca NULL i zostawia blok
+	void (*free)(void* context, void* ptr, size_t size); ///< zwalnia blok, NULL jeżeli bloki
+							///< zwalniamy razem z całym alokatorem
+	void* context; 					///< dane przekazywane funkcjom alokatora
+} allocator;
+
+/** @brief alokator korzystający z calloc, realloc i free
+ */
+extern const allocator heap_allocator;
+
+/** @brief przydziela wyzerowany blok pamięci
+ * param[in] a 		- alokator
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL, jeżeli nie udało się go przydzielić
+ */
+static inline void* allocator_alloc(const allocator* a, uint64_t size){
+	if(size > SIZE_MAX)
+		return NULL;
+	return a->alloc(a->context, size);
+}
+
+/** @brief powiększa blok pamięci
+ * param[in] a 		- alokator
+ * param[in] ptr 	- powiększany blok lub NULL
+ * param[in] old_size 	- dotychczasowa długość bloku w bajtach
+ * param[in] size 	- nowa długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL, jeżeli się nie udało; stary blok pozostaje wtedy ważny
+ */
+static inline void* allocator_realloc(const allocator* a, void* ptr,
+				      uint64_t old_size, uint64_t size){
+	if(size > SIZE_MAX)
+		return NULL;
+	return a->realloc(a->context, ptr, old_size, size);
+}
+
+/** @brief zwalnia blok pamięci, nic nie robi dla NULL i alokatorów bez free
+ * param[in] a 		- alokator
+ * param[in] ptr 	- zwalniany blok lub NULL
+ * param[in] size 	- długość bloku w bajtach
+ */
+static inline void allocator_free(const allocator* a, void* ptr, uint64_t size){
+	if(ptr != NULL && a->free != NULL)
+		a->free(a->context, ptr, size);
+}
+
+/** @brief Struktura areny: bloki przydzielamy narastająco z kolejnych porcji pamięci,
+ * a zwalniamy wszystkie naraz.
+ */
+typedef struct arena arena;
+
+/** @brief tworzy pustą arenę
+ * Sama struktura areny leży w jej pierwszej porcji pamięci.
+ * param[in] base 	- alokator, z którego arena bierze porcje pamięci
+ *
+ * @return wskaźnik na arenę lub NULL, jeżeli nie udało się przydzielić pamięci
+ */
+arena* arena_new(const allocator* base);
+
+/** @brief zwraca alokator przydzielający bloki z areny
+ * Jego funkcja free jest równa NULL, bloki zwalnia dopiero arena_delete.
+ * param[in] a 	- arena
+ *
+ * @return alokator areny
+ */
+allocator arena_allocator(arena* a);
+
+/** @brief zwraca łączną długość porcji pamięci pobranych przez arenę
+ * param[in] a 	- arena
+ *
+ * @return liczba bajtów
+ */
+uint64_t arena_reserved(const arena* a);
+
+/** @brief zwalnia całą pamięć areny, w czasie zależnym tylko od liczby jej porcji
+ * param[in] a 	- arena
+ */
+void arena_delete(arena* a);
+
+/** @brief Struktura puli: bloki jednej długości tworzą klasę, wycinamy je
+ * z płyt pobranych z areny, a zwolnione trafiają na listę swojej klasy.
+ */
+typedef struct slab_pool slab_pool;
+
+/** @brief tworzy pustą pulę bloków
+ * param[in] base 	- alokator, z którego pula bierze pamięć
+ *
+ * @return wskaźnik na pulę lub NULL, jeżeli nie udało się przydzielić pamięci
+ */
+slab_pool* slab_pool_new(const allocator* base);
+
+/** @brief zwraca alokator przydzielający bloki z puli
+ * Przydział i zwolnienie bloku kosztują czas stały. Bloki dłuższe niż
+ * 256 KiB pochodzą wprost z alokatora bazowego.
+ * param[in] p 	- pula
+ *
+ * @return alokator puli
+ */
+allocator slab_pool_allocator(slab_pool* p);
+
+/** @brief zwraca łączną długość pamięci pobranej przez pulę z alokatora bazowego
+ * param[in] p 	- pula
+ *
+ * @return liczba bajtów
+ */
+uint64_t slab_pool_reserved(const slab_pool* p);
+
+/** @brief zwalnia płyty puli, duże bloki muszą być wcześniej zwolnione
+ * param[in] p 	- pula
+ */
+void slab_pool_delete(slab_pool* p);
+
+#endif
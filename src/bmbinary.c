@@ -0,0 +1,476 @@
+/** @file
+ * Implementacja interfejsu bmbinary.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z getline() i getc_unlocked()
+ */
+#define _XOPEN_SOURCE 700
+#include <inttypes.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bmbinary.h"
+#include "bmparser.h"
+#include "gamma.h"
+#include "logic.h"
+
+/** @brief największa liczba argumentów rekordu
+ */
+#define MAX_RECORD_ARGUMENTS 4
+
+/** @brief litery komend tekstowych indeksowane typem command_type
+ */
+static const char command_letters[] = {'?', 'm', 'g', 'b', 'f', 'q', 'p', 'M'};
+
+/** @brief Struktura reprezentująca rekord binarny
+ */
+typedef struct{
+	int type; 				///< typ rekordu
+	uint64_t args[MAX_RECORD_ARGUMENTS]; 	///< argumenty rekordu
+	uint64_t* coords; 			///< współrzędne ruchów rekordu BulkMove,
+						///< x i y na zmianę, jest ich 2 * args[1]
+	uint64_t capacity; 			///< rozmiar tablicy coords
+} binary_record;
+
+/** @brief zapisuje liczbę zmiennej długości
+ * param[in] out 	- strumień
+ * param[in] v 		- zapisywana liczba
+ */
+static void write_varint(FILE* out, uint64_t v){
+	while(v >= 0x80){
+		putc_unlocked((int)(v | 0x80) & 0xff, out);
+		v >>= 7;
+	}
+	putc_unlocked((int)v, out);
+}
+
+/** @brief odczytuje liczbę zapisaną przez write_varint
+ * param[in] in 	- strumień
+ * param[out] v 	- odczytana liczba
+ *
+ * @return true jeżeli się udało, false jeżeli strumień się skończył lub liczba jest
+ * za długa, czyli ma więcej niż 10 bajtów lub nie mieści się w 64 bitach
+ */
+static bool read_varint(FILE* in, uint64_t* v){
+	*v = 0;
+	for(uint32_t shift=0;shift<64;shift+=7){
+		int byte = getc_unlocked(in);
+		if(byte == EOF || (shift == 63 && byte > 1))
+			return false;
+		*v |= (uint64_t)(byte & 0x7f) << shift;
+		if(byte < 0x80)
+			return true;
+	}
+	return false;
+}
+
+/** @brief zwraca liczbę argumentów rekordu danego typu
+ * Rekord BulkMove ma po dwóch argumentach (gracz i liczba ruchów) współrzędne ruchów.
+ * param[in] type 	- typ rekordu
+ *
+ * @return liczba argumentów lub -1 dla niepoprawnego typu
+ */
+static int record_arguments(int type){
+	if(type == Move || type == Golden)
+		return 3;
+	else if(type == BulkMove)
+		return 2;
+	else if(type == Busy || type == Free || type == GoldenPossible || type == BINARY_SKIP)
+		return 1;
+	else if(type == Unknown || type == Print)
+		return 0;
+	else if(type == BINARY_NEW_GAME)
+		return 4;
+	return -1;
+}
+
+/** @brief odczytuje współrzędne ruchów rekordu BulkMove
+ * Tablicę powiększamy w miarę czytania, więc ucięty strumień z dużą
+ * zadeklarowaną liczbą ruchów nie zajmuje dużo pamięci.
+ * param[in] in 	- strumień komend
+ * param[in,out] r 	- rekord
+ * param[in] n 		- liczba współrzędnych
+ *
+ * @return true jeżeli się udało, false jeżeli strumień się skończył lub zabrakło pamięci
+ */
+static bool read_coords(FILE* in, binary_record* r, uint64_t n){
+	for(uint64_t i=0;i<n;i++){
+		if(i == r->capacity){
+			uint64_t capacity = r->capacity == 0? 64 : 2*r->capacity;
+			uint64_t* coords = capacity <= SIZE_MAX/sizeof(uint64_t)?
+					   realloc(r->coords, capacity*sizeof(uint64_t)) : NULL;
+			if(coords == NULL)
+				return false;
+			r->coords = coords;
+			r->capacity = capacity;
+		}
+		if(!read_varint(in, &r->coords[i]))
+			return false;
+	}
+	return true;
+}
+
+/** @brief odczytuje kolejny rekord
+ * param[in] in 	- strumień komend
+ * param[out] r 	- odczytany rekord
+ * param[out] valid 	- false jeżeli rekord jest niepoprawny lub ucięty
+ *
+ * @return true jeżeli odczytano rekord, false jeżeli strumień się skończył
+ */
+static bool read_record(FILE* in, binary_record* r, bool* valid){
+	r->type = getc_unlocked(in);
+	if(r->type == EOF)
+		return false;
+	int n = record_arguments(r->type);
+	*valid = n >= 0;
+	for(int i=0;i<n && *valid;i++)
+		*valid = read_varint(in, &r->args[i]);
+	if(r->type == BulkMove && *valid)
+		*valid = r->args[1] <= UINT64_MAX/2 && read_coords(in, r, 2*r->args[1]);
+	return true;
+}
+
+/** @brief sprawdza czy argumenty rekordu mieszczą się w zakresie [0, UINT32_MAX]
+ * param[in] r 	- rekord
+ * param[in] n 	- liczba sprawdzanych argumentów
+ *
+ * @return true jeżeli wszystkie argumenty mieszczą się w zakresie, false wpp
+ */
+static bool valid_args(const binary_record* r, int n){
+	bool flague = true;
+	for(int i=0;i<n;i++)
+		flague &= r->args[i] <= UINT32_MAX;
+	return flague;
+}
+
+/** @brief zapisuje odpowiedź logiczną
+ * param[in] out 	- strumień odpowiedzi
+ * param[in] value 	- wartość odpowiedzi
+ */
+static void write_bool(FILE* out, bool value){
+	putc_unlocked(value? BinaryTrue : BinaryFalse, out);
+}
+
+/** @brief zapisuje odpowiedź liczbową
+ * param[in] out 	- strumień odpowiedzi
+ * param[in] value 	- wartość odpowiedzi
+ */
+static void write_number(FILE* out, uint64_t value){
+	putc_unlocked(BinaryNumber, out);
+	write_varint(out, value);
+}
+
+/** @brief wykonuje rekord BulkMove i zapisuje spakowane wyniki ruchów
+ * param[in] r 		- rekord
+ * param[in] game 	- struktura przechowująca stan gry
+ * param[in] out 	- strumień odpowiedzi
+ * param[in] line 	- numer linii odpowiadającej rekordowi
+ */
+static void execute_bulk_move(const binary_record* r, gamma_t* game, FILE* out, int line){
+	uint64_t n = r->args[1];
+	bool flague = true;
+	for(uint64_t i=0;i<2*n;i++)
+		flague &= r->coords[i] <= UINT32_MAX;
+	if(!flague){
+		errLine(line);
+		return;
+	}
+	gamma_coord_t* coords = malloc(n*sizeof(gamma_coord_t));
+	uint8_t* results = malloc(n+1);
+	if((n > 0 && coords == NULL) || results == NULL)
+		fail("NO MEMORY FOR COMMAND");
+	for(uint64_t i=0;i<n;i++){
+		coords[i].x = r->coords[2*i];
+		coords[i].y = r->coords[2*i+1];
+	}
+	gamma_move_batch(game, r->args[0], coords, n, results);
+	putc_unlocked(BinaryResults, out);
+	write_varint(out, n);
+	for(uint64_t i=0;i<n;i+=8){
+		int byte = 0;
+		for(uint64_t j=i;j<n && j<i+8;j++)
+			byte |= results[j] << (j-i);
+		putc_unlocked(byte, out);
+	}
+	free(coords);
+	free(results);
+}
+
+/** @brief wykonuje rekord tworzący grę
+ * param[in] r 		- rekord
+ * param[in] out 	- strumień odpowiedzi
+ * param[in] line 	- numer linii odpowiadającej rekordowi
+ *
+ * @return utworzona gra lub NULL
+ */
+static gamma_t* execute_new_game(const binary_record* r, FILE* out, int line){
+	gamma_t* g = NULL;
+	if(r->type == BINARY_NEW_GAME && valid_args(r, 4))
+		g = gamma_new(r->args[0], r->args[1], r->args[2], r->args[3]);
+	if(g == NULL){
+		errLine(line);
+	} else{
+		putc_unlocked(BinaryOk, out);
+		write_varint(out, line);
+	}
+	return g;
+}
+
+/** @brief wykonuje rekord komendy
+ * param[in] r 		- rekord
+ * param[in] game 	- struktura przechowująca stan gry
+ * param[in] out 	- strumień odpowiedzi
+ * param[in] line 	- numer linii odpowiadającej rekordowi
+ */
+static void execute_record(const binary_record* r, gamma_t* game, FILE* out, int line){
+	int n = record_arguments(r->type);
+	if(r->type == Unknown || r->type == BINARY_NEW_GAME || !valid_args(r, n)){
+		errLine(line);
+	} else if(r->type == Move){
+		write_bool(out, gamma_move(game, r->args[0], r->args[1], r->args[2]));
+	} else if(r->type == BulkMove){
+		execute_bulk_move(r, game, out, line);
+	} else if(r->type == Golden){
+		write_bool(out, gamma_golden_move(game, r->args[0], r->args[1], r->args[2]));
+	} else if(r->type == Busy){
+		write_number(out, gamma_busy_fields(game, r->args[0]));
+	} else if(r->type == Free){
+		write_number(out, gamma_free_fields(game, r->args[0]));
+	} else if(r->type == GoldenPossible){
+		write_bool(out, gamma_golden_possible(game, r->args[0]));
+	} else if(r->type == Print){
+		char* board = gamma_board(game);
+		if(board != NULL){
+			uint64_t length = strlen(board);
+			putc_unlocked(BinaryBoard, out);
+			write_varint(out, length);
+			fwrite(board, 1, length, out);
+			free(board);
+		}
+	}
+}
+
+/** @brief sprawdza, czy strumień zaczyna się napisem BINARY_MAGIC, i go pomija
+ * Jeżeli pierwszy bajt nie jest zerem, zostaje w strumieniu.
+ * param[in] in 	- strumień komend
+ *
+ * @return true jeżeli strumień jest binarny, false wpp
+ */
+bool binary_input(FILE* in){
+	int first = getc(in);
+	if(first != 0){
+		if(first != EOF)
+			ungetc(first, in);
+		return false;
+	}
+	char magic[BINARY_MAGIC_LENGTH] = {0};
+	return fread(magic+1, 1, BINARY_MAGIC_LENGTH-1, in) == BINARY_MAGIC_LENGTH-1 &&
+	       memcmp(magic, BINARY_MAGIC, BINARY_MAGIC_LENGTH) == 0;
+}
+
+/** @brief przeprowadza rozgrywkę w binarnym trybie wsadowym
+ * Wykonuje rekordy ze strumienia pozbawionego już napisu BINARY_MAGIC
+ * i zapisuje odpowiedzi, a komunikaty o błędach wypisuje na stderr tak jak
+ * tryb tekstowy. Niepoprawny typ rekordu lub ucięty rekord kończy rozgrywkę.
+ * param[in] in 	- strumień komend
+ * param[in] out 	- strumień odpowiedzi
+ */
+void play_binary(FILE* in, FILE* out){
+	fwrite(BINARY_RESPONSE_MAGIC, 1, BINARY_MAGIC_LENGTH, out);
+	gamma_t* game = NULL;
+	binary_record r = {.coords = NULL, .capacity = 0};
+	bool valid = true;
+	int line = 0;
+	while(valid && read_record(in, &r, &valid)){
+		if(!valid || (r.type == BINARY_SKIP && r.args[0] > (uint64_t)INT_MAX-line)){
+			errLine(line+1);
+			valid = false;
+		} else if(r.type == BINARY_SKIP){
+			line += r.args[0];
+		} else if(game == NULL){
+			game = execute_new_game(&r, out, ++line);
+		} else{
+			execute_record(&r, game, out, ++line);
+		}
+	}
+	fflush(out);
+	free(r.coords);
+	gamma_delete(game);
+}
+
+/** @brief zapisuje rekord komendy
+ * param[in] out 	- strumień komend binarnych
+ * param[in] type 	- typ rekordu
+ * param[in] nums 	- argumenty rekordu
+ * param[in] n 		- liczba argumentów
+ */
+static void write_record(FILE* out, int type, const long long int* nums, int n){
+	putc_unlocked(type, out);
+	for(int i=0;i<n;i++)
+		write_varint(out, (uint64_t)nums[i]);
+}
+
+/** @brief dopisuje do rekordu BulkMove współrzędne ruchów
+ * param[in] out 	- strumień komend binarnych
+ * param[in] coords 	- współrzędne, x i y na zmianę
+ * param[in] n 		- liczba współrzędnych
+ */
+static void write_record_coords(FILE* out, const long long int* coords, long long int n){
+	for(long long int i=0;i<n;i++)
+		write_varint(out, (uint64_t)coords[i]);
+}
+
+/** @brief zamienia linię komendy tekstowej na rekord binarny
+ * Linie niepoprawne w obu stanach trybu tekstowego stają się rekordem Unknown.
+ * param[in] buffer 	- linia komendy
+ * param[in] out 	- strumień komend binarnych
+ */
+static void write_line_record(char* buffer, FILE* out){
+	mode_selection_command* mode = parse_mode_selection(buffer);
+	if(mode != NULL){
+		if(mode->mode == 'B')
+			write_record(out, BINARY_NEW_GAME, mode->nums, 4);
+		else
+			write_record(out, Unknown, NULL, 0);
+		free(mode);
+		return;
+	}
+	enum command_type type = parse_command_type(buffer);
+	if(type == Move || type == Golden){
+		move_command* com = parse_move_command(buffer);
+		if(com != NULL)
+			write_record(out, type, com->nums, 3);
+		else
+			write_record(out, Unknown, NULL, 0);
+		free(com);
+	} else if(type == BulkMove){
+		bulk_move_command* com = parse_bulk_move_command(buffer);
+		if(com != NULL){
+			write_record(out, type, &com->player, 2);
+			write_record_coords(out, com->coords, 2*com->n);
+		} else{
+			write_record(out, Unknown, NULL, 0);
+		}
+		free(com);
+	} else if(type == Busy || type == Free || type == GoldenPossible){
+		player_info_command* com = parse_player_info_command(buffer);
+		if(com != NULL)
+			write_record(out, type, &com->player, 1);
+		else
+			write_record(out, Unknown, NULL, 0);
+		free(com);
+	} else if(type == Print){
+		print_command* com = parse_print_command(buffer);
+		write_record(out, com != NULL? Print : Unknown, NULL, 0);
+		free(com);
+	} else{
+		write_record(out, Unknown, NULL, 0);
+	}
+}
+
+/** @brief zamienia komendy w formacie tekstowym na binarne
+ * Linie I i T zamienia na rekord Unknown, bo tryb binarny obsługuje tylko
+ * tryb wsadowy jednej gry.
+ * param[in] in 	- komendy tekstowe
+ * param[in] out 	- komendy binarne
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci lub nie udało się pisać
+ */
+bool text_to_binary(FILE* in, FILE* out){
+	char* buffer = NULL;
+	size_t buffsize = 0;
+	long long int skipped = 0;
+	fwrite(BINARY_MAGIC, 1, BINARY_MAGIC_LENGTH, out);
+	while(getline(&buffer, &buffsize, in) != -1){
+		if(ignore_line(buffer)){
+			skipped++;
+		} else{
+			if(skipped > 0)
+				write_record(out, BINARY_SKIP, &skipped, 1);
+			skipped = 0;
+			write_line_record(buffer, out);
+		}
+	}
+	free(buffer);
+	return !ferror(in) && fflush(out) == 0 && !ferror(out);
+}
+
+/** @brief zamienia komendy binarne na tekstowe
+ * param[in] in 	- komendy binarne
+ * param[in] out 	- komendy tekstowe
+ *
+ * @return true jeżeli się udało, false jeżeli strumień jest niepoprawny lub nie udało się pisać
+ */
+bool binary_to_text(FILE* in, FILE* out){
+	if(!binary_input(in))
+		return false;
+	binary_record r = {.coords = NULL, .capacity = 0};
+	bool valid = true;
+	while(valid && read_record(in, &r, &valid)){
+		if(!valid){
+			break;
+		} else if(r.type == BINARY_SKIP){
+			for(uint64_t i=0;i<r.args[0];i++)
+				fputs("#\n", out);
+		} else if(r.type == BINARY_NEW_GAME){
+			fprintf(out, "B %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+				r.args[0], r.args[1], r.args[2], r.args[3]);
+		} else{
+			putc_unlocked(command_letters[r.type], out);
+			for(int i=0;i<record_arguments(r.type);i++)
+				fprintf(out, " %" PRIu64, r.args[i]);
+			for(uint64_t i=0;r.type == BulkMove && i<2*r.args[1];i++)
+				fprintf(out, " %" PRIu64, r.coords[i]);
+			putc_unlocked('\n', out);
+		}
+	}
+	free(r.coords);
+	return valid && fflush(out) == 0 && !ferror(out);
+}
+
+/** @brief zamienia odpowiedzi binarne na wyjście trybu tekstowego
+ * param[in] in 	- odpowiedzi binarne
+ * param[in] out 	- odpowiedzi tekstowe
+ *
+ * @return true jeżeli się udało, false jeżeli strumień jest niepoprawny lub nie udało się pisać
+ */
+bool responses_to_text(FILE* in, FILE* out){
+	char magic[BINARY_MAGIC_LENGTH];
+	if(fread(magic, 1, BINARY_MAGIC_LENGTH, in) != BINARY_MAGIC_LENGTH ||
+	   memcmp(magic, BINARY_RESPONSE_MAGIC, BINARY_MAGIC_LENGTH) != 0)
+		return false;
+	bool valid = true;
+	int tag;
+	while(valid && (tag = getc_unlocked(in)) != EOF){
+		uint64_t value = 0;
+		if(tag == BinaryFalse || tag == BinaryTrue){
+			fprintf(out, "%d\n", tag == BinaryTrue);
+		} else if(tag == BinaryNumber && (valid = read_varint(in, &value))){
+			fprintf(out, "%" PRIu64 "\n", value);
+		} else if(tag == BinaryOk && (valid = read_varint(in, &value))){
+			fprintf(out, "OK %" PRIu64 "\n", value);
+		} else if(tag == BinaryResults && (valid = read_varint(in, &value))){
+			int byte = 0;
+			for(uint64_t i=0;i<value && valid;i++){
+				if(i % 8 == 0)
+					valid = (byte = getc_unlocked(in)) != EOF;
+				putc_unlocked('0'+((byte >> (i % 8)) & 1), out);
+			}
+			putc_unlocked('\n', out);
+		} else if(tag == BinaryBoard && (valid = read_varint(in, &value))){
+			for(uint64_t i=0;i<value && valid;i++){
+				int c = getc_unlocked(in);
+				valid = c != EOF;
+				if(valid)
+					putc_unlocked(c, out);
+			}
+		} else{
+			valid = false;
+		}
+	}
+	return valid && fflush(out) == 0 && !ferror(out);
+}
@@ -0,0 +1,97 @@
+/** @file
+ * Interfejs binarnego trybu wsadowego i konwertera między formatem
+ * tekstowym a binarnym
+ *
+ * Strumień binarny zaczyna się napisem BINARY_MAGIC, po którym następują
+ * rekordy: bajt typu i jego argumenty zapisane jako liczby zmiennej długości
+ * (po 7 bitów na bajt, od najmłodszych, najstarszy bit bajtu oznacza, że
+ * liczba trwa dalej). Typ rekordu komendy jest wartością command_type,
+ * a jej argumenty to kolejne liczby komendy tekstowej. Odpowiedzi zaczynają
+ * się napisem BINARY_RESPONSE_MAGIC, a każda z nich bajtem binary_response.
+ * Odpowiedź na BulkMove to liczba ruchów i ich wyniki po 8 w bajcie,
+ * od najmłodszego bitu.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef BMBINARY_H
+#define BMBINARY_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/** @brief napis rozpoczynający binarny strumień komend, pierwszy bajt
+ * jest zerem, więc nie myli się z żadną linią formatu tekstowego
+ */
+#define BINARY_MAGIC "\0GAMMABC"
+
+/** @brief napis rozpoczynający binarny strumień odpowiedzi
+ */
+#define BINARY_RESPONSE_MAGIC "\0GAMMABR"
+
+/** @brief długość BINARY_MAGIC i BINARY_RESPONSE_MAGIC
+ */
+#define BINARY_MAGIC_LENGTH 8
+
+/** @brief typ rekordu tworzącego grę w trybie wsadowym (linia B),
+ * argumenty jak w gamma_new
+ */
+#define BINARY_NEW_GAME 0x80
+
+/** @brief typ rekordu zastępującego linie ignorowane w formacie tekstowym,
+ * argumentem jest liczba linii, dzięki której numery linii w odpowiedziach
+ * zgadzają się z formatem tekstowym
+ */
+#define BINARY_SKIP 0x81
+
+/** @brief typ odpowiedzi binarnej
+ */
+enum binary_response{BinaryFalse = 0, BinaryTrue, BinaryNumber, BinaryBoard, BinaryOk,
+		     BinaryResults};
+
+/** @brief sprawdza, czy strumień zaczyna się napisem BINARY_MAGIC, i go pomija
+ * Jeżeli pierwszy bajt nie jest zerem, zostaje w strumieniu.
+ * param[in] in 	- strumień komend
+ *
+ * @return true jeżeli strumień jest binarny, false wpp
+ */
+bool binary_input(FILE* in);
+
+/** @brief przeprowadza rozgrywkę w binarnym trybie wsadowym
+ * Wykonuje rekordy ze strumienia pozbawionego już napisu BINARY_MAGIC
+ * i zapisuje odpowiedzi, a komunikaty o błędach wypisuje na stderr tak jak
+ * tryb tekstowy. Niepoprawny typ rekordu lub ucięty rekord kończy rozgrywkę.
+ * param[in] in 	- strumień komend
+ * param[in] out 	- strumień odpowiedzi
+ */
+void play_binary(FILE* in, FILE* out);
+
+/** @brief zamienia komendy w formacie tekstowym na binarne
+ * Linie I i T zamienia na rekord Unknown, bo tryb binarny obsługuje tylko
+ * tryb wsadowy jednej gry.
+ * param[in] in 	- komendy tekstowe
+ * param[in] out 	- komendy binarne
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci lub nie udało się pisać
+ */
+bool text_to_binary(FILE* in, FILE* out);
+
+/** @brief zamienia komendy binarne na tekstowe
+ * param[in] in 	- komendy binarne
+ * param[in] out 	- komendy tekstowe
+ *
+ * @return true jeżeli się udało, false jeżeli strumień jest niepoprawny lub nie udało się pisać
+ */
+bool binary_to_text(FILE* in, FILE* out);
+
+/** @brief zamienia odpowiedzi binarne na wyjście trybu tekstowego
+ * param[in] in 	- odpowiedzi binarne
+ * param[in] out 	- odpowiedzi tekstowe
+ *
+ * @return true jeżeli się udało, false jeżeli strumień jest niepoprawny lub nie udało się pisać
+ */
+bool responses_to_text(FILE* in, FILE* out);
+
+#endif
@@ -31,9 +31,9 @@ static void print1(){
  * @param[in] size	 	– rozmiar tablicy
  * @return true wszystkie liczby mieszczą się w zakresie [0, UINT32_MAX], false wpp
  */
-static bool valid_nums(long long int nums[], int size){
+bool valid_nums(long long int nums[], long long int size){
 	bool flague = true;
-	for(int i=0;i<size;i++){
+	for(long long int i=0;i<size;i++){
 		flague &= nums[i]>=0 && nums[i]<= UINT32_MAX;
 	}
 	return flague;
@@ -52,11 +52,16 @@ static bool valid_num(long long int num){
  * @param[in] gm    – wskaźnik na strukturę do której zapiszemy utworzoną grę 
  * 					  i informację o trybie, w którym będziemy grać
  * @param[in] line 	– wskaźnik na licznik przetworzonych lini
- * @return true jeżeli gamma_new zwróciło grę, false jeżeli zwróciło NULL 
+ * @return true jeżeli gamma_new zwróciło grę lub wybrano tryb T, który
+ * nie tworzy gry, false jeżeli gamma_new zwróciło NULL 
  */
 bool execute_mode_selection(mode_selection_command* com, game_and_mode* gm, int line){
 
-	if(com != NULL && valid_nums(com->nums, 4)){
+	if(com != NULL && com->mode == 'T'){
+		gm->mod = Tagged;
+		gm->game = NULL;
+		return true;
+	} else if(com != NULL && valid_nums(com->nums, 4)){
 		if(com->mode == 'I'){
 			gm->mod = Interactive;
 		} else if(com->mode == 'B'){
@@ -114,6 +119,49 @@ void execute_golden_move_command(move_command* com, gamma_t* game, int line){
 	}
 }
 
+/** @brief wykonuje gamma_move_batch z parametrami zapisanymi w com
+ * @param[in] com 	– sparsowana komenda zawierajaca informacje o wykonywanej akcji
+ * @param[in] game  – wskaźnik na strukturę przechowującą stan gry
+ * @return linia długości com->n + 1 z cyframi 0 i 1 zakończona znakiem nowej
+ * linii, którą trzeba zwolnić, lub NULL dla niepoprawnej komendy
+ */
+char* bulk_move_results(bulk_move_command* com, gamma_t* game){
+	if(com == NULL || !valid_num(com->player) || !valid_nums(com->coords, 2*com->n))
+		return NULL;
+	uint64_t n = com->n;
+	gamma_coord_t* coords = malloc(n*sizeof(gamma_coord_t));
+	uint8_t* results = malloc(n+1);
+	if((n > 0 && coords == NULL) || results == NULL)
+		fail("NO MEMORY FOR COMMAND");
+	for(uint64_t i=0;i<n;i++){
+		coords[i].x = com->coords[2*i];
+		coords[i].y = com->coords[2*i+1];
+	}
+	gamma_move_batch(game, com->player, coords, n, results);
+	for(uint64_t i=0;i<n;i++)
+		results[i] += '0';
+	results[n] = '\n';
+	free(coords);
+	return (char*)results;
+}
+
+/** @brief wykonuje gamma_move_batch z parametrami zapisanymi w com
+ * i wypisuje wyniki wszystkich ruchów w jednej linii
+ * @param[in] com 	– sparsowana komenda zawierajaca informacje o wykonywanej akcji
+ * @param[in] game  – wskaźnik na strukturę przechowującą stan gry 
+ * 					  i informację o trybie, w którym będziemy grać
+ * @param[in] line 	– wskaźnik na licznik przetworzonych lini
+ */
+void execute_bulk_move_command(bulk_move_command* com, gamma_t* game, int line){
+	char* results = bulk_move_results(com, game);
+	if(results != NULL){
+		fwrite(results, 1, com->n+1, stdout);
+		free(results);
+	} else{
+		errLine(line);
+	}
+}
+
 /** @brief wykonuje gamma_busy_fields z parametrami zapisanymi w com
  * @param[in] com 	– sparsowana komenda zawierajaca informacje o wykonywanej akcji
  * @param[in] game  – wskaźnik na strukturę przechowującą stan gry 
@@ -14,12 +14,20 @@
 #include "gamma.h"
 #include "logic.h"
 
+/** @brief sprawdza czy podana tablica liczb zawiera liczby w zakresie [0, UINT32_MAX]
+ * @param[in] nums[] 	– tablica liczb, którą badamy 
+ * @param[in] size	 	– rozmiar tablicy
+ * @return true wszystkie liczby mieszczą się w zakresie [0, UINT32_MAX], false wpp
+ */
+bool valid_nums(long long int nums[], long long int size);
+
 /** @brief ustawia tryb gry na podstawie podanej komendy
  * @param[in] com 	– sparsowana komenda zawierajaca informacje o trybie
  * @param[in] gm    – wskaźnik na strukturę do której zapiszemy utworzoną grę 
  * 					  i informację o trybie, w którym będziemy grać
  * @param[in] line 	– wskaźnik na licznik przetworzonych lini
- * @return true jeżeli gamma_new zwróciło grę, false jeżeli zwróciło NULL 
+ * @return true jeżeli gamma_new zwróciło grę lub wybrano tryb T, który
+ * nie tworzy gry, false jeżeli gamma_new zwróciło NULL 
  */
 bool execute_mode_selection(mode_selection_command* com, game_and_mode* gm, int line);
 
@@ -39,6 +47,23 @@ void execute_move_command(move_command* com, gamma_t* game, int line);
  */
 void execute_golden_move_command(move_command* com, gamma_t* game, int line);
 
+/** @brief wykonuje gamma_move_batch z parametrami zapisanymi w com
+ * @param[in] com 	– sparsowana komenda zawierajaca informacje o wykonywanej akcji
+ * @param[in] game  – wskaźnik na strukturę przechowującą stan gry
+ * @return linia długości com->n + 1 z cyframi 0 i 1 zakończona znakiem nowej
+ * linii, którą trzeba zwolnić, lub NULL dla niepoprawnej komendy
+ */
+char* bulk_move_results(bulk_move_command* com, gamma_t* game);
+
+/** @brief wykonuje gamma_move_batch z parametrami zapisanymi w com
+ * i wypisuje wyniki wszystkich ruchów w jednej linii
+ * @param[in] com 	– sparsowana komenda zawierajaca informacje o wykonywanej akcji
+ * @param[in] game  – wskaźnik na strukturę przechowującą stan gry 
+ * 					  i informację o trybie, w którym będziemy grać
+ * @param[in] line 	– wskaźnik na licznik przetworzonych lini
+ */
+void execute_bulk_move_command(bulk_move_command* com, gamma_t* game, int line);
+
 /** @brief wykonuje gamma_busy_fields z parametrami zapisanymi w com
  * @param[in] com 	– sparsowana komenda zawierajaca informacje o wykonywanej akcji
  * @param[in] game  – wskaźnik na strukturę przechowującą stan gry 
@@ -73,7 +73,17 @@ mode_selection_command* parse_mode_selection(char* buffer){
 		strcpy(bufferCpy, buffer);
 		trim_last(bufferCpy);
 		char* token = strtok(bufferCpy, " \t\v\f\r");
-		if(token != NULL){
+		if(token != NULL && strcmp(token, "T") == 0 && !is_space(buffer[0]) && com != NULL){
+			com->mode = token[0];
+			token = strtok(NULL, " \t\v\f\r");
+			free(bufferCpy);
+			if(token != NULL){
+				//printf("too long\n");
+				free(com);
+				return NULL;
+			}
+			return com;
+		} else if(token != NULL){
 			if(strcmp(token, "B")*strcmp(token, "I") != 0 || is_space(buffer[0])){
 				//printf("wrong mode\n");
 				free(bufferCpy);
@@ -155,6 +165,8 @@ enum command_type parse_command_type(char* buffer){
 					type = GoldenPossible;
 				else if(strcmp(token, "p") == 0)
 					type = Print;
+				else if(strcmp(token, "M") == 0)
+					type = BulkMove;
 			}
 		}
 		free(bufferCpy);
@@ -282,6 +294,54 @@ player_info_command* parse_player_info_command(char* buffer){
 	return NULL;
 }
 
+/** @brief parsuje kolejny token linii jako liczbę
+ * param[out] num 	- sparsowana liczba
+ *
+ * @return true jeżeli token istnieje i jest liczbą, false wpp
+ */
+static bool parse_next_num(long long int* num){
+	char* token = strtok(NULL, " \t\v\f\r");
+	if(token == NULL)
+		return false;
+	*num = strtoull(token, NULL, 10);
+	return valid_num_token(*num, token);
+}
+
+/** @brief parsuje linię inputu i zwraca komendę
+ * param[in] buffer	- linia inputu do przetworzenia
+ *
+ * @return sparsowana komenda
+ */
+bulk_move_command* parse_bulk_move_command(char* buffer){
+	if(buffer == NULL || strlen(buffer) == 0)
+		return NULL;
+	char* bufferCpy = malloc(strlen(buffer)+1);
+	if(bufferCpy == NULL)
+		fail("NO MEMORY FOR COMMAND");
+	strcpy(bufferCpy, buffer);
+	trim_last(bufferCpy);
+	bulk_move_command header;
+	bulk_move_command* com = NULL;
+	strtok(bufferCpy, " \t\v\f\r");
+	if(parse_next_num(&header.player) && parse_next_num(&header.n) &&
+	   header.n >= 0 && (unsigned long long)header.n <= strlen(buffer)/4){
+		com = malloc(sizeof(bulk_move_command)+2*header.n*sizeof(long long int));
+		if(com == NULL)
+			fail("NO MEMORY FOR COMMAND");
+		*com = header;
+		bool flague = true;
+		for(long long int i=0;i<2*com->n && flague;i++)
+			flague = parse_next_num(&com->coords[i]);
+		if(!flague || strtok(NULL, " \t\v\f\r") != NULL){
+			//printf("wrong number of coordinates\n");
+			free(com);
+			com = NULL;
+		}
+	}
+	free(bufferCpy);
+	return com;
+}
+
 /** @brief parsuje linię inputu i zwraca komendę
  * param[in] buffer	- linia inputu do przetworzenia
  *
@@ -325,3 +385,46 @@ print_command* parse_print_command(char* buffer){
 	}
 	return NULL;
 }
+
+/** @brief parsuje identyfikator gry na początku linii trybu z identyfikatorami gier
+ * param[in] buffer	- linia inputu do przetworzenia
+ * param[out] id 	- identyfikator gry
+ *
+ * @return wskaźnik na komendę w buffer, za identyfikatorem i jednym białym
+ * znakiem, lub NULL jeżeli linia nie zaczyna się identyfikatorem
+ */
+char* parse_game_tag(char* buffer, long long int* id){
+	if(buffer == NULL)
+		return NULL;
+	char token[GAME_TAG_MAX_LENGTH+1];
+	size_t length = 0;
+	while(length < GAME_TAG_MAX_LENGTH && isdigit((unsigned char)buffer[length])){
+		token[length] = buffer[length];
+		length++;
+	}
+	token[length] = '\0';
+	if(length == 0 || !is_space(buffer[length]))
+		return NULL;
+	*id = strtoull(token, NULL, 10);
+	return valid_num_token(*id, token)? buffer+length+1 : NULL;
+}
+
+/** @brief sprawdza, czy linia inputu jest komendą usunięcia gry (D)
+ * param[in] buffer	- linia inputu do przetworzenia
+ *
+ * @return true jeżeli linia jest komendą usunięcia gry, false wpp
+ */
+bool parse_delete_command(char* buffer){
+	if(buffer == NULL || strlen(buffer) == 0 || is_space(buffer[0]))
+		return false;
+	char* bufferCpy = malloc(strlen(buffer)+1);
+	if(bufferCpy == NULL)
+		fail("NO MEMORY FOR COMMAND");
+	strcpy(bufferCpy, buffer);
+	trim_last(bufferCpy);
+	char* token = strtok(bufferCpy, " \t\v\f\r");
+	bool flague = token != NULL && strcmp(token, "D") == 0;
+	flague = flague && strtok(NULL, " \t\v\f\r") == NULL;
+	free(bufferCpy);
+	return flague;
+}
@@ -9,12 +9,17 @@
 #ifndef BMPARSER_H
 #define BMPARSER_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
+/** @brief największa liczba cyfr identyfikatora gry, wystarcza na UINT32_MAX
+ */
+#define GAME_TAG_MAX_LENGTH 10
+
 
 /** @brief typ reprezentujący radzaj zwróconej komendy
  */
-enum command_type{Unknown = 0, Move, Golden, Busy, Free, GoldenPossible, Print};
+enum command_type{Unknown = 0, Move, Golden, Busy, Free, GoldenPossible, Print, BulkMove};
 
 /** @brief Struktura reprezentująca komendę 
  * zawierającą parametry z jakimi ma być wykonane gamma_move i gamma_golden_move
@@ -23,6 +28,15 @@ typedef struct{
 	long long int nums[3]; ///< tablica liczb będących parametrami
 } move_command;
 
+/** @brief Struktura reprezentująca komendę 
+ * zawierającą parametry z jakimi ma być wykonane gamma_move_batch
+ */
+typedef struct{
+	long long int player; 	///< numer gracza
+	long long int n; 	///< liczba ruchów
+	long long int coords[]; ///< współrzędne kolejnych ruchów, x i y na zmianę
+} bulk_move_command;
+
 /** @brief Struktura reprezentująca komendę 
  * zawierającą parametry z jakimi ma być wykonane gamma_golden_possible,
  * gamma_free_frields, gamma_busy_fields
@@ -36,7 +50,7 @@ typedef struct{
  * tryb w jakim ma być prowadzona gra
  */
 typedef struct{
-	char mode; ///< zawiera informacje o trybie gry
+	char mode; ///< zawiera informacje o trybie gry: B, I lub T (bez parametrów)
 	long long int nums [4]; ///< tablica liczb będących parametrami
 } mode_selection_command;
 
@@ -75,6 +89,13 @@ move_command* parse_move_command(char* buffer);
  */
 player_info_command* parse_player_info_command(char* buffer);
 
+/** @brief parsuje linię inputu i zwraca komendę
+ * param[in] buffer	- linia inputu do przetworzenia
+ *
+ * @return sparsowana komenda
+ */
+bulk_move_command* parse_bulk_move_command(char* buffer);
+
 /** @brief parsuje linię inputu i zwraca komendę
  * param[in] buffer	- linia inputu do przetworzenia
  *
@@ -82,4 +103,20 @@ player_info_command* parse_player_info_command(char* buffer);
  */
 print_command* parse_print_command(char* buffer);
 
+/** @brief parsuje identyfikator gry na początku linii trybu z identyfikatorami gier
+ * param[in] buffer	- linia inputu do przetworzenia
+ * param[out] id 	- identyfikator gry
+ *
+ * @return wskaźnik na komendę w buffer, za identyfikatorem i jednym białym
+ * znakiem, lub NULL jeżeli linia nie zaczyna się identyfikatorem
+ */
+char* parse_game_tag(char* buffer, long long int* id);
+
+/** @brief sprawdza, czy linia inputu jest komendą usunięcia gry (D)
+ * param[in] buffer	- linia inputu do przetworzenia
+ *
+ * @return true jeżeli linia jest komendą usunięcia gry, false wpp
+ */
+bool parse_delete_command(char* buffer);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,336 @@
+/** @file
+ * Implementacja interfejsu bmpipeline.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z getline()
+ */
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "bmparser.h"
+#include "bmexecuter.h"
+#include "bmpipeline.h"
+#include "logic.h"
+#include "spsc.h"
+#include "threadpool.h"
+
+/** @brief liczba miejsc w kolejkach komend i wyników
+ */
+#define PIPELINE_CAPACITY 4096
+
+/** @brief największa liczba kolejnych zapytań wykonywanych razem
+ */
+#define QUERY_RUN_MAX 256
+
+/** @brief Struktura reprezentująca sparsowaną linię inputu
+ */
+typedef struct{
+	enum command_type type; 	///< rodzaj komendy
+	bool end; 			///< true dla znacznika końca inputu
+	bool parsed; 			///< false jeżeli linia jest niepoprawna
+	int line; 			///< numer linii
+	long long int nums[3]; 		///< parametry komendy, dla komend gracza tylko nums[0]
+	bulk_move_command* bulk; 	///< sparsowana komenda BulkMove, zwalnia ją wykonujący
+} pipeline_command;
+
+/** @brief typ wyniku komendy
+ */
+enum result_kind{ResultNone, ResultEnd, ResultError, ResultBool, ResultNumber, ResultText};
+
+/** @brief Struktura reprezentująca wynik komendy do wypisania
+ */
+typedef struct{
+	enum result_kind kind; 	///< typ wyniku
+	int line; 		///< numer linii komendy
+	uint64_t value; 	///< wartość wyniku logicznego lub liczbowego
+	char* text; 		///< napis do wypisania, zwalnia go wątek piszący
+	size_t length; 		///< długość napisu
+} pipeline_result;
+
+/** @brief Struktura łącząca wątki potoku
+ */
+typedef struct{
+	spsc_ring commands; 	///< kolejka od parsera do silnika
+	spsc_ring results; 	///< kolejka od silnika do wątku piszącego
+	int line; 		///< numer ostatniej linii przeczytanej przez parser
+} pipeline;
+
+/** @brief Struktura opisująca ciąg kolejnych komend, które nie zmieniają stanu gry
+ */
+typedef struct{
+	gamma_t* game; 					///< gra, której dotyczą zapytania
+	uint32_t length; 				///< liczba komend w ciągu
+	pipeline_command commands[QUERY_RUN_MAX]; 	///< komendy w kolejności inputu
+	pipeline_result results[QUERY_RUN_MAX]; 	///< ich wyniki
+} query_run;
+
+/** @brief sprawdza, czy tryb wsadowy ma działać potokowo
+ * Tryb potokowy trzeba włączyć zmienną środowiskową GAMMA_PIPELINE=1,
+ * domyślnie działa zwykły play_batch.
+ *
+ * @return true jeżeli tryb potokowy jest włączony, false wpp
+ */
+bool pipeline_requested(void){
+	char* env = getenv("GAMMA_PIPELINE");
+	return env != NULL && strcmp(env, "1") == 0;
+}
+
+/** @brief parsuje linię inputu tak jak play_batch
+ * param[in] buffer 	- linia inputu
+ * param[in] line 	- numer linii
+ * param[out] c 	- sparsowana komenda
+ */
+static void parse_line(char* buffer, int line, pipeline_command* c){
+	c->type = parse_command_type(buffer);
+	c->end = false;
+	c->parsed = false;
+	c->line = line;
+	c->bulk = NULL;
+	if(c->type == Move || c->type == Golden){
+		move_command* com = parse_move_command(buffer);
+		if(com != NULL){
+			memcpy(c->nums, com->nums, sizeof(com->nums));
+			c->parsed = true;
+		}
+		free(com);
+	} else if(c->type == Busy || c->type == Free || c->type == GoldenPossible){
+		player_info_command* com = parse_player_info_command(buffer);
+		if(com != NULL){
+			c->nums[0] = com->player;
+			c->parsed = true;
+		}
+		free(com);
+	} else if(c->type == Print){
+		print_command* com = parse_print_command(buffer);
+		c->parsed = com != NULL;
+		free(com);
+	} else if(c->type == BulkMove){
+		c->bulk = parse_bulk_move_command(buffer);
+		c->parsed = c->bulk != NULL;
+	}
+}
+
+/** @brief wątek parsera: czyta i parsuje linie, a na końcu wkłada znacznik końca
+ * param[in] arg 	- wskaźnik na strukturę pipeline
+ *
+ * @return NULL
+ */
+static void* parse_input(void* arg){
+	pipeline* p = arg;
+	char* buffer = NULL;
+	size_t buffsize = 0;
+	pipeline_command c;
+	while(getline(&buffer, &buffsize, stdin) != -1){
+		p->line++;
+		if(!ignore_line(buffer)){
+			parse_line(buffer, p->line, &c);
+			spsc_push(&p->commands, &c);
+		}
+	}
+	free(buffer);
+	c.end = true;
+	spsc_push(&p->commands, &c);
+	return NULL;
+}
+
+/** @brief wykonuje komendę na silniku
+ * param[in] c 		- sparsowana komenda
+ * param[in] game 	- struktura przechowująca stan gry
+ * param[out] r 	- wynik komendy
+ */
+static void execute_command(pipeline_command* c, gamma_t* game, pipeline_result* r){
+	r->line = c->line;
+	r->text = NULL;
+	if(!c->parsed){
+		r->kind = ResultError;
+	} else if(c->type == Move || c->type == Golden){
+		r->kind = valid_nums(c->nums, 3)? ResultBool : ResultError;
+		if(r->kind == ResultBool && c->type == Move)
+			r->value = gamma_move(game, c->nums[0], c->nums[1], c->nums[2]);
+		else if(r->kind == ResultBool)
+			r->value = gamma_golden_move(game, c->nums[0], c->nums[1], c->nums[2]);
+	} else if(!valid_nums(c->nums, 1) && c->type != Print && c->type != BulkMove){
+		r->kind = ResultError;
+	} else if(c->type == Busy){
+		r->kind = ResultNumber;
+		r->value = gamma_busy_fields(game, c->nums[0]);
+	} else if(c->type == Free){
+		r->kind = ResultNumber;
+		r->value = gamma_free_fields(game, c->nums[0]);
+	} else if(c->type == GoldenPossible){
+		r->kind = ResultBool;
+		r->value = gamma_golden_possible(game, c->nums[0]);
+	} else if(c->type == Print){
+		r->text = gamma_board(game);
+		r->kind = r->text != NULL? ResultText : ResultNone;
+		r->length = r->text != NULL? strlen(r->text) : 0;
+	} else if(c->type == BulkMove){
+		r->text = bulk_move_results(c->bulk, game);
+		r->kind = r->text != NULL? ResultText : ResultError;
+		r->length = c->bulk->n+1;
+	}
+	free(c->bulk);
+}
+
+/** @brief wątek piszący: wypisuje wyniki w kolejności komend
+ * param[in] arg 	- wskaźnik na strukturę pipeline
+ *
+ * @return NULL
+ */
+static void* write_output(void* arg){
+	pipeline* p = arg;
+	pipeline_result r;
+	spsc_pop(&p->results, &r);
+	while(r.kind != ResultEnd){
+		if(r.kind == ResultError){
+			errLine(r.line);
+		} else if(r.kind == ResultBool){
+			printf("%d\n", (int)r.value);
+		} else if(r.kind == ResultNumber){
+			printf("%lu\n", r.value);
+		} else if(r.kind == ResultText){
+			fwrite(r.text, 1, r.length, stdout);
+			free(r.text);
+		}
+		spsc_pop(&p->results, &r);
+	}
+	fflush(stdout);
+	return NULL;
+}
+
+/** @brief sprawdza, czy komenda nie zmienia stanu gry
+ * Takie są zapytania i linie niepoprawne, które dają tylko komunikat o błędzie.
+ * param[in] c 	- sparsowana komenda
+ *
+ * @return true jeżeli komendę można wykonać równolegle z innymi takimi, false wpp
+ */
+static bool read_only(pipeline_command* c){
+	return !c->end && (!c->parsed ||
+	       (c->type != Move && c->type != Golden && c->type != BulkMove));
+}
+
+/** @brief dokłada do ciągu zapytań komendy, które są już w kolejce
+ * Nie czeka na parser, więc nie opóźnia odpowiedzi, gdy input przychodzi powoli.
+ * param[in] p 		- potok
+ * param[in,out] run 	- ciąg zapytań z co najmniej jedną komendą
+ * param[out] next 	- pierwsza komenda za ciągiem
+ *
+ * @return true jeżeli w next jest wyjęta z kolejki komenda zmieniająca stan
+ * gry lub znacznik końca, false wpp
+ */
+static bool collect_queries(pipeline* p, query_run* run, pipeline_command* next){
+	while(run->length < QUERY_RUN_MAX){
+		if(!spsc_try_pop(&p->commands, next))
+			return false;
+		if(!read_only(next))
+			return true;
+		run->commands[run->length++] = *next;
+	}
+	return false;
+}
+
+/** @brief wykonuje jedno zapytanie z ciągu, zadanie dla puli wątków
+ * param[in] arg 	- wskaźnik na query_run
+ * param[in] chunk 	- numer zapytania w ciągu
+ */
+static void query_chunk(void* arg, uint32_t chunk){
+	query_run* run = arg;
+	execute_command(&run->commands[chunk], run->game, &run->results[chunk]);
+}
+
+/** @brief wykonuje ciąg zapytań, równolegle jeżeli jest ich więcej niż jedno
+ * Między zapytaniami nie ma ruchów, więc każde z nich widzi ten sam stan gry.
+ * param[in,out] run 	- ciąg zapytań
+ */
+static void execute_queries(query_run* run){
+	if(run->length > 1 && gamma_prepare_queries(run->game)){
+		thread_pool_run(query_chunk, run, run->length);
+	} else{
+		for(uint32_t i=0;i<run->length;i++)
+			query_chunk(run, i);
+	}
+}
+
+/** @brief przekazuje wynik wątkowi piszącemu, jeżeli jest co wypisać
+ * param[in] p 	- potok
+ * param[in] r 	- wynik komendy
+ */
+static void push_result(pipeline* p, pipeline_result* r){
+	if(r->kind != ResultNone)
+		spsc_push(&p->results, r);
+}
+
+/** @brief wykonuje komendy z kolejki, aż trafi na znacznik końca
+ * Kolejne zapytania zebrane z kolejki wykonuje razem przez execute_queries,
+ * a ich wyniki przekazuje w kolejności inputu.
+ * param[in] p 		- potok
+ * param[in,out] run 	- pamięć na ciąg zapytań
+ */
+static void execute_commands(pipeline* p, query_run* run){
+	pipeline_command c;
+	pipeline_result r;
+	bool pending = false;
+	spsc_pop(&p->commands, &c);
+	while(!c.end){
+		if(read_only(&c)){
+			run->commands[0] = c;
+			run->length = 1;
+			pending = collect_queries(p, run, &c);
+			execute_queries(run);
+			for(uint32_t i=0;i<run->length;i++)
+				push_result(p, &run->results[i]);
+		} else{
+			pending = false;
+			execute_command(&c, run->game, &r);
+			push_result(p, &r);
+		}
+		if(!pending)
+			spsc_pop(&p->commands, &c);
+	}
+	r.kind = ResultEnd;
+	spsc_push(&p->results, &r);
+}
+
+/** @brief przeprowadza rozgrywkę w potokowym trybie wsadowym
+ * param[in] game 	- struktura przechowująca stan gry
+ * param[in] line 	- numer przetwarzanej lini
+ *
+ * @return true jeżeli rozgrywka się odbyła, false jeżeli nie udało się
+ * uruchomić wątków - wejście nie zostało wtedy tknięte
+ */
+bool play_batch_pipelined(gamma_t* game, int* line){
+	pipeline p;
+	p.line = *line;
+	if(!spsc_init(&p.commands, PIPELINE_CAPACITY, sizeof(pipeline_command)))
+		return false;
+	if(!spsc_init(&p.results, PIPELINE_CAPACITY, sizeof(pipeline_result))){
+		spsc_destroy(&p.commands);
+		return false;
+	}
+	query_run* run = malloc(sizeof(query_run));
+	pthread_t writer, parser;
+	bool success = run != NULL && pthread_create(&writer, NULL, write_output, &p) == 0;
+	if(success && pthread_create(&parser, NULL, parse_input, &p) != 0){
+		pipeline_result end = {.kind = ResultEnd};
+		spsc_push(&p.results, &end);
+		pthread_join(writer, NULL);
+		success = false;
+	}
+	if(success){
+		run->game = game;
+		execute_commands(&p, run);
+		pthread_join(parser, NULL);
+		pthread_join(writer, NULL);
+		*line = p.line;
+	}
+	free(run);
+	spsc_destroy(&p.commands);
+	spsc_destroy(&p.results);
+	return success;
+}
@@ -0,0 +1,39 @@
+/** @file
+ * Interfejs potokowego trybu wsadowego
+ *
+ * Wątek parsera czyta i parsuje linie, wątek wywołujący wykonuje komendy
+ * na silniku, a wątek piszący formatuje odpowiedzi. Wątki przekazują sobie
+ * komendy i wyniki kolejkami spsc_ring, więc kolejność wyjścia i numery
+ * linii w komunikatach ERROR są takie same jak w play_batch. Kolejne zapytania
+ * (komendy b, f, q, p i linie niepoprawne), które zastaje w kolejce, wątek
+ * wykonujący liczy równolegle pulą wątków, bo między nimi stan gry się nie zmienia.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef BMPIPELINE_H
+#define BMPIPELINE_H
+
+#include <stdbool.h>
+#include "gamma.h"
+
+/** @brief sprawdza, czy tryb wsadowy ma działać potokowo
+ * Tryb potokowy trzeba włączyć zmienną środowiskową GAMMA_PIPELINE=1,
+ * domyślnie działa zwykły play_batch.
+ *
+ * @return true jeżeli tryb potokowy jest włączony, false wpp
+ */
+bool pipeline_requested(void);
+
+/** @brief przeprowadza rozgrywkę w potokowym trybie wsadowym
+ * param[in] game 	- struktura przechowująca stan gry
+ * param[in] line 	- numer przetwarzanej lini
+ *
+ * @return true jeżeli rozgrywka się odbyła, false jeżeli nie udało się
+ * uruchomić wątków - wejście nie zostało wtedy tknięte
+ */
+bool play_batch_pipelined(gamma_t* game, int* line);
+
+#endif
@@ -0,0 +1,364 @@
+/** @file
+ * Implementacja interfejsu bmserver.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z open_memstream() i MSG_NOSIGNAL
+ */
+#define _XOPEN_SOURCE 700
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "bmserver.h"
+#include "bmtagged.h"
+#include "logic.h"
+
+/** @brief największa liczba bajtów czytanych od klienta naraz, żeby jeden
+ * klient nie zagłodził pozostałych
+ */
+#define SERVER_READ_CHUNK 65536
+
+/** @brief liczba niewysłanych bajtów odpowiedzi, powyżej której przestajemy
+ * czytać komendy klienta
+ */
+#define SERVER_OUTPUT_LIMIT (1 << 20)
+
+/** @brief największa długość niepełnej linii klienta, po której przekroczeniu
+ * rozłączamy klienta
+ */
+#define SERVER_INPUT_LIMIT (1 << 20)
+
+/** @brief największa liczba zdarzeń odbieranych jednym epoll_wait
+ */
+#define SERVER_MAX_EVENTS 64
+
+/** @brief Struktura opisująca połączenie z klientem
+ */
+typedef struct client{
+	int fd; 			///< gniazdo połączenia
+	int line; 			///< numer ostatniej przeczytanej linii klienta
+	char* input; 			///< przeczytane bajty, które nie tworzą jeszcze pełnej linii
+	size_t input_length; 		///< liczba bajtów w input
+	size_t input_capacity; 		///< rozmiar bufora input
+	FILE* answers; 			///< strumień odpowiedzi dopisujący do output lub NULL
+	char* output; 			///< odpowiedzi, uaktualniane przez fflush(answers)
+	size_t output_length; 		///< liczba bajtów w output
+	size_t sent; 			///< liczba wysłanych już bajtów output
+	uint32_t events; 		///< zdarzenia, na które czekamy w epoll
+	bool closing; 			///< true jeżeli klient skończył pisać
+	struct client* prev; 		///< poprzedni klient na liście serwera
+	struct client* next; 		///< następny klient na liście serwera
+} client;
+
+/** @brief Struktura serwera gier
+ */
+struct game_server{
+	int listen_fd; 		///< gniazdo nasłuchujące
+	int epoll_fd; 		///< deskryptor epoll
+	int stop_fd; 		///< eventfd, którym server_stop budzi pętlę
+	char* path; 		///< ścieżka gniazda, usuwana przy zamknięciu
+	tagged_games* games; 	///< gry wspólne dla wszystkich klientów
+	client* clients; 	///< lista połączonych klientów
+};
+
+/** @brief ustawia deskryptor w tryb nieblokujący
+ * param[in] fd 	- deskryptor
+ *
+ * @return true jeżeli się udało, false wpp
+ */
+static bool set_nonblocking(int fd){
+	int flags = fcntl(fd, F_GETFL);
+	return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1 &&
+	       fcntl(fd, F_SETFD, FD_CLOEXEC) != -1;
+}
+
+/** @brief dodaje deskryptor do epoll
+ * param[in] s 		- serwer
+ * param[in] fd 	- deskryptor
+ * param[in] events 	- zdarzenia, na które czekamy
+ * param[in] ptr 	- wskaźnik zwracany razem ze zdarzeniem
+ *
+ * @return true jeżeli się udało, false wpp
+ */
+static bool watch(game_server* s, int fd, uint32_t events, void* ptr){
+	struct epoll_event ev = {.events = events, .data.ptr = ptr};
+	return epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+/** @brief rozłącza klienta i zwalnia jego pamięć
+ * param[in,out] s 	- serwer
+ * param[in] c 		- klient
+ */
+static void drop_client(game_server* s, client* c){
+	if(c->prev != NULL)
+		c->prev->next = c->next;
+	else
+		s->clients = c->next;
+	if(c->next != NULL)
+		c->next->prev = c->prev;
+	close(c->fd);
+	if(c->answers != NULL)
+		fclose(c->answers);
+	free(c->output);
+	free(c->input);
+	free(c);
+}
+
+/** @brief przyjmuje oczekujące połączenia
+ * param[in,out] s 	- serwer
+ */
+static void accept_clients(game_server* s){
+	int fd;
+	while((fd = accept(s->listen_fd, NULL, NULL)) != -1){
+		client* c = calloc(1, sizeof(client));
+		if(c == NULL || !set_nonblocking(fd) || !watch(s, fd, EPOLLIN, c)){
+			free(c);
+			close(fd);
+			continue;
+		}
+		c->fd = fd;
+		c->events = EPOLLIN;
+		c->next = s->clients;
+		if(s->clients != NULL)
+			s->clients->prev = c;
+		s->clients = c;
+	}
+}
+
+/** @brief ustawia zdarzenia klienta według stanu jego buforów
+ * Nie czytamy komend klienta, który nie odbiera odpowiedzi.
+ * param[in] s 	- serwer
+ * param[in,out] c 	- klient
+ *
+ * @return true jeżeli się udało, false wpp
+ */
+static bool update_events(game_server* s, client* c){
+	size_t pending = c->output_length-c->sent;
+	uint32_t events = 0;
+	if(!c->closing && pending <= SERVER_OUTPUT_LIMIT)
+		events |= EPOLLIN;
+	if(pending > 0)
+		events |= EPOLLOUT;
+	if(events == c->events)
+		return true;
+	struct epoll_event ev = {.events = events, .data.ptr = c};
+	c->events = events;
+	return epoll_ctl(s->epoll_fd, EPOLL_CTL_MOD, c->fd, &ev) == 0;
+}
+
+/** @brief wysyła klientowi tyle odpowiedzi, ile przyjmie gniazdo
+ * Gdy wszystko wysłaliśmy, zwalnia bufor odpowiedzi.
+ * param[in,out] c 	- klient
+ *
+ * @return true jeżeli połączenie działa, false wpp
+ */
+static bool send_answers(client* c){
+	while(c->sent < c->output_length){
+		ssize_t n = send(c->fd, c->output+c->sent, c->output_length-c->sent, MSG_NOSIGNAL);
+		if(n < 0 && errno == EINTR)
+			continue;
+		if(n < 0)
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		c->sent += n;
+	}
+	if(c->answers != NULL){
+		fclose(c->answers);
+		free(c->output);
+		c->answers = NULL;
+		c->output = NULL;
+		c->output_length = 0;
+		c->sent = 0;
+	}
+	return true;
+}
+
+/** @brief wykonuje pełne linie z bufora klienta i zostawia w nim niepełną resztę
+ * param[in,out] s 	- serwer
+ * param[in,out] c 	- klient, bufor input ma miejsce na bajt za danymi
+ */
+static void execute_lines(game_server* s, client* c){
+	size_t start = 0;
+	char* end;
+	while((end = memchr(c->input+start, '\n', c->input_length-start)) != NULL){
+		size_t next = end-c->input+1;
+		char saved = c->input[next];
+		c->input[next] = '\0';
+		c->line++;
+		if(!ignore_line(c->input+start))
+			execute_tagged_line(s->games, c->input+start, c->line, c->answers, c->answers);
+		c->input[next] = saved;
+		start = next;
+	}
+	memmove(c->input, c->input+start, c->input_length-start);
+	c->input_length -= start;
+}
+
+/** @brief wykonuje niepełną linię, którą klient zostawił przed zamknięciem połączenia
+ * Tak jak w trybie wsadowym na standardowym wejściu, ostatnia linia bez znaku
+ * nowej linii też jest wykonywana.
+ * param[in,out] s 	- serwer
+ * param[in,out] c 	- klient, bufor input ma miejsce na bajt za danymi
+ */
+static void execute_rest(game_server* s, client* c){
+	if(c->input_length == 0)
+		return;
+	c->input[c->input_length] = '\0';
+	c->line++;
+	if(!ignore_line(c->input))
+		execute_tagged_line(s->games, c->input, c->line, c->answers, c->answers);
+	c->input_length = 0;
+}
+
+/** @brief czyta komendy klienta, wykonuje je i wysyła odpowiedzi
+ * param[in,out] s 	- serwer
+ * param[in,out] c 	- klient
+ *
+ * @return true jeżeli połączenie działa, false wpp, również gdy niepełna linia
+ * klienta przekroczyła SERVER_INPUT_LIMIT
+ */
+static bool read_commands(game_server* s, client* c){
+	if(c->input_capacity < c->input_length+SERVER_READ_CHUNK+1){
+		size_t capacity = c->input_length+SERVER_READ_CHUNK+1;
+		char* input = realloc(c->input, capacity);
+		if(input == NULL)
+			return false;
+		c->input = input;
+		c->input_capacity = capacity;
+	}
+	ssize_t n = read(c->fd, c->input+c->input_length, SERVER_READ_CHUNK);
+	if(n < 0)
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+	if(c->answers == NULL){
+		c->answers = open_memstream(&c->output, &c->output_length);
+		if(c->answers == NULL)
+			return false;
+	}
+	if(n == 0){
+		c->closing = true;
+		execute_rest(s, c);
+	} else{
+		c->input_length += n;
+		execute_lines(s, c);
+	}
+	return c->input_length <= SERVER_INPUT_LIMIT && fflush(c->answers) == 0;
+}
+
+/** @brief obsługuje zdarzenie połączenia z klientem
+ * param[in,out] s 	- serwer
+ * param[in,out] c 	- klient
+ * param[in] events 	- zdarzenia zgłoszone przez epoll
+ */
+static void serve_client(game_server* s, client* c, uint32_t events){
+	bool alive = (events & EPOLLERR) == 0;
+	if(alive && (events & EPOLLIN))
+		alive = read_commands(s, c);
+	else if(alive && (events & EPOLLHUP))
+		c->closing = true;
+	alive = alive && send_answers(c) && update_events(s, c);
+	if(!alive || (c->closing && c->sent == c->output_length))
+		drop_client(s, c);
+}
+
+/** @brief tworzy serwer nasłuchujący na gnieździe uniksowym
+ * param[in] path 	- ścieżka gniazda
+ *
+ * @return serwer lub NULL jeżeli nie udało się utworzyć gniazda lub zabrakło pamięci
+ */
+game_server* server_open(const char* path){
+	struct sockaddr_un address = {.sun_family = AF_UNIX};
+	if(strlen(path) >= sizeof(address.sun_path))
+		return NULL;
+	strcpy(address.sun_path, path);
+	game_server* s = calloc(1, sizeof(game_server));
+	if(s == NULL)
+		return NULL;
+	char* copy = malloc(strlen(path)+1);
+	s->games = tagged_games_new();
+	s->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	s->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	s->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	struct stat st;
+	if(lstat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+		unlink(path);
+	bool flague = copy != NULL && s->games != NULL && s->listen_fd != -1 &&
+		      s->epoll_fd != -1 && s->stop_fd != -1 && set_nonblocking(s->listen_fd) &&
+		      bind(s->listen_fd, (struct sockaddr*)&address, sizeof(address)) == 0;
+	if(flague){
+		strcpy(copy, path);
+		s->path = copy;
+	} else{
+		free(copy);
+	}
+	flague = flague && listen(s->listen_fd, SOMAXCONN) == 0 &&
+		 watch(s, s->listen_fd, EPOLLIN, &s->listen_fd) &&
+		 watch(s, s->stop_fd, EPOLLIN, &s->stop_fd);
+	if(!flague){
+		server_close(s);
+		return NULL;
+	}
+	return s;
+}
+
+/** @brief obsługuje klientów, aż ktoś wywoła server_stop
+ * param[in,out] s 	- serwer
+ *
+ * @return true jeżeli serwer zatrzymano, false po błędzie epoll
+ */
+bool server_run(game_server* s){
+	struct epoll_event events[SERVER_MAX_EVENTS];
+	while(true){
+		int n = epoll_wait(s->epoll_fd, events, SERVER_MAX_EVENTS, -1);
+		if(n < 0 && errno != EINTR)
+			return false;
+		for(int i=0;i<n;i++){
+			if(events[i].data.ptr == &s->stop_fd)
+				return true;
+			else if(events[i].data.ptr == &s->listen_fd)
+				accept_clients(s);
+			else
+				serve_client(s, events[i].data.ptr, events[i].events);
+		}
+	}
+}
+
+/** @brief prosi serwer o zakończenie server_run
+ * param[in] s 	- serwer
+ */
+void server_stop(game_server* s){
+	uint64_t one = 1;
+	ssize_t written = write(s->stop_fd, &one, sizeof(one));
+	(void)written;
+}
+
+/** @brief zamyka połączenia, usuwa gry i gniazdo serwera
+ * param[in] s 	- serwer lub NULL
+ */
+void server_close(game_server* s){
+	if(s == NULL)
+		return;
+	while(s->clients != NULL)
+		drop_client(s, s->clients);
+	if(s->listen_fd != -1)
+		close(s->listen_fd);
+	if(s->epoll_fd != -1)
+		close(s->epoll_fd);
+	if(s->stop_fd != -1)
+		close(s->stop_fd);
+	if(s->path != NULL)
+		unlink(s->path);
+	tagged_games_delete(s->games);
+	free(s->path);
+	free(s);
+}
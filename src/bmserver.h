@@ -0,0 +1,52 @@
+/** @file
+ * Interfejs serwera gier na gnieździe uniksowym
+ *
+ * Serwer przechowuje jeden zbiór gier trybu z identyfikatorami (bmtagged.h),
+ * wspólny dla wszystkich klientów, więc np. sędzia i boty mogą grać w tę
+ * samą grę z osobnych połączeń. Klient wysyła linie trybu T bez linii T,
+ * a serwer odpowiada tak jak ten tryb, również komunikatami ERROR, które
+ * trafiają do tego samego połączenia i niosą numer linii klienta.
+ * Odpowiedzi na linie przeczytane jednym odczytem wysyłamy razem.
+ * Gry żyją do komendy D lub zamknięcia serwera, a nie połączenia.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef BMSERVER_H
+#define BMSERVER_H
+
+#include <stdbool.h>
+
+/** @brief Struktura serwera gier
+ */
+typedef struct game_server game_server;
+
+/** @brief tworzy serwer nasłuchujący na gnieździe uniksowym
+ * Istniejące gniazdo o tej ścieżce zastępuje, innego pliku nie rusza.
+ * param[in] path 	- ścieżka gniazda
+ *
+ * @return serwer lub NULL jeżeli nie udało się utworzyć gniazda lub zabrakło pamięci
+ */
+game_server* server_open(const char* path);
+
+/** @brief obsługuje klientów, aż ktoś wywoła server_stop
+ * param[in,out] s 	- serwer
+ *
+ * @return true jeżeli serwer zatrzymano, false po błędzie epoll
+ */
+bool server_run(game_server* s);
+
+/** @brief prosi serwer o zakończenie server_run
+ * Można ją wywołać z innego wątku lub z funkcji obsługi sygnału.
+ * param[in] s 	- serwer
+ */
+void server_stop(game_server* s);
+
+/** @brief zamyka połączenia, usuwa gry i gniazdo serwera
+ * param[in] s 	- serwer lub NULL
+ */
+void server_close(game_server* s);
+
+#endif
@@ -0,0 +1,203 @@
+/** @file
+ * Implementacja interfejsu bmtagged.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z getline()
+ */
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bmparser.h"
+#include "bmexecuter.h"
+#include "bmtagged.h"
+#include "gametable.h"
+#include "logic.h"
+
+/** @brief Struktura przechowująca gry trybu z identyfikatorami
+ */
+struct tagged_games{
+	game_table games; 	///< gry według identyfikatorów
+	gamma_pool_t* pool; 	///< pula, w której leżą gry
+};
+
+/** @brief wypisuje komunikat ERROR line do strumienia błędów
+ * param[in] errors 	- strumień komunikatów o błędach
+ * param[in] line 	- numer przetwarzanej lini
+ */
+static void tagged_error(FILE* errors, int line){
+	fprintf(errors, "ERROR %d\n", line);
+}
+
+/** @brief wypisuje planszę, poprzedzając każdą jej linię identyfikatorem gry
+ * param[in] out 	- strumień odpowiedzi
+ * param[in] id 	- identyfikator gry
+ * param[in] board 	- napis opisujący planszę
+ */
+static void print_tagged_board(FILE* out, uint32_t id, const char* board){
+	while(*board != '\0'){
+		const char* end = strchr(board, '\n');
+		size_t length = end != NULL? (size_t)(end-board)+1 : strlen(board);
+		fprintf(out, "%u ", id);
+		fwrite(board, 1, length, out);
+		board += length;
+	}
+}
+
+/** @brief tworzy grę o identyfikatorze id na podstawie komendy B
+ * param[in,out] t 	- gry trybu
+ * param[in] id 	- identyfikator gry
+ * param[in] command 	- linia komendy bez identyfikatora
+ * param[in] line 	- numer przetwarzanej lini
+ * param[in] out 	- strumień odpowiedzi
+ * param[in] errors 	- strumień komunikatów o błędach
+ */
+static void create_game(tagged_games* t, uint32_t id, char* command, int line,
+			FILE* out, FILE* errors){
+	mode_selection_command* com = parse_mode_selection(command);
+	gamma_t* g = NULL;
+	if(com != NULL && com->mode == 'B' && valid_nums(com->nums, 4) &&
+	   game_table_get(&t->games, id) == NULL)
+		g = gamma_pool_game(t->pool, com->nums[0], com->nums[1], com->nums[2], com->nums[3]);
+	if(g != NULL && game_table_put(&t->games, id, g)){
+		fprintf(out, "%u OK\n", id);
+	} else{
+		gamma_delete(g);
+		tagged_error(errors, line);
+	}
+	free(com);
+}
+
+/** @brief wykonuje komendę trybu wsadowego na grze g
+ * param[in] g 		- gra, której dotyczy komenda
+ * param[in] id 	- identyfikator gry
+ * param[in] command 	- linia komendy bez identyfikatora
+ * param[in] line 	- numer przetwarzanej lini
+ * param[in] out 	- strumień odpowiedzi
+ * param[in] errors 	- strumień komunikatów o błędach
+ */
+static void execute_game_command(gamma_t* g, uint32_t id, char* command, int line,
+				 FILE* out, FILE* errors){
+	enum command_type type = parse_command_type(command);
+	bool flague = false;
+	if(type == Move || type == Golden){
+		move_command* com = parse_move_command(command);
+		flague = com != NULL && valid_nums(com->nums, 3);
+		if(flague && type == Move)
+			fprintf(out, "%u %d\n", id, gamma_move(g, com->nums[0], com->nums[1], com->nums[2]));
+		else if(flague)
+			fprintf(out, "%u %d\n", id, gamma_golden_move(g, com->nums[0], com->nums[1], com->nums[2]));
+		free(com);
+	} else if(type == Busy || type == Free || type == GoldenPossible){
+		player_info_command* com = parse_player_info_command(command);
+		flague = com != NULL && valid_nums(&com->player, 1);
+		if(flague && type == Busy)
+			fprintf(out, "%u %lu\n", id, gamma_busy_fields(g, com->player));
+		else if(flague && type == Free)
+			fprintf(out, "%u %lu\n", id, gamma_free_fields(g, com->player));
+		else if(flague)
+			fprintf(out, "%u %d\n", id, gamma_golden_possible(g, com->player));
+		free(com);
+	} else if(type == Print){
+		print_command* com = parse_print_command(command);
+		flague = com != NULL;
+		char* board = flague? gamma_board(g) : NULL;
+		if(board != NULL)
+			print_tagged_board(out, id, board);
+		free(board);
+		free(com);
+	} else if(type == BulkMove){
+		bulk_move_command* com = parse_bulk_move_command(command);
+		char* results = bulk_move_results(com, g);
+		flague = results != NULL;
+		if(flague){
+			fprintf(out, "%u ", id);
+			fwrite(results, 1, com->n+1, out);
+		}
+		free(results);
+		free(com);
+	}
+	if(!flague)
+		tagged_error(errors, line);
+}
+
+/** @brief tworzy pusty zbiór gier trybu z identyfikatorami
+ *
+ * @return zbiór gier lub NULL jeżeli zabrakło pamięci
+ */
+tagged_games* tagged_games_new(void){
+	tagged_games* t = malloc(sizeof(tagged_games));
+	if(t == NULL)
+		return NULL;
+	game_table_init(&t->games);
+	t->pool = gamma_pool_new(NULL);
+	if(t->pool == NULL){
+		free(t);
+		return NULL;
+	}
+	return t;
+}
+
+/** @brief usuwa wszystkie gry zbioru i zwalnia jego pamięć
+ * param[in] t 	- zbiór gier lub NULL
+ */
+void tagged_games_delete(tagged_games* t){
+	if(t == NULL)
+		return;
+	game_table_free(&t->games);
+	gamma_pool_delete(t->pool);
+	free(t);
+}
+
+/** @brief wykonuje linię trybu z identyfikatorami gier
+ * param[in,out] t 	- zbiór gier
+ * param[in] buffer 	- linia inputu zakończona znakiem nowej linii
+ * param[in] line 	- numer przetwarzanej lini
+ * param[in] out 	- strumień odpowiedzi
+ * param[in] errors 	- strumień komunikatów o błędach
+ */
+void execute_tagged_line(tagged_games* t, char* buffer, int line, FILE* out, FILE* errors){
+	long long int id;
+	char* command = parse_game_tag(buffer, &id);
+	if(command == NULL || !valid_nums(&id, 1)){
+		tagged_error(errors, line);
+	} else if(command[0] == 'B'){
+		create_game(t, id, command, line, out, errors);
+	} else if(parse_delete_command(command)){
+		gamma_t* g = game_table_remove(&t->games, id);
+		if(g != NULL){
+			gamma_delete(g);
+			fprintf(out, "%u OK\n", (uint32_t)id);
+		} else{
+			tagged_error(errors, line);
+		}
+	} else{
+		gamma_t* g = game_table_get(&t->games, id);
+		if(g != NULL)
+			execute_game_command(g, id, command, line, out, errors);
+		else
+			tagged_error(errors, line);
+	}
+}
+
+/** @brief przeprowadza rozgrywki w trybie wsadowym wielu gier
+ * param[in] line 	- numer przetwarzanej lini
+ */
+void play_tagged(int* line){
+	tagged_games* t = tagged_games_new();
+	if(t == NULL)
+		fail("NO MEMORY FOR GAME POOL");
+	char* buffer = NULL;
+	size_t buffsize = 0;
+	while(getline(&buffer, &buffsize, stdin) != -1){
+		(*line)++;
+		if(!ignore_line(buffer))
+			execute_tagged_line(t, buffer, *line, stdout, stderr);
+	}
+	free(buffer);
+	tagged_games_delete(t);
+}
@@ -0,0 +1,54 @@
+/** @file
+ * Interfejs trybu wsadowego wielu gier o identyfikatorach
+ *
+ * Tryb wybiera linia T. Każda kolejna linia zaczyna się identyfikatorem gry
+ * z zakresu [0, UINT32_MAX] i jednym białym znakiem, po którym następuje
+ * komenda: B width height players areas tworzy grę o tym identyfikatorze,
+ * D ją usuwa, a pozostałe komendy działają jak w trybie wsadowym na grze
+ * o tym identyfikatorze. Każda linia odpowiedzi zaczyna się identyfikatorem
+ * gry i spacją; utworzenie i usunięcie gry potwierdza odpowiedź OK. Błędy,
+ * również komendy dla nieistniejącej gry lub powtórzone utworzenie gry,
+ * zgłasza ERROR z numerem linii. Gry leżą w jednej puli gier, więc pamięć
+ * usuniętych gier służy kolejnym.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef BMTAGGED_H
+#define BMTAGGED_H
+
+#include <stdio.h>
+
+/** @brief Struktura przechowująca gry trybu z identyfikatorami
+ */
+typedef struct tagged_games tagged_games;
+
+/** @brief tworzy pusty zbiór gier trybu z identyfikatorami
+ *
+ * @return zbiór gier lub NULL jeżeli zabrakło pamięci
+ */
+tagged_games* tagged_games_new(void);
+
+/** @brief usuwa wszystkie gry zbioru i zwalnia jego pamięć
+ * param[in] t 	- zbiór gier lub NULL
+ */
+void tagged_games_delete(tagged_games* t);
+
+/** @brief wykonuje linię trybu z identyfikatorami gier
+ * param[in,out] t 	- zbiór gier
+ * param[in] buffer 	- linia inputu zakończona znakiem nowej linii
+ * param[in] line 	- numer przetwarzanej lini
+ * param[in] out 	- strumień odpowiedzi
+ * param[in] errors 	- strumień komunikatów o błędach
+ */
+void execute_tagged_line(tagged_games* t, char* buffer, int line, FILE* out, FILE* errors);
+
+/** @brief przeprowadza rozgrywki w trybie wsadowym wielu gier
+ * Na końcu inputu usuwa wszystkie gry, które nie zostały usunięte komendą D.
+ * param[in] line 	- numer przetwarzanej lini
+ */
+void play_tagged(int* line);
+
+#endif
@@ -0,0 +1,616 @@
+/** @file
+ * Implementacja interfejsu board.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "board.h"
+#include "alloc.h"
+#include "hugepage.h"
+
+/** @brief największa liczba kafelków planszy, dla której katalog jest tablicą
+ */
+#define DENSE_DIRECTORY_MAX_TILES (1 << 18)
+
+/** @brief początkowy rozmiar katalogu haszującego i tablicy kafelków
+ */
+#define BOARD_INITIAL_CAPACITY 64
+
+/** @brief liczba kafelków mieszczących się na jednej dużej stronie
+ */
+#define TILES_PER_HUGE_PAGE (HUGE_PAGE_SIZE/sizeof(tile))
+
+/** @brief największa długość słownika kafelka przeszukiwanego liniowo przy pakowaniu planszy
+ */
+#define SMALL_DICTIONARY 16
+
+/** @brief rozsuwa bity współrzędnej wewnątrz kafelka na parzyste pozycje
+ * param[in] v 	- współrzędna, liczba mniejsza od TILE_SIDE
+ *
+ * @return v z bitem i przeniesionym na pozycję 2i
+ */
+static uint16_t spread_bits(uint32_t v){
+	uint16_t spread = 0;
+	for(uint32_t i=0;i<TILE_SHIFT;i++)
+		spread |= ((v >> i) & 1) << (2*i);
+	return spread;
+}
+
+/** @brief wypełnia tablice składników indeksu pola dla zadanego układu
+ * param[in,out] b 	- inicjowana plansza z ustawionym polem layout
+ */
+static void init_offsets(tiled_board* b){
+	for(uint32_t v=0;v<TILE_SIDE;v++){
+		if(b->layout == BOARD_LAYOUT_MORTON){
+			b->offset_x[v] = spread_bits(v);
+			b->offset_y[v] = spread_bits(v) << 1;
+		}
+		else{
+			b->offset_x[v] = v;
+			b->offset_y[v] = v << TILE_SHIFT;
+		}
+	}
+}
+
+/** @brief wspólny kafelek samych pustych pól, tylko do odczytu
+ */
+const tile board_empty_tile;
+
+/** @brief ustawia wymiary planszy i liczby kafelków
+ * param[in,out] b 	- modyfikowana plansza
+ * param[in] width 	- szerokość planszy
+ * param[in] height 	- wysokość planszy
+ */
+static void set_geometry(tiled_board* b, uint32_t width, uint32_t height){
+	b->width = width;
+	b->height = height;
+	b->tiles_x = ((uint64_t)width+TILE_MASK) >> TILE_SHIFT;
+	b->tiles_y = ((uint64_t)height+TILE_MASK) >> TILE_SHIFT;
+	b->dense_shift = 0;
+	while(((uint64_t)1 << b->dense_shift) < b->tiles_x)
+		b->dense_shift++;
+}
+
+/** @brief zwraca liczbę pozycji katalogu tablicowego planszy
+ * param[in] b 	- plansza
+ *
+ * @return liczba pozycji, katalog jest tablicowy jeżeli nie przekracza DENSE_DIRECTORY_MAX_TILES
+ */
+static uint64_t dense_entries(const tiled_board* b){
+	return (uint64_t)b->tiles_y << b->dense_shift;
+}
+
+/** @brief zwalnia katalog kafelków planszy
+ * param[in,out] b 	- plansza
+ */
+static void free_directory(tiled_board* b){
+	if(b->dense != NULL)
+		allocator_free(&b->alloc, b->dense, dense_entries(b)*sizeof(uintptr_t));
+	allocator_free(&b->alloc, b->hash_keys, b->hash_capacity*sizeof(uint64_t));
+	allocator_free(&b->alloc, b->hash_tiles, b->hash_capacity*sizeof(tile*));
+	b->dense = NULL;
+	b->hash_keys = NULL;
+	b->hash_tiles = NULL;
+	b->hash_capacity = 0;
+}
+
+/** @brief tworzy pusty katalog kafelków dla wymiarów planszy
+ * param[in,out] b 	- plansza z ustawionymi wymiarami
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool init_directory(tiled_board* b){
+	b->dense = NULL;
+	b->hash_keys = NULL;
+	b->hash_tiles = NULL;
+	b->hash_capacity = 0;
+	uint64_t no_entries = dense_entries(b);
+	if(no_entries <= DENSE_DIRECTORY_MAX_TILES){
+		b->dense = allocator_alloc(&b->alloc, no_entries*sizeof(uintptr_t));
+		if(b->dense != NULL && b->huge_pages)
+			huge_advise(b->dense, no_entries*sizeof(uintptr_t));
+		return b->dense != NULL;
+	}
+	b->hash_capacity = BOARD_INITIAL_CAPACITY;
+	b->hash_keys = allocator_alloc(&b->alloc, b->hash_capacity*sizeof(uint64_t));
+	b->hash_tiles = allocator_alloc(&b->alloc, b->hash_capacity*sizeof(tile*));
+	if(b->hash_keys == NULL || b->hash_tiles == NULL){
+		free_directory(b);
+		return false;
+	}
+	return true;
+}
+
+/** @brief inicjuje pustą planszę
+ * param[in,out] b 	- inicjowana plansza
+ * param[in] width 	- szerokość planszy
+ * param[in] height 	- wysokość planszy
+ * param[in] layout 	- układ pól wewnątrz kafelków
+ * param[in] alloc 	- alokator katalogu kafelków
+ * param[in] tile_alloc - alokator kafelków
+ * param[in] huge_pages - true jeżeli kafelki mają leżeć na dużych stronach,
+ * 			  a katalog być oznaczony MADV_HUGEPAGE
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+bool board_init(tiled_board* b, uint32_t width, uint32_t height, board_layout layout,
+		const allocator* alloc, const allocator* tile_alloc, bool huge_pages){
+	b->alloc = *alloc;
+	b->tile_alloc = *tile_alloc;
+	b->huge_pages = huge_pages;
+	b->layout = layout;
+	init_offsets(b);
+	set_geometry(b, width, height);
+	b->tiles = NULL;
+	b->no_tiles = 0;
+	b->no_cleared_tiles = 0;
+	b->tiles_capacity = 0;
+	return init_directory(b);
+}
+
+/** @brief zwalnia pamięć zajmowaną przez planszę
+ * param[in,out] b 	- zwalniana plansza
+ */
+void board_free(tiled_board* b){
+	uint64_t no_tiles = b->no_tiles+b->no_cleared_tiles;
+	if(b->huge_pages){
+		for(uint64_t i=0;i<no_tiles;i+=TILES_PER_HUGE_PAGE)
+			huge_free(b->tiles[i], HUGE_PAGE_SIZE);
+	}
+	else if(b->tile_alloc.free != NULL){
+		for(uint64_t i=0;i<no_tiles;i++)
+			allocator_free(&b->tile_alloc, b->tiles[i], sizeof(tile));
+	}
+	allocator_free(&b->alloc, b->tiles, b->tiles_capacity*sizeof(tile*));
+	free_directory(b);
+	b->tiles = NULL;
+	b->no_tiles = 0;
+	b->no_cleared_tiles = 0;
+	b->tiles_capacity = 0;
+}
+
+/** @brief zeruje pola kafelka leżące na planszy
+ * W układzie wierszowym zeruje wiersze części kafelka na planszy, w układzie
+ * Mortona indeks pola rośnie z każdą współrzędną, więc zeruje początek tablicy
+ * pól aż do ostatniego pola na planszy.
+ * param[in] b 	- plansza, do której należy kafelek
+ * param[in,out] t 	- zerowany kafelek
+ */
+static void clear_tile(const tiled_board* b, tile* t){
+	uint32_t width = board_tile_width(b, t);
+	uint32_t height = board_tile_height(b, t);
+	if(b->layout == BOARD_LAYOUT_ROWS){
+		for(uint32_t dy=0;dy<height;dy++)
+			memset(&t->fields[board_field_index(b, 0, dy)], 0, width*sizeof(field));
+	}
+	else
+		memset(t->fields, 0, (board_field_index(b, width-1, height-1)+1)*sizeof(field));
+}
+
+/** @brief czyści planszę i zmienia jej wymiary, zachowując zaalokowane kafelki
+ * Zeruje tylko kafelki zajęte w poprzedniej grze i odkłada je do ponownego
+ * użycia przez board_alloc_tile. Katalog kafelków przydziela od nowa tylko
+ * wtedy, gdy zmienia się jego rozmiar.
+ * param[in,out] b 	- czyszczona plansza
+ * param[in] width 	- nowa szerokość planszy
+ * param[in] height 	- nowa wysokość planszy
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci - plansza się wtedy nie zmienia
+ */
+bool board_reset(tiled_board* b, uint32_t width, uint32_t height){
+	tiled_board old = *b;
+	set_geometry(b, width, height);
+	bool same_directory = old.dense != NULL?
+			      dense_entries(b) == dense_entries(&old) :
+			      dense_entries(b) > DENSE_DIRECTORY_MAX_TILES;
+	if(!same_directory && !init_directory(b)){
+		*b = old;
+		return false;
+	}
+	for(uint64_t i=0;i<old.no_tiles;i++){
+		tile* t = old.tiles[i];
+		clear_tile(&old, t);
+		if(same_directory && old.dense != NULL)
+			old.dense[((uint64_t)t->tile_y << old.dense_shift) | t->tile_x] = 0;
+	}
+	if(same_directory && old.dense == NULL)
+		memset(b->hash_keys, 0, b->hash_capacity*sizeof(uint64_t));
+	if(!same_directory)
+		free_directory(&old);
+	b->no_cleared_tiles += b->no_tiles;
+	b->no_tiles = 0;
+	return true;
+}
+
+/** @brief zwraca rozmiar tablicy tiles lub katalogu haszującego po kolejnych podwojeniach
+ * param[in] needed 	- najmniejszy wymagany rozmiar
+ *
+ * @return najmniejsza potęga dwójki niemniejsza od needed i od BOARD_INITIAL_CAPACITY
+ */
+static uint64_t grown_capacity(uint64_t needed){
+	uint64_t capacity = BOARD_INITIAL_CAPACITY;
+	while(capacity < needed)
+		capacity *= 2;
+	return capacity;
+}
+
+/** @brief zwraca pamięć zajmowaną przez planszę
+ * param[in] b 		- plansza
+ * param[out] tiles 	- liczba bajtów kafelków, również wyzerowanych przez board_reset
+ * param[out] directory - liczba bajtów katalogu kafelków i tablicy tiles
+ */
+void board_memory(const tiled_board* b, uint64_t* tiles, uint64_t* directory){
+	uint64_t no_tiles = b->no_tiles+b->no_cleared_tiles;
+	if(b->huge_pages)
+		*tiles = (no_tiles+TILES_PER_HUGE_PAGE-1)/TILES_PER_HUGE_PAGE*HUGE_PAGE_SIZE;
+	else
+		*tiles = no_tiles*sizeof(tile);
+	*directory = b->tiles_capacity*sizeof(tile*)+
+		     b->hash_capacity*(sizeof(uint64_t)+sizeof(tile*));
+	if(b->dense != NULL)
+		*directory += dense_entries(b)*sizeof(uintptr_t);
+}
+
+/** @brief szacuje z góry pamięć planszy, na której zajęto wszystkie pola
+ * param[in] width 	- szerokość planszy
+ * param[in] height 	- wysokość planszy
+ * param[out] tiles 	- liczba bajtów kafelków
+ * param[out] directory - liczba bajtów katalogu kafelków i tablicy tiles
+ */
+void board_estimate_memory(uint32_t width, uint32_t height,
+			   uint64_t* tiles, uint64_t* directory){
+	tiled_board b;
+	set_geometry(&b, width, height);
+	uint64_t no_tiles = (uint64_t)b.tiles_x*b.tiles_y;
+	*tiles = no_tiles*sizeof(tile);
+	*directory = grown_capacity(no_tiles)*sizeof(tile*);
+	if(dense_entries(&b) <= DENSE_DIRECTORY_MAX_TILES)
+		*directory += dense_entries(&b)*sizeof(uintptr_t);
+	else
+		*directory += grown_capacity(2*no_tiles)*(sizeof(uint64_t)+sizeof(tile*));
+}
+
+/** @brief wpisuje kafelek do katalogu haszującego, zakłada że jest w nim wolne miejsce
+ * param[in,out] keys 		- numery kafelków katalogu
+ * param[in,out] tiles 		- kafelki katalogu
+ * param[in] capacity 		- rozmiar katalogu
+ * param[in] t 			- wpisywany kafelek
+ * param[in] tiles_x 		- liczba kolumn kafelków planszy
+ */
+static void hash_insert(uint64_t* keys, tile** tiles, uint64_t capacity,
+			tile* t, uint32_t tiles_x){
+	uint64_t key = (uint64_t)t->tile_y*tiles_x+t->tile_x;
+	uint64_t mask = capacity-1;
+	uint64_t i = board_hash(key) & mask;
+	while(keys[i] != 0)
+		i = (i+1) & mask;
+	keys[i] = key+1;
+	tiles[i] = t;
+}
+
+/** @brief zapewnia miejsce na kolejny kafelek w tablicy tiles i katalogu haszującym
+ * param[in,out] b 	- modyfikowana plansza
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool reserve_tile(tiled_board* b){
+	if(b->no_tiles == b->tiles_capacity){
+		uint64_t capacity = grown_capacity(b->tiles_capacity+1);
+		tile** tiles = allocator_realloc(&b->alloc, b->tiles,
+						 b->tiles_capacity*sizeof(tile*),
+						 capacity*sizeof(tile*));
+		if(tiles == NULL)
+			return false;
+		b->tiles = tiles;
+		b->tiles_capacity = capacity;
+	}
+	if(b->dense == NULL && 2*(b->no_tiles+1) > b->hash_capacity){
+		uint64_t capacity = 2*b->hash_capacity;
+		uint64_t* keys = allocator_alloc(&b->alloc, capacity*sizeof(uint64_t));
+		tile** tiles = allocator_alloc(&b->alloc, capacity*sizeof(tile*));
+		if(keys == NULL || tiles == NULL){
+			allocator_free(&b->alloc, keys, capacity*sizeof(uint64_t));
+			allocator_free(&b->alloc, tiles, capacity*sizeof(tile*));
+			return false;
+		}
+		if(b->huge_pages){
+			huge_advise(keys, capacity*sizeof(uint64_t));
+			huge_advise(tiles, capacity*sizeof(tile*));
+		}
+		for(uint64_t i=0;i<b->no_tiles;i++)
+			hash_insert(keys, tiles, capacity, b->tiles[i], b->tiles_x);
+		allocator_free(&b->alloc, b->hash_keys, b->hash_capacity*sizeof(uint64_t));
+		allocator_free(&b->alloc, b->hash_tiles, b->hash_capacity*sizeof(tile*));
+		b->hash_keys = keys;
+		b->hash_tiles = tiles;
+		b->hash_capacity = capacity;
+	}
+	return true;
+}
+
+/** @brief wpisuje istniejący kafelek do tablicy tiles i katalogu
+ * param[in,out] b 	- modyfikowana plansza
+ * param[in] t 		- kafelek z ustawionymi tile_x i tile_y, którego nie ma jeszcze na planszy
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+bool board_insert_tile(tiled_board* b, tile* t){
+	if(!reserve_tile(b))
+		return false;
+	b->tiles[b->no_tiles++] = t;
+	if(b->dense != NULL)
+		b->dense[((uint64_t)t->tile_y << b->dense_shift) | t->tile_x] =
+			(uintptr_t)t-(uintptr_t)&board_empty_tile;
+	else
+		hash_insert(b->hash_keys, b->hash_tiles, b->hash_capacity, t, b->tiles_x);
+	return true;
+}
+
+/** @brief zwraca kafelek zawierający pole (x, y), alokuje go jeżeli nie istnieje
+ * param[in,out] b 	- modyfikowana plansza
+ * param[in] x 		- odcięta pola
+ * param[in] y 		- rzędna pola
+ *
+ * @return wskaźnik na kafelek lub NULL, jeżeli zabrakło pamięci
+ */
+tile* board_alloc_tile(tiled_board* b, uint32_t x, uint32_t y){
+	uint32_t tile_x = x >> TILE_SHIFT;
+	uint32_t tile_y = y >> TILE_SHIFT;
+	tile* t = board_find_tile(b, tile_x, tile_y);
+	if(t != NULL)
+		return t;
+	if(!reserve_tile(b))
+		return NULL;
+	if(b->no_cleared_tiles > 0){
+		t = b->tiles[b->no_tiles];
+		b->no_cleared_tiles--;
+	}
+	else if(b->huge_pages && b->no_tiles % TILES_PER_HUGE_PAGE != 0)
+		t = b->tiles[b->no_tiles-1]+1;
+	else if(b->huge_pages)
+		t = huge_alloc(HUGE_PAGE_SIZE);
+	else
+		t = allocator_alloc(&b->tile_alloc, sizeof(tile));
+	if(t == NULL)
+		return NULL;
+	t->tile_x = tile_x;
+	t->tile_y = tile_y;
+	board_insert_tile(b, t);
+	return t;
+}
+
+/** @brief dopisuje liczbę zapisaną po 7 bitów na bajt, starszy bit oznacza kolejny bajt
+ * param[out] out 	- bufor lub NULL, jeżeli tylko liczymy długość
+ * param[in] pos 	- położenie liczby w buforze
+ * param[in] v 		- zapisywana liczba
+ *
+ * @return położenie pierwszego bajtu za liczbą
+ */
+static uint64_t put_varint(uint8_t* out, uint64_t pos, uint64_t v){
+	while(v >= 0x80){
+		if(out != NULL)
+			out[pos] = (uint8_t)(v | 0x80);
+		pos++;
+		v >>= 7;
+	}
+	if(out != NULL)
+		out[pos] = (uint8_t)v;
+	return pos+1;
+}
+
+/** @brief odczytuje liczbę zapisaną przez put_varint
+ * param[in] in 	- bufor
+ * param[in,out] pos 	- położenie liczby, przesuwane za nią
+ *
+ * @return odczytana liczba
+ */
+static uint64_t get_varint(const uint8_t* in, uint64_t* pos){
+	uint64_t v = 0;
+	for(uint32_t shift=0;;shift+=7){
+		uint8_t byte = in[(*pos)++];
+		v |= (uint64_t)(byte & 0x7f) << shift;
+		if(byte < 0x80)
+			return v;
+	}
+}
+
+/** @brief porównuje id graczy dla qsort i bsearch
+ * param[in] a 	- wskaźnik na pierwszą liczbę
+ * param[in] b 	- wskaźnik na drugą liczbę
+ *
+ * @return liczba ujemna, zero lub dodatnia, jeżeli pierwsza jest odpowiednio mniejsza,
+ * równa lub większa
+ */
+static int compare_players(const void* a, const void* b){
+	uint32_t x = *(const uint32_t*)a;
+	uint32_t y = *(const uint32_t*)b;
+	return (x > y)-(x < y);
+}
+
+/** @brief zwraca liczbę bitów potrzebnych na numer w słowniku długości n
+ * param[in] n 	- długość słownika, liczba dodatnia
+ *
+ * @return najmniejsze k, dla którego 2^k >= n
+ */
+static uint32_t dictionary_bits(uint64_t n){
+	uint32_t bits = 0;
+	while(((uint64_t)1 << bits) < n)
+		bits++;
+	return bits;
+}
+
+/** @brief wypełnia słownik różnymi player_id pól kafelka w kolejności pierwszego wystąpienia
+ * param[in] b 		- plansza
+ * param[in] t 		- kafelek planszy
+ * param[out] dictionary - tablica długości co najmniej SMALL_DICTIONARY
+ *
+ * @return długość słownika lub SMALL_DICTIONARY+1, jeżeli kafelek zajmuje więcej graczy
+ */
+static uint64_t small_tile_dictionary(const tiled_board* b, const tile* t, uint32_t* dictionary){
+	uint32_t width = board_tile_width(b, t);
+	uint32_t height = board_tile_height(b, t);
+	uint64_t no_entries = 0;
+	for(uint32_t dy=0;dy<height;dy++){
+		for(uint32_t dx=0;dx<width;dx++){
+			uint32_t player = t->fields[board_field_index(b, dx, dy)].player_id;
+			uint64_t i = 0;
+			while(i < no_entries && dictionary[i] != player)
+				i++;
+			if(i == no_entries && no_entries == SMALL_DICTIONARY)
+				return SMALL_DICTIONARY+1;
+			if(i == no_entries)
+				dictionary[no_entries++] = player;
+		}
+	}
+	return no_entries;
+}
+
+/** @brief wypełnia słownik różnymi player_id pól kafelka leżących na planszy
+ * Słownik do SMALL_DICTIONARY graczy jest w kolejności pierwszego
+ * wystąpienia, dłuższy jest posortowany.
+ * param[in] b 		- plansza
+ * param[in] t 		- kafelek planszy
+ * param[out] dictionary - tablica długości TILE_SIDE*TILE_SIDE
+ *
+ * @return długość słownika
+ */
+static uint64_t tile_dictionary(const tiled_board* b, const tile* t, uint32_t* dictionary){
+	uint64_t no_entries = small_tile_dictionary(b, t, dictionary);
+	if(no_entries <= SMALL_DICTIONARY)
+		return no_entries;
+	uint32_t width = board_tile_width(b, t);
+	uint32_t height = board_tile_height(b, t);
+	uint64_t n = 0;
+	for(uint32_t dy=0;dy<height;dy++)
+		for(uint32_t dx=0;dx<width;dx++)
+			dictionary[n++] = t->fields[board_field_index(b, dx, dy)].player_id;
+	qsort(dictionary, n, sizeof(uint32_t), compare_players);
+	no_entries = 0;
+	for(uint64_t i=0;i<n;i++){
+		if(no_entries == 0 || dictionary[no_entries-1] != dictionary[i])
+			dictionary[no_entries++] = dictionary[i];
+	}
+	return no_entries;
+}
+
+/** @brief zwraca numer gracza w słowniku zbudowanym przez tile_dictionary
+ * param[in] dictionary - słownik
+ * param[in] no_entries - długość słownika
+ * param[in] player 	- id gracza występującego w słowniku
+ *
+ * @return numer gracza w słowniku
+ */
+static uint64_t dictionary_index(const uint32_t* dictionary, uint64_t no_entries,
+				 uint32_t player){
+	if(no_entries <= SMALL_DICTIONARY){
+		uint64_t i = 0;
+		while(dictionary[i] != player)
+			i++;
+		return i;
+	}
+	const uint32_t* entry = bsearch(&player, dictionary, no_entries,
+					sizeof(uint32_t), compare_players);
+	return entry-dictionary;
+}
+
+/** @brief zapisuje player_id pól kafelka leżących na planszy w zwartej postaci
+ * param[in] b 		- plansza
+ * param[in] t 		- kafelek planszy
+ * param[out] out 	- bufor lub NULL, jeżeli tylko liczymy długość
+ * param[in] pos 	- położenie kafelka w buforze
+ *
+ * @return położenie pierwszego bajtu za kafelkiem
+ */
+static uint64_t pack_tile(const tiled_board* b, const tile* t, uint8_t* out, uint64_t pos){
+	uint32_t dictionary[TILE_SIDE*TILE_SIDE];
+	uint64_t no_entries = tile_dictionary(b, t, dictionary);
+	pos = put_varint(out, pos, t->tile_x);
+	pos = put_varint(out, pos, t->tile_y);
+	pos = put_varint(out, pos, no_entries);
+	for(uint64_t i=0;i<no_entries;i++)
+		pos = put_varint(out, pos, dictionary[i]);
+	uint32_t width = board_tile_width(b, t);
+	uint32_t height = board_tile_height(b, t);
+	uint32_t bits = dictionary_bits(no_entries);
+	if(out == NULL || bits == 0)
+		return pos+((uint64_t)width*height*bits+7)/8;
+	uint64_t acc = 0;
+	uint32_t no_acc = 0;
+	for(uint32_t dy=0;dy<height;dy++){
+		for(uint32_t dx=0;dx<width;dx++){
+			uint32_t player = t->fields[board_field_index(b, dx, dy)].player_id;
+			acc |= dictionary_index(dictionary, no_entries, player) << no_acc;
+			for(no_acc+=bits;no_acc>=8;no_acc-=8){
+				out[pos++] = (uint8_t)acc;
+				acc >>= 8;
+			}
+		}
+	}
+	if(no_acc > 0)
+		out[pos++] = (uint8_t)acc;
+	return pos;
+}
+
+/** @brief zapisuje player_id pól planszy w zwartej postaci
+ * Każdy kafelek koduje słownikiem graczy zajmujących jego pola i numerami
+ * w słowniku zapisanymi na najmniejszej potrzebnej liczbie bitów, więc
+ * kafelek zajęty przez jednego gracza zajmuje kilka bajtów.
+ * param[in] b 		- plansza
+ * param[out] out 	- bufor długości co najmniej wyniku dla out == NULL lub NULL
+ *
+ * @return liczba bajtów zwartej postaci planszy
+ */
+uint64_t board_pack(const tiled_board* b, uint8_t* out){
+	uint64_t pos = put_varint(out, 0, b->no_tiles);
+	for(uint64_t i=0;i<b->no_tiles;i++)
+		pos = pack_tile(b, b->tiles[i], out, pos);
+	return pos;
+}
+
+/** @brief odtwarza planszę zwolnioną przez board_free z jej zwartej postaci
+ * param[in,out] b 	- plansza zwolniona przez board_free, zachowuje wymiary i alokatory
+ * param[in] in 	- wynik board_pack dla tej planszy
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci - plansza jest wtedy zwolniona
+ */
+bool board_unpack(tiled_board* b, const uint8_t* in){
+	uint32_t dictionary[TILE_SIDE*TILE_SIDE];
+	allocator alloc = b->alloc;
+	allocator tile_alloc = b->tile_alloc;
+	if(!board_init(b, b->width, b->height, b->layout, &alloc, &tile_alloc, b->huge_pages))
+		return false;
+	uint64_t pos = 0;
+	uint64_t no_tiles = get_varint(in, &pos);
+	for(uint64_t i=0;i<no_tiles;i++){
+		uint32_t tile_x = get_varint(in, &pos);
+		uint32_t tile_y = get_varint(in, &pos);
+		tile* t = board_alloc_tile(b, tile_x << TILE_SHIFT, tile_y << TILE_SHIFT);
+		if(t == NULL){
+			board_free(b);
+			return false;
+		}
+		uint64_t no_entries = get_varint(in, &pos);
+		for(uint64_t j=0;j<no_entries;j++)
+			dictionary[j] = get_varint(in, &pos);
+		uint32_t bits = dictionary_bits(no_entries);
+		uint32_t mask = (1u << bits)-1;
+		uint64_t acc = 0;
+		uint32_t no_acc = 0;
+		uint32_t width = board_tile_width(b, t);
+		uint32_t height = board_tile_height(b, t);
+		for(uint32_t dy=0;dy<height;dy++){
+			for(uint32_t dx=0;dx<width;dx++){
+				for(;no_acc<bits;no_acc+=8)
+					acc |= (uint64_t)in[pos++] << no_acc;
+				t->fields[board_field_index(b, dx, dy)].player_id = dictionary[acc & mask];
+				acc >>= bits;
+				no_acc -= bits;
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,301 @@
+/** @file
+ * Interfejs rzadkiej planszy podzielonej na kafelki alokowane przy pierwszym zapisie
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "alloc.h"
+#include "hugepage.h"
+
+/** @brief log2 boku kafelka
+ */
+#define TILE_SHIFT 6
+/** @brief bok kafelka
+ */
+#define TILE_SIDE (1u << TILE_SHIFT)
+/** @brief maska wyznaczająca współrzędną pola wewnątrz kafelka
+ */
+#define TILE_MASK (TILE_SIDE-1)
+
+/** @brief Układ pól wewnątrz kafelka.
+ */
+typedef enum{
+	BOARD_LAYOUT_ROWS, 	///< pola zapisane wierszami
+	BOARD_LAYOUT_MORTON, 	///< pola zapisane w porządku Mortona (krzywa Z)
+} board_layout;
+
+/** @brief Struktura reprezentująca pole planszy.
+ */
+typedef struct{
+	uint32_t player_id; 	///< id gracza zajmującego pole
+	uint32_t area_id; 	///< id obszaru do którego należy pole
+} field;
+
+/** @brief Struktura reprezentująca kafelek TILE_SIDE x TILE_SIDE pól planszy.
+ * Kolejność pól wyznacza board_field_index, kafelki na brzegu planszy wystają poza nią.
+ */
+typedef struct{
+	field fields[TILE_SIDE*TILE_SIDE]; 	///< pola kafelka
+	uint32_t tile_x; 			///< numer kolumny kafelków
+	uint32_t tile_y; 			///< numer wiersza kafelków
+} tile;
+
+/** @brief Struktura przechowująca planszę.
+ * Kafelki alokujemy przy pierwszym zapisie niezerowej wartości, nieistniejący
+ * kafelek oznacza same puste pola. Na małych planszach katalog kafelków jest
+ * tablicą, na dużych tablicą haszującą, więc zajęta pamięć zależy od liczby
+ * zaalokowanych kafelków, a nie od rozmiaru planszy.
+ */
+typedef struct{
+	uint32_t width; 		///< szerokość planszy
+	uint32_t height; 		///< wysokość planszy
+	uint32_t tiles_x; 		///< liczba kolumn kafelków
+	uint32_t tiles_y; 		///< liczba wierszy kafelków
+	uint32_t dense_shift; 		///< log2 długości wiersza katalogu tablicowego
+	board_layout layout; 		///< układ pól wewnątrz kafelków
+	uint16_t offset_x[TILE_SIDE]; 	///< składnik indeksu pola zależny od odciętej w kafelku
+	uint16_t offset_y[TILE_SIDE]; 	///< składnik indeksu pola zależny od rzędnej w kafelku
+	uintptr_t* dense; 		///< katalog tablicowy lub NULL, jeżeli używamy haszującego,
+					///< przechowuje odległości kafelków od board_empty_tile
+	uint64_t* hash_keys; 		///< numery kafelków w katalogu haszującym, 0 oznacza wolne miejsce
+	tile** hash_tiles; 		///< kafelki w katalogu haszującym
+	uint64_t hash_capacity; 	///< rozmiar katalogu haszującego, potęga dwójki
+	allocator alloc; 		///< alokator katalogu kafelków
+	allocator tile_alloc; 		///< alokator kafelków, w grze w pliku różny od alloc
+	bool huge_pages; 		///< kafelki leżą na dużych stronach zamiast w tile_alloc
+	tile** tiles; 			///< wszystkie zaalokowane kafelki w kolejności alokacji
+	uint64_t no_tiles; 		///< liczba kafelków planszy
+	uint64_t no_cleared_tiles; 	///< liczba wyzerowanych kafelków poprzednich gier,
+					///< leżą w tiles zaraz za kafelkami planszy
+	uint64_t tiles_capacity; 	///< rozmiar tablicy tiles
+} tiled_board;
+
+/** @brief wspólny kafelek samych pustych pól, tylko do odczytu
+ * Wskazują na niego niezaalokowane pozycje katalogu tablicowego, dzięki czemu
+ * odczyt pola nie sprawdza, czy kafelek istnieje. Pozycje katalogu trzymają
+ * odległość kafelka od board_empty_tile, więc pusty katalog składa się z samych
+ * zer i dostaje od systemu wyzerowane strony bez zapisywania ich przy tworzeniu.
+ */
+extern const tile board_empty_tile;
+
+/** @brief inicjuje pustą planszę
+ * param[in,out] b 	- inicjowana plansza
+ * param[in] width 	- szerokość planszy
+ * param[in] height 	- wysokość planszy
+ * param[in] layout 	- układ pól wewnątrz kafelków
+ * param[in] alloc 	- alokator katalogu kafelków
+ * param[in] tile_alloc - alokator kafelków
+ * param[in] huge_pages - true jeżeli kafelki mają leżeć na dużych stronach,
+ * 			  a katalog być oznaczony MADV_HUGEPAGE
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+bool board_init(tiled_board* b, uint32_t width, uint32_t height, board_layout layout,
+		const allocator* alloc, const allocator* tile_alloc, bool huge_pages);
+
+/** @brief zwalnia pamięć zajmowaną przez planszę
+ * param[in,out] b 	- zwalniana plansza
+ */
+void board_free(tiled_board* b);
+
+/** @brief czyści planszę i zmienia jej wymiary, zachowując zaalokowane kafelki
+ * Zeruje tylko kafelki zajęte w poprzedniej grze i odkłada je do ponownego użycia.
+ * param[in,out] b 	- czyszczona plansza
+ * param[in] width 	- nowa szerokość planszy
+ * param[in] height 	- nowa wysokość planszy
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci - plansza się wtedy nie zmienia
+ */
+bool board_reset(tiled_board* b, uint32_t width, uint32_t height);
+
+/** @brief zwraca pamięć zajmowaną przez planszę
+ * param[in] b 		- plansza
+ * param[out] tiles 	- liczba bajtów kafelków, również wyzerowanych przez board_reset
+ * param[out] directory - liczba bajtów katalogu kafelków i tablicy tiles
+ */
+void board_memory(const tiled_board* b, uint64_t* tiles, uint64_t* directory);
+
+/** @brief szacuje z góry pamięć planszy, na której zajęto wszystkie pola
+ * Plansza na dużych stronach może zająć do jednej dużej strony więcej.
+ * param[in] width 	- szerokość planszy
+ * param[in] height 	- wysokość planszy
+ * param[out] tiles 	- liczba bajtów kafelków
+ * param[out] directory - liczba bajtów katalogu kafelków i tablicy tiles
+ */
+void board_estimate_memory(uint32_t width, uint32_t height,
+			   uint64_t* tiles, uint64_t* directory);
+
+/** @brief zapisuje player_id pól planszy w zwartej postaci
+ * Każdy kafelek koduje słownikiem graczy zajmujących jego pola i numerami
+ * w słowniku zapisanymi na najmniejszej potrzebnej liczbie bitów.
+ * Wartości area_id pomijamy.
+ * param[in] b 		- plansza
+ * param[out] out 	- bufor długości co najmniej wyniku dla out == NULL lub NULL
+ *
+ * @return liczba bajtów zwartej postaci planszy
+ */
+uint64_t board_pack(const tiled_board* b, uint8_t* out);
+
+/** @brief odtwarza planszę zwolnioną przez board_free z jej zwartej postaci
+ * Pola dostają area_id równe 0.
+ * param[in,out] b 	- plansza zwolniona przez board_free, zachowuje wymiary i alokatory
+ * param[in] in 	- wynik board_pack dla tej planszy
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci - plansza jest wtedy zwolniona
+ */
+bool board_unpack(tiled_board* b, const uint8_t* in);
+
+/** @brief zwraca indeks pola o współrzędnych (lx, ly) w tablicy pól kafelka
+ * W układzie Mortona sąsiedzi w pionie leżą zwykle w tej samej linii
+ * pamięci podręcznej co sąsiedzi w poziomie.
+ * param[in] b 	- plansza
+ * param[in] lx - odcięta pola wewnątrz kafelka
+ * param[in] ly - rzędna pola wewnątrz kafelka
+ *
+ * @return indeks pola w tablicy fields
+ */
+static inline uint32_t board_field_index(const tiled_board* b, uint32_t lx, uint32_t ly){
+	return b->offset_x[lx] | b->offset_y[ly];
+}
+
+/** @brief miesza bity numeru kafelka
+ * param[in] key 	- numer kafelka
+ *
+ * @return wartość funkcji haszującej
+ */
+static inline uint64_t board_hash(uint64_t key){
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return key;
+}
+
+/** @brief zwraca kafelek o zadanym położeniu lub wspólny pusty kafelek
+ * param[in] b 		- przeszukiwana plansza
+ * param[in] tile_x 	- numer kolumny kafelków
+ * param[in] tile_y 	- numer wiersza kafelków
+ *
+ * @return wskaźnik na kafelek lub &board_empty_tile, jeżeli nie został zaalokowany
+ */
+static inline const tile* board_lookup_tile(const tiled_board* b, uint32_t tile_x, uint32_t tile_y){
+	if(b->dense != NULL)
+		return (const tile*)((uintptr_t)&board_empty_tile +
+				     b->dense[((uint64_t)tile_y << b->dense_shift) | tile_x]);
+	uint64_t key = (uint64_t)tile_y*b->tiles_x+tile_x;
+	uint64_t mask = b->hash_capacity-1;
+	for(uint64_t i = board_hash(key) & mask; b->hash_keys[i] != 0; i = (i+1) & mask){
+		if(b->hash_keys[i] == key+1)
+			return b->hash_tiles[i];
+	}
+	return &board_empty_tile;
+}
+
+/** @brief zwraca kafelek o zadanym położeniu
+ * param[in] b 		- przeszukiwana plansza
+ * param[in] tile_x 	- numer kolumny kafelków
+ * param[in] tile_y 	- numer wiersza kafelków
+ *
+ * @return wskaźnik na kafelek lub NULL, jeżeli nie został zaalokowany
+ */
+static inline tile* board_find_tile(const tiled_board* b, uint32_t tile_x, uint32_t tile_y){
+	const tile* t = board_lookup_tile(b, tile_x, tile_y);
+	return t == &board_empty_tile? NULL : (tile*)t;
+}
+
+/** @brief zwraca pole o współrzędnych (x, y)
+ * param[in] b 	- przeszukiwana plansza
+ * param[in] x 	- odcięta pola
+ * param[in] y 	- rzędna pola
+ *
+ * @return pole planszy, (0, 0) dla pola z niezaalokowanego kafelka
+ */
+static inline field board_get(const tiled_board* b, uint32_t x, uint32_t y){
+	const tile* t = board_lookup_tile(b, x >> TILE_SHIFT, y >> TILE_SHIFT);
+	return t->fields[board_field_index(b, x & TILE_MASK, y & TILE_MASK)];
+}
+
+/** @brief wpisuje istniejący kafelek do tablicy tiles i katalogu
+ * param[in,out] b 	- modyfikowana plansza
+ * param[in] t 		- kafelek z ustawionymi tile_x i tile_y, którego nie ma jeszcze na planszy
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+bool board_insert_tile(tiled_board* b, tile* t);
+
+/** @brief zwraca kafelek zawierający pole (x, y), alokuje go jeżeli nie istnieje
+ * Najpierw używa ponownie kafelków wyzerowanych przez board_reset.
+ * param[in,out] b 	- modyfikowana plansza
+ * param[in] x 		- odcięta pola
+ * param[in] y 		- rzędna pola
+ *
+ * @return wskaźnik na kafelek lub NULL, jeżeli zabrakło pamięci
+ */
+tile* board_alloc_tile(tiled_board* b, uint32_t x, uint32_t y);
+
+/** @brief ustawia player_id pola (x, y), w razie potrzeby alokuje kafelek
+ * param[in,out] b 	- modyfikowana plansza
+ * param[in] x 		- odcięta pola
+ * param[in] y 		- rzędna pola
+ * param[in] player 	- nowa wartość player_id
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static inline bool board_set_player(tiled_board* b, uint32_t x, uint32_t y, uint32_t player){
+	tile* t = board_find_tile(b, x >> TILE_SHIFT, y >> TILE_SHIFT);
+	if(t == NULL && player != 0)
+		t = board_alloc_tile(b, x, y);
+	if(t == NULL)
+		return player == 0;
+	t->fields[board_field_index(b, x & TILE_MASK, y & TILE_MASK)].player_id = player;
+	return true;
+}
+
+/** @brief ustawia area_id pola (x, y), w razie potrzeby alokuje kafelek
+ * param[in,out] b 	- modyfikowana plansza
+ * param[in] x 		- odcięta pola
+ * param[in] y 		- rzędna pola
+ * param[in] area 	- nowa wartość area_id
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static inline bool board_set_area(tiled_board* b, uint32_t x, uint32_t y, uint32_t area){
+	tile* t = board_find_tile(b, x >> TILE_SHIFT, y >> TILE_SHIFT);
+	if(t == NULL && area != 0)
+		t = board_alloc_tile(b, x, y);
+	if(t == NULL)
+		return area == 0;
+	t->fields[board_field_index(b, x & TILE_MASK, y & TILE_MASK)].area_id = area;
+	return true;
+}
+
+/** @brief zwraca liczbę pól kafelka leżących na planszy w poziomie
+ * param[in] b 	- plansza
+ * param[in] t 	- kafelek planszy
+ *
+ * @return szerokość części kafelka leżącej na planszy
+ */
+static inline uint32_t board_tile_width(const tiled_board* b, const tile* t){
+	uint64_t left = b->width-((uint64_t)t->tile_x << TILE_SHIFT);
+	return left < TILE_SIDE? left : TILE_SIDE;
+}
+
+/** @brief zwraca liczbę pól kafelka leżących na planszy w pionie
+ * param[in] b 	- plansza
+ * param[in] t 	- kafelek planszy
+ *
+ * @return wysokość części kafelka leżącej na planszy
+ */
+static inline uint32_t board_tile_height(const tiled_board* b, const tile* t){
+	uint64_t left = b->height-((uint64_t)t->tile_y << TILE_SHIFT);
+	return left < TILE_SIDE? left : TILE_SIDE;
+}
+
+#endif
@@ -0,0 +1,145 @@
+/** @file
+ * Implementacja interfejsu cellset.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cellset.h"
+#include "hugepage.h"
+
+/** @brief początkowy rozmiar tablic zbioru
+ */
+#define CELL_SET_INITIAL_CAPACITY 64
+
+/** @brief miesza bity numeru pola
+ * param[in] key 	- numer pola
+ *
+ * @return wartość funkcji haszującej
+ */
+static uint64_t hash(uint64_t key){
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return key;
+}
+
+/** @brief inicjuje pusty zbiór, nie alokuje pamięci
+ * param[in,out] s 	- inicjowany zbiór
+ */
+void cell_set_init(cell_set* s){
+	s->keys = NULL;
+	s->stamps = NULL;
+	s->tags = NULL;
+	s->capacity = 0;
+	s->size = 0;
+	s->stamp = 1;
+}
+
+/** @brief zwalnia pamięć zajmowaną przez zbiór
+ * param[in,out] s 	- zwalniany zbiór
+ */
+void cell_set_free(cell_set* s){
+	free(s->keys);
+	free(s->stamps);
+	free(s->tags);
+	cell_set_init(s);
+}
+
+/** @brief usuwa wszystkie pola ze zbioru
+ * param[in,out] s 	- czyszczony zbiór
+ */
+void cell_set_clear(cell_set* s){
+	s->size = 0;
+	s->stamp++;
+	if(s->stamp == 0){
+		if(s->stamps != NULL)
+			memset(s->stamps, 0, s->capacity*sizeof(uint32_t));
+		s->stamp = 1;
+	}
+}
+
+/** @brief zwraca indeks, pod którym znajduje się pole lub powinno zostać wpisane
+ * param[in] s 		- przeszukiwany zbiór o niezerowym rozmiarze tablic
+ * param[in] key 	- numer pola
+ *
+ * @return indeks w tablicach zbioru
+ */
+static uint64_t find_slot(cell_set* s, uint64_t key){
+	uint64_t mask = s->capacity-1;
+	uint64_t i = hash(key) & mask;
+	while(s->stamps[i] == s->stamp && s->keys[i] != key)
+		i = (i+1) & mask;
+	return i;
+}
+
+/** @brief zwraca etykietę pola
+ * param[in] s 		- przeszukiwany zbiór
+ * param[in] key 	- numer pola
+ *
+ * @return etykieta pola lub CELL_SET_ABSENT jeżeli pola nie ma w zbiorze
+ */
+uint8_t cell_set_get(cell_set* s, uint64_t key){
+	if(s->capacity == 0)
+		return CELL_SET_ABSENT;
+	uint64_t i = find_slot(s, key);
+	return s->stamps[i] == s->stamp? s->tags[i] : CELL_SET_ABSENT;
+}
+
+/** @brief podwaja rozmiar tablic zbioru przepisując aktualne wpisy
+ * param[in,out] s 	- modyfikowany zbiór
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool grow(cell_set* s){
+	cell_set bigger;
+	cell_set_init(&bigger);
+	bigger.capacity = s->capacity == 0? CELL_SET_INITIAL_CAPACITY : 2*s->capacity;
+	bigger.keys = malloc(bigger.capacity*sizeof(uint64_t));
+	bigger.stamps = calloc(bigger.capacity, sizeof(uint32_t));
+	bigger.tags = malloc(bigger.capacity*sizeof(uint8_t));
+	if(bigger.keys == NULL || bigger.stamps == NULL || bigger.tags == NULL){
+		cell_set_free(&bigger);
+		return false;
+	}
+	if(huge_pages_requested()){
+		huge_advise(bigger.keys, bigger.capacity*sizeof(uint64_t));
+		huge_advise(bigger.stamps, bigger.capacity*sizeof(uint32_t));
+		huge_advise(bigger.tags, bigger.capacity*sizeof(uint8_t));
+	}
+	for(uint64_t i=0;i<s->capacity;i++){
+		if(s->stamps[i] == s->stamp){
+			uint64_t j = find_slot(&bigger, s->keys[i]);
+			bigger.keys[j] = s->keys[i];
+			bigger.stamps[j] = bigger.stamp;
+			bigger.tags[j] = s->tags[i];
+			bigger.size++;
+		}
+	}
+	cell_set_free(s);
+	*s = bigger;
+	return true;
+}
+
+/** @brief dodaje pole do zbioru lub zmienia jego etykietę
+ * param[in,out] s 	- modyfikowany zbiór
+ * param[in] key 	- numer pola
+ * param[in] tag 	- etykieta pola, różna od CELL_SET_ABSENT
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+bool cell_set_put(cell_set* s, uint64_t key, uint8_t tag){
+	if(2*(s->size+1) > s->capacity && !grow(s))
+		return false;
+	uint64_t i = find_slot(s, key);
+	if(s->stamps[i] != s->stamp){
+		s->keys[i] = key;
+		s->stamps[i] = s->stamp;
+		s->size++;
+	}
+	s->tags[i] = tag;
+	return true;
+}
@@ -0,0 +1,65 @@
+/** @file
+ * Interfejs zbioru odwiedzonych pól używanego przy przeszukiwaniu planszy
+ * bez modyfikowania jej stanu
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef CELLSET_H
+#define CELLSET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief wartość zwracana przez cell_set_get dla pola spoza zbioru
+ */
+#define CELL_SET_ABSENT 0xFF
+
+/** @brief Struktura przechowująca zbiór pól planszy wraz z etykietą każdego z nich.
+ * Pola są identyfikowane numerem y*width+x. Czyszczenie zbioru kosztuje O(1),
+ * bo wpisy z nieaktualnym znacznikiem traktujemy jak puste.
+ */
+typedef struct{
+	uint64_t* keys; 	///< numery pól
+	uint32_t* stamps; 	///< znacznik czyszczenia, z którym zapisano wpis
+	uint8_t* tags; 		///< etykiety pól
+	uint64_t capacity; 	///< rozmiar tablic, potęga dwójki
+	uint64_t size; 		///< liczba aktualnych wpisów
+	uint32_t stamp; 	///< aktualny znacznik czyszczenia
+} cell_set;
+
+/** @brief inicjuje pusty zbiór, nie alokuje pamięci
+ * param[in,out] s 	- inicjowany zbiór
+ */
+void cell_set_init(cell_set* s);
+
+/** @brief zwalnia pamięć zajmowaną przez zbiór
+ * param[in,out] s 	- zwalniany zbiór
+ */
+void cell_set_free(cell_set* s);
+
+/** @brief usuwa wszystkie pola ze zbioru
+ * param[in,out] s 	- czyszczony zbiór
+ */
+void cell_set_clear(cell_set* s);
+
+/** @brief zwraca etykietę pola
+ * param[in] s 		- przeszukiwany zbiór
+ * param[in] key 	- numer pola
+ *
+ * @return etykieta pola lub CELL_SET_ABSENT jeżeli pola nie ma w zbiorze
+ */
+uint8_t cell_set_get(cell_set* s, uint64_t key);
+
+/** @brief dodaje pole do zbioru lub zmienia jego etykietę
+ * param[in,out] s 	- modyfikowany zbiór
+ * param[in] key 	- numer pola
+ * param[in] tag 	- etykieta pola, różna od CELL_SET_ABSENT
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+bool cell_set_put(cell_set* s, uint64_t key, uint8_t tag);
+
+#endif
@@ -0,0 +1,364 @@
+/** @file
+ * Implementacja interfejsu components.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "components.h"
+#include "threadpool.h"
+
+/** @brief początkowy rozmiar tablic etykiet pasa planszy
+ */
+#define INITIAL_STRIPE_LABELS 64
+
+/** @brief Struktura z tymczasowymi etykietami jednego pasa planszy.
+ * Etykiety pasa mają numery [1, no_labels], parent tworzy las zbiorów rozłącznych.
+ */
+typedef struct{
+	uint32_t* parent; 	///< rodzic etykiety w lesie zbiorów rozłącznych
+	uint32_t* owner; 	///< id gracza, do którego należą pola z etykietą
+	uint64_t* size; 	///< liczba pól z etykietą
+	uint32_t no_labels; 	///< liczba etykiet pasa
+	uint32_t capacity; 	///< rozmiar tablic parent, owner i size
+	uint64_t offset; 	///< numer ostatniej etykiety poprzednich pasów
+} stripe_labels;
+
+/** @brief Struktura ze stanem etykietowania, wspólna dla wątków
+ */
+typedef struct{
+	tiled_board* b; 		///< etykietowana plansza
+	const uint32_t* owners; 	///< układ pionków
+	uint32_t max_player; 		///< największe dopuszczalne id gracza
+	stripe_labels* stripes; 	///< etykiety pasów, po jednym na wiersz kafelków
+	uint32_t* colour; 		///< ostateczny kolor etykiety o numerze globalnym
+	atomic_bool failed; 		///< true jeżeli któryś pas się nie powiódł
+} labelling;
+
+/** @brief zwraca korzeń drzewa etykiety, skracając po drodze ścieżkę o połowę
+ * param[in,out] parent - las zbiorów rozłącznych
+ * param[in] label 	- etykieta
+ *
+ * @return etykieta reprezentująca zbiór
+ */
+static uint32_t find_root(uint32_t* parent, uint32_t label){
+	while(parent[label] != label){
+		parent[label] = parent[parent[label]];
+		label = parent[label];
+	}
+	return label;
+}
+
+/** @brief łączy zbiory dwóch etykiet, reprezentantem zostaje mniejszy korzeń
+ * param[in,out] parent - las zbiorów rozłącznych
+ * param[in] a 		- pierwsza etykieta
+ * param[in] b 		- druga etykieta
+ */
+static void unite(uint32_t* parent, uint32_t a, uint32_t b){
+	a = find_root(parent, a);
+	b = find_root(parent, b);
+	if(a < b)
+		parent[b] = a;
+	else
+		parent[a] = b;
+}
+
+/** @brief przydziela nową etykietę pasa
+ * param[in,out] s 	- etykiety pasa
+ * param[in] player 	- id gracza, do którego należy pole z etykietą
+ *
+ * @return nowa etykieta lub 0, jeżeli zabrakło pamięci lub etykiet
+ */
+static uint32_t new_stripe_label(stripe_labels* s, uint32_t player){
+	if(s->no_labels+1 >= s->capacity){
+		if(s->capacity == UINT32_MAX)
+			return 0;
+		uint64_t capacity = s->capacity == 0? INITIAL_STRIPE_LABELS : 2*(uint64_t)s->capacity;
+		if(capacity > UINT32_MAX)
+			capacity = UINT32_MAX;
+		uint32_t* parent = realloc(s->parent, capacity*sizeof(uint32_t));
+		if(parent != NULL)
+			s->parent = parent;
+		uint32_t* owner = realloc(s->owner, capacity*sizeof(uint32_t));
+		if(owner != NULL)
+			s->owner = owner;
+		uint64_t* size = realloc(s->size, capacity*sizeof(uint64_t));
+		if(size != NULL)
+			s->size = size;
+		if(parent == NULL || owner == NULL || size == NULL)
+			return 0;
+		s->capacity = capacity;
+	}
+	uint32_t label = ++s->no_labels;
+	s->parent[label] = label;
+	s->owner[label] = player;
+	s->size[label] = 0;
+	return label;
+}
+
+/** @brief zwraca liczbę pól kafelka o zadanym numerze kolumny leżących na planszy w poziomie
+ * param[in] b 		- plansza
+ * param[in] tile_x 	- numer kolumny kafelków
+ *
+ * @return szerokość części kafelka leżącej na planszy
+ */
+static uint32_t column_width(const tiled_board* b, uint32_t tile_x){
+	uint64_t left = b->width-((uint64_t)tile_x << TILE_SHIFT);
+	return left < TILE_SIDE? left : TILE_SIDE;
+}
+
+/** @brief zwraca liczbę pól pasa o zadanym numerze leżących na planszy w pionie
+ * param[in] b 		- plansza
+ * param[in] tile_y 	- numer wiersza kafelków
+ *
+ * @return wysokość pasa
+ */
+static uint32_t stripe_height(const tiled_board* b, uint32_t tile_y){
+	uint64_t left = b->height-((uint64_t)tile_y << TILE_SHIFT);
+	return left < TILE_SIDE? left : TILE_SIDE;
+}
+
+/** @brief alokuje kafelki planszy, w których układ pionków ma zajęte pole
+ * param[in,out] b 	- pusta plansza
+ * param[in] owners 	- układ pionków
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool allocate_tiles(tiled_board* b, const uint32_t* owners){
+	for(uint32_t ty=0;ty<b->tiles_y;ty++){
+		uint32_t height = stripe_height(b, ty);
+		for(uint32_t tx=0;tx<b->tiles_x;tx++){
+			uint32_t width = column_width(b, tx);
+			uint32_t x0 = tx << TILE_SHIFT;
+			uint32_t y0 = ty << TILE_SHIFT;
+			bool busy = false;
+			for(uint32_t ly=0;ly<height && !busy;ly++){
+				const uint32_t* row = owners+(uint64_t)(y0+ly)*b->width+x0;
+				for(uint32_t lx=0;lx<width && !busy;lx++)
+					busy = row[lx] != 0;
+			}
+			if(busy && board_alloc_tile(b, x0, y0) == NULL)
+				return false;
+		}
+	}
+	return true;
+}
+
+/** @brief wpisuje pionki pasa planszy i nadaje jego polom tymczasowe etykiety
+ * Pierwsze przejście: pole dostaje etykietę lewego lub dolnego sąsiada tego
+ * samego gracza, a gdy obaj istnieją, ich etykiety łączymy.
+ * param[in] arg 	- wskaźnik na strukturę labelling
+ * param[in] tile_y 	- numer pasa, czyli wiersza kafelków
+ */
+static void label_stripe(void* arg, uint32_t tile_y){
+	labelling* l = arg;
+	tiled_board* b = l->b;
+	stripe_labels* s = &l->stripes[tile_y];
+	uint32_t height = stripe_height(b, tile_y);
+	for(uint32_t ly=0;ly<height;ly++){
+		const uint32_t* row = l->owners+((uint64_t)(tile_y << TILE_SHIFT)+ly)*b->width;
+		uint32_t left_owner = 0;
+		uint32_t left_label = 0;
+		for(uint32_t tx=0;tx<b->tiles_x;tx++){
+			tile* t = board_find_tile(b, tx, tile_y);
+			if(t == NULL){
+				left_owner = 0;
+				continue;
+			}
+			uint32_t width = column_width(b, tx);
+			const uint32_t* segment = row+(tx << TILE_SHIFT);
+			for(uint32_t lx=0;lx<width;lx++){
+				uint32_t player = segment[lx];
+				field* f = &t->fields[board_field_index(b, lx, ly)];
+				f->player_id = player;
+				if(player == 0){
+					left_owner = 0;
+					continue;
+				}
+				uint32_t label = left_owner == player? left_label : 0;
+				if(ly > 0){
+					field below = t->fields[board_field_index(b, lx, ly-1)];
+					if(below.player_id == player && label == 0)
+						label = below.area_id;
+					else if(below.player_id == player && below.area_id != label)
+						unite(s->parent, label, below.area_id);
+				}
+				if(player > l->max_player ||
+				   (label == 0 && (label = new_stripe_label(s, player)) == 0)){
+					atomic_store(&l->failed, true);
+					return;
+				}
+				f->area_id = label;
+				s->size[label]++;
+				left_owner = player;
+				left_label = label;
+			}
+		}
+	}
+}
+
+/** @brief wpisuje zajętym polom pasa planszy ostateczne kolory
+ * Puste pola zostają z kolorem 0; colour jest przesunięte o początek etykiet
+ * pasa, więc colour[0] to ostatnia etykieta poprzedniego pasa.
+ * param[in] arg 	- wskaźnik na strukturę labelling
+ * param[in] tile_y 	- numer pasa, czyli wiersza kafelków
+ */
+static void colour_stripe(void* arg, uint32_t tile_y){
+	labelling* l = arg;
+	tiled_board* b = l->b;
+	const uint32_t* colour = l->colour+l->stripes[tile_y].offset;
+	uint32_t height = stripe_height(b, tile_y);
+	for(uint32_t tx=0;tx<b->tiles_x;tx++){
+		tile* t = board_find_tile(b, tx, tile_y);
+		uint32_t width = column_width(b, tx);
+		for(uint32_t ly=0;ly<height && t != NULL;ly++){
+			for(uint32_t lx=0;lx<width;lx++){
+				field* f = &t->fields[board_field_index(b, lx, ly)];
+				if(f->player_id != 0)
+					f->area_id = colour[f->area_id];
+			}
+		}
+	}
+}
+
+/** @brief łączy etykiety pasów w jeden las i etykiety pól sąsiadujących przez granice pasów
+ * param[in,out] l 	- stan etykietowania po pierwszym przejściu
+ * param[in,out] parent - tablica długości liczby wszystkich etykiet + 1
+ */
+static void merge_stripes(labelling* l, uint32_t* parent){
+	tiled_board* b = l->b;
+	parent[0] = 0;
+	for(uint32_t ty=0;ty<b->tiles_y;ty++){
+		stripe_labels* s = &l->stripes[ty];
+		for(uint32_t i=1;i<=s->no_labels;i++)
+			parent[s->offset+i] = s->offset+find_root(s->parent, i);
+	}
+	for(uint32_t ty=1;ty<b->tiles_y;ty++){
+		uint64_t offset = l->stripes[ty].offset;
+		uint64_t below_offset = l->stripes[ty-1].offset;
+		for(uint32_t tx=0;tx<b->tiles_x;tx++){
+			const tile* t = board_find_tile(b, tx, ty);
+			const tile* below = board_find_tile(b, tx, ty-1);
+			uint32_t width = column_width(b, tx);
+			for(uint32_t lx=0;lx<width && t != NULL && below != NULL;lx++){
+				field f = t->fields[board_field_index(b, lx, 0)];
+				field g = below->fields[board_field_index(b, lx, TILE_SIDE-1)];
+				if(f.player_id != 0 && f.player_id == g.player_id)
+					unite(parent, offset+f.area_id, below_offset+g.area_id);
+			}
+		}
+	}
+}
+
+/** @brief numeruje zbiory etykiet kolejnymi kolorami i zlicza pola składowych
+ * param[in,out] l 	- stan etykietowania po połączeniu pasów
+ * param[in,out] parent - las wszystkich etykiet
+ * param[in] no_labels 	- liczba wszystkich etykiet
+ * param[out] out 	- składowe planszy
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool number_components(labelling* l, uint32_t* parent, uint64_t no_labels,
+			      components* out){
+	uint32_t n = 0;
+	for(uint64_t i=1;i<=no_labels;i++){
+		if(find_root(parent, i) == i)
+			l->colour[i] = ++n;
+	}
+	out->no_components = n;
+	out->size = calloc((uint64_t)n+1, sizeof(uint64_t));
+	out->owner = calloc((uint64_t)n+1, sizeof(uint32_t));
+	if(out->size == NULL || out->owner == NULL)
+		return false;
+	l->colour[0] = 0;
+	for(uint32_t ty=0;ty<l->b->tiles_y;ty++){
+		stripe_labels* s = &l->stripes[ty];
+		for(uint32_t i=1;i<=s->no_labels;i++){
+			uint32_t colour = l->colour[find_root(parent, s->offset+i)];
+			l->colour[s->offset+i] = colour;
+			out->size[colour] += s->size[i];
+			out->owner[colour] = s->owner[i];
+		}
+	}
+	return true;
+}
+
+/** @brief zwalnia tablice etykiet pasów
+ * param[in,out] l 	- stan etykietowania
+ */
+static void free_stripes(labelling* l){
+	for(uint32_t ty=0;ty<l->b->tiles_y;ty++){
+		free(l->stripes[ty].parent);
+		free(l->stripes[ty].owner);
+		free(l->stripes[ty].size);
+	}
+	free(l->stripes);
+}
+
+/** @brief wypełnia pustą planszę układem pionków i nadaje kolory jej obszarom
+ * param[in,out] b 		- pusta plansza
+ * param[in] owners 		- id gracza na polu (x, y) pod indeksem y*width+x, 0 dla pustego pola
+ * param[in] max_player 	- największe dopuszczalne id gracza
+ * param[out] out 		- składowe planszy
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci, kolorów
+ * lub id gracza przekracza max_player - plansza może być wtedy częściowo wypełniona
+ */
+bool components_load(tiled_board* b, const uint32_t* owners, uint32_t max_player,
+		     components* out){
+	out->no_components = 0;
+	out->size = NULL;
+	out->owner = NULL;
+	labelling l;
+	l.b = b;
+	l.owners = owners;
+	l.max_player = max_player;
+	l.colour = NULL;
+	atomic_init(&l.failed, false);
+	l.stripes = calloc(b->tiles_y, sizeof(stripe_labels));
+	if(l.stripes == NULL)
+		return false;
+	if(!allocate_tiles(b, owners)){
+		free_stripes(&l);
+		return false;
+	}
+	thread_pool_run(label_stripe, &l, b->tiles_y);
+	uint64_t no_labels = 0;
+	for(uint32_t ty=0;ty<b->tiles_y;ty++){
+		l.stripes[ty].offset = no_labels;
+		no_labels += l.stripes[ty].no_labels;
+	}
+	uint32_t* parent = NULL;
+	bool success = !atomic_load(&l.failed) && no_labels < UINT32_MAX;
+	if(success){
+		parent = malloc((no_labels+1)*sizeof(uint32_t));
+		l.colour = malloc((no_labels+1)*sizeof(uint32_t));
+		success = parent != NULL && l.colour != NULL;
+	}
+	if(success){
+		merge_stripes(&l, parent);
+		success = number_components(&l, parent, no_labels, out);
+	}
+	if(success)
+		thread_pool_run(colour_stripe, &l, b->tiles_y);
+	free(parent);
+	free(l.colour);
+	free_stripes(&l);
+	if(!success)
+		components_free(out);
+	return success;
+}
+
+/** @brief zwalnia tablice wyniku components_load
+ * param[in,out] c 	- zwalniane składowe
+ */
+void components_free(components* c){
+	free(c->size);
+	free(c->owner);
+	c->size = NULL;
+	c->owner = NULL;
+	c->no_components = 0;
+}
@@ -0,0 +1,50 @@
+/** @file
+ * Interfejs wypełniania planszy zadanym układem pionków i etykietowania
+ * jej spójnych składowych (obszarów graczy)
+ *
+ * Etykietujemy dwoma przejściami: pasy planszy o wysokości kafelka
+ * etykietujemy równolegle, każdy z własną strukturą zbiorów rozłącznych,
+ * potem łączymy etykiety na granicach pasów i ponownie równolegle
+ * wpisujemy polom ostateczne kolory.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "board.h"
+
+/** @brief Struktura opisująca spójne składowe planszy.
+ * Składowe mają kolory [1, no_components], tablice mają długość no_components+1.
+ */
+typedef struct{
+	uint32_t no_components; ///< liczba składowych
+	uint64_t* size; 	///< liczba pól składowej o danym kolorze
+	uint32_t* owner; 	///< id gracza zajmującego składową o danym kolorze
+} components;
+
+/** @brief wypełnia pustą planszę układem pionków i nadaje kolory jej obszarom
+ * Alokuje kafelki zawierające zajęte pola. Pamięć pomocnicza i tablice
+ * wyniku pochodzą ze sterty.
+ * param[in,out] b 		- pusta plansza
+ * param[in] owners 		- id gracza na polu (x, y) pod indeksem y*width+x, 0 dla pustego pola
+ * param[in] max_player 	- największe dopuszczalne id gracza
+ * param[out] out 		- składowe planszy
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci, kolorów
+ * lub id gracza przekracza max_player - plansza może być wtedy częściowo wypełniona
+ */
+bool components_load(tiled_board* b, const uint32_t* owners, uint32_t max_player,
+		     components* out);
+
+/** @brief zwalnia tablice wyniku components_load
+ * param[in,out] c 	- zwalniane składowe
+ */
+void components_free(components* c);
+
+#endif
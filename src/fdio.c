@@ -0,0 +1,61 @@
+/** @file
+ * Implementacja interfejsu fdio.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z read() i write()
+ */
+#define _XOPEN_SOURCE 700
+#include <errno.h>
+#include <unistd.h>
+#include "fdio.h"
+
+/** @brief największa liczba bajtów przenoszona jednym wywołaniem read lub write
+ * Linux i tak przenosi najwyżej tyle naraz.
+ */
+#define FD_MAX_CHUNK 0x7ffff000
+
+/** @brief czyta z deskryptora dokładnie size bajtów
+ * param[in] fd 	- deskryptor pliku
+ * param[out] buf 	- bufor długości co najmniej size
+ * param[in] size 	- liczba bajtów do przeczytania
+ *
+ * @return true jeżeli się udało, false przy błędzie lub końcu pliku przed size bajtami
+ */
+bool fd_read_full(int fd, void* buf, uint64_t size){
+	char* p = buf;
+	while(size > 0){
+		ssize_t n = read(fd, p, size < FD_MAX_CHUNK? size : FD_MAX_CHUNK);
+		if(n < 0 && errno == EINTR)
+			continue;
+		if(n <= 0)
+			return false;
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+/** @brief zapisuje do deskryptora dokładnie size bajtów
+ * param[in] fd 	- deskryptor pliku
+ * param[in] buf 	- zapisywany blok
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return true jeżeli się udało, false przy błędzie zapisu
+ */
+bool fd_write_full(int fd, const void* buf, uint64_t size){
+	const char* p = buf;
+	while(size > 0){
+		ssize_t n = write(fd, p, size < FD_MAX_CHUNK? size : FD_MAX_CHUNK);
+		if(n < 0 && errno == EINTR)
+			continue;
+		if(n <= 0)
+			return false;
+		p += n;
+		size -= n;
+	}
+	return true;
+}
@@ -0,0 +1,37 @@
+/** @file
+ * Interfejs pełnego odczytu i zapisu bloków przez deskryptor pliku
+ *
+ * read i write mogą przenieść mniej bajtów, niż im zlecono, np. przy
+ * potokach i gniazdach lub po przerwaniu sygnałem. Funkcje tutaj ponawiają
+ * je aż do przeniesienia całego bloku.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef FDIO_H
+#define FDIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief czyta z deskryptora dokładnie size bajtów
+ * param[in] fd 	- deskryptor pliku
+ * param[out] buf 	- bufor długości co najmniej size
+ * param[in] size 	- liczba bajtów do przeczytania
+ *
+ * @return true jeżeli się udało, false przy błędzie lub końcu pliku przed size bajtami
+ */
+bool fd_read_full(int fd, void* buf, uint64_t size);
+
+/** @brief zapisuje do deskryptora dokładnie size bajtów
+ * param[in] fd 	- deskryptor pliku
+ * param[in] buf 	- zapisywany blok
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return true jeżeli się udało, false przy błędzie zapisu
+ */
+bool fd_write_full(int fd, const void* buf, uint64_t size);
+
+#endif
@@ -0,0 +1,150 @@
+/** @file
+ * Implementacja interfejsu gametable.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#include <stdlib.h>
+#include "gametable.h"
+
+/** @brief początkowy rozmiar tablic
+ */
+#define GAME_TABLE_INITIAL_CAPACITY 64
+
+/** @brief miesza bity identyfikatora gry
+ * param[in] id 	- identyfikator gry
+ *
+ * @return wartość funkcji haszującej
+ */
+static uint64_t hash(uint32_t id){
+	uint64_t key = id;
+	key ^= key >> 16;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return key;
+}
+
+/** @brief inicjuje pustą tablicę, nie alokuje pamięci
+ * param[in,out] t 	- inicjowana tablica
+ */
+void game_table_init(game_table* t){
+	t->ids = NULL;
+	t->games = NULL;
+	t->capacity = 0;
+	t->size = 0;
+}
+
+/** @brief usuwa wszystkie gry tablicy przez gamma_delete i zwalnia jej pamięć
+ * param[in,out] t 	- zwalniana tablica
+ */
+void game_table_free(game_table* t){
+	for(uint64_t i=0;i<t->capacity;i++)
+		gamma_delete(t->games[i]);
+	free(t->ids);
+	free(t->games);
+	game_table_init(t);
+}
+
+/** @brief zwraca indeks, pod którym znajduje się gra lub powinna zostać wpisana
+ * param[in] t 		- przeszukiwana tablica o niezerowym rozmiarze
+ * param[in] id 	- identyfikator gry
+ *
+ * @return indeks w tablicach
+ */
+static uint64_t find_slot(game_table* t, uint32_t id){
+	uint64_t mask = t->capacity-1;
+	uint64_t i = hash(id) & mask;
+	while(t->games[i] != NULL && t->ids[i] != id)
+		i = (i+1) & mask;
+	return i;
+}
+
+/** @brief zwraca grę o danym identyfikatorze
+ * param[in] t 		- przeszukiwana tablica
+ * param[in] id 	- identyfikator gry
+ *
+ * @return gra lub NULL jeżeli nie ma gry o tym identyfikatorze
+ */
+gamma_t* game_table_get(game_table* t, uint32_t id){
+	if(t->capacity == 0)
+		return NULL;
+	return t->games[find_slot(t, id)];
+}
+
+/** @brief podwaja rozmiar tablic przepisując gry
+ * param[in,out] t 	- modyfikowana tablica
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool grow(game_table* t){
+	game_table bigger;
+	bigger.capacity = t->capacity == 0? GAME_TABLE_INITIAL_CAPACITY : 2*t->capacity;
+	bigger.size = t->size;
+	bigger.ids = malloc(bigger.capacity*sizeof(uint32_t));
+	bigger.games = calloc(bigger.capacity, sizeof(gamma_t*));
+	if(bigger.ids == NULL || bigger.games == NULL){
+		free(bigger.ids);
+		free(bigger.games);
+		return false;
+	}
+	for(uint64_t i=0;i<t->capacity;i++){
+		if(t->games[i] != NULL){
+			uint64_t j = find_slot(&bigger, t->ids[i]);
+			bigger.ids[j] = t->ids[i];
+			bigger.games[j] = t->games[i];
+		}
+	}
+	free(t->ids);
+	free(t->games);
+	*t = bigger;
+	return true;
+}
+
+/** @brief dodaje grę o identyfikatorze, którego nie ma w tablicy
+ * param[in,out] t 	- modyfikowana tablica
+ * param[in] id 	- identyfikator gry
+ * param[in] g 		- gra, różna od NULL
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+bool game_table_put(game_table* t, uint32_t id, gamma_t* g){
+	if(2*(t->size+1) > t->capacity && !grow(t))
+		return false;
+	uint64_t i = find_slot(t, id);
+	t->ids[i] = id;
+	t->games[i] = g;
+	t->size++;
+	return true;
+}
+
+/** @brief usuwa grę z tablicy, nie usuwając jej stanu
+ * Kolejne gry ciągu próbkowania przesuwa na zwolnione miejsce, jeżeli
+ * tam powinny się znaleźć, więc tablica nie potrzebuje znaczników usunięcia.
+ * param[in,out] t 	- modyfikowana tablica
+ * param[in] id 	- identyfikator gry
+ *
+ * @return usunięta gra lub NULL jeżeli nie było gry o tym identyfikatorze
+ */
+gamma_t* game_table_remove(game_table* t, uint32_t id){
+	if(t->capacity == 0)
+		return NULL;
+	uint64_t mask = t->capacity-1;
+	uint64_t hole = find_slot(t, id);
+	gamma_t* g = t->games[hole];
+	if(g == NULL)
+		return NULL;
+	t->games[hole] = NULL;
+	t->size--;
+	for(uint64_t i=(hole+1) & mask; t->games[i] != NULL; i=(i+1) & mask){
+		uint64_t home = hash(t->ids[i]) & mask;
+		if(((i-home) & mask) >= ((i-hole) & mask)){
+			t->ids[hole] = t->ids[i];
+			t->games[hole] = t->games[i];
+			t->games[i] = NULL;
+			hole = i;
+		}
+	}
+	return g;
+}
@@ -0,0 +1,61 @@
+/** @file
+ * Interfejs tablicy haszującej gier trybu z identyfikatorami gier
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef GAMETABLE_H
+#define GAMETABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gamma.h"
+
+/** @brief Struktura przypisująca identyfikatorom gier ich stan.
+ * Adresowanie otwarte z liniowym próbkowaniem, puste miejsce ma grę NULL.
+ */
+typedef struct{
+	uint32_t* ids; 		///< identyfikatory gier
+	gamma_t** games; 	///< gry o tych identyfikatorach lub NULL dla pustego miejsca
+	uint64_t capacity; 	///< rozmiar tablic, potęga dwójki
+	uint64_t size; 		///< liczba gier w tablicy
+} game_table;
+
+/** @brief inicjuje pustą tablicę, nie alokuje pamięci
+ * param[in,out] t 	- inicjowana tablica
+ */
+void game_table_init(game_table* t);
+
+/** @brief usuwa wszystkie gry tablicy przez gamma_delete i zwalnia jej pamięć
+ * param[in,out] t 	- zwalniana tablica
+ */
+void game_table_free(game_table* t);
+
+/** @brief zwraca grę o danym identyfikatorze
+ * param[in] t 		- przeszukiwana tablica
+ * param[in] id 	- identyfikator gry
+ *
+ * @return gra lub NULL jeżeli nie ma gry o tym identyfikatorze
+ */
+gamma_t* game_table_get(game_table* t, uint32_t id);
+
+/** @brief dodaje grę o identyfikatorze, którego nie ma w tablicy
+ * param[in,out] t 	- modyfikowana tablica
+ * param[in] id 	- identyfikator gry
+ * param[in] g 		- gra, różna od NULL
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+bool game_table_put(game_table* t, uint32_t id, gamma_t* g);
+
+/** @brief usuwa grę z tablicy, nie usuwając jej stanu
+ * param[in,out] t 	- modyfikowana tablica
+ * param[in] id 	- identyfikator gry
+ *
+ * @return usunięta gra lub NULL jeżeli nie było gry o tym identyfikatorze
+ */
+gamma_t* game_table_remove(game_table* t, uint32_t id);
+
+#endif
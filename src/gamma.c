@@ -11,43 +11,158 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "alloc.h"
+#include "board.h"
+#include "hugepage.h"
+#include "mapped.h"
+#include "cellset.h"
+#include "threadpool.h"
+#include "fdio.h"
+#include "components.h"
+#include "rwlock.h"
 
-/** @brief przeźroczysty kolor - domyślny, na który malujemy pola przy gamma_try_golden_move
- * używamy go, żeby niepotrzebnie nie alokować tablicy rozmiaru planszy na tablicę visited
- * przy używaniu DFSa do kolorowania obszarów
+/** @brief minimalna liczba pól zaalokowanych kafelków, od której przeszukujemy planszę równolegle
  */
-#define TRANSPARENT UINT32_MAX
+#define PARALLEL_SCAN_MIN_FIELDS (1 << 16)
 
-/** @brief standardowy stdlib::malloc mowiacy czy funkcja zwraca NULL czy też nie.
- * Alokuje pamięć jak standardowy stdlib::malloc, ale 
- * jeżeli zwraca NULL to ustawia success na false
- * @param[in] size 	- ilość pamięci w bajtach do zaalokowania
- * @param[in] success 	- referencja do flagi mówiącej czy udało się 
- * wykonać wszystkie procesy
- *
- * @return Pointer na blok zaalokowanej pamięci lub NULL jeżeli nie udało się jej zaalokować 
+/** @brief liczba porcji kafelków przypadająca na jeden wątek przy równoległym przeszukiwaniu
  */
-static void* safe_malloc(size_t size, bool* success){
-	void* r = malloc(size);
-	if(r == NULL){
-		*success = false;
+#define CHUNKS_PER_THREAD 8
+
+/** @brief maksymalna liczba fragmentów, na które może rozpaść się obszar po usunięciu pola
+ */
+#define MAX_FRAGMENTS 4
+
+/** @brief Struktura reprezentująca stos numerów pól
+ */
+typedef struct{
+	uint64_t* fields; 	///< numery pól na stosie
+	uint64_t capacity; 	///< rozmiar tablicy fields
+	uint64_t top; 		///< liczba pól na stosie
+} field_stack;
+
+/** @brief Struktura z pamięcią pomocniczą jednego wątku do przeszukiwania planszy
+ * bez modyfikowania jej stanu
+ */
+typedef struct{
+	cell_set visited; 	///< odwiedzone pola z etykietą fragmentu, do którego należą
+	field_stack stacks[MAX_FRAGMENTS]; ///< stosy pól do odwiedzenia, po jednym na fragment
+} search_scratch;
+
+/** @brief klucz, pod którym każdy wątek trzyma swoją pamięć pomocniczą
+ */
+static pthread_key_t scratch_key;
+/** @brief zapewnia jednokrotne utworzenie scratch_key
+ */
+static pthread_once_t scratch_key_once = PTHREAD_ONCE_INIT;
+
+/** @brief zwalnia pamięć pomocniczą wątku, wywoływana przy jego zakończeniu
+ * @param[in] ptr 	- wskaźnik na zwalnianą strukturę search_scratch
+ */
+static void free_search_scratch(void* ptr){
+	search_scratch* s = ptr;
+	cell_set_free(&s->visited);
+	for(int i=0;i<MAX_FRAGMENTS;i++)
+		free(s->stacks[i].fields);
+	free(s);
+}
+
+/** @brief tworzy klucz pamięci pomocniczej wątków
+ */
+static void make_scratch_key(void){
+	pthread_key_create(&scratch_key, free_search_scratch);
+}
+
+/** @brief zwraca pamięć pomocniczą wywołującego wątku, tworzy ją przy pierwszym użyciu
+ * Pamięć pomocnicza jest wspólna dla wszystkich gier, więc pochodzi ze sterty,
+ * a nie z alokatora gry.
+ *
+ * @return wskaźnik na pamięć pomocniczą lub NULL jeżeli nie udało się jej zaalokować
+ */
+static search_scratch* get_search_scratch(void){
+	pthread_once(&scratch_key_once, make_scratch_key);
+	search_scratch* s = pthread_getspecific(scratch_key);
+	if(s == NULL){
+		s = malloc(sizeof(search_scratch));
+		if(s == NULL)
+			return NULL;
+		cell_set_init(&s->visited);
+		for(int i=0;i<MAX_FRAGMENTS;i++){
+			s->stacks[i].fields = NULL;
+			s->stacks[i].capacity = 0;
+			s->stacks[i].top = 0;
+		}
+		pthread_setspecific(scratch_key, s);
 	}
-	return r;
+	return s;
 }
 
-/** @brief standardowy stdlib::malloc ale jezeli nie udalo sie zaalokować pamięci wyrzuca exit(1).
- * @param[in] size 	- ilość pamięci w bajtach do zaalokowania
+/** @brief oznacza pole jako odwiedzone przez fragment o zadanej etykiecie
+ * @param[in,out] s 	- pamięć pomocnicza wątku
+ * @param[in] key 	- numer pola
+ * @param[in] tag 	- etykieta fragmentu
  *
- * @return Pointer na blok zaalokowanej pamięci lub kończy działanie programu
- * z flagą 1 jeżeli nie udało się zaalokować
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
  */
-static void* safer_malloc(size_t size){
-	void* r = malloc(size);
-	if(r == NULL)
-		exit (1);
-	else
-		return r;
+static bool mark_visited(search_scratch* s, uint64_t key, uint8_t tag){
+	return cell_set_put(&s->visited, key, tag);
+}
 
+/** @brief zapewnia miejsce na stosie na co najmniej n pól
+ * @param[in,out] st 	- stos
+ * @param[in] n 	- wymagany rozmiar stosu
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool reserve_fields(field_stack* st, uint64_t n){
+	if(n <= st->capacity)
+		return true;
+	uint64_t capacity = st->capacity == 0? 64 : 2*st->capacity;
+	while(capacity < n)
+		capacity *= 2;
+	if(capacity > SIZE_MAX/sizeof(uint64_t))
+		return false;
+	uint64_t* fields = realloc(st->fields, capacity*sizeof(uint64_t));
+	if(fields == NULL)
+		return false;
+	if(huge_pages_requested())
+		huge_advise(fields, capacity*sizeof(uint64_t));
+	st->fields = fields;
+	st->capacity = capacity;
+	return true;
+}
+
+/** @brief odkłada pole na stos, powiększając go w razie potrzeby
+ * @param[in,out] st 	- stos
+ * @param[in] key 	- numer odkładanego pola
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool push_field(field_stack* st, uint64_t key){
+	if(st->top == st->capacity && !reserve_fields(st, st->top+1))
+		return false;
+	st->fields[st->top++] = key;
+	return true;
+}
+
+/** @brief odkłada pole na stos, na którym zarezerwowano już dla niego miejsce
+ * @param[in,out] st 	- stos o rozmiarze większym niż liczba pól na nim
+ * @param[in] key 	- numer odkładanego pola
+ */
+static void push_reserved_field(field_stack* st, uint64_t key){
+	st->fields[st->top++] = key;
+}
+
+/** @brief zdejmuje pole ze szczytu niepustego stosu
+ * @param[in,out] st 	- stos
+ *
+ * @return numer zdjętego pola
+ */
+static uint64_t pop_field(field_stack* st){
+	return st->fields[--st->top];
 }
 
 /** @brief Zadaje numeryczny odpowiednik kierunków świata (E,N,W,S) na osi OX.
@@ -57,36 +172,81 @@ static const int directions_x[4]={1,0,-1,0};
 */
 static const int directions_y[4]={0,1,0,-1};
 
-/** @brief Struktura reprezentująca pole na planszy.
- * utożsamiamy colour = area_id w niektórych opisach
+/** @brief Struktura przechowująca stan wszystkich graczy.
+ * Każdy parametr gracza trzymamy w osobnej tablicy indeksowanej id gracza
+ * (długości no_players+1), a sumy po wszystkich graczach aktualizujemy przy
+ * każdej zmianie, żeby odpowiadać na pytania o nie w czasie stałym.
  */
 typedef struct{
-	uint32_t player_id; 	///< id gracza zajmującego pole
-	uint32_t area_id; 	///< id obszaru do którego należy pole
-} field;
-
-/** @brief Struktura reprezentująca gracza.
- * utożsamiamy colour = area_id w niektórych opisach
+	uint64_t* no_busy_fields; 	///< liczba zajętych pól przez gracza
+	uint32_t* no_areas_used; 	///< liczba obszarów gracza
+	bool* golden_move_used; 	///< true jeśli golden_move został wykonany, false wpp
+	uint64_t total_busy_fields; 	///< suma no_busy_fields po wszystkich graczach
+	uint32_t no_players_with_fields;///< liczba graczy z niezerowym no_busy_fields
+	uint32_t capacity; 		///< liczba graczy, dla których starcza tablic
+} player_table;
+
+/** @brief Struktura przydzielająca kolory (area_id) obszarom wszystkich graczy.
+ * Kolory są wspólne dla całej gry, kolor 0 oznacza puste pole. Dla każdego
+ * koloru pamiętamy rozmiar obszaru, dzięki czemu przy łączeniu obszarów
+ * przemalowujemy mniejsze, a przy rozcinaniu nowe kolory dostają mniejsze
+ * fragmenty. Kolory zwolnionych obszarów trafiają na stos i są używane ponownie.
  */
 typedef struct{
-	bool* does_area_exist; 		///< tablica booli mówiąca czy i-ty obszar istnieje
-	uint64_t no_busy_fields; 	///< liczba zajętych pól przez gracza
-	bool golden_move_used; 		///< true jeśli golden_move został wykonany, false wpp
-	uint32_t no_areas_used; 	///< liczba wystąpieć wartości true w bool[] does_area_exist
-	uint32_t first_free_colour; 	///< zwraca id pierwszego nieużytego jeszcze obszaru
-} player;
+	uint64_t* size; 	///< liczba pól obszaru o danym kolorze, 0 dla wolnego koloru
+	uint32_t* free; 	///< stos zwolnionych kolorów
+	uint32_t no_free; 	///< liczba kolorów na stosie free
+	uint32_t no_labels; 	///< liczba wydanych kolorów, mają one numery [1, no_labels]
+	uint32_t capacity; 	///< rozmiar tablic size i free
+} area_labels;
+
+/** @brief Struktura puli gier.
+ * Odpowiada typowi gamma_pool_t z gamma.h.
+ */
+typedef struct gamma_pool gamma_pool_t;
 
 /** @brief Struktura przechowująca stan gry
  */
 typedef struct{
-	field** board; 		///< 2-wymiarowa tablica pól czyli plansza
+	tiled_board board; 	///< plansza, utożsamiamy colour = area_id pola w niektórych opisach
 	uint32_t width; 	///< szerokość planszy
 	uint32_t height; 	///< wysokość planszy
 	uint32_t no_players; 	///< liczba graczy uczestniczących w grze
 	uint32_t max_no_areas; 	///< maksymalna liczba obszerów jaką może zająć gracz w danej grze
-	player* playerlist; 	///< lista graczy uczestniczących w grze
+	player_table players; 	///< stan graczy uczestniczących w grze
+	area_labels labels; 	///< kolory obszarów wszystkich graczy
+	allocator alloc; 	///< alokator planszy, tablic graczy i kolorów
+	allocator base; 	///< alokator pamięci tymczasowej zapytań, porcji areny
+				///< i spakowanej planszy
+	arena* arena; 		///< arena, w której leży cała gra, lub NULL
+	mapped_file* mapped; 	///< plik z odwzorowanym stanem gry lub NULL
+	gamma_pool_t* pool; 	///< pula, do której gra wraca w gamma_delete, lub NULL
+	void* next_idle; 	///< następna nieużywana gra tej samej klasy w puli
+	uint8_t* packed; 	///< plansza spakowana przez gamma_compact lub NULL,
+				///< kafelki, katalog i kolory są wtedy zwolnione
+	uint64_t packed_size; 	///< długość spakowanej planszy w bajtach
+	bool touched; 		///< true jeżeli grę używano od ostatniego gamma_compact_idle
+	rw_lock* lock; 		///< zamek trybu współbieżnego lub NULL
 } gamma_t;
 
+/** @brief liczba klas rozmiaru gier w puli
+ */
+#define POOL_CLASSES 64
+
+/** @brief Struktura puli gier.
+ * Wszystkie gry puli przydzielają pamięć z jednej puli bloków pogrupowanych
+ * według długości. Usunięta gra czeka na liście swojej klasy rozmiaru
+ * i jest czyszczona przez gamma_reset dopiero przy ponownym użyciu.
+ */
+struct gamma_pool{
+	allocator base; 		///< alokator, z którego pochodzi pula
+	slab_pool* slabs; 		///< pula bloków wszystkich gier
+	board_layout layout; 		///< układ pól planszy gier puli
+	gamma_t* idle[POOL_CLASSES]; 	///< nieużywane gry według klasy rozmiaru planszy
+	uint64_t no_games; 		///< liczba gier puli, używanych i nieużywanych
+	uint64_t no_idle; 		///< liczba nieużywanych gier
+};
+
 /** @brief zwraca true jeśli gracz zajął już maksymalną liczbe obszarów, false wpp
  * param[in] g 		- wskaźnik na strukturę opisującą stan gry
  * param[in] player 	- id gracza, o którego pytamy
@@ -94,7 +254,7 @@ typedef struct{
  * @return true jeżeli gracz zajął już wszystkie dostępne obszary, false wpp
  */
 static bool player_all_areas_used(gamma_t *g, uint32_t player){
-	return (g->playerlist)[player].no_areas_used == g->max_no_areas;
+	return g->players.no_areas_used[player] == g->max_no_areas;
 }
 
 /** @brief zwraca pole o współżędnych x,y z gry g
@@ -105,7 +265,7 @@ static bool player_all_areas_used(gamma_t *g, uint32_t player){
  * @return pole o współrzędnych kartezjańskich (x,y) z planszy w grze g
  */
 static field get_field(gamma_t *g, uint32_t x, uint32_t y){
-	return (g->board)[y][x];
+	return board_get(&g->board, x, y);
 }
 
 /** @brief zwraca wysokość planszy z gry g
@@ -126,13 +286,24 @@ uint32_t get_width(gamma_t* g){
 	return g->width;
 }
 
+/** @brief zwraca numer pola (x, y) używany w pamięci pomocniczej
+ * param[in] g  - wskaźnik na strukturę opisującą stan gry
+ * param[in] x  - odcięta pola
+ * param[in] y  - rzędna pola
+ *
+ * @return y*width+x
+ */
+static uint64_t field_key(gamma_t* g, uint32_t x, uint32_t y){
+	return (uint64_t)y*get_width(g)+x;
+}
+
 /** @brief zwraca objętość planszy z gry g
  * param[in] g  - wskaźnik na strukturę opisującą stan gry
  *
  * @return objętość planszy (width*height) z gry g
  */
 static uint64_t board_size(gamma_t* g){
-	return get_height(g)*get_width(g);
+	return (uint64_t)get_height(g)*get_width(g);
 }
 
 /** @brief ustala wartość area_id pola o wskazanych koordynatach na zadaną wartość
@@ -140,9 +311,10 @@ static uint64_t board_size(gamma_t* g){
  * param[in] x 		- odcięta pola, które modyfikujemy
  * param[in] y 		- rzędna pola, które modyfikujemy
  * param[in] colour 	- kolor na który malujemy pole, czyli wartość area_id, którą chcemy nadać
+ * Kafelek pola musi już istnieć, jego przydział zapewnia reserve_move.
  */
 static void set_area_id(gamma_t *g, uint32_t x, uint32_t y, uint32_t colour){
-	(g->board)[y][x].area_id = colour;
+	board_set_area(&g->board, x, y, colour);
 }
 
 /** @brief ustala wartość player_id pola o wskazanych koordynatach na zadaną wartość
@@ -150,25 +322,26 @@ static void set_area_id(gamma_t *g, uint32_t x, uint32_t y, uint32_t colour){
  * param[in] x 		- odcięta pola, które modyfikujemy
  * param[in] y 		- rzędna pola, które modyfikujemy
  * param[in] player 	- wartość player_id, którą nadajemy polu
+ * Kafelek pola musi już istnieć, jego przydział zapewnia reserve_move.
  */
 static void set_player_id(gamma_t* g, uint32_t x, uint32_t y, uint32_t player){
-	(g->board)[y][x].player_id = player;
+	board_set_player(&g->board, x, y, player);
 }
 
-/** @brief zwiększa wartość player.no_areas_used o 1
+/** @brief zwiększa wartość players.no_areas_used[player] o 1
  * param[in] g  	- wskaźnik na strukturę opisującą stan gry
  * param[in] player 	- id gracza, którego modyfikujemy
  */
 static void increase_player_no_areas_used(gamma_t* g, uint32_t player){
-	(g->playerlist)[player].no_areas_used++;
+	g->players.no_areas_used[player]++;
 }
 
-/** @brief zmniejsza wartość player.no_areas_used o 1
+/** @brief zmniejsza wartość players.no_areas_used[player] o 1
  * param[in] g  	- wskaźnik na strukturę opisującą stan gry
  * param[in] player 	- id gracza, którego modyfikujemy
  */
 static void decrease_player_no_areas_used(gamma_t* g, uint32_t player){
-	(g->playerlist)[player].no_areas_used--;
+	g->players.no_areas_used[player]--;
 }
 
 /** @brief zwraca wartość liczbę użytych obszarów przez gracza
@@ -178,66 +351,107 @@ static void decrease_player_no_areas_used(gamma_t* g, uint32_t player){
  * @return liczba użytych już obszarów przez gracza
  */
 static uint32_t get_player_no_areas_used(gamma_t* g, uint32_t player){
-	return (g->playerlist)[player].no_areas_used;
+	return g->players.no_areas_used[player];
 }
 
-/** @brief zwraca pierwszy wolny kolor (area_id), na które możemy pomalować nowy obszar
- * zwraca poprawną wartość tylko w przypadku, gdy jeszcze nie wszystkie obszary zostały wykorzystane
+/** @brief początkowy rozmiar tablic area_labels
+ */
+#define INITIAL_LABELS_CAPACITY 16
+
+/** @brief zwraca rozmiar obszaru o zadanym kolorze
  * param[in] g  	- wskaźnik na strukturę opisującą stan gry
- * param[in] player 	- id gracza, o którego pytamy
+ * param[in] colour 	- kolor obszaru
  *
- * @return pierwszy wolny kolor, na który możemy pomalować nowy obszar
+ * @return liczba pól obszaru
  */
-static uint32_t get_player_first_free_colour(gamma_t* g, uint32_t player){
-	return (g->playerlist)[player].first_free_colour;
+static uint64_t get_area_size(gamma_t* g, uint32_t colour){
+	return g->labels.size[colour];
 }
 
-
-/** @brief ustawia wartość player.first_free_colour na zadaną wartość
+/** @brief ustawia rozmiar obszaru o zadanym kolorze
  * param[in] g  	- wskaźnik na strukturę opisującą stan gry
- * param[in] player 	- id gracza, którego modyfikujemy
- * param[in] value 	- wartość jaką chcemy nadać zmiennej first_free_colour
+ * param[in] colour 	- kolor obszaru
+ * param[in] size 	- nowy rozmiar obszaru
  */
-static void set_player_first_free_colour(gamma_t* g, uint32_t player, 
-					 uint32_t value){
-	(g->playerlist)[player].first_free_colour = value;
+static void set_area_size(gamma_t* g, uint32_t colour, uint64_t size){
+	g->labels.size[colour] = size;
 }
 
-/** @brief ustawia wartość player.does_area_exist[area_id] na zadaną wartość
+/** @brief powiększa tablice area_labels dwukrotnie
  * param[in] g  	- wskaźnik na strukturę opisującą stan gry
- * param[in] player 	- id gracza, którego modyfikujemy
- * param[in] area_id 	- indeks w tablicy does_area_exist, który chcemy zmienić
- * param[in] value 	- wartość jaką chcemy nadać zmiennej does_area_exist[area_id]
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci lub kolorów
  */
-static void set_player_does_area_exist(gamma_t* g, uint32_t player, 
-				uint32_t area_id, bool value){
-	(g->playerlist)[player].does_area_exist[area_id] = value;
+static bool grow_labels(gamma_t* g){
+	area_labels* l = &g->labels;
+	if(l->capacity == UINT32_MAX)
+		return false;
+	uint64_t capacity = l->capacity == 0? INITIAL_LABELS_CAPACITY : 2*(uint64_t)l->capacity;
+	if(capacity > UINT32_MAX)
+		capacity = UINT32_MAX;
+	uint64_t* size = allocator_alloc(&g->alloc, capacity*sizeof(uint64_t));
+	uint32_t* free_stack = allocator_alloc(&g->alloc, capacity*sizeof(uint32_t));
+	if(size == NULL || free_stack == NULL){
+		allocator_free(&g->alloc, size, capacity*sizeof(uint64_t));
+		allocator_free(&g->alloc, free_stack, capacity*sizeof(uint32_t));
+		return false;
+	}
+	if(l->capacity > 0){
+		memcpy(size, l->size, l->capacity*sizeof(uint64_t));
+		memcpy(free_stack, l->free, l->no_free*sizeof(uint32_t));
+		allocator_free(&g->alloc, l->size, l->capacity*sizeof(uint64_t));
+		allocator_free(&g->alloc, l->free, l->capacity*sizeof(uint32_t));
+	}
+	l->size = size;
+	l->free = free_stack;
+	l->capacity = capacity;
+	if(g->board.huge_pages){
+		huge_advise(size, capacity*sizeof(uint64_t));
+		huge_advise(free_stack, capacity*sizeof(uint32_t));
+	}
+	return true;
 }
 
-/** @brief zwraca true jeżeli obszar o zadanym id jest już w użyciu, false wpp
+/** @brief zapewnia, że kolejne n wywołań new_area_label się powiedzie
  * param[in] g  	- wskaźnik na strukturę opisującą stan gry
- * param[in] player 	- id gracza, o którego pytamy
- * param[in] area	- id obszaru, o który pytamy
- * param[in] value 	- wartość jaką chcemy nadać zmiennej does_area_exist[area_id]
+ * param[in] n 		- liczba potrzebnych kolorów
  *
- * @return true jeżeli obszar o zadanym id jest już w użyciu, false wpp 
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci lub kolorów
  */
-static bool get_player_does_area_exist(gamma_t* g, uint32_t player, uint32_t area){
-	return (g->playerlist)[player].does_area_exist[area];
+static bool reserve_area_labels(gamma_t* g, uint32_t n){
+	area_labels* l = &g->labels;
+	while((uint64_t)l->no_free+l->capacity-1-l->no_labels < n){
+		if(!grow_labels(g))
+			return false;
+	}
+	return true;
 }
 
-/** @brief ustawia wartość player.first_free_colour na następny pierwszy wolny kolor
+/** @brief przydziela nieużywany kolor nowemu obszarowi o rozmiarze 0
+ * Wolny kolor musi być zarezerwowany przez reserve_area_labels.
  * param[in] g  	- wskaźnik na strukturę opisującą stan gry
- * param[in] player 	- id gracza, którego modyfikujemy
+ *
+ * @return nowy kolor
  */
-static void move_player_first_free_colour(gamma_t* g, uint32_t player){
-	if(!player_all_areas_used(g, player)){
-		uint32_t iterator = get_player_first_free_colour(g, player);	
-		while(get_player_does_area_exist(g, player, iterator)){
-			iterator = (iterator+1)%(g->max_no_areas);
-		}
-		set_player_first_free_colour(g, player, iterator);
+static uint32_t new_area_label(gamma_t* g){
+	area_labels* l = &g->labels;
+	uint32_t colour;
+	if(l->no_free > 0){
+		colour = l->free[--l->no_free];
+	} else{
+		colour = ++l->no_labels;
 	}
+	set_area_size(g, colour, 0);
+	return colour;
+}
+
+/** @brief zwalnia kolor obszaru, który przestał istnieć
+ * param[in] g  	- wskaźnik na strukturę opisującą stan gry
+ * param[in] colour 	- zwalniany kolor
+ */
+static void release_area_label(gamma_t* g, uint32_t colour){
+	set_area_size(g, colour, 0);
+	g->labels.free[g->labels.no_free++] = colour;
 }
 
 /** @brief zwraca true jeżeli gracz użył już golden_move w danej grze
@@ -247,32 +461,38 @@ static void move_player_first_free_colour(gamma_t* g, uint32_t player){
  * @return true jeżeli gracz użył już golden_move w danej grze
  */
 static bool get_player_golden_move_used(gamma_t* g, uint32_t player){
-	return (g->playerlist)[player].golden_move_used;
+	return g->players.golden_move_used[player];
 }
 
-/** @brief ustawia wartość player.golden_mode_used na zadaną wartość
+/** @brief ustawia wartość players.golden_move_used[player] na zadaną wartość
  * param[in] g  	- wskaźnik na strukturę opisującą stan gry
  * param[in] player 	- id gracza, o którego modyfikujemy
- * param[in] value 	- wartość, którą nadajemy player.player_golden_move_used
+ * param[in] value 	- wartość, którą nadajemy players.golden_move_used[player]
  */
 static void set_player_golden_move_used(gamma_t* g, uint32_t player, bool value){
-	(g->playerlist)[player].golden_move_used = value;
+	g->players.golden_move_used[player] = value;
 }
 
-/** @brief zwiększa player.no_busy_fields o 1
+/** @brief zwiększa players.no_busy_fields[player] o 1 i aktualizuje sumy po graczach
  * param[in] g  	- wskaźnik na strukturę opisującą stan gry
  * param[in] player 	- id gracza, którego modyfikujemy
  */
 static void increase_player_no_busy_fields(gamma_t* g, uint32_t player){
-	(g->playerlist)[player].no_busy_fields++;
+	if(g->players.no_busy_fields[player] == 0)
+		g->players.no_players_with_fields++;
+	g->players.total_busy_fields++;
+	g->players.no_busy_fields[player]++;
 }
 
-/** @brief zmniejsza player.no_busy_fields o 1
+/** @brief zmniejsza players.no_busy_fields[player] o 1 i aktualizuje sumy po graczach
  * param[in] g  	- wskaźnik na strukturę opisującą stan gry
  * param[in] player 	- id gracza, którego modyfikujemy
  */
 static void decrease_player_no_busy_fields(gamma_t* g, uint32_t player){
-	(g->playerlist)[player].no_busy_fields--;
+	g->players.no_busy_fields[player]--;
+	g->players.total_busy_fields--;
+	if(g->players.no_busy_fields[player] == 0)
+		g->players.no_players_with_fields--;
 }
 
 /** @brief zwraca liczbę zajętych pól przez gracza
@@ -282,7 +502,7 @@ static void decrease_player_no_busy_fields(gamma_t* g, uint32_t player){
  * @return liczba zajętych pól przez gracza
  */
 static uint64_t get_player_no_busy_fields(gamma_t* g, uint32_t player){
-	return (g->playerlist)[player].no_busy_fields;
+	return g->players.no_busy_fields[player];
 }
 
 /** @brief zwraca liczbę graczy uczestniczących w grze
@@ -345,43 +565,209 @@ static bool player_fit_the_range(gamma_t* g, uint32_t player){
 	return (player>0 && player<=get_no_players(g));
 }
 
-/** @brief zwalnia pamięć zaalokowaną na planszę dla danej gry
+/** @brief zwalnia pamięć zaalokowaną na tablice graczy
+ * param[in] table  - zwalniane tablice graczy
+ * param[in] alloc  - alokator, z którego pochodzą tablice
+ */
+static void free_player_table(player_table* table, const allocator* alloc){
+	uint64_t n = (uint64_t)table->capacity+1;
+	allocator_free(alloc, table->no_busy_fields, n*sizeof(uint64_t));
+	allocator_free(alloc, table->no_areas_used, n*sizeof(uint32_t));
+	allocator_free(alloc, table->golden_move_used, n*sizeof(bool));
+}
+
+/** @brief zwalnia pamięć zaalokowaną na graczy i kolory obszarów dla danej gry
  * param[in] g  - wskaźnik na strukturę opisującą stan gry
  */
-static void free_board(gamma_t* g){
-	if(g != NULL && g->board != NULL){
-		for(uint32_t i=0;i<g->height;i++){
-			if(g->board[i] != NULL)
-				free(g->board[i]);
-		}
-		free(g->board);
+static void free_player_list(gamma_t* g){
+	if(g != NULL){
+		free_player_table(&g->players, &g->alloc);
+		allocator_free(&g->alloc, g->labels.size, g->labels.capacity*sizeof(uint64_t));
+		allocator_free(&g->alloc, g->labels.free, g->labels.capacity*sizeof(uint32_t));
 	}
 }
 
-/** @brief zwalnia pamięć zaalokowaną na listę graczy i każdego z graczy dla danej gry
+/** @brief zwalnia całą pamięć gry poza plikiem z odwzorowanym stanem
+ * Gra w arenie leży w niej w całości, więc wystarczy zwolnić arenę.
  * param[in] g  - wskaźnik na strukturę opisującą stan gry
  */
-static void free_player_list(gamma_t* g){
-	if(g != NULL && g->playerlist != NULL){
-		for(uint32_t i=0;i<=g->no_players;i++){
-			if(((g->playerlist)[i]).does_area_exist != NULL)
-				free(((g->playerlist)[i]).does_area_exist);
-		}
-		free(g->playerlist);
+static void free_game_state(gamma_t* g){
+	if(g->arena != NULL){
+		arena_delete(g->arena);
+		return;
+	}
+	allocator base = g->base;
+	allocator_free(&base, g->packed, g->packed_size);
+	board_free(&g->board);
+	free_player_list(g);
+	allocator_free(&base, g, sizeof(gamma_t));
+}
+
+/** @brief napis rozpoczynający poprawny plik z odwzorowanym stanem gry
+ */
+#define MAPPED_MAGIC "GAMMAMAP"
+
+/** @brief wersja formatu pliku z odwzorowanym stanem gry
+ */
+#define MAPPED_VERSION 1
+
+/** @brief Struktura opisująca kafelek zapisany w pliku z odwzorowanym stanem gry.
+ */
+typedef struct{
+	uint64_t offset; 	///< położenie kafelka w pliku
+	uint32_t tile_x; 	///< numer kolumny kafelków
+	uint32_t tile_y; 	///< numer wiersza kafelków
+} mapped_tile_entry;
+
+/** @brief Nagłówek pliku z odwzorowanym stanem gry.
+ * Leży na początku pliku, tablice stanu gry wskazujemy ich położeniem w pliku.
+ * Nagłówek zapisujemy w gamma_delete, a w trakcie gry magic jest wyzerowany,
+ * więc pliku nieprawidłowo zamkniętej gry nie da się otworzyć ponownie.
+ */
+typedef struct{
+	char magic[8]; 				///< MAPPED_MAGIC bez kończącego zera
+	uint32_t version; 			///< MAPPED_VERSION
+	uint32_t width; 			///< szerokość planszy
+	uint32_t height; 			///< wysokość planszy
+	uint32_t no_players; 			///< liczba graczy
+	uint32_t max_no_areas; 			///< maksymalna liczba obszarów gracza
+	uint32_t layout; 			///< układ pól wewnątrz kafelków
+	uint64_t used; 				///< pierwszy nieprzydzielony bajt pliku
+	uint64_t no_busy_fields; 		///< położenie tablicy players.no_busy_fields
+	uint64_t no_areas_used; 		///< położenie tablicy players.no_areas_used
+	uint64_t golden_move_used; 		///< położenie tablicy players.golden_move_used
+	uint64_t total_busy_fields; 		///< players.total_busy_fields
+	uint32_t no_players_with_fields; 	///< players.no_players_with_fields
+	uint32_t no_free; 			///< labels.no_free
+	uint32_t no_labels; 			///< labels.no_labels
+	uint32_t labels_capacity; 		///< labels.capacity
+	uint64_t label_size; 			///< położenie tablicy labels.size
+	uint64_t label_free; 			///< położenie tablicy labels.free
+	uint64_t tiles; 			///< położenie tablicy opisów kafelków
+	uint64_t no_tiles; 			///< liczba kafelków planszy
+} mapped_header;
+
+/** @brief zapisuje w nagłówku pliku stan gry, który nie leży w tablicach w pliku
+ * Dopisuje do pliku opisy kafelków, dzięki którym przy ponownym otwarciu
+ * odbudowujemy katalog kafelków bez czytania samych kafelków.
+ * @param[in] g 	- wskaźnik na strukturę przechowującą stan gry w pliku
+ *
+ * @return true jeżeli się udało, false jeżeli nie udało się powiększyć pliku
+ */
+static bool save_mapped_state(gamma_t* g){
+	mapped_file* m = g->mapped;
+	tiled_board* b = &g->board;
+	mapped_tile_entry* entries = mapped_alloc(m, b->no_tiles*sizeof(mapped_tile_entry));
+	if(entries == NULL)
+		return false;
+	for(uint64_t i=0;i<b->no_tiles;i++){
+		entries[i].offset = mapped_offset(m, b->tiles[i]);
+		entries[i].tile_x = b->tiles[i]->tile_x;
+		entries[i].tile_y = b->tiles[i]->tile_y;
+	}
+	mapped_header* h = mapped_pointer(m, 0, sizeof(mapped_header));
+	h->version = MAPPED_VERSION;
+	h->width = g->width;
+	h->height = g->height;
+	h->no_players = g->no_players;
+	h->max_no_areas = g->max_no_areas;
+	h->layout = b->layout;
+	h->no_busy_fields = mapped_offset(m, g->players.no_busy_fields);
+	h->no_areas_used = mapped_offset(m, g->players.no_areas_used);
+	h->golden_move_used = mapped_offset(m, g->players.golden_move_used);
+	h->total_busy_fields = g->players.total_busy_fields;
+	h->no_players_with_fields = g->players.no_players_with_fields;
+	h->no_free = g->labels.no_free;
+	h->no_labels = g->labels.no_labels;
+	h->labels_capacity = g->labels.capacity;
+	h->label_size = mapped_offset(m, g->labels.size);
+	h->label_free = mapped_offset(m, g->labels.free);
+	h->tiles = mapped_offset(m, entries);
+	h->no_tiles = b->no_tiles;
+	h->used = m->used;
+	memcpy(h->magic, MAPPED_MAGIC, sizeof(h->magic));
+	return true;
+}
+
+/** @brief zwraca klasę rozmiaru gry w puli
+ * Gry jednej klasy mają podobną liczbę kafelków, więc gamma_reset zwykle nie
+ * musi przydzielać dla nich nowego katalogu kafelków.
+ * @param[in] width 	– szerokość planszy
+ * @param[in] height 	– wysokość planszy
+ *
+ * @return liczba bitów liczby kafelków planszy
+ */
+static uint32_t pool_class(uint32_t width, uint32_t height){
+	uint64_t tiles = (((uint64_t)width+TILE_MASK) >> TILE_SHIFT)*
+			 (((uint64_t)height+TILE_MASK) >> TILE_SHIFT);
+	uint32_t bits = 0;
+	while(tiles > 0){
+		bits++;
+		tiles >>= 1;
 	}
+	return bits;
+}
+
+/** @brief odkłada grę z puli na listę nieużywanych gier jej klasy, w czasie stałym
+ * @param[in] g 	– wskaźnik na grę z puli
+ */
+static void release_pooled_game(gamma_t* g){
+	gamma_pool_t* pool = g->pool;
+	uint32_t c = pool_class(g->width, g->height);
+	g->next_idle = pool->idle[c];
+	pool->idle[c] = g;
+	pool->no_idle++;
+}
+
+/** @brief usuwa grę w pliku, której stan jest już zapisany w nagłówku
+ * @param[in] g 	- wskaźnik na strukturę przechowującą stan gry w pliku
+ *
+ * @return true jeżeli zapis pliku na dysk się powiódł, false wpp
+ */
+static bool close_mapped_game(gamma_t* g){
+	mapped_file* mapped = g->mapped;
+	rw_lock_delete(g->lock);
+	free_game_state(g);
+	bool success = mapped_close(mapped);
+	free(mapped);
+	return success;
+}
+
+/** @brief Zamyka grę otwartą przez gamma_open_mapped, zapisując jej stan w pliku.
+ * Jeżeli nie udało się dopisać do pliku opisów kafelków, gra zostaje
+ * otwarta, a plik nie zawiera jeszcze poprawnie zamkniętej gry.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli stan gry jest zapisany na dysku, a @p false,
+ * gdy @p g nie jest grą w pliku, nie udało się powiększyć pliku - gra
+ * pozostaje wtedy otwarta - lub zapis na dysk się nie powiódł.
+ */
+bool gamma_close_mapped(gamma_t* g){
+	if(g == NULL || g->mapped == NULL || !save_mapped_state(g))
+		return false;
+	return close_mapped_game(g);
 }
 
 /** @brief Usuwa strukturę przechowującą stan gry.
  * Usuwa z pamięci strukturę wskazywaną przez @p g.
  * Nic nie robi, jeśli wskaźnik ten ma wartość NULL.
+ * Stan gry otwartej przez gamma_open_mapped zapisuje w pliku jak
+ * gamma_close_mapped, ale pomija błąd zapisu, a grę z puli oddaje do puli.
  * @param[in] g       – wskaźnik na usuwaną strukturę.
  */
 void gamma_delete(gamma_t* g){
+	if(g != NULL && g->mapped != NULL){
+		save_mapped_state(g);
+		close_mapped_game(g);
+		return;
+	}
 	if(g != NULL){
-		free_board(g);
-		free_player_list(g);
-		free(g);
+		rw_lock_delete(g->lock);
+		g->lock = NULL;
 	}
+	if(g != NULL && g->pool != NULL)
+		release_pooled_game(g);
+	else if(g != NULL)
+		free_game_state(g);
 }
 
 /** @brief sprawdza czy zadany input spełnia założenia gamma_new
@@ -402,96 +788,45 @@ static bool gamma_new_valid_input(uint32_t width, uint32_t height,
 	return flague;
 }
 
-/** @brief alokuje pamięć na planszę, ustala success na false jeżeli się nie udało
- * param[in] width 	- szerokość
- * param[in] height 	- wysokość
+/** @brief tworzy tablice graczy z domyślymi wartościami startowymi
+ * (zero zajętych pól i obszarów, niewykorzystany złoty ruch)
+ * param[in] players 	- liczba graczy w grze
+ * param[in] alloc 	- alokator tablic
+ * param[in] huge_pages - true jeżeli tablice mają leżeć na dużych stronach
  * param[in] success 	- referencja do flagi mówiącej czy wszystkie procesy zakończyły się powodzeniem
  *
- * @return wskaźnik na utworzoną planszę
- */
-static field** alloc_board(uint32_t width, uint32_t height, bool* success){
-	field** board = safe_malloc(height*sizeof(field*), success);
-	if(board != NULL){
-		for(uint32_t i=0;i<height;i++){
-			board[i] = safe_malloc(width*sizeof(field), success);
-		}
-	}
-	return board;
-}
-
-/** @brief ustawia wszystkie pola danej planszy na (player_id, area_id) = (0, 0)
- * param[in] board 	- wskaźnik do planszy, którą modyfikujemy
- * param[in] width 	- szerokość
- * param[in] height 	- wysokość
- */
-static void fill_board_with_default_values(field** board, 
-				    	   uint32_t width, uint32_t height){
-	for(uint32_t i=0;i<height;i++){
-		for(uint32_t j=0;j<width;j++){
-			board[i][j].player_id = 0;
-			board[i][j].area_id = 0;
-		}
-	}
-}
-
-/** @brief tworzy planszę z domyślnymi wartościami pól ((0, 0))
- * ustala success na false jeżeli się nie udało
- * param[in] width 	- szerokość
- * param[in] height 	- wysokość
- * param[in] success 	- referencja do flagi mówiącej czy wszystkie procesy zakończyły się powodzeniem
- *
- * @return wskaźnik na utworzoną planszę
- */
-static field** make_board(uint32_t width, uint32_t height, bool* success){
-	field** board = alloc_board(width, height, success);
-	if(*success == true){
-		fill_board_with_default_values(board, width, height);
-	}
-	return board;
-}
-
-/** @brief ustawia początkowe wartości danego gracza
- * param[in] p 		- gracz, którego modyfikujemy
- * param[in] areas 	- liczba dostępnych obszarów dla gracza
- */
-static void set_player_to_default(player* p, uint32_t areas){
- 	p->no_busy_fields = 0;
-	p->golden_move_used = false;
-	p->no_areas_used = 0;
-	p->first_free_colour = 0;
-	for(uint32_t i=0;i<areas;i++){
-		(p->does_area_exist)[i] = false;
+ * @return tablice graczy z domyślnymi wartościami startowymi
+ */
+static player_table make_player_table(uint32_t players, const allocator* alloc,
+				      bool huge_pages, bool* success){
+	player_table table;
+	uint64_t n = (uint64_t)players+1;
+	table.no_busy_fields = allocator_alloc(alloc, n*sizeof(uint64_t));
+	table.no_areas_used = allocator_alloc(alloc, n*sizeof(uint32_t));
+	table.golden_move_used = allocator_alloc(alloc, n*sizeof(bool));
+	table.total_busy_fields = 0;
+	table.no_players_with_fields = 0;
+	table.capacity = players;
+	if(table.no_busy_fields == NULL || table.no_areas_used == NULL ||
+	   table.golden_move_used == NULL)
+		*success = false;
+	else if(huge_pages){
+		huge_advise(table.no_busy_fields, n*sizeof(uint64_t));
+		huge_advise(table.no_areas_used, n*sizeof(uint32_t));
+		huge_advise(table.golden_move_used, n*sizeof(bool));
 	}
+	return table;
 }
 
-/** @brief tworzy i zwraca listę graczy z domyślymi wartościami startowymi
- * param[in] players 	- liczba graczy w grze (długość listy)
- * param[in] areas 	- liczba dostępnych obszarów dla gracza
- * param[in] success 	- referencja do flagi mówiącej czy wszystkie procesy zakończyły się powodzeniem
- *
- * @return wskaźnik na listę graczy z domyślnymi wartościami startowymi
+/** @brief Struktura opisująca, gdzie leży stan tworzonej gry.
  */
-static player* make_playerlist(uint32_t players, uint32_t areas, bool* success){
-	player* playerlist = safe_malloc((players+1)*sizeof(player), success);
-	if(playerlist != NULL){
-		for(uint32_t i=0;i<=players;i++){
-			playerlist[i].does_area_exist = NULL;
-		}
-		for(uint32_t i=0;i<=players;i++){
-			bool* bool_tab = safe_malloc(areas*sizeof(bool), success);
-			if(bool_tab != NULL){
-				playerlist[i].does_area_exist = bool_tab;
-				set_player_to_default(&playerlist[i], areas);
-			} else{
-				for(uint32_t j=0;j<i;j++){
-					free(playerlist[j].does_area_exist);
-				}
-				break;
-			}
-		}
-	}
-	return playerlist;
-}
+typedef struct{
+	board_layout layout; 	///< układ pól wewnątrz kafelków planszy
+	allocator base; 	///< alokator podany przez użytkownika lub sterta
+	bool arena; 		///< true jeżeli cała gra ma leżeć w jednej arenie
+	bool huge_pages; 	///< true jeżeli plansza ma leżeć na dużych stronach
+	mapped_file* mapped; 	///< plik, w którym leży stan gry, lub NULL
+} game_storage;
 
 /** @brief Tworzy strukturę przechowującą stan gry.
  * Alokuje pamięć na nową strukturę przechowującą stan gry.
@@ -503,48 +838,140 @@ static player* make_playerlist(uint32_t players, uint32_t areas, bool* success){
  * @param[in] players – liczba graczy, liczba dodatnia,
  * @param[in] areas   – maksymalna liczba obszarów,
  *                      jakie może zająć jeden gracz.
+ * @param[in] storage – miejsce, w którym leży stan gry
  * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
  * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
  */
 static gamma_t* make_game_state(uint32_t width, uint32_t height,
-			 	uint32_t players, uint32_t areas){
-	bool success = true;
-	field** board = make_board(width, height, &success);
-    player* playerlist = make_playerlist(players, areas, &success);
-	gamma_t* game_state = safe_malloc(sizeof(gamma_t), &success);
-	if(game_state != NULL){
-		game_state->board = board;
-		game_state->width = width;
-		game_state->height = height;
-		game_state->no_players = players;
-		game_state->max_no_areas = areas;
-		game_state->playerlist = playerlist;
+			 	uint32_t players, uint32_t areas,
+				const game_storage* storage){
+	allocator alloc = storage->base;
+	arena* game_arena = NULL;
+	if(storage->mapped != NULL)
+		alloc = mapped_allocator(storage->mapped);
+	else if(storage->arena){
+		game_arena = arena_new(&storage->base);
+		if(game_arena == NULL)
+			return NULL;
+		alloc = arena_allocator(game_arena);
+	}
+	gamma_t* game_state = allocator_alloc(game_arena != NULL? &alloc : &storage->base,
+					      sizeof(gamma_t));
+	if(game_state == NULL){
+		if(game_arena != NULL)
+			arena_delete(game_arena);
+		return NULL;
 	}
+	game_state->alloc = alloc;
+	game_state->base = storage->base;
+	game_state->arena = game_arena;
+	game_state->mapped = storage->mapped;
+	game_state->pool = NULL;
+	game_state->next_idle = NULL;
+	game_state->packed = NULL;
+	game_state->packed_size = 0;
+	game_state->touched = false;
+	game_state->lock = NULL;
+	game_state->width = width;
+	game_state->height = height;
+	game_state->no_players = players;
+	game_state->max_no_areas = areas;
+	game_state->labels.size = NULL;
+	game_state->labels.free = NULL;
+	game_state->labels.no_free = 0;
+	game_state->labels.no_labels = 0;
+	game_state->labels.capacity = 0;
+	bool success = board_init(&game_state->board, width, height, storage->layout,
+				  storage->mapped != NULL? &storage->base : &alloc, &alloc,
+				  storage->huge_pages);
+	game_state->players = make_player_table(players, &alloc,
+						game_state->board.huge_pages, &success);
+	if(success)
+		success = grow_labels(game_state);
 	if(success == false){
-		if(game_state != NULL){
-			gamma_delete(game_state);
-		}
-		else{
-			if(board != NULL){
-				for(uint32_t i=0;i<height;i++){
-					free(board[i]);
-				}
-				free(board);
-			}
-			if(playerlist != NULL){
-				for(uint32_t i=0; i<=players;i++){
-					if(((playerlist)[i]).does_area_exist != NULL)
-						free(((playerlist)[i]).does_area_exist);
-				}
-				free(playerlist);
-			}
-		}
+		free_game_state(game_state);
 		return NULL;
 	}
 
 	return game_state;
 }
 
+/** @brief Układ pól planszy w pamięci.
+ * Odpowiada typowi gamma_layout_t z gamma.h.
+ */
+typedef enum{
+	GAMMA_LAYOUT_ROWS, 	///< pola zapisane wierszami
+	GAMMA_LAYOUT_MORTON, 	///< pola zapisane w porządku Mortona
+} gamma_layout_t;
+
+/** @brief Alokator pamięci podany przez użytkownika.
+ * Odpowiada typowi gamma_allocator_t z gamma.h.
+ */
+typedef allocator gamma_allocator_t;
+
+/** @brief Struktura z dodatkowymi parametrami tworzenia gry.
+ * Odpowiada typowi gamma_params_t z gamma.h.
+ */
+typedef struct{
+	gamma_layout_t layout; 	///< układ pól planszy w pamięci
+	bool huge_pages; 	///< true jeżeli stan gry ma leżeć na dużych stronach
+	const gamma_allocator_t* allocator; ///< alokator stanu gry lub NULL dla sterty
+	bool arena; 		///< true jeżeli cała gra ma leżeć w jednej arenie
+} gamma_params_t;
+
+/** @brief odczytuje z dodatkowych parametrów gry, gdzie ma leżeć jej stan
+ * Duże strony wybrane w params lub zmienną GAMMA_HUGE_PAGES dotyczą tylko gier
+ * na stercie bez areny.
+ * @param[in] params   – dodatkowe parametry lub NULL dla wartości domyślnych
+ * @param[out] storage – miejsce, w którym ma leżeć stan gry
+ *
+ * @return true jeżeli parametry są poprawne, false wpp
+ */
+static bool params_storage(const gamma_params_t* params, game_storage* storage){
+	storage->layout = BOARD_LAYOUT_ROWS;
+	storage->base = heap_allocator;
+	storage->arena = false;
+	storage->huge_pages = huge_pages_requested();
+	storage->mapped = NULL;
+	if(params == NULL)
+		return true;
+	if(params->layout == GAMMA_LAYOUT_MORTON)
+		storage->layout = BOARD_LAYOUT_MORTON;
+	else if(params->layout != GAMMA_LAYOUT_ROWS)
+		return false;
+	if(params->allocator != NULL){
+		if(params->allocator->alloc == NULL || params->allocator->realloc == NULL)
+			return false;
+		storage->base = *params->allocator;
+	}
+	storage->arena = params->arena;
+	storage->huge_pages = (storage->huge_pages || params->huge_pages) &&
+			      params->allocator == NULL && !params->arena;
+	return true;
+}
+
+/** @brief Tworzy strukturę przechowującą stan gry z dodatkowymi parametrami.
+ * Działa jak gamma_new, a params wybiera sposób przechowywania planszy.
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz,
+ * @param[in] params  – dodatkowe parametry lub NULL dla wartości domyślnych.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
+ */
+gamma_t* gamma_new_ex(uint32_t width, uint32_t height,
+		      uint32_t players, uint32_t areas,
+		      const gamma_params_t* params){
+	game_storage storage;
+	if(params_storage(params, &storage) &&
+	   gamma_new_valid_input(width, height, players, areas))
+		return make_game_state(width, height, players, areas, &storage);
+	else
+		return NULL;
+}
+
 /** @brief Tworzy strukturę przechowującą stan gry.
  * Alokuje pamięć na nową strukturę przechowującą stan gry.
  * Inicjuje tę strukturę tak, aby reprezentowała początkowy stan gry.
@@ -558,50 +985,434 @@ static gamma_t* make_game_state(uint32_t width, uint32_t height,
  */
 gamma_t* gamma_new(uint32_t width, uint32_t height,
 		   uint32_t players, uint32_t areas){
-	if(gamma_new_valid_input(width, height, players, areas)){
-		gamma_t* game_state = make_game_state(width, height,
-						      players, areas);
-		return game_state;
+	return gamma_new_ex(width, height, players, areas, NULL);
+}
+
+/** @brief sprawdza, czy parametr gamma_open_mapped zgadza się z wartością zapisaną w pliku
+ * @param[in] given 	- wartość parametru, 0 oznacza dowolną
+ * @param[in] stored 	- wartość zapisana w pliku
+ *
+ * @return true jeżeli wartości się zgadzają, false wpp
+ */
+static bool mapped_param_matches(uint32_t given, uint32_t stored){
+	return given == 0 || given == stored;
+}
+
+/** @brief sprawdza tablice graczy gry wczytanej z pliku lub obrazu
+ * Liczby pól i obszarów muszą zgadzać się z sumami zapisanymi osobno, a bajty
+ * golden_move_used czytamy jako liczby, bo inne wartości niż 0 i 1 nie są
+ * poprawnymi wartościami typu bool.
+ * @param[in] g 	- wskaźnik na strukturę przechowującą wczytany stan gry
+ *
+ * @return true jeżeli tablice są poprawne, false wpp
+ */
+static bool players_valid(gamma_t* g){
+	const player_table* t = &g->players;
+	const unsigned char* golden = (const unsigned char*)t->golden_move_used;
+	uint64_t total = 0;
+	uint32_t with_fields = 0;
+	bool flague = true;
+	for(uint32_t p=1;p<=get_no_players(g) && flague;p++){
+		flague = golden[p] <= 1 && t->no_areas_used[p] <= g->max_no_areas &&
+			 t->no_areas_used[p] <= t->no_busy_fields[p] &&
+			 t->no_busy_fields[p] <= board_size(g)-total;
+		total += t->no_busy_fields[p];
+		with_fields += t->no_busy_fields[p] != 0;
 	}
-	else
+	return flague && total == t->total_busy_fields &&
+	       with_fields == t->no_players_with_fields;
+}
+
+/** @brief sprawdza stos zwolnionych kolorów gry wczytanej z pliku lub obrazu
+ * @param[in] g 	- wskaźnik na strukturę przechowującą wczytany stan gry
+ *
+ * @return true jeżeli wszystkie kolory na stosie są wydanymi kolorami, false wpp
+ */
+static bool free_labels_valid(gamma_t* g){
+	const area_labels* l = &g->labels;
+	bool flague = l->no_free <= l->no_labels && l->no_labels < l->capacity;
+	for(uint32_t i=0;i<l->no_free && flague;i++)
+		flague = l->free[i] != 0 && l->free[i] <= l->no_labels;
+	return flague;
+}
+
+/** @brief odtwarza stan gry z poprawnie zamkniętego pliku
+ * Tablice stanu gry zostają w pliku, w pamięci odbudowujemy tylko katalog
+ * kafelków z ich opisów zapisanych w pliku.
+ * @param[in] m       – otwarty plik ze stanem gry
+ * @param[in] width   – szerokość planszy lub 0,
+ * @param[in] height  – wysokość planszy lub 0,
+ * @param[in] players – liczba graczy lub 0,
+ * @param[in] areas   – maksymalna liczba obszarów lub 0.
+ * @return Wskaźnik na strukturę przechowującą stan gry lub NULL, gdy plik
+ * nie jest poprawny, parametry nie zgadzają się z zapisanymi w pliku
+ * lub nie udało się zaalokować pamięci.
+ */
+static gamma_t* load_game_state(mapped_file* m, uint32_t width, uint32_t height,
+				uint32_t players, uint32_t areas){
+	mapped_header* h = mapped_pointer(m, 0, sizeof(mapped_header));
+	if(h == NULL || memcmp(h->magic, MAPPED_MAGIC, sizeof(h->magic)) != 0 ||
+	   h->version != MAPPED_VERSION || h->used > m->size ||
+	   !gamma_new_valid_input(h->width, h->height, h->no_players, h->max_no_areas) ||
+	   !mapped_param_matches(width, h->width) || !mapped_param_matches(height, h->height) ||
+	   !mapped_param_matches(players, h->no_players) ||
+	   !mapped_param_matches(areas, h->max_no_areas) ||
+	   (h->layout != BOARD_LAYOUT_ROWS && h->layout != BOARD_LAYOUT_MORTON) ||
+	   h->no_players_with_fields > h->no_players ||
+	   h->total_busy_fields > (uint64_t)h->width*h->height ||
+	   h->no_labels >= h->labels_capacity || h->no_free > h->no_labels)
+		return NULL;
+	uint64_t n = (uint64_t)h->no_players+1;
+	uint64_t labels = h->labels_capacity;
+	gamma_t* g = allocator_alloc(&heap_allocator, sizeof(gamma_t));
+	if(g == NULL)
+		return NULL;
+	g->alloc = mapped_allocator(m);
+	g->base = heap_allocator;
+	g->arena = NULL;
+	g->mapped = m;
+	g->pool = NULL;
+	g->next_idle = NULL;
+	g->packed = NULL;
+	g->packed_size = 0;
+	g->touched = false;
+	g->lock = NULL;
+	g->width = h->width;
+	g->height = h->height;
+	g->no_players = h->no_players;
+	g->max_no_areas = h->max_no_areas;
+	g->players.no_busy_fields = mapped_pointer(m, h->no_busy_fields, n*sizeof(uint64_t));
+	g->players.no_areas_used = mapped_pointer(m, h->no_areas_used, n*sizeof(uint32_t));
+	g->players.golden_move_used = mapped_pointer(m, h->golden_move_used, n*sizeof(bool));
+	g->players.total_busy_fields = h->total_busy_fields;
+	g->players.no_players_with_fields = h->no_players_with_fields;
+	g->players.capacity = h->no_players;
+	g->labels.size = mapped_pointer(m, h->label_size, labels*sizeof(uint64_t));
+	g->labels.free = mapped_pointer(m, h->label_free, labels*sizeof(uint32_t));
+	g->labels.no_free = h->no_free;
+	g->labels.no_labels = h->no_labels;
+	g->labels.capacity = h->labels_capacity;
+	const mapped_tile_entry* entries = mapped_pointer(m, h->tiles,
+							  h->no_tiles*sizeof(mapped_tile_entry));
+	bool success = board_init(&g->board, h->width, h->height, h->layout,
+				  &g->base, &g->alloc, false) &&
+		       g->players.no_busy_fields != NULL && g->players.no_areas_used != NULL &&
+		       g->players.golden_move_used != NULL && g->labels.size != NULL &&
+		       g->labels.free != NULL && entries != NULL &&
+		       players_valid(g) && free_labels_valid(g);
+	for(uint64_t i=0;i<h->no_tiles && success;i++){
+		tile* t = mapped_pointer(m, entries[i].offset, sizeof(tile));
+		success = t != NULL && entries[i].tile_x < g->board.tiles_x &&
+			  entries[i].tile_y < g->board.tiles_y &&
+			  board_find_tile(&g->board, entries[i].tile_x, entries[i].tile_y) == NULL;
+		if(success){
+			t->tile_x = entries[i].tile_x;
+			t->tile_y = entries[i].tile_y;
+			success = board_insert_tile(&g->board, t);
+		}
+	}
+	if(!success || !mapped_fill_pages(m)){
+		board_free(&g->board);
+		allocator_free(&g->base, g, sizeof(gamma_t));
 		return NULL;
+	}
+	m->used = h->used;
+	memset(h->magic, 0, sizeof(h->magic));
+	return g;
 }
 
-/** @brief zwraca tablicę wartości logicznych reprezentujących sąsiedztwo pola danego gracza z innymi jego polami
- * tablica reprezentuje kierunki świata [0,1,2,3] = [E,N,W,S]
- * tab[i] = true jeżeli w kierunku odpowiadającym i-temu indexowi znajduje się pole gracza.
- * param[in] g  	- wskaźnik na strukturę opisującą stan gry
- * param[in] player  	- id gracza, o którego pytamy
- * param[in] x  	- odcięta pola, o które pytamy
- * param[in] y  	- rzędna pola, o które pytamy
+/** @brief tworzy pustą planszę o nowych wymiarach w miejsce planszy spakowanej przez gamma_compact
+ * Odtwarza też kolory obszarów, spakowaną planszę zwalnia wywołujący.
+ * @param[in,out] g 	– wskaźnik na strukturę przechowującą spakowany stan gry
+ * @param[in] width 	– nowa szerokość planszy
+ * @param[in] height 	– nowa wysokość planszy
  *
- * @return tablica wartości logicznych rozmiaru 4 mówiąca, w których kierunkach są inne pola danego gracza
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci - gra się wtedy nie zmienia
  */
-static bool* player_areas_nearby(gamma_t* g, uint32_t player, 
-				 uint32_t x, uint32_t y){
-	bool* tab = safer_malloc(4*sizeof(bool));
-	bool N = false;
-	bool S = false;
-	bool E = false;
-	bool W = false;
+static bool reset_packed_board(gamma_t* g, uint32_t width, uint32_t height){
+	tiled_board old = g->board;
+	if(!board_init(&g->board, width, height, old.layout, &old.alloc, &old.tile_alloc,
+		       old.huge_pages)){
+		g->board = old;
+		return false;
+	}
+	if(!grow_labels(g)){
+		board_free(&g->board);
+		g->board = old;
+		return false;
+	}
+	return true;
+}
 
-	if(x<g->width-1){
-		E = (get_field(g, x+1, y).player_id == player)? true : false;
+/** @brief Przygotowuje strukturę stanu gry do nowej rozgrywki.
+ * Doprowadza grę do stanu takiego jak po gamma_new z podanymi parametrami,
+ * używając ponownie jej pamięci: zeruje tylko kafelki zajęte w poprzedniej
+ * rozgrywce, a tablice graczy przydziela od nowa tylko wtedy, gdy są za małe.
+ * Układ planszy i sposób przechowywania gry się nie zmieniają.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy któryś
+ * z parametrów jest niepoprawny lub nie udało się zaalokować pamięci -
+ * stan gry się wtedy nie zmienia.
+ */
+bool gamma_reset(gamma_t* g, uint32_t width, uint32_t height,
+		 uint32_t players, uint32_t areas){
+	if(g == NULL || !gamma_new_valid_input(width, height, players, areas))
+		return false;
+	player_table table = g->players;
+	bool grow = players > table.capacity;
+	if(grow){
+		bool success = true;
+		table = make_player_table(players, &g->alloc, g->board.huge_pages, &success);
+		if(!success){
+			free_player_table(&table, &g->alloc);
+			return false;
+		}
 	}
-	if(x>0){
-		W = (get_field(g, x-1, y).player_id == player)? true : false;
+	bool packed = g->packed != NULL;
+	if(packed? !reset_packed_board(g, width, height) : !board_reset(&g->board, width, height)){
+		if(grow)
+			free_player_table(&table, &g->alloc);
+		return false;
 	}
-	if(y<g->height-1){
-		N = (get_field(g, x, y+1).player_id == player)? true : false;
+	if(packed){
+		allocator_free(&g->base, g->packed, g->packed_size);
+		g->packed = NULL;
+		g->packed_size = 0;
 	}
-	if(y>0){
-		S = (get_field(g, x, y-1).player_id == player)? true : false;
+	if(grow)
+		free_player_table(&g->players, &g->alloc);
+	else{
+		uint64_t n = (uint64_t)players+1;
+		memset(table.no_busy_fields, 0, n*sizeof(uint64_t));
+		memset(table.no_areas_used, 0, n*sizeof(uint32_t));
+		memset(table.golden_move_used, 0, n*sizeof(bool));
+		table.total_busy_fields = 0;
+		table.no_players_with_fields = 0;
 	}
-	tab[0] = E;
-	tab[1] = N;
-	tab[2] = W;
-	tab[3] = S;
-	return tab;
+	g->players = table;
+	g->labels.no_free = 0;
+	g->labels.no_labels = 0;
+	g->width = width;
+	g->height = height;
+	g->no_players = players;
+	g->max_no_areas = areas;
+	g->touched = true;
+	return true;
+}
+
+/** @brief Tworzy pulę gier.
+ * @param[in] params  – dodatkowe parametry gier puli lub NULL; pola
+ *                      huge_pages i arena są pomijane.
+ * @return Wskaźnik na pulę lub NULL, gdy nie udało się zaalokować pamięci
+ * lub któryś z parametrów jest niepoprawny.
+ */
+gamma_pool_t* gamma_pool_new(const gamma_params_t* params){
+	game_storage storage;
+	if(!params_storage(params, &storage))
+		return NULL;
+	gamma_pool_t* pool = allocator_alloc(&storage.base, sizeof(gamma_pool_t));
+	if(pool == NULL)
+		return NULL;
+	pool->slabs = slab_pool_new(&storage.base);
+	if(pool->slabs == NULL){
+		allocator_free(&storage.base, pool, sizeof(gamma_pool_t));
+		return NULL;
+	}
+	pool->base = storage.base;
+	pool->layout = storage.layout;
+	return pool;
+}
+
+/** @brief Tworzy grę w puli lub używa ponownie usuniętej gry z puli.
+ * Działa jak gamma_new, ale jeżeli w puli czeka usunięta gra o podobnym
+ * rozmiarze planszy, czyści ją przez gamma_reset zamiast przydzielać pamięć.
+ * @param[in,out] pool – pula gier,
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz.
+ * @return Wskaźnik na grę lub NULL, gdy nie udało się zaalokować pamięci
+ * lub któryś z parametrów jest niepoprawny.
+ */
+gamma_t* gamma_pool_game(gamma_pool_t* pool, uint32_t width, uint32_t height,
+			 uint32_t players, uint32_t areas){
+	if(pool == NULL || !gamma_new_valid_input(width, height, players, areas))
+		return NULL;
+	uint32_t c = pool_class(width, height);
+	gamma_t* g = pool->idle[c];
+	if(g != NULL){
+		if(!gamma_reset(g, width, height, players, areas))
+			return NULL;
+		pool->idle[c] = g->next_idle;
+		pool->no_idle--;
+		g->next_idle = NULL;
+		return g;
+	}
+	game_storage storage = {pool->layout, slab_pool_allocator(pool->slabs), false, false, NULL};
+	g = make_game_state(width, height, players, areas, &storage);
+	if(g != NULL){
+		g->pool = pool;
+		pool->no_games++;
+	}
+	return g;
+}
+
+/** @brief Podaje pamięć zajmowaną przez pulę gier.
+ * @param[in] pool    – pula gier,
+ * @param[out] games  – liczba gier puli, używanych i usuniętych, lub NULL,
+ * @param[out] idle   – liczba usuniętych gier czekających w puli lub NULL.
+ * @return Liczba bajtów pobranych przez pulę lub zero, gdy @p pool jest NULL.
+ */
+uint64_t gamma_pool_memory(gamma_pool_t* pool, uint64_t* games, uint64_t* idle){
+	if(pool == NULL)
+		return 0;
+	if(games != NULL)
+		*games = pool->no_games;
+	if(idle != NULL)
+		*idle = pool->no_idle;
+	return slab_pool_reserved(pool->slabs)+sizeof(gamma_pool_t);
+}
+
+/** @brief Usuwa pulę gier razem z czekającymi w niej usuniętymi grami.
+ * Wszystkie gry puli muszą być wcześniej usunięte przez gamma_delete.
+ * Nic nie robi, jeśli wskaźnik ten ma wartość NULL.
+ * @param[in] pool    – wskaźnik na usuwaną pulę.
+ */
+void gamma_pool_delete(gamma_pool_t* pool){
+	if(pool == NULL)
+		return;
+	for(uint32_t c=0;c<POOL_CLASSES;c++){
+		while(pool->idle[c] != NULL){
+			gamma_t* g = pool->idle[c];
+			pool->idle[c] = g->next_idle;
+			free_game_state(g);
+		}
+	}
+	allocator base = pool->base;
+	slab_pool_delete(pool->slabs);
+	allocator_free(&base, pool, sizeof(gamma_pool_t));
+}
+
+/** @brief Otwiera grę, której stan przechowujemy w pliku odwzorowanym w pamięci.
+ * Jeżeli plik nie istnieje lub jest pusty, tworzy w nim nową grę tak jak
+ * gamma_new_ex. W przeciwnym razie otwiera zapisaną w nim grę, parametry
+ * równe 0 są wtedy pomijane, a pozostałe muszą zgadzać się z zapisanymi.
+ * Niepustego pliku, którego nie udało się otworzyć, nie zmienia.
+ * @param[in] path    – ścieżka do pliku,
+ * @param[in] width   – szerokość planszy,
+ * @param[in] height  – wysokość planszy,
+ * @param[in] players – liczba graczy,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz,
+ * @param[in] params  – dodatkowe parametry nowej gry lub NULL.
+ * @return Wskaźnik na strukturę przechowującą stan gry lub NULL, gdy nie
+ * udało się otworzyć pliku lub zaalokować pamięci, plik nie zawiera
+ * poprawnie zamkniętej gry lub któryś z parametrów jest niepoprawny.
+ */
+gamma_t* gamma_open_mapped(const char* path, uint32_t width, uint32_t height,
+			   uint32_t players, uint32_t areas,
+			   const gamma_params_t* params){
+	game_storage storage;
+	if(path == NULL || !params_storage(params, &storage))
+		return NULL;
+	storage.base = heap_allocator;
+	storage.arena = false;
+	storage.huge_pages = false;
+	mapped_file* m = malloc(sizeof(mapped_file));
+	if(m == NULL)
+		return NULL;
+	gamma_t* g = NULL;
+	mapped_status status = mapped_open(m, path);
+	if(status == MappedOpened){
+		g = load_game_state(m, width, height, players, areas);
+		if(g == NULL)
+			mapped_close(m);
+	}
+	else if(status == MappedMissing && gamma_new_valid_input(width, height, players, areas) &&
+		mapped_create(m, path)){
+		storage.mapped = m;
+		if(mapped_alloc(m, sizeof(mapped_header)) != NULL)
+			g = make_game_state(width, height, players, areas, &storage);
+		if(g == NULL){
+			mapped_close(m);
+			remove(path);
+		}
+	}
+	if(g == NULL)
+		free(m);
+	return g;
+}
+
+/** @brief wartość wpisywana przez neighbour_owners dla kierunku wychodzącego poza planszę
+ */
+#define NO_NEIGHBOUR UINT64_MAX
+
+/** @brief wpisuje do owners id graczy zajmujących pola sąsiednie do (x, y)
+ * Sąsiadów leżących w tym samym kafelku czyta bezpośrednio z kafelka,
+ * bez przeszukiwania katalogu kafelków.
+ * @param[in] g 	- wskaźnik na strukturę przechowującą stan gry
+ * @param[in] t 	- kafelek zawierający pole (x, y)
+ * @param[in] x 	- odcięta pola
+ * @param[in] y 	- rzędna pola
+ * @param[out] owners 	- id graczy w kolejności directions (E, N, W, S), 0 dla wolnego pola,
+ * 			  NO_NEIGHBOUR dla kierunku wychodzącego poza planszę
+ */
+static inline void neighbour_owners(gamma_t* g, const tile* t, uint32_t x, uint32_t y,
+			     uint64_t owners[4]){
+	const tiled_board* b = &g->board;
+	uint32_t lx = x & TILE_MASK;
+	uint32_t ly = y & TILE_MASK;
+	if(x+1 >= get_width(g))
+		owners[0] = NO_NEIGHBOUR;
+	else if(lx+1 < TILE_SIDE)
+		owners[0] = t->fields[board_field_index(b, lx+1, ly)].player_id;
+	else
+		owners[0] = get_field(g, x+1, y).player_id;
+	if(y+1 >= get_height(g))
+		owners[1] = NO_NEIGHBOUR;
+	else if(ly+1 < TILE_SIDE)
+		owners[1] = t->fields[board_field_index(b, lx, ly+1)].player_id;
+	else
+		owners[1] = get_field(g, x, y+1).player_id;
+	if(x == 0)
+		owners[2] = NO_NEIGHBOUR;
+	else if(lx > 0)
+		owners[2] = t->fields[board_field_index(b, lx-1, ly)].player_id;
+	else
+		owners[2] = get_field(g, x-1, y).player_id;
+	if(y == 0)
+		owners[3] = NO_NEIGHBOUR;
+	else if(ly > 0)
+		owners[3] = t->fields[board_field_index(b, lx, ly-1)].player_id;
+	else
+		owners[3] = get_field(g, x, y-1).player_id;
+}
+
+/** @brief wypełnia tablicę wartości logicznych reprezentujących sąsiedztwo pola danego gracza
+ * z innymi jego polami, nie alokuje pamięci
+ * tablica reprezentuje kierunki świata [0,1,2,3] = [E,N,W,S]
+ * param[in] g  	- wskaźnik na strukturę opisującą stan gry
+ * param[in] player  	- id gracza, o którego pytamy
+ * param[in] x  	- odcięta pola, o które pytamy
+ * param[in] y  	- rzędna pola, o które pytamy
+ * param[out] tab 	- tablica rozmiaru 4, tab[i] = true jeżeli w i-tym kierunku jest pole gracza
+ *
+ * @return liczba kierunków, w których są inne pola danego gracza
+ */
+static int fill_player_areas_nearby(gamma_t* g, uint32_t player,
+				    uint32_t x, uint32_t y, bool tab[4]){
+	uint64_t owners[4];
+	neighbour_owners(g, board_lookup_tile(&g->board, x >> TILE_SHIFT, y >> TILE_SHIFT),
+			 x, y, owners);
+	for(int i=0;i<4;i++)
+		tab[i] = owners[i] == player;
+	return tab[0] + tab[1] + tab[2] + tab[3];
 }
 
 /** @brief zwraca true jeżeli w sąsiedztwie danego pola istnieje inne pole danego gracza
@@ -614,12 +1425,24 @@ static bool* player_areas_nearby(gamma_t* g, uint32_t player,
  */
 static bool are_player_areas_nearby(gamma_t* g, uint32_t player, 
 				    uint32_t x, uint32_t y){
-	bool* tab = player_areas_nearby(g, player, x , y);
-	bool flague = false;
-	for(int i=0;i<4;i++){
-		flague = flague || tab[i];
-	}
-	free(tab);
+	bool tab[4];
+	return fill_player_areas_nearby(g, player, x, y, tab) > 0;
+}
+
+/** @brief sprawdza czy poprawny gracz może postawić pionek na polu (x, y)
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player    – id gracza, który ma wykonać ruch
+ * @param[in] x   	– odcięta pola, na które ma zostać wykonany ruch
+ * @param[in] y   	– rzędna pola, na które ma zostać wykonany ruch
+ *
+ * @return zwraca true jeżeli ruch jest legalny, false wpp
+ */
+static bool move_allowed(gamma_t* g, uint32_t player, uint32_t x, uint32_t y){
+	bool flague = true;
+	flague = flague && x_y_fit_the_board(g, x, y);
+	flague = flague && (get_field(g, x, y).player_id == 0);
+	flague = flague && (!player_all_areas_used(g, player) ||
+			    are_player_areas_nearby(g, player, x, y));
 	return flague;
 }
 
@@ -633,22 +1456,14 @@ static bool are_player_areas_nearby(gamma_t* g, uint32_t player,
  */
 static bool gamma_move_valid_input(gamma_t* g, uint32_t player, 
 				   uint32_t x, uint32_t y){
-	bool flague = true;
-	if(g!=NULL){
-		flague = flague && player_fit_the_range(g, player);
-		flague = flague && x_y_fit_the_board(g, x, y);
-		flague = flague && ((g->board)[y][x].player_id == 0);
-		flague = flague && (!player_all_areas_used(g, player) ||
-				    are_player_areas_nearby(g, player, x, y));
-		return flague;
-	}
+	if(g!=NULL)
+		return player_fit_the_range(g, player) && move_allowed(g, player, x, y);
 	else 
 		return false;
 }
 
 /** @brief koloruje dane pole na nowy, jeszcze nie użyty kolor
- * inkrementuje player.no_areas_used
- * po wykonaniu malowania aktualizuje player.first_free_colour
+ * inkrementuje players.no_areas_used[player]
  * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
  * @param[in] player    – id gracza, do którego będzie należeć pokolorowane pole
  * @param[in] x   	– odcięta pola, które kolorujemy
@@ -656,39 +1471,53 @@ static bool gamma_move_valid_input(gamma_t* g, uint32_t player,
  */
 static void colour_new(gamma_t* g, uint32_t player, uint32_t x, uint32_t y){
 	increase_player_no_areas_used(g, player);
-	uint32_t first_free_colour = get_player_first_free_colour(g, player);
-	set_area_id(g, x, y, first_free_colour);
-	set_player_does_area_exist(g, player , first_free_colour, true);
-	if(!player_all_areas_used(g, player)){
-		move_player_first_free_colour(g, player);
-	}
+	uint32_t colour = new_area_label(g);
+	set_area_id(g, x, y, colour);
+	set_area_size(g, colour, 1);
 }
 
 /** @brief koloruje caly obszar na zadany kolor
- * implementacja na podstawie DFS, bez tablicy visited, bo zawsze malujemy na "świerzy" kolor
+ * implementacja na podstawie DFS, bez tablicy visited, bo zawsze malujemy na "świerzy" kolor,
+ * pola do odwiedzenia trzymamy na stosie z pamięci pomocniczej wątku zamiast rekurencji,
+ * miejsce na nim rezerwuje wcześniej reserve_move lub reserve_golden_move
  * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
  * @param[in] player    – id gracza, do którego będzie należeć pokolorowane pole
  * @param[in] x   	– odcięta pola, które kolorujemy
  * @param[in] y   	– rzędna pola, które kolorujemy 
  * @param[in] colour 	- kolor na który kolorujemy obszar 
+ *
+ * @return liczba pokolorowanych pól
  */
-static void colour_area(gamma_t* g, uint32_t player, 
-		 	uint32_t x, uint32_t y, uint32_t colour){
+static uint64_t colour_area(gamma_t* g, uint32_t player, 
+		 	    uint32_t x, uint32_t y, uint32_t colour){
+	field_stack* st = &get_search_scratch()->stacks[0];
+	st->top = 0;
 	set_area_id(g, x, y, colour);
-	bool* tab = player_areas_nearby(g, player, x, y); 
-	for(int i=0;i<4;i++){
-		if(tab[i]){
-			uint32_t new_x = x+directions_x[i];
-			uint32_t new_y = y+directions_y[i];		
-			if(colour != get_field(g, new_x, new_y).area_id){
-				colour_area(g, player, new_x, new_y, colour);
+	push_reserved_field(st, field_key(g, x, y));
+	uint64_t coloured = 1;
+	while(st->top > 0){
+		uint64_t key = pop_field(st);
+		x = key%get_width(g);
+		y = key/get_width(g);
+		bool tab[4];
+		fill_player_areas_nearby(g, player, x, y, tab);
+		for(int i=0;i<4;i++){
+			if(tab[i]){
+				uint32_t new_x = x+directions_x[i];
+				uint32_t new_y = y+directions_y[i];
+				if(colour != get_field(g, new_x, new_y).area_id){
+					set_area_id(g, new_x, new_y, colour);
+					push_reserved_field(st, field_key(g, new_x, new_y));
+					coloured++;
+				}
 			}
 		}
 	}
-	free(tab);
+	return coloured;
 }
 
-/** @brief koloruje obszar na zadany kolor i dba o aktualizację parametrów danego gracza
+/** @brief dołącza pole do obszaru o zadanym kolorze i przemalowuje na ten kolor
+ * pozostałe sąsiednie obszary gracza, dba o aktualizację parametrów danego gracza
  * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
  * @param[in] player    – id gracza, do którego będzie należeć pokolorowane pole
  * @param[in] x   	– odcięta pola, które kolorujemy
@@ -698,7 +1527,9 @@ static void colour_area(gamma_t* g, uint32_t player,
 static void perform_area_colouring(gamma_t* g, uint32_t player,
 	       		           uint32_t x, uint32_t y, uint32_t colour){
 	set_area_id(g, x, y, colour);	
-	bool* tab = player_areas_nearby(g, player, x, y); 
+	set_area_size(g, colour, get_area_size(g, colour)+1);
+	bool tab[4];
+	fill_player_areas_nearby(g, player, x, y, tab);
 	for(int i=0;i<4;i++){
 		if(tab[i]){
 			uint32_t new_x = x+directions_x[i];
@@ -706,18 +1537,19 @@ static void perform_area_colouring(gamma_t* g, uint32_t player,
 			uint32_t field_colour = get_field(g, new_x, new_y).area_id;
 			if(colour != field_colour){
 				decrease_player_no_areas_used(g, player);
-				set_player_does_area_exist(g, player, 
-							   field_colour, false);
+				set_area_size(g, colour, get_area_size(g, colour)+
+					      get_area_size(g, field_colour));
+				release_area_label(g, field_colour);
 				colour_area(g, player, new_x, new_y, colour);
-				move_player_first_free_colour(g, player);
 			}
 		}
 	}
-	free(tab);
 }
 
 /** @brief Wykonuje ruch przy założeniu, że input jest poprawny
  * Ustawia pionek gracza @p player na polu (@p x, @p y).
+ * Łączone obszary przyjmują kolor największego z nich, więc przemalowujemy
+ * tylko mniejsze obszary.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
  * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
  *                      @p players z funkcji @ref gamma_new,
@@ -729,23 +1561,365 @@ static void perform_area_colouring(gamma_t* g, uint32_t player,
 static void gamma_make_move(gamma_t *g, uint32_t player, 
 			    uint32_t x, uint32_t y){
 	set_player_id(g, x, y, player);
-	bool* tab = player_areas_nearby(g, player, x, y);
-	uint32_t colour;
-	bool is_colour_choosen = false;
+	bool tab[4];
+	fill_player_areas_nearby(g, player, x, y, tab);
+	uint32_t colour = 0;
 	for(int i=0;i<4;i++){
 		if(tab[i]){
 			uint32_t new_x = x+directions_x[i];
 			uint32_t new_y = y+directions_y[i];
-			colour = get_field(g, new_x, new_y).area_id;
-			is_colour_choosen = true;
+			uint32_t field_colour = get_field(g, new_x, new_y).area_id;
+			if(colour == 0 || 
+			   get_area_size(g, field_colour) > get_area_size(g, colour))
+				colour = field_colour;
 		}
 	}
-	if(is_colour_choosen){
+	if(colour != 0){
 		perform_area_colouring(g, player, x, y, colour);
 	}
 	else
 		colour_new(g, player, x, y);
-	free(tab);
+}
+
+/** @brief zwraca rozmiar największego obszaru gracza sąsiadującego z polem (x, y)
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player    – id gracza, o którego pytamy
+ * @param[in] x   	– odcięta pola
+ * @param[in] y   	– rzędna pola
+ *
+ * @return rozmiar obszaru lub 0, jeżeli gracz nie ma pól obok (x, y)
+ */
+static uint64_t largest_area_nearby(gamma_t* g, uint32_t player, uint32_t x, uint32_t y){
+	bool tab[4];
+	fill_player_areas_nearby(g, player, x, y, tab);
+	uint64_t largest = 0;
+	for(int i=0;i<4;i++){
+		if(tab[i]){
+			uint64_t size = get_area_size(g, get_field(g, x+directions_x[i],
+							       y+directions_y[i]).area_id);
+			if(size > largest)
+				largest = size;
+		}
+	}
+	return largest;
+}
+
+/** @brief przydziela całą pamięć potrzebną do wykonania ruchu gracza na pole (x, y)
+ * Rezerwuje kolor nowego obszaru, stos przemalowywanych obszarów i kafelek pola,
+ * więc gamma_make_move nie może się już nie udać.
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
+ * @param[in] s 	– pamięć pomocnicza wątku lub NULL, jeżeli jej zabrakło
+ * @param[in] player    – id gracza, który ma wykonać ruch
+ * @param[in] x   	– odcięta pola, na które ma zostać wykonany ruch
+ * @param[in] y   	– rzędna pola, na które ma zostać wykonany ruch
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool reserve_move(gamma_t* g, search_scratch* s, uint32_t player,
+			 uint32_t x, uint32_t y){
+	return s != NULL && reserve_area_labels(g, 1) &&
+	       reserve_fields(&s->stacks[0], largest_area_nearby(g, player, x, y)) &&
+	       board_alloc_tile(&g->board, x, y) != NULL;
+}
+
+/** @brief zwalnia kolory obszarów, które gamma_compact odtwarza przy rozpakowaniu
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
+ */
+static void drop_area_labels(gamma_t* g){
+	allocator_free(&g->alloc, g->labels.size, g->labels.capacity*sizeof(uint64_t));
+	allocator_free(&g->alloc, g->labels.free, g->labels.capacity*sizeof(uint32_t));
+	g->labels.size = NULL;
+	g->labels.free = NULL;
+	g->labels.no_free = 0;
+	g->labels.no_labels = 0;
+	g->labels.capacity = 0;
+}
+
+/** @brief nadaje kolory obszarom planszy odtworzonej przez board_unpack
+ * Obszary dostają kolejne kolory w kolejności kafelków i pól.
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry z pustymi kolorami
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool recolour_areas(gamma_t* g){
+	search_scratch* s = get_search_scratch();
+	uint64_t no_areas = 0;
+	uint64_t largest = 0;
+	for(uint64_t p=1;p<=get_no_players(g);p++){
+		no_areas += get_player_no_areas_used(g, p);
+		if(get_player_no_busy_fields(g, p) > largest)
+			largest = get_player_no_busy_fields(g, p);
+	}
+	if(s == NULL || no_areas >= UINT32_MAX || !grow_labels(g) ||
+	   !reserve_area_labels(g, no_areas) || !reserve_fields(&s->stacks[0], largest))
+		return false;
+	tiled_board* b = &g->board;
+	for(uint64_t i=0;i<b->no_tiles;i++){
+		const tile* t = b->tiles[i];
+		uint32_t width = board_tile_width(b, t);
+		uint32_t height = board_tile_height(b, t);
+		for(uint32_t dy=0;dy<height;dy++){
+			for(uint32_t dx=0;dx<width;dx++){
+				field f = t->fields[board_field_index(b, dx, dy)];
+				if(f.player_id != 0 && f.area_id == 0){
+					uint32_t x = (t->tile_x << TILE_SHIFT)+dx;
+					uint32_t y = (t->tile_y << TILE_SHIFT)+dy;
+					uint32_t colour = new_area_label(g);
+					set_area_size(g, colour, colour_area(g, f.player_id, x, y, colour));
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/** @brief rozpakowuje planszę spakowaną przez gamma_compact i odtwarza kolory obszarów
+ * @param[in] g 	– wskaźnik na strukturę przechowującą spakowany stan gry
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci - gra zostaje wtedy spakowana
+ */
+static bool unpack_game(gamma_t* g){
+	if(!board_unpack(&g->board, g->packed))
+		return false;
+	if(!recolour_areas(g)){
+		board_free(&g->board);
+		drop_area_labels(g);
+		return false;
+	}
+	allocator_free(&g->base, g->packed, g->packed_size);
+	g->packed = NULL;
+	g->packed_size = 0;
+	return true;
+}
+
+/** @brief oznacza grę jako używaną i rozpakowuje jej planszę, jeżeli jest spakowana
+ * Wywołują ją wszystkie funkcje interfejsu czytające planszę. Na grze
+ * przygotowanej przez gamma_prepare_queries niczego nie zapisuje, więc nie
+ * przeszkadza równoległym zapytaniom.
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry lub NULL
+ *
+ * @return true jeżeli plansza jest gotowa do użycia lub g jest NULL,
+ * false jeżeli zabrakło pamięci na jej rozpakowanie
+ */
+static bool touch_game(gamma_t* g){
+	if(g == NULL)
+		return true;
+	if(!g->touched)
+		g->touched = true;
+	return g->packed == NULL || unpack_game(g);
+}
+
+/** @brief Przygotowuje grę do równoległych zapytań.
+ * Rozpakowuje planszę i oznacza grę jako używaną, żeby touch_game
+ * wywoływana przez zapytania tylko czytała stan gry.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli gra jest gotowa, a @p false, gdy @p g jest
+ * NULL lub zabrakło pamięci na rozpakowanie planszy.
+ */
+bool gamma_prepare_queries(gamma_t* g){
+	return g != NULL && touch_game(g);
+}
+
+/** @brief Włącza tryb współbieżny gry.
+ * Przygotowuje grę jak gamma_prepare_queries i tworzy jej zamek czytelników
+ * i pisarza, który od tej chwili zajmują funkcje ruchów i zapytań.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli tryb jest włączony, a @p false, gdy @p g
+ * jest NULL lub zabrakło pamięci.
+ */
+bool gamma_enable_concurrency(gamma_t* g){
+	if(g == NULL || !touch_game(g))
+		return false;
+	if(g->lock == NULL)
+		g->lock = rw_lock_new();
+	return g->lock != NULL;
+}
+
+/** @brief zajmuje zamek gry w trybie współbieżnym do czytania
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry lub NULL
+ */
+static void lock_for_reading(gamma_t* g){
+	if(g != NULL && g->lock != NULL)
+		rw_lock_read(g->lock);
+}
+
+/** @brief zajmuje zamek gry w trybie współbieżnym do pisania
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry lub NULL
+ */
+static void lock_for_writing(gamma_t* g){
+	if(g != NULL && g->lock != NULL)
+		rw_lock_write(g->lock);
+}
+
+/** @brief zwalnia zamek zajęty przez lock_for_reading lub lock_for_writing
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry lub NULL
+ */
+static void unlock_game(gamma_t* g){
+	if(g != NULL && g->lock != NULL)
+		rw_lock_unlock(g->lock);
+}
+
+/** @brief Pakuje planszę nieużywanej gry.
+ * Zapisuje planszę w zwartej postaci i zwalnia kafelki, katalog kafelków
+ * i kolory obszarów. Kolejne wywołanie funkcji czytającej planszę
+ * rozpakowuje ją i odtwarza kolory.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli plansza jest spakowana, a @p false, gdy
+ * @p g jest NULL, gra leży w pliku lub w arenie albo zabrakło pamięci -
+ * stan gry się wtedy nie zmienia.
+ */
+bool gamma_compact(gamma_t* g){
+	if(g == NULL || g->mapped != NULL || g->arena != NULL || g->lock != NULL)
+		return false;
+	if(g->packed != NULL)
+		return true;
+	uint64_t size = board_pack(&g->board, NULL);
+	uint8_t* packed = allocator_alloc(&g->base, size);
+	if(packed == NULL)
+		return false;
+	board_pack(&g->board, packed);
+	board_free(&g->board);
+	drop_area_labels(g);
+	g->packed = packed;
+	g->packed_size = size;
+	return true;
+}
+
+/** @brief Pakuje planszę gry nieużywanej od poprzedniego wywołania.
+ * Wywoływana dla każdej gry co N sekund pakuje gry, na których przez
+ * ostatnie N sekund nie wywołano żadnej funkcji czytającej planszę.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli plansza jest spakowana, a @p false wpp.
+ */
+bool gamma_compact_idle(gamma_t* g){
+	if(g == NULL || g->lock != NULL)
+		return false;
+	if(g->touched){
+		g->touched = false;
+		return g->packed != NULL;
+	}
+	return gamma_compact(g);
+}
+
+/** @brief przydziela tablice kolorów obszarów dla składowych wczytanej planszy
+ * Rozmiar tablic jest potęgą dwójki, tak jak po kolejnych grow_labels.
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
+ * @param[in] c 	– składowe wczytanej planszy
+ * @param[out] out 	– kolory obszarów, składowa o kolorze i dostaje kolor i
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool make_loaded_labels(gamma_t* g, const components* c, area_labels* out){
+	uint64_t capacity = INITIAL_LABELS_CAPACITY;
+	while(capacity <= c->no_components)
+		capacity *= 2;
+	if(capacity > UINT32_MAX)
+		capacity = UINT32_MAX;
+	out->size = allocator_alloc(&g->alloc, capacity*sizeof(uint64_t));
+	out->free = allocator_alloc(&g->alloc, capacity*sizeof(uint32_t));
+	if(out->size == NULL || out->free == NULL){
+		allocator_free(&g->alloc, out->size, capacity*sizeof(uint64_t));
+		allocator_free(&g->alloc, out->free, capacity*sizeof(uint32_t));
+		return false;
+	}
+	memcpy(out->size, c->size, ((uint64_t)c->no_components+1)*sizeof(uint64_t));
+	out->no_free = 0;
+	out->no_labels = c->no_components;
+	out->capacity = capacity;
+	if(g->board.huge_pages){
+		huge_advise(out->size, capacity*sizeof(uint64_t));
+		huge_advise(out->free, capacity*sizeof(uint32_t));
+	}
+	return true;
+}
+
+/** @brief zlicza pola i obszary graczy wczytanej planszy
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
+ * @param[in] c 	– składowe wczytanej planszy
+ * @param[out] busy 	– liczba pól gracza, tablica długości no_players+1
+ * @param[out] areas 	– liczba obszarów gracza, tablica długości no_players+1
+ *
+ * @return true jeżeli żaden gracz nie przekracza max_no_areas, false wpp
+ */
+static bool count_loaded_areas(gamma_t* g, const components* c, uint64_t* busy,
+			       uint32_t* areas){
+	uint64_t n = (uint64_t)get_no_players(g)+1;
+	memset(busy, 0, n*sizeof(uint64_t));
+	memset(areas, 0, n*sizeof(uint32_t));
+	for(uint64_t i=1;i<=c->no_components;i++){
+		uint32_t player = c->owner[i];
+		if(areas[player] == get_max_no_areas(g))
+			return false;
+		areas[player]++;
+		busy[player] += c->size[i];
+	}
+	return true;
+}
+
+/** @brief Wczytuje układ pionków na planszę gry.
+ * Zastępuje planszę gry zadanym układem i odtwarza kolory obszarów oraz
+ * liczby pól i obszarów graczy jednym etykietowaniem spójnych składowych,
+ * w czasie liniowym względem rozmiaru planszy, równolegle w pasach planszy.
+ * Gracze nie mają po wczytaniu wykonanego złotego ruchu.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] owners  – numer gracza na polu (x, y) pod indeksem
+ *                      y * width + x lub 0 dla pustego pola.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy któryś
+ * z parametrów jest niepoprawny, numer gracza przekracza liczbę graczy,
+ * gracz ma więcej obszarów niż maksymalna ich liczba lub zabrakło
+ * pamięci - stan gry się wtedy nie zmienia.
+ */
+bool gamma_load_board(gamma_t* g, const uint32_t* owners){
+	if(g == NULL || owners == NULL)
+		return false;
+	uint64_t n = (uint64_t)get_no_players(g)+1;
+	tiled_board old = g->board;
+	tiled_board board;
+	if(!board_init(&board, get_width(g), get_height(g), old.layout, &old.alloc,
+		       &old.tile_alloc, old.huge_pages))
+		return false;
+	components c;
+	area_labels labels;
+	uint64_t* busy = allocator_alloc(&g->base, n*sizeof(uint64_t));
+	uint32_t* areas = allocator_alloc(&g->base, n*sizeof(uint32_t));
+	bool success = busy != NULL && areas != NULL &&
+		       components_load(&board, owners, get_no_players(g), &c);
+	if(success){
+		success = count_loaded_areas(g, &c, busy, areas) &&
+			  make_loaded_labels(g, &c, &labels);
+		components_free(&c);
+	}
+	if(!success){
+		board_free(&board);
+		allocator_free(&g->base, busy, n*sizeof(uint64_t));
+		allocator_free(&g->base, areas, n*sizeof(uint32_t));
+		return false;
+	}
+	if(g->packed != NULL){
+		allocator_free(&g->base, g->packed, g->packed_size);
+		g->packed = NULL;
+		g->packed_size = 0;
+	} else{
+		board_free(&g->board);
+		drop_area_labels(g);
+	}
+	g->board = board;
+	g->labels = labels;
+	player_table* table = &g->players;
+	memcpy(table->no_busy_fields, busy, n*sizeof(uint64_t));
+	memcpy(table->no_areas_used, areas, n*sizeof(uint32_t));
+	memset(table->golden_move_used, 0, n*sizeof(bool));
+	table->total_busy_fields = 0;
+	table->no_players_with_fields = 0;
+	for(uint64_t p=1;p<n;p++){
+		table->total_busy_fields += busy[p];
+		if(busy[p] > 0)
+			table->no_players_with_fields++;
+	}
+	allocator_free(&g->base, busy, n*sizeof(uint64_t));
+	allocator_free(&g->base, areas, n*sizeof(uint32_t));
+	g->touched = true;
+	return true;
 }
 
 /** @brief Wykonuje ruch.
@@ -758,16 +1932,61 @@ static void gamma_make_move(gamma_t *g, uint32_t player,
  * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
  *                      @p height z funkcji @ref gamma_new.
  * @return Wartość @p true, jeśli ruch został wykonany, a @p false,
- * gdy ruch jest nielegalny lub któryś z parametrów jest niepoprawny.
+ * gdy ruch jest nielegalny, któryś z parametrów jest niepoprawny
+ * lub zabrakło pamięci - stan gry się wtedy nie zmienia.
  */
 bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
-	if(gamma_move_valid_input(g, player, x, y)){
+	lock_for_writing(g);
+	bool flague = touch_game(g) && gamma_move_valid_input(g, player, x, y) &&
+		      reserve_move(g, get_search_scratch(), player, x, y);
+	if(flague){
 		gamma_make_move(g, player, x, y);
 		increase_player_no_busy_fields(g, player);
-		return true;
-	}	
-	else
-		return false;
+	}
+	unlock_game(g);
+	return flague;
+}
+
+/** @brief Struktura opisująca współrzędne pola planszy.
+ * Odpowiada typowi gamma_coord_t z gamma.h.
+ */
+typedef struct{
+	uint32_t x; 	///< numer kolumny
+	uint32_t y; 	///< numer wiersza
+} gamma_coord_t;
+
+/** @brief Wykonuje kolejno ruchy jednego gracza.
+ * Daje takie same wyniki jak gamma_move wywołane po kolei dla każdego
+ * pola, ale sprawdza grę i gracza raz dla wszystkich ruchów.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[in] coords  – tablica długości @p n z polami kolejnych ruchów,
+ * @param[in] n       – liczba ruchów,
+ * @param[out] results – tablica długości @p n, pod indeksem i zapisujemy
+ *                      1, jeśli i-ty ruch został wykonany, a 0 wpp.
+ * @return Liczba wykonanych ruchów.
+ */
+uint64_t gamma_move_batch(gamma_t *g, uint32_t player, const gamma_coord_t *coords,
+			  uint64_t n, uint8_t *results){
+	lock_for_writing(g);
+	bool valid = g != NULL && touch_game(g) && player_fit_the_range(g, player);
+	search_scratch* s = valid? get_search_scratch() : NULL;
+	uint64_t done = 0;
+	for(uint64_t i=0;i<n;i++){
+		uint32_t x = coords[i].x;
+		uint32_t y = coords[i].y;
+		bool move = valid && move_allowed(g, player, x, y) &&
+			    reserve_move(g, s, player, x, y);
+		if(move){
+			gamma_make_move(g, player, x, y);
+			increase_player_no_busy_fields(g, player);
+			done++;
+		}
+		results[i] = move;
+	}
+	unlock_game(g);
+	return done;
 }
 
 /** @brief sprawdza czy inni gracze zajeli już jakieś pola
@@ -777,15 +1996,10 @@ bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
  * @return true jeżeli inni gracze posiadają zajęte pola, false wpp
  */
 static bool other_players_have_busy_fields(gamma_t *g, uint32_t player){
-	uint32_t no_players = get_no_players(g);
-	bool flague = false;
-	for(uint32_t i=1;i<=no_players;i++){
-		if(i!=player && get_player_no_busy_fields(g, i)>0){
-			flague = true;
-			break;
-		}
-	}
-	return flague;
+	uint32_t others = g->players.no_players_with_fields;
+	if(get_player_no_busy_fields(g, player) > 0)
+		others--;
+	return others > 0;
 }
 
 /** @brief sprawdza czy zadany input spełnia założenia gamma_golden_possible
@@ -806,61 +2020,318 @@ static bool gamma_golden_possible_valid_input(gamma_t* g, uint32_t player){
 
 
 
+/** @brief Struktura opisująca fragmenty, na które rozpada się obszar po usunięciu pola
+ */
+typedef struct{
+	int no_starts; 			///< liczba sąsiadów usuwanego pola należących do jego właściciela
+	uint64_t starts[MAX_FRAGMENTS]; ///< numery tych sąsiadów, od nich zaczynamy przeszukiwania
+	int group[MAX_FRAGMENTS]; 	///< ojciec przeszukiwania w zbiorze przeszukiwań, które się spotkały
+	uint64_t visited[MAX_FRAGMENTS]; ///< liczba pól odwiedzonych przez przeszukiwanie
+	uint64_t size[MAX_FRAGMENTS]; 	///< rozmiar fragmentu, poprawny dla wyczerpanych grup
+	uint32_t no_fragments; 		///< liczba fragmentów, na które rozpadnie się obszar
+	int keeper; 			///< przeszukiwanie, którego fragment zachowa dotychczasowy kolor
+} fragments;
+
+/** @brief zwraca reprezentanta zbioru przeszukiwań, które się spotkały
+ * @param[in] f 	- opis przeszukiwań
+ * @param[in] i 	- numer przeszukiwania
+ *
+ * @return numer przeszukiwania będącego reprezentantem
+ */
+static int find_group(fragments* f, int i){
+	while(f->group[i] != i)
+		i = f->group[i];
+	return i;
+}
+
+/** @brief sprawdza, czy liczba fragmentów jest już znana
+ * Przeszukiwania, które się spotkały, tworzą jedną grupę. Grupa jest wyczerpana,
+ * gdy wszystkie jej stosy są puste - wtedy przeszła cały swój fragment.
+ * Kończymy, gdy została jedna grupa lub co najwyżej jedna niewyczerpana.
+ * @param[in] f 	- opis przeszukiwań
+ * @param[in] s 	- pamięć pomocnicza wątku
+ *
+ * @return true jeżeli można zakończyć przeszukiwanie
+ */
+static bool fragments_known(fragments* f, search_scratch* s){
+	bool active[MAX_FRAGMENTS] = {false};
+	int no_groups = 0;
+	int no_active = 0;
+	for(int i=0;i<f->no_starts;i++){
+		int root = find_group(f, i);
+		if(root == i)
+			no_groups++;
+		if(s->stacks[i].top > 0 && !active[root]){
+			active[root] = true;
+			no_active++;
+		}
+	}
+	return no_groups <= 1 || no_active <= 1;
+}
+
+/** @brief wykonuje jeden krok przeszukiwania: zdejmuje pole ze stosu i odwiedza jego sąsiadów
+ * Jeżeli natrafi na pole odwiedzone przez inne przeszukiwanie, łączy ich grupy.
+ * @param[in] g 	- wskaźnik na strukturę przechowującą stan gry
+ * @param[in,out] s 	- pamięć pomocnicza wątku
+ * @param[in,out] f 	- opis przeszukiwań
+ * @param[in] player 	- id gracza, do którego należy obszar
+ * @param[in] i 	- numer przeszukiwania, którego stos nie jest pusty
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool fragment_search_step(gamma_t* g, search_scratch* s, fragments* f,
+				 uint32_t player, int i){
+	uint64_t key = pop_field(&s->stacks[i]);
+	uint32_t x = key%get_width(g);
+	uint32_t y = key/get_width(g);
+	bool tab[4];
+	fill_player_areas_nearby(g, player, x, y, tab);
+	for(int d=0;d<4;d++){
+		if(tab[d]){
+			uint64_t next = field_key(g, x+directions_x[d], y+directions_y[d]);
+			uint8_t tag = cell_set_get(&s->visited, next);
+			if(tag == CELL_SET_ABSENT){
+				if(!mark_visited(s, next, i) || !push_field(&s->stacks[i], next))
+					return false;
+				f->visited[i]++;
+			} else if(tag < MAX_FRAGMENTS){
+				int a = find_group(f, i);
+				int b = find_group(f, tag);
+				if(a != b)
+					f->group[b] = a;
+			}
+		}
+	}
+	return true;
+}
+
+/** @brief wyznacza fragmenty, na które rozpadnie się obszar po usunięciu pola (x, y)
+ * Przeszukuje fragmenty zaczynające się w sąsiadach pola równocześnie, po jednym
+ * polu na krok. Kończy, gdy przeszukiwania się spotkały lub wszystkie poza jednym
+ * się wyczerpały, więc koszt jest rzędu rozmiaru mniejszych fragmentów, a nie
+ * całego obszaru. Nie modyfikuje stanu gry.
+ * @param[in] g 	- wskaźnik na strukturę przechowującą stan gry
+ * @param[in] x 	- odcięta usuwanego pola
+ * @param[in] y 	- rzędna usuwanego pola
+ * @param[out] f 	- opis fragmentów
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool split_into_fragments(gamma_t* g, uint32_t x, uint32_t y, fragments* f){
+	uint32_t player = get_field(g, x, y).player_id;
+	search_scratch* s = get_search_scratch();
+	if(s == NULL)
+		return false;
+	bool tab[4];
+	fill_player_areas_nearby(g, player, x, y, tab);
+	cell_set_clear(&s->visited);
+	if(!mark_visited(s, field_key(g, x, y), MAX_FRAGMENTS))
+		return false;
+	f->no_starts = 0;
+	for(int d=0;d<4;d++){
+		if(tab[d]){
+			int i = f->no_starts++;
+			f->starts[i] = field_key(g, x+directions_x[d], y+directions_y[d]);
+			f->group[i] = i;
+			f->visited[i] = 1;
+			s->stacks[i].top = 0;
+			if(!mark_visited(s, f->starts[i], i) ||
+			   !push_field(&s->stacks[i], f->starts[i]))
+				return false;
+		}
+	}
+	while(!fragments_known(f, s)){
+		for(int i=0;i<f->no_starts;i++){
+			if(s->stacks[i].top > 0 && !fragment_search_step(g, s, f, player, i))
+				return false;
+		}
+	}
+
+	uint64_t* group_size = f->size;
+	bool active[MAX_FRAGMENTS] = {false};
+	for(int i=0;i<f->no_starts;i++)
+		group_size[i] = 0;
+	for(int i=0;i<f->no_starts;i++){
+		int root = find_group(f, i);
+		group_size[root] += f->visited[i];
+		active[root] = active[root] || s->stacks[i].top > 0;
+	}
+	f->no_fragments = 0;
+	f->keeper = -1;
+	for(int i=0;i<f->no_starts;i++){
+		if(find_group(f, i) == i){
+			f->no_fragments++;
+			if(f->keeper == -1 || active[i] || 
+			   (!active[f->keeper] && group_size[i] > group_size[f->keeper]))
+				f->keeper = i;
+		}
+	}
+	return true;
+}
+
 /** @brief symuluje złoty ruch. Zwraca true jeżeli dało się go wykonać
- * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * Sprawdza, czy po usunięciu pionka z pola (x, y) jego właściciel nie przekroczy
+ * limitu obszarów. Nie modyfikuje stanu gry, więc może być wywoływana równolegle
+ * z wielu wątków - każdy z nich korzysta z własnej pamięci pomocniczej.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
  * @param[in] x       – numer kolumny, liczba nieujemna mniejsza od wartości
  *                      @p width z funkcji @ref gamma_new,
  * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
  *                      @p height z funkcji @ref gamma_new.
- * @return Wartość @p true, jeśli dało się wykonać ruch
+ * @return Wartość @p true, jeśli dało się wykonać ruch, @p false również
+ * wtedy, gdy zabrakło pamięci na przeszukiwanie
  */
 static bool gamma_try_golden_move_no_sideeffect(gamma_t* g, uint32_t x, uint32_t y){
-	field primal_field = get_field(g, x, y);
-	uint32_t primal_player = primal_field.player_id;
-	uint32_t primal_colour = primal_field.area_id;
-	bool* tab = player_areas_nearby(g, primal_player, x, y);	
-	set_area_id(g, x, y, 0);
-	set_player_id(g, x, y, 0);
-	set_player_does_area_exist(g, primal_player, primal_colour, false);
-	decrease_player_no_areas_used(g, primal_player);
-	move_player_first_free_colour(g, primal_player);
-	uint32_t no_areas_that_will_be_added = 0;
-	for(int i=0;i<4;i++){
-		if(tab[i]){
-			uint32_t new_x = x+directions_x[i];
-			uint32_t new_y = y+directions_y[i];
-			if(get_field(g, new_x, new_y).area_id != TRANSPARENT){
-				no_areas_that_will_be_added++;
-				colour_area(g, primal_player, new_x, new_y, 
-					    TRANSPARENT);
-			}
+	uint32_t primal_player = get_field(g, x, y).player_id;
+	bool tab[4];
+	int no_neighbours = fill_player_areas_nearby(g, primal_player, x, y, tab);
+	uint64_t areas_left = get_player_no_areas_used(g, primal_player)-1;
+	if(areas_left+no_neighbours <= get_max_no_areas(g))
+		return true;
+
+	fragments f;
+	return split_into_fragments(g, x, y, &f) &&
+	       areas_left+f.no_fragments <= get_max_no_areas(g);
+}
+
+/** @brief sprawdza czy któreś z pól sąsiednich jest wolne
+ * @param[in] owners 	- sąsiedzi pola wyznaczeni przez neighbour_owners
+ *
+ * @return true jeżeli któryś z sąsiadów jest wolnym polem planszy, false wpp
+ */
+static bool has_free_neighbour(const uint64_t owners[4]){
+	return owners[0] == 0 || owners[1] == 0 || owners[2] == 0 || owners[3] == 0;
+}
+
+/** @brief zlicza wolne sąsiednie pola, za które odpowiada pole (x, y) gracza
+ * Wolne pole sąsiadujące z kilkoma polami gracza liczymy tylko przy pierwszym
+ * z nich w kolejności kierunków, dzięki czemu brzeg obszarów gracza można
+ * policzyć przeglądając tylko jego pola, a nie całą planszę.
+ * @param[in] g 	- wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player 	- id gracza, do którego należy pole (x, y)
+ * @param[in] x 	- odcięta pola gracza
+ * @param[in] y 	- rzędna pola gracza
+ * @param[in] owners 	- sąsiedzi pola (x, y) wyznaczeni przez neighbour_owners
+ *
+ * @return liczba wolnych pól, które liczymy przy polu (x, y)
+ */
+static uint32_t free_neighbours_counted_at(gamma_t* g, uint32_t player,
+					   uint32_t x, uint32_t y,
+					   const uint64_t owners[4]){
+	uint32_t count = 0;
+	for(int d=0;d<4;d++){
+		if(owners[d] != 0)
+			continue;
+		uint32_t ex = x+directions_x[d];
+		uint32_t ey = y+directions_y[d];
+		bool first = true;
+		for(int i=0;i<(d+2)%4 && first;i++){
+			uint32_t nx = ex+directions_x[i];
+			uint32_t ny = ey+directions_y[i];
+			first = !x_y_fit_the_board(g, nx, ny) || 
+				get_field(g, nx, ny).player_id != player;
 		}
-		
-	}
-	free(tab);
-	bool answ = false; 
-	if(get_player_no_areas_used(g, primal_player)+
-	   no_areas_that_will_be_added <= get_max_no_areas(g)){
-		answ = true;
+		if(first)
+			count++;
 	}
+	return count;
+}
 
-	 //undo things
-	set_area_id(g, x, y, primal_colour);
-    set_player_id(g, x, y, primal_player);
-   	set_player_does_area_exist(g, primal_player, primal_colour, true);
-	increase_player_no_areas_used(g, primal_player);
-	move_player_first_free_colour(g, primal_player);
-	colour_area(g, primal_player, x, y, primal_colour);
-	return answ;
-	
+/** @brief sprawdza zajęte pola kafelka w poszukiwaniu pola, na które da się wykonać złoty ruch
+ * Gracz, który zajął już wszystkie dostępne obszary, może wykonać złoty ruch
+ * tylko obok swojego pola, więc dla niego sprawdzamy tylko sąsiadów jego pól.
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player    – id gracza, o którego pytamy
+ * @param[in] saturated - true jeżeli gracz zajął już wszystkie dostępne obszary
+ * @param[in] t 	- przeszukiwany kafelek
+ *
+ * @return true jeżeli znaleźliśmy takie pole, false wpp
+ */
+static bool golden_move_makable_in_tile(gamma_t* g, uint32_t player, bool saturated,
+					const tile* t){
+	uint32_t x0 = t->tile_x << TILE_SHIFT;
+	uint32_t y0 = t->tile_y << TILE_SHIFT;
+	for(uint32_t dy=0; dy<board_tile_height(&g->board, t); dy++){
+		for(uint32_t dx=0; dx<board_tile_width(&g->board, t); dx++){
+			uint32_t owner = t->fields[board_field_index(&g->board, dx, dy)].player_id;
+			if(!saturated && owner != 0 && owner != player &&
+			   gamma_try_golden_move_no_sideeffect(g, x0+dx, y0+dy))
+				return true;
+			if(!saturated || owner != player)
+				continue;
+			uint64_t owners[4];
+			neighbour_owners(g, t, x0+dx, y0+dy, owners);
+			for(int i=0;i<4;i++){
+				if(owners[i] != NO_NEIGHBOUR && owners[i] != 0 && owners[i] != player &&
+				   gamma_try_golden_move_no_sideeffect(g, x0+dx+directions_x[i],
+								       y0+dy+directions_y[i]))
+					return true;
+			}
+		}
+	}
+	return false;
 }
 
-//tylko deklaracja, opis niżej
-static bool gamma_golden_move_valid_input(gamma_t *g, uint32_t player, 
-				   	  uint32_t x, uint32_t y);
+/** @brief Struktura opisująca równoległe przeszukiwanie kafelków planszy
+ */
+typedef struct{
+	gamma_t* g; 		///< przeszukiwana gra
+	uint32_t player; 	///< gracz, dla którego szukamy złotego ruchu
+	bool saturated; 	///< true jeżeli gracz zajął już wszystkie dostępne obszary
+	uint64_t tiles_per_chunk; ///< liczba kafelków w jednej porcji pracy
+	atomic_bool found; 	///< true jeżeli któryś z wątków znalazł złoty ruch
+} golden_scan;
+
+/** @brief przeszukuje jedną porcję kafelków, wywoływana przez pulę wątków
+ * pomija kafelki bez zajętych pól i przerywa pracę, gdy któryś z wątków
+ * znalazł już pole na złoty ruch
+ * @param[in,out] arg 	- wskaźnik na strukturę golden_scan
+ * @param[in] chunk 	- numer przeszukiwanej porcji
+ */
+static void golden_scan_chunk(void* arg, uint32_t chunk){
+	golden_scan* scan = arg;
+	tiled_board* b = &scan->g->board;
+	uint64_t from = (uint64_t)chunk*scan->tiles_per_chunk;
+	uint64_t to = from+scan->tiles_per_chunk;
+	if(to > b->no_tiles)
+		to = b->no_tiles;
+	for(uint64_t i=from; i<to; i++){
+		if(atomic_load_explicit(&scan->found, memory_order_relaxed))
+			return;
+		if(golden_move_makable_in_tile(scan->g, scan->player, scan->saturated,
+					       b->tiles[i])){
+			atomic_store(&scan->found, true);
+			return;
+		}
+	}
+}
 
+/** @brief dzieli zaalokowane kafelki planszy na porcje przeszukiwane równolegle
+ * małe plansze przeszukujemy w całości jednym wątkiem
+ * @param[in] g 			- wskaźnik na strukturę przechowującą stan gry
+ * @param[out] tiles_per_chunk 	- liczba kafelków w jednej porcji
+ *
+ * @return liczba porcji
+ */
+static uint32_t split_into_chunks(gamma_t* g, uint64_t* tiles_per_chunk){
+	uint64_t no_tiles = g->board.no_tiles;
+	uint64_t no_chunks = 1;
+	if(no_tiles*TILE_SIDE*TILE_SIDE >= PARALLEL_SCAN_MIN_FIELDS){
+		uint64_t wanted = (uint64_t)thread_pool_size()*CHUNKS_PER_THREAD;
+		no_chunks = wanted < no_tiles? wanted : no_tiles;
+	}
+	if(no_tiles == 0){
+		*tiles_per_chunk = 1;
+		return 0;
+	}
+	*tiles_per_chunk = (no_tiles+no_chunks-1)/no_chunks;
+	return (no_tiles+*tiles_per_chunk-1)/ *tiles_per_chunk;
+}
 
 /** @brief iteruje try_golden_move_no_sideeddect.
+ * Przegląda tylko zaalokowane kafelki z zajętymi polami, na dużych planszach
+ * równolegle pulą wątków, i kończy, gdy tylko któryś wątek znajdzie pole,
+ * na które da się wykonać ruch.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
  * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
  *                      @p players z funkcji @ref gamma_new.
@@ -868,16 +2339,14 @@ static bool gamma_golden_move_valid_input(gamma_t *g, uint32_t player,
  * try_golden_move_no_sideeddect no chodź jednym polu
  */
 static bool is_golden_move_makable_anywhere(gamma_t* g, uint32_t player){
-	for(uint32_t x=0; x<get_width(g); x++){
-		for(uint32_t y=0; y<get_height(g); y++){
-			if(gamma_golden_move_valid_input(g, player, x, y)){
-				 if(gamma_try_golden_move_no_sideeffect(g, x, y)){
-				 	return true;
-				 }
-			}
-		}
-	}	
-	return false;
+	golden_scan scan;
+	scan.g = g;
+	scan.player = player;
+	scan.saturated = player_all_areas_used(g, player);
+	atomic_init(&scan.found, false);
+	uint32_t no_chunks = split_into_chunks(g, &scan.tiles_per_chunk);
+	thread_pool_run(golden_scan_chunk, &scan, no_chunks);
+	return atomic_load(&scan.found);
 }
 
 
@@ -892,16 +2361,14 @@ static bool is_golden_move_makable_anywhere(gamma_t* g, uint32_t player){
  * a @p false w przeciwnym przypadku.
  */
 bool gamma_golden_possible(gamma_t *g, uint32_t player){
-	bool flague = true;
-	if(gamma_golden_possible_valid_input(g, player)){
-		flague = flague && !get_player_golden_move_used(g, player);
-		flague = flague && other_players_have_busy_fields(g, player);
-		if(flague) //expensive operation
-			flague = flague && is_golden_move_makable_anywhere(g, player);
-		return flague;
-	}
-	else
-		return false;
+	lock_for_reading(g);
+	bool flague = touch_game(g) && gamma_golden_possible_valid_input(g, player);
+	flague = flague && !get_player_golden_move_used(g, player);
+	flague = flague && other_players_have_busy_fields(g, player);
+	if(flague) //expensive operation
+		flague = flague && is_golden_move_makable_anywhere(g, player);
+	unlock_game(g);
+	return flague;
 }
 
 /** @brief sprawdza czy zadany input spełnia założenia gamma_golden_move
@@ -930,55 +2397,85 @@ static bool gamma_golden_move_valid_input(gamma_t *g, uint32_t player,
 		return false;
 }
 
-/** @brief funkcja pomocnicza do gamma_make_move
- * koloruje obszar na zadany kolor i dba o aktualizację parametrów
+/** @brief funkcja pomocnicza do gamma_make_golden_move
+ * koloruje fragment odcięty złotym ruchem na nowy kolor i dba o aktualizację parametrów
  * @param[in] g 		- wskaźnik na strukturę przechowującą stan gry
  * @param[in] primal_player 	- id gracza, którego modyfikujemy
  * @param[in] new_x 		- odcięta pola, które modyfikujemy
  * @param[in] new_y 		- rzędna pola, które modyfikujemy
+ * @param[in] size 		- liczba pól fragmentu
  */
-static void perform_transparent_colouring(gamma_t* g, uint32_t primal_player, 
-				 	  uint32_t new_x, uint32_t new_y){
+static void perform_fragment_colouring(gamma_t* g, uint32_t primal_player, 
+				       uint32_t new_x, uint32_t new_y, uint64_t size){
 	increase_player_no_areas_used(g, primal_player);
-        uint32_t fst_col = get_player_first_free_colour(g, primal_player);
-        set_player_does_area_exist(g, primal_player, fst_col, true);
-        colour_area(g, primal_player, new_x, new_y, fst_col);
-        move_player_first_free_colour(g, primal_player);
+	uint32_t colour = new_area_label(g);
+	set_area_size(g, colour, size);
+	colour_area(g, primal_player, new_x, new_y, colour);
 }
 
 /** @brief Wykonuje złoty ruch przy założeniu, że input jest poprawny, nie naruszy on limitu obszarów
  * Ustawia pionek gracza @p player na polu (@p x, @p y) zajętym przez innego
- * gracza, usuwając pionek innego gracza.
+ * gracza, usuwając pionek innego gracza. Największy fragment obszaru
+ * poprzedniego właściciela zachowuje kolor, pozostałe dostają nowe kolory.
  * @param[in,out] g   		- wskaźnik na strukturę przechowującą stan gry,
  * @param[in] player  		- numer gracza, liczba dodatnia niewiększa od wartości
  *                      	  @p players z funkcji @ref gamma_new,
- * @param[in] primal_player 	- id gracza, do którego pierwotnie należało pole
+ * @param[in] primal_field 	- pole (x, y) przed wykonaniem ruchu
  * @param[in] x       		- numer kolumny, liczba nieujemna mniejsza od wartości
  *                      	  @p width z funkcji @ref gamma_new,
  * @param[in] y       		- numer wiersza, liczba nieujemna mniejsza od wartości
  *                      	  @p height z funkcji @ref gamma_new.
+ * @param[in] f 		- fragmenty, na które rozpada się obszar poprzedniego właściciela
  */
 static void gamma_make_golden_move(gamma_t* g, uint32_t player, 
-				   uint32_t primal_player,
-	       	                   uint32_t x, uint32_t y){
+				   field primal_field,
+	       	                   uint32_t x, uint32_t y, fragments* f){
+	uint32_t primal_player = primal_field.player_id;
+	uint32_t primal_colour = primal_field.area_id;
 	set_area_id(g, x, y, 0);
 	set_player_id(g, x, y, 0);
-	gamma_move(g, player, x, y);
-	bool* tab = player_areas_nearby(g, primal_player, x, y);
-	for(int i=0;i<4;i++){
-		if(tab[i]){
-			uint32_t new_x = x+directions_x[i];
-			uint32_t new_y = y+directions_y[i];
-			field new_field = get_field(g, new_x, new_y);
-			if(new_field.area_id == TRANSPARENT){
-				perform_transparent_colouring(g, primal_player,
-							      new_x, new_y);
-			}
+	set_area_size(g, primal_colour, get_area_size(g, primal_colour)-1);
+	if(f->no_fragments == 0){
+		release_area_label(g, primal_colour);
+		decrease_player_no_areas_used(g, primal_player);
+	}
+	for(int i=0;i<f->no_starts;i++){
+		if(find_group(f, i) == i && i != f->keeper){
+			set_area_size(g, primal_colour, 
+				      get_area_size(g, primal_colour)-f->size[i]);
+			perform_fragment_colouring(g, primal_player,
+						   f->starts[i]%get_width(g),
+						   f->starts[i]/get_width(g),
+						   f->size[i]);
 		}
 	}
+	gamma_make_move(g, player, x, y);
+	increase_player_no_busy_fields(g, player);
 	set_player_golden_move_used(g, player, true);
 	decrease_player_no_busy_fields(g, primal_player);
-	free(tab);
+}
+
+/** @brief przydziela całą pamięć potrzebną do wykonania złotego ruchu
+ * Rezerwuje kolory odciętych fragmentów i nowego pola oraz stos na przemalowanie
+ * największego z odciętych fragmentów lub obszarów gracza łączonych przez ruch.
+ * Kafelek pola (x, y) już istnieje, bo pole jest zajęte.
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
+ * @param[in] player    – id gracza, który ma wykonać ruch
+ * @param[in] x   	– odcięta pola, na które ma zostać wykonany ruch
+ * @param[in] y   	– rzędna pola, na które ma zostać wykonany ruch
+ * @param[in] f 	- fragmenty, na które rozpada się obszar poprzedniego właściciela
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+static bool reserve_golden_move(gamma_t* g, uint32_t player, uint32_t x, uint32_t y,
+				const fragments* f){
+	uint64_t largest = largest_area_nearby(g, player, x, y);
+	for(int i=0;i<f->no_starts;i++){
+		if(f->group[i] == i && i != f->keeper && f->size[i] > largest)
+			largest = f->size[i];
+	}
+	return reserve_area_labels(g, MAX_FRAGMENTS) &&
+	       reserve_fields(&get_search_scratch()->stacks[0], largest);
 }
 
 /** @brief Wykonuje złoty ruch przy założeniu, że input jest poprawny
@@ -1000,41 +2497,17 @@ static bool gamma_try_golden_move(gamma_t* g, uint32_t player,
 		 		  uint32_t x, uint32_t y){
 	field primal_field = get_field(g, x, y);
 	uint32_t primal_player = primal_field.player_id;
-	uint32_t primal_colour = primal_field.area_id;
-	bool* tab = player_areas_nearby(g, primal_player, x, y);	
-	set_area_id(g, x, y, 0);
-	set_player_id(g, x, y, 0);
-	set_player_does_area_exist(g, primal_player, primal_colour, false);
-	decrease_player_no_areas_used(g, primal_player);
-	move_player_first_free_colour(g, primal_player);
-	uint32_t no_areas_that_will_be_added = 0;
-	for(int i=0;i<4;i++){
-		if(tab[i]){
-			uint32_t new_x = x+directions_x[i];
-			uint32_t new_y = y+directions_y[i];
-			if(get_field(g, new_x, new_y).area_id != TRANSPARENT){
-				no_areas_that_will_be_added++;
-				colour_area(g, primal_player, new_x, new_y, 
-					    TRANSPARENT);
-			}
-		}
-		
-	}
-	free(tab);
-	if(get_player_no_areas_used(g, primal_player)+
-	   no_areas_that_will_be_added <= get_max_no_areas(g)){
-		gamma_make_golden_move(g, player, primal_player, x, y);
+	fragments f;
+	if(!split_into_fragments(g, x, y, &f))
+		return false;
+	uint64_t areas_left = get_player_no_areas_used(g, primal_player)-1;
+	if(areas_left+f.no_fragments <= get_max_no_areas(g) &&
+	   reserve_golden_move(g, player, x, y, &f)){
+		gamma_make_golden_move(g, player, primal_field, x, y, &f);
 		return true;
 	}
-	else{ //undo things
-		set_area_id(g, x, y, primal_colour);
-    	    	set_player_id(g, x, y, primal_player);
-   		set_player_does_area_exist(g, primal_player, primal_colour, true);
-		increase_player_no_areas_used(g, primal_player);
-		move_player_first_free_colour(g, primal_player);
-		colour_area(g, primal_player, x, y, primal_colour);
+	else
 		return false;
-	}
 }
 
 /** @brief Wykonuje złoty ruch.
@@ -1048,15 +2521,15 @@ static bool gamma_try_golden_move(gamma_t* g, uint32_t player,
  * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
  *                      @p height z funkcji @ref gamma_new.
  * @return Wartość @p true, jeśli ruch został wykonany, a @p false,
- * gdy gracz wykorzystał już swój złoty ruch, ruch jest nielegalny
- * lub któryś z parametrów jest niepoprawny.
+ * gdy gracz wykorzystał już swój złoty ruch, ruch jest nielegalny,
+ * któryś z parametrów jest niepoprawny lub zabrakło pamięci.
  */
 bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y){
-	if(gamma_golden_move_valid_input(g, player, x, y)){
-		return gamma_try_golden_move(g, player, x, y);
-	}
-	else
-		return false;
+	lock_for_writing(g);
+	bool flague = touch_game(g) && gamma_golden_move_valid_input(g, player, x, y) &&
+		      gamma_try_golden_move(g, player, x, y);
+	unlock_game(g);
+	return flague;
 }
 
 /** @brief sprawdza czy zadany input spełnia założenia gamma_busy_fields
@@ -1084,11 +2557,12 @@ static bool gamma_busy_fields_valid_input(gamma_t* g, uint32_t player){
  * jeśli któryś z parametrów jest niepoprawny.
  */
 uint64_t gamma_busy_fields(gamma_t *g, uint32_t player){
-	if(gamma_busy_fields_valid_input(g, player)){
-		return get_player_no_busy_fields(g, player);
-	}
-	else
-		return 0;
+	lock_for_reading(g);
+	uint64_t count = 0;
+	if(gamma_busy_fields_valid_input(g, player))
+		count = get_player_no_busy_fields(g, player);
+	unlock_game(g);
+	return count;
 }
 
 /** @brief zwraca liczbę wszystkich zajętych pól przez wszystkich graczy w grze
@@ -1097,32 +2571,38 @@ uint64_t gamma_busy_fields(gamma_t *g, uint32_t player){
  * @return liczba wszystkich zajętych pól przez wszystkich graczy w grze
  */
 static uint64_t sum_of_all_players_busy_fields(gamma_t* g){
-	uint64_t sum = 0;
-	for(uint32_t i=1;i<=get_no_players(g);i++){
-		sum+= get_player_no_busy_fields(g, i);
-	}
-	return sum;
+	return g->players.total_busy_fields;
 }
 
-/** @brief zwraca liczbę wszystkich pól danego gracza będących przegiem dowolnego obszaru
+/** @brief zwraca liczbę wolnych pól sąsiadujących z obszarami gracza
+ * przegląda tylko zaalokowane kafelki, każdy z nich zawiera zajęte pole,
+ * bo kafelek powstaje przy zajęciu pola, a zajęte pole nie staje się z powrotem wolne
  * @param[in] g 	- wskaźnik na strukturę przechowującą stan gry
  * @param[in] player 	- id gracza, o którego pytamy
  *
- * @return liczba wszystkich pól danego gracza będących przegiem dowolnego obszaru
+ * @return liczba wolnych pól sąsiadujących z obszarami gracza
  */
 static uint64_t count_boarder_size(gamma_t* g, uint32_t player){
 	uint64_t count = 0;
-	for(uint32_t i=0;i<get_height(g);i++){
-		for(uint32_t j=0;j<get_width(g);j++){
-			field f = get_field(g, j, i);
-			bool flague = true;
-			flague = flague && (f.player_id == 0);
-			flague = flague && (are_player_areas_nearby(g, player,
-								    j, i));
-			if(flague)
-				count++;
+	if(g->mapped != NULL)
+		mapped_advise_sequential(g->mapped, true);
+	for(uint64_t i=0;i<g->board.no_tiles;i++){
+		tile* t = g->board.tiles[i];
+		uint32_t x0 = t->tile_x << TILE_SHIFT;
+		uint32_t y0 = t->tile_y << TILE_SHIFT;
+		for(uint32_t dy=0; dy<board_tile_height(&g->board, t); dy++){
+			for(uint32_t dx=0; dx<board_tile_width(&g->board, t); dx++){
+				if(t->fields[board_field_index(&g->board, dx, dy)].player_id != player)
+					continue;
+				uint64_t owners[4];
+				neighbour_owners(g, t, x0+dx, y0+dy, owners);
+				if(has_free_neighbour(owners))
+					count += free_neighbours_counted_at(g, player, x0+dx, y0+dy, owners);
+			}
 		}
 	}
+	if(g->mapped != NULL)
+		mapped_advise_sequential(g->mapped, false);
 	return count;
 }
 
@@ -1152,15 +2632,530 @@ static bool gamma_free_fields_valid_input(gamma_t* g, uint32_t player){
  * jeśli któryś z parametrów jest niepoprawny.
  */
 uint64_t gamma_free_fields(gamma_t *g, uint32_t player){
-	if(gamma_free_fields_valid_input(g, player)){
-		if(player_all_areas_used(g, player)){
-			return count_boarder_size(g, player);
-		}
+	lock_for_reading(g);
+	uint64_t count = 0;
+	if(touch_game(g) && gamma_free_fields_valid_input(g, player)){
+		if(player_all_areas_used(g, player))
+			count = count_boarder_size(g, player);
 		else
-			return board_size(g)-sum_of_all_players_busy_fields(g);
+			count = board_size(g)-sum_of_all_players_busy_fields(g);
 	}
-	else
+	unlock_game(g);
+	return count;
+}
+
+/** @brief Struktura opisująca możliwości ruchu jednego gracza.
+ * Odpowiada typowi gamma_player_status_t z gamma.h.
+ */
+typedef struct{
+	uint64_t free_fields; 	///< wynik gamma_free_fields dla gracza
+	bool golden_possible; 	///< wynik gamma_golden_possible dla gracza
+} gamma_player_status_t;
+
+/** @brief Struktura opisująca wspólne przeszukiwanie planszy dla wszystkich graczy
+ * Tablice indeksujemy numerem gracza, mają długość no_players+1.
+ */
+typedef struct{
+	gamma_t* g; 			///< przeszukiwana gra
+	uint64_t tiles_per_chunk; 	///< liczba kafelków w jednej porcji pracy
+	bool* saturated; 		///< true jeżeli gracz zajął już wszystkie dostępne obszary
+	bool* can_golden; 		///< true jeżeli gracz nie wykonał jeszcze złotego ruchu
+	atomic_bool* golden; 		///< true jeżeli znaleźliśmy pole na złoty ruch gracza
+	atomic_uint_fast64_t* border; 	///< liczba wolnych pól sąsiadujących z graczem
+	atomic_uint_fast32_t no_open; 	///< liczba nienasyconych graczy bez znalezionego złotego ruchu
+} status_scan;
+
+/** @brief sprawdza czy gracz wciąż szuka pola na złoty ruch
+ * @param[in] scan 	- przeszukiwanie, w ramach którego pytamy
+ * @param[in] player 	- id gracza
+ *
+ * @return true jeżeli gracz może wykonać złoty ruch, a nie znaleźliśmy jeszcze pola
+ */
+static bool status_open(status_scan* scan, uint32_t player){
+	return scan->can_golden[player] && 
+	       !atomic_load_explicit(&scan->golden[player], memory_order_relaxed);
+}
+
+/** @brief oznacza, że gracz może wykonać złoty ruch
+ * @param[in,out] scan 	- przeszukiwanie, w ramach którego oznaczamy
+ * @param[in] player 	- id gracza
+ */
+static void status_mark_golden(status_scan* scan, uint32_t player){
+	if(!atomic_exchange(&scan->golden[player], true) && !scan->saturated[player])
+		atomic_fetch_sub(&scan->no_open, 1);
+}
+
+/** @brief sprawdza zajęte pole (x, y) - czy któryś z graczy może wykonać na nie złoty ruch
+ * Jeżeli właściciel pola jest nasycony, to dolicza mu wolne pola brzegu liczone
+ * przy tym polu. Test właściciela pola wykonujemy tylko jeżeli któryś z graczy
+ * wciąż szuka pola na złoty ruch.
+ * @param[in,out] scan 	- przeszukiwanie, w ramach którego sprawdzamy pole
+ * @param[in] t 	- kafelek zawierający pole (x, y)
+ * @param[in] owner 	- id gracza zajmującego pole (x, y)
+ * @param[in] x 	- odcięta pola
+ * @param[in] y 	- rzędna pola
+ */
+static void status_busy_field(status_scan* scan, const tile* t, uint32_t owner,
+			      uint32_t x, uint32_t y){
+	gamma_t* g = scan->g;
+	uint64_t owners[4];
+	neighbour_owners(g, t, x, y, owners);
+	if(scan->saturated[owner] && has_free_neighbour(owners)){
+		uint32_t border = free_neighbours_counted_at(g, owner, x, y, owners);
+		if(border > 0)
+			atomic_fetch_add_explicit(&scan->border[owner], border, memory_order_relaxed);
+	}
+	uint32_t open = atomic_load_explicit(&scan->no_open, memory_order_relaxed);
+	if(open > 0 && !scan->saturated[owner] && status_open(scan, owner))
+		open--;
+	uint32_t adjacent[4];
+	int no_adjacent = 0;
+	for(int i=0;i<4;i++){
+		uint64_t p = owners[i];
+		if(p != NO_NEIGHBOUR && p != 0 && p != owner && 
+		   scan->saturated[p] && status_open(scan, p))
+			adjacent[no_adjacent++] = p;
+	}
+	if(open == 0 && no_adjacent == 0)
+		return;
+	if(!gamma_try_golden_move_no_sideeffect(g, x, y))
+		return;
+	for(int i=0;i<no_adjacent;i++)
+		status_mark_golden(scan, adjacent[i]);
+	if(open > 0){
+		for(uint32_t p=1;p<=get_no_players(g);p++){
+			if(p != owner && !scan->saturated[p] && status_open(scan, p))
+				status_mark_golden(scan, p);
+		}
+	}
+}
+
+/** @brief przegląda jedną porcję kafelków, wywoływana przez pulę wątków
+ * wolne pola i kafelki bez zajętych pól pomijamy
+ * @param[in,out] arg 	- wskaźnik na strukturę status_scan
+ * @param[in] chunk 	- numer przeglądanej porcji
+ */
+static void status_scan_chunk(void* arg, uint32_t chunk){
+	status_scan* scan = arg;
+	tiled_board* b = &scan->g->board;
+	uint64_t from = (uint64_t)chunk*scan->tiles_per_chunk;
+	uint64_t to = from+scan->tiles_per_chunk;
+	if(to > b->no_tiles)
+		to = b->no_tiles;
+	for(uint64_t i=from; i<to; i++){
+		tile* t = b->tiles[i];
+		uint32_t x0 = t->tile_x << TILE_SHIFT;
+		uint32_t y0 = t->tile_y << TILE_SHIFT;
+		for(uint32_t dy=0; dy<board_tile_height(b, t); dy++){
+			for(uint32_t dx=0; dx<board_tile_width(b, t); dx++){
+				uint32_t owner = t->fields[board_field_index(b, dx, dy)].player_id;
+				if(owner != 0)
+					status_busy_field(scan, t, owner, x0+dx, y0+dy);
+			}
+		}
+	}
+}
+
+/** @brief zwalnia tablice przeszukiwania
+ * Tablice pochodzą z alokatora podanego przy tworzeniu gry, a nie z jej areny,
+ * więc kolejne wywołania nie zwiększają zajętej przez grę pamięci.
+ * @param[in] scan 	- przeszukiwanie, którego tablice zwalniamy
+ * @param[in] n 	- długość tablic
+ */
+static void free_status_scan(status_scan* scan, uint64_t n){
+	const allocator* base = &scan->g->base;
+	allocator_free(base, scan->saturated, n*sizeof(bool));
+	allocator_free(base, scan->can_golden, n*sizeof(bool));
+	allocator_free(base, scan->golden, n*sizeof(atomic_bool));
+	allocator_free(base, scan->border, n*sizeof(atomic_uint_fast64_t));
+}
+
+/** @brief liczy wyniki gamma_players_status bez zajmowania zamka gry
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
+ * @param[out] out 	– wyniki kolejnych graczy
+ *
+ * @return true jeżeli udało się policzyć wyniki, false wpp
+ */
+static bool scan_players_status(gamma_t* g, gamma_player_status_t* out){
+	if(g == NULL || out == NULL || !touch_game(g))
+		return false;
+	uint64_t n = (uint64_t)get_no_players(g)+1;
+	status_scan scan;
+	scan.g = g;
+	scan.saturated = allocator_alloc(&g->base, n*sizeof(bool));
+	scan.can_golden = allocator_alloc(&g->base, n*sizeof(bool));
+	scan.golden = allocator_alloc(&g->base, n*sizeof(atomic_bool));
+	scan.border = allocator_alloc(&g->base, n*sizeof(atomic_uint_fast64_t));
+	if(scan.saturated == NULL || scan.can_golden == NULL ||
+	   scan.golden == NULL || scan.border == NULL){
+		free_status_scan(&scan, n);
+		return false;
+	}
+	uint32_t no_open = 0;
+	scan.saturated[0] = false;
+	scan.can_golden[0] = false;
+	for(uint64_t p=0;p<n;p++){
+		if(p > 0){
+			scan.saturated[p] = player_all_areas_used(g, p);
+			scan.can_golden[p] = !get_player_golden_move_used(g, p);
+			if(scan.can_golden[p] && !scan.saturated[p])
+				no_open++;
+		}
+		atomic_init(&scan.golden[p], false);
+		atomic_init(&scan.border[p], 0);
+	}
+	atomic_init(&scan.no_open, no_open);
+
+	uint32_t no_chunks = split_into_chunks(g, &scan.tiles_per_chunk);
+	thread_pool_run(status_scan_chunk, &scan, no_chunks);
+
+	uint64_t free_fields = board_size(g)-sum_of_all_players_busy_fields(g);
+	for(uint64_t p=1;p<n;p++){
+		out[p-1].free_fields = scan.saturated[p]? atomic_load(&scan.border[p]) : free_fields;
+		out[p-1].golden_possible = atomic_load(&scan.golden[p]);
+	}
+	free_status_scan(&scan, n);
+	return true;
+}
+
+/** @brief Podaje liczbę wolnych pól i możliwość złotego ruchu dla wszystkich graczy.
+ * Wyniki są takie same jak gamma_free_fields i gamma_golden_possible wywołane
+ * dla każdego gracza, ale plansza jest przeglądana raz, równolegle porcjami kafelków.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] out    – tablica długości @ref get_no_players, pod indeksem
+ *                      i - 1 zapisujemy wynik dla gracza i.
+ * @return Wartość @p true, jeśli udało się policzyć wyniki, a @p false,
+ * gdy któryś z parametrów jest niepoprawny lub nie udało się zaalokować pamięci.
+ */
+bool gamma_players_status(gamma_t* g, gamma_player_status_t* out){
+	lock_for_reading(g);
+	bool flague = scan_players_status(g, out);
+	unlock_game(g);
+	return flague;
+}
+
+/** @brief Struktura z podziałem pamięci gry na kategorie, w bajtach.
+ * Odpowiada typowi gamma_memory_t z gamma.h.
+ */
+typedef struct{
+	uint64_t board; 	///< kafelki planszy, również wyzerowane przez gamma_reset,
+				///< lub plansza spakowana przez gamma_compact
+	uint64_t directory; 	///< katalog kafelków i tablica kafelków
+	uint64_t players; 	///< tablice graczy
+	uint64_t areas; 	///< tablice kolorów obszarów
+	uint64_t state; 	///< struktura stanu gry
+	uint64_t overhead; 	///< nieużywana pamięć areny gry
+	uint64_t scratch; 	///< pamięć pomocnicza przeszukiwań wywołującego wątku
+} gamma_memory_t;
+
+/** @brief zwraca pamięć tablic graczy
+ * @param[in] capacity 	- liczba graczy, dla których starcza tablic
+ *
+ * @return liczba bajtów
+ */
+static uint64_t player_table_memory(uint64_t capacity){
+	return (capacity+1)*(sizeof(uint64_t)+sizeof(uint32_t)+sizeof(bool));
+}
+
+/** @brief zwraca pamięć pomocniczą przeszukiwań wywołującego wątku
+ *
+ * @return liczba bajtów lub 0, jeżeli wątek jeszcze nie przeszukiwał planszy
+ */
+static uint64_t search_scratch_memory(void){
+	pthread_once(&scratch_key_once, make_scratch_key);
+	search_scratch* s = pthread_getspecific(scratch_key);
+	if(s == NULL)
+		return 0;
+	uint64_t memory = sizeof(search_scratch)+s->visited.capacity*
+			  (sizeof(uint64_t)+sizeof(uint32_t)+sizeof(uint8_t));
+	for(int i=0;i<MAX_FRAGMENTS;i++)
+		memory += s->stacks[i].capacity*sizeof(uint64_t);
+	return memory;
+}
+
+/** @brief Podaje pamięć zajmowaną przez grę.
+ * Liczy długości bloków przydzielonych na stan gry. Pamięć pomocnicza
+ * przeszukiwań jest wspólna dla wszystkich gier wątku, więc podajemy ją
+ * osobno i nie wliczamy do wyniku.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] out    – podział pamięci na kategorie lub NULL.
+ * @return Liczba bajtów zajmowanych przez grę lub zero, gdy @p g jest NULL.
+ */
+uint64_t gamma_memory_usage(gamma_t* g, gamma_memory_t* out){
+	if(g == NULL)
+		return 0;
+	gamma_memory_t m;
+	board_memory(&g->board, &m.board, &m.directory);
+	m.board += g->packed_size;
+	m.players = player_table_memory(g->players.capacity);
+	m.areas = (uint64_t)g->labels.capacity*(sizeof(uint64_t)+sizeof(uint32_t));
+	m.state = sizeof(gamma_t);
+	m.overhead = 0;
+	uint64_t total = m.board+m.directory+m.players+m.areas+m.state;
+	if(g->arena != NULL){
+		uint64_t reserved = arena_reserved(g->arena);
+		if(!g->board.huge_pages && reserved > total)
+			m.overhead = reserved-total;
+		total += m.overhead;
+	}
+	m.scratch = search_scratch_memory();
+	if(out != NULL)
+		*out = m;
+	return total;
+}
+
+/** @brief Szacuje z góry pamięć gry, zanim zostanie utworzona.
+ * Podaje pamięć gry utworzonej przez gamma_new, w której zajęto wszystkie
+ * pola, a liczba obszarów jest największa możliwa.
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz,
+ * @param[out] out    – podział pamięci na kategorie lub NULL.
+ * @return Górne ograniczenie liczby bajtów lub zero, gdy któryś z parametrów
+ * jest niepoprawny.
+ */
+uint64_t gamma_estimate_memory(uint32_t width, uint32_t height,
+			       uint32_t players, uint32_t areas,
+			       gamma_memory_t* out){
+	if(!gamma_new_valid_input(width, height, players, areas))
+		return 0;
+	gamma_memory_t m;
+	board_estimate_memory(width, height, &m.board, &m.directory);
+	m.players = player_table_memory(players);
+	uint64_t no_labels = (uint64_t)players*areas;
+	if(no_labels > (uint64_t)width*height)
+		no_labels = (uint64_t)width*height;
+	uint64_t capacity = INITIAL_LABELS_CAPACITY;
+	while(capacity < no_labels+1+MAX_FRAGMENTS && capacity < UINT32_MAX)
+		capacity *= 2;
+	if(capacity > UINT32_MAX)
+		capacity = UINT32_MAX;
+	m.areas = capacity*(sizeof(uint64_t)+sizeof(uint32_t));
+	m.state = sizeof(gamma_t);
+	m.overhead = 0;
+	m.scratch = 0;
+	if(out != NULL)
+		*out = m;
+	return m.board+m.directory+m.players+m.areas+m.state;
+}
+
+/** @brief napis rozpoczynający poprawny obraz stanu gry
+ */
+#define SNAPSHOT_MAGIC "GAMMASNP"
+
+/** @brief wersja formatu obrazu stanu gry
+ */
+#define SNAPSHOT_VERSION 1
+
+/** @brief Nagłówek obrazu stanu gry zapisywanego przez gamma_save.
+ * Za nagłówkiem leżą kolejno: tablice graczy no_busy_fields, no_areas_used
+ * i golden_move_used długości no_players+1, rozmiary obszarów o kolorach
+ * [0, no_labels], stos no_free zwolnionych kolorów, położenia no_tiles
+ * kafelków i same pola tych kafelków, w tej samej kolejności. Liczby
+ * zapisujemy w porządku bajtów maszyny, która zapisała obraz.
+ */
+typedef struct{
+	char magic[8]; 				///< SNAPSHOT_MAGIC bez kończącego zera
+	uint32_t version; 			///< SNAPSHOT_VERSION
+	uint32_t tile_side; 			///< TILE_SIDE
+	uint32_t width; 			///< szerokość planszy
+	uint32_t height; 			///< wysokość planszy
+	uint32_t no_players; 			///< liczba graczy
+	uint32_t max_no_areas; 			///< maksymalna liczba obszarów gracza
+	uint32_t layout; 			///< układ pól wewnątrz kafelków
+	uint32_t no_players_with_fields; 	///< players.no_players_with_fields
+	uint64_t total_busy_fields; 		///< players.total_busy_fields
+	uint32_t no_labels; 			///< labels.no_labels
+	uint32_t no_free; 			///< labels.no_free
+	uint64_t no_tiles; 			///< liczba kafelków planszy
+} snapshot_header;
+
+/** @brief Struktura opisująca położenie kafelka w obrazie stanu gry.
+ */
+typedef struct{
+	uint32_t tile_x; 	///< numer kolumny kafelków
+	uint32_t tile_y; 	///< numer wiersza kafelków
+} snapshot_tile_entry;
+
+/** @brief zapisuje obraz stanu gry z rozpakowaną planszą
+ * @param[in] g 	– wskaźnik na strukturę przechowującą stan gry
+ * @param[in] fd 	– deskryptor pliku otwartego do zapisu
+ *
+ * @return true jeżeli się udało, false przy błędzie zapisu lub braku pamięci
+ */
+static bool write_snapshot(gamma_t* g, int fd){
+	tiled_board* b = &g->board;
+	snapshot_tile_entry* entries = allocator_alloc(&g->base,
+						       (b->no_tiles+1)*sizeof(snapshot_tile_entry));
+	if(entries == NULL)
+		return false;
+	for(uint64_t i=0;i<b->no_tiles;i++){
+		entries[i].tile_x = b->tiles[i]->tile_x;
+		entries[i].tile_y = b->tiles[i]->tile_y;
+	}
+	snapshot_header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+	h.version = SNAPSHOT_VERSION;
+	h.tile_side = TILE_SIDE;
+	h.width = g->width;
+	h.height = g->height;
+	h.no_players = g->no_players;
+	h.max_no_areas = g->max_no_areas;
+	h.layout = b->layout;
+	h.no_players_with_fields = g->players.no_players_with_fields;
+	h.total_busy_fields = g->players.total_busy_fields;
+	h.no_labels = g->labels.no_labels;
+	h.no_free = g->labels.no_free;
+	h.no_tiles = b->no_tiles;
+	uint64_t n = (uint64_t)g->no_players+1;
+	bool success = fd_write_full(fd, &h, sizeof(h)) &&
+		       fd_write_full(fd, g->players.no_busy_fields, n*sizeof(uint64_t)) &&
+		       fd_write_full(fd, g->players.no_areas_used, n*sizeof(uint32_t)) &&
+		       fd_write_full(fd, g->players.golden_move_used, n*sizeof(bool)) &&
+		       fd_write_full(fd, g->labels.size,
+				     ((uint64_t)h.no_labels+1)*sizeof(uint64_t)) &&
+		       fd_write_full(fd, g->labels.free, h.no_free*sizeof(uint32_t)) &&
+		       fd_write_full(fd, entries, b->no_tiles*sizeof(snapshot_tile_entry));
+	for(uint64_t i=0;i<b->no_tiles && success;i++)
+		success = fd_write_full(fd, b->tiles[i]->fields, sizeof(b->tiles[i]->fields));
+	allocator_free(&g->base, entries, (b->no_tiles+1)*sizeof(snapshot_tile_entry));
+	return success;
+}
+
+/** @brief Zapisuje obraz stanu gry.
+ * Obraz zawiera planszę razem z kolorami obszarów, więc gamma_load nie
+ * przelicza obszarów ani nie powtarza ruchów.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] fd      – deskryptor pliku, potoku lub gniazda otwartego do zapisu.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy @p g jest NULL,
+ * wystąpił błąd zapisu lub zabrakło pamięci.
+ */
+bool gamma_save(gamma_t* g, int fd){
+	return g != NULL && touch_game(g) && write_snapshot(g, fd);
+}
+
+/** @brief sprawdza, czy nagłówek obrazu stanu gry jest poprawny
+ * @param[in] h 	– nagłówek
+ *
+ * @return true jeżeli nagłówek jest poprawny, false wpp
+ */
+static bool snapshot_header_valid(const snapshot_header* h){
+	uint64_t tiles = (((uint64_t)h->width+TILE_MASK) >> TILE_SHIFT)*
+			 (((uint64_t)h->height+TILE_MASK) >> TILE_SHIFT);
+	bool flague = true;
+	flague = flague && memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) == 0;
+	flague = flague && h->version == SNAPSHOT_VERSION && h->tile_side == TILE_SIDE;
+	flague = flague && gamma_new_valid_input(h->width, h->height,
+						 h->no_players, h->max_no_areas);
+	flague = flague && (h->layout == BOARD_LAYOUT_ROWS || h->layout == BOARD_LAYOUT_MORTON);
+	flague = flague && h->no_players_with_fields <= h->no_players;
+	flague = flague && h->total_busy_fields <= (uint64_t)h->width*h->height;
+	flague = flague && h->no_labels < UINT32_MAX && h->no_free <= h->no_labels;
+	flague = flague && h->no_labels <= (uint64_t)h->width*h->height;
+	flague = flague && h->no_tiles <= tiles;
+	return flague;
+}
+
+/** @brief sprawdza pola wczytanego kafelka
+ * Każde pole musi należeć do gracza gry i mieć wydany kolor, a puste pole
+ * i tylko ono ma kolor 0.
+ * @param[in] g 	– wskaźnik na strukturę przechowującą wczytany stan gry
+ * @param[in] t 	– sprawdzany kafelek
+ *
+ * @return true jeżeli pola są poprawne, false wpp
+ */
+static bool tile_fields_valid(gamma_t* g, const tile* t){
+	bool flague = true;
+	for(uint32_t i=0;i<TILE_SIDE*TILE_SIDE && flague;i++){
+		field f = t->fields[i];
+		flague = f.player_id <= get_no_players(g) && f.area_id <= g->labels.no_labels &&
+			 (f.player_id == 0) == (f.area_id == 0);
+	}
+	return flague;
+}
+
+/** @brief wczytuje tablice graczy, kolory obszarów i kafelki obrazu stanu gry
+ * @param[in,out] g 	– wskaźnik na nową grę o wymiarach i liczbie graczy z nagłówka
+ * @param[in] fd 	– deskryptor pliku ustawiony za nagłówkiem
+ * @param[in] h 	– poprawny nagłówek obrazu
+ *
+ * Sprawdza zakresy wczytanych liczb, więc niepoprawny obraz nie prowadzi do
+ * odwołań poza tablice gry.
+ * @return true jeżeli się udało, false przy błędzie odczytu, niepoprawnym obrazie
+ * lub braku pamięci
+ */
+static bool read_snapshot(gamma_t* g, int fd, const snapshot_header* h){
+	uint64_t n = (uint64_t)h->no_players+1;
+	bool success = fd_read_full(fd, g->players.no_busy_fields, n*sizeof(uint64_t)) &&
+		       fd_read_full(fd, g->players.no_areas_used, n*sizeof(uint32_t)) &&
+		       fd_read_full(fd, g->players.golden_move_used, n*sizeof(bool));
+	g->players.total_busy_fields = h->total_busy_fields;
+	g->players.no_players_with_fields = h->no_players_with_fields;
+	while(success && g->labels.capacity <= h->no_labels)
+		success = grow_labels(g);
+	success = success &&
+		  fd_read_full(fd, g->labels.size, ((uint64_t)h->no_labels+1)*sizeof(uint64_t)) &&
+		  fd_read_full(fd, g->labels.free, h->no_free*sizeof(uint32_t));
+	g->labels.no_labels = h->no_labels;
+	g->labels.no_free = h->no_free;
+	success = success && players_valid(g) && free_labels_valid(g);
+	snapshot_tile_entry* entries = NULL;
+	if(success)
+		entries = allocator_alloc(&g->base, (h->no_tiles+1)*sizeof(snapshot_tile_entry));
+	success = entries != NULL &&
+		  fd_read_full(fd, entries, h->no_tiles*sizeof(snapshot_tile_entry));
+	tiled_board* b = &g->board;
+	for(uint64_t i=0;i<h->no_tiles && success;i++){
+		success = entries[i].tile_x < b->tiles_x && entries[i].tile_y < b->tiles_y &&
+			  board_find_tile(b, entries[i].tile_x, entries[i].tile_y) == NULL;
+		tile* t = NULL;
+		if(success)
+			t = board_alloc_tile(b, entries[i].tile_x << TILE_SHIFT,
+					     entries[i].tile_y << TILE_SHIFT);
+		success = t != NULL && fd_read_full(fd, t->fields, sizeof(t->fields)) &&
+			  tile_fields_valid(g, t);
+	}
+	allocator_free(&g->base, entries, (h->no_tiles+1)*sizeof(snapshot_tile_entry));
+	return success;
+}
+
+/** @brief Odtwarza grę z obrazu stanu gry zapisanego przez gamma_save.
+ * @param[in] fd      – deskryptor pliku, potoku lub gniazda ustawiony na
+ *                      początku obrazu,
+ * @param[in] params  – dodatkowe parametry lub NULL; układ planszy pochodzi z obrazu.
+ * @return Wskaźnik na strukturę przechowującą stan gry lub NULL, gdy obraz
+ * nie jest poprawny, wystąpił błąd odczytu lub nie udało się zaalokować pamięci.
+ */
+gamma_t* gamma_load(int fd, const gamma_params_t* params){
+	snapshot_header h;
+	game_storage storage;
+	if(!params_storage(params, &storage) || !fd_read_full(fd, &h, sizeof(h)) ||
+	   !snapshot_header_valid(&h))
+		return NULL;
+	storage.layout = h.layout;
+	gamma_t* g = make_game_state(h.width, h.height, h.no_players, h.max_no_areas, &storage);
+	if(g != NULL && !read_snapshot(g, fd, &h)){
+		free_game_state(g);
+		return NULL;
+	}
+	return g;
+}
+
+/** @brief zwraca id gracza zajmującego pole (x, y) kafelka t
+ * @param[in] g 	- wskaźnik na strukturę przechowującą stan gry
+ * @param[in] t 	- kafelek zawierający pole lub NULL, jeżeli nie został zaalokowany
+ * @param[in] x 	- odcięta pola
+ * @param[in] y 	- rzędna pola
+ *
+ * @return id gracza zajmującego pole, 0 dla pola wolnego
+ */
+static uint32_t tile_player_id(gamma_t* g, const tile* t, uint32_t x, uint32_t y){
+	if(t == NULL)
 		return 0;
+	return t->fields[board_field_index(&g->board, x & TILE_MASK, y & TILE_MASK)].player_id;
 }
 
 /** @brief Daje napis opisujący stan planszy jeżeli liczba graczy <10
@@ -1179,11 +3174,18 @@ static char* print_board_without_space(gamma_t* g){
 			uint32_t h = get_height(g);
 			uint32_t w = get_width(g);
 			uint64_t it = 0;
-			for(int i=h-1;i>=0;i--){
-				for(uint32_t j=0;j<w;j++){
-					field f = get_field(g,j,i);
-					buffer[it] = f.player_id == 0? '.' : (f.player_id+'0');
-					it++;
+			for(uint32_t i=h;i-- > 0;){
+				for(uint32_t j=0;j<w;j+=TILE_SIDE){
+					uint32_t segment = w-j < TILE_SIDE? w-j : TILE_SIDE;
+					const tile* t = board_find_tile(&g->board, j >> TILE_SHIFT,
+									i >> TILE_SHIFT);
+					if(t == NULL)
+						memset(buffer+it, '.', segment);
+					for(uint32_t k=0;k<segment && t != NULL;k++){
+						uint32_t player_id = tile_player_id(g, t, j+k, i);
+						buffer[it+k] = player_id == 0? '.' : (player_id+'0');
+					}
+					it+= segment;
 				}
 				buffer[it] = '\n';
 				it++;
@@ -1220,7 +3222,7 @@ static uint32_t len(uint32_t n){
 static uint32_t max_player_id_on_board(gamma_t* g){
 	uint32_t p = 0;
 	for(uint32_t i = get_no_players(g); i!=0; i--){
-		if(gamma_busy_fields(g, i) != 0){
+		if(get_player_no_busy_fields(g, i) != 0){
 			p=i;
 			break;
 		}
@@ -1243,7 +3245,9 @@ static uint32_t max_player_id_on_board(gamma_t* g){
  * @return log(największy aktywny gracz na planszy) zaokrąglony w dół
  */
 uint32_t length_of_max_player_id_on_board(gamma_t* g){
-	uint32_t max_player_id = max_player_id_on_board(g);
+	lock_for_reading(g);
+	uint32_t max_player_id = touch_game(g)? max_player_id_on_board(g) : 0;
+	unlock_game(g);
 	return len(max_player_id);
 }
 
@@ -1255,7 +3259,7 @@ uint32_t length_of_max_player_id_on_board(gamma_t* g){
  * param[in] no_places_it_should_take 	- ile miejsc powinniśmy zapisać w bufferze
  * param[in] player_id 			- id gracza, którego wpisujemy
  */
-static void insert_player_id_in_buffer(char* buffer, uint32_t ptr,
+static void insert_player_id_in_buffer(char* buffer, uint64_t ptr,
 				       uint32_t no_places_it_should_take,
 				       uint32_t player_id){
 	if(player_id != 0){
@@ -1288,15 +3292,17 @@ static void insert_player_id_in_buffer(char* buffer, uint32_t ptr,
 static char* print_board_with_space(gamma_t* g, uint32_t size_of_pocket){
 	uint32_t h = get_height(g);
 	uint32_t w = get_width(g);
-	char* buffer = malloc((h*w*(size_of_pocket+1)+1)*sizeof(char));
+	char* buffer = malloc((board_size(g)*(size_of_pocket+1)+1)*sizeof(char));
 	if(buffer == NULL)
 		return NULL;
-	uint32_t it = 0;
-	for(int i=h-1;i>=0;i--){
+	uint64_t it = 0;
+	const tile* t = NULL;
+	for(uint32_t i=h;i-- > 0;){
 		for(uint32_t j=0;j<w;j++){
-			field f = get_field(g,j,i);
+			if((j & TILE_MASK) == 0)
+				t = board_find_tile(&g->board, j >> TILE_SHIFT, i >> TILE_SHIFT);
 			insert_player_id_in_buffer(buffer, it, size_of_pocket, 
-						   f.player_id);
+						   tile_player_id(g, t, j, i));
 			it+= size_of_pocket;
 			if(j!=w-1){
 				buffer[it] = ' ';
@@ -1320,15 +3326,125 @@ static char* print_board_with_space(gamma_t* g, uint32_t size_of_pocket){
  * planszy lub NULL, jeśli nie udało się zaalokować pamięci.
  */
 char* gamma_board(gamma_t *g){
-	if(g != NULL){
-		uint32_t size_of_pocket = length_of_max_player_id_on_board(g);
+	lock_for_reading(g);
+	char* board = NULL;
+	if(g != NULL && touch_game(g)){
+		uint32_t size_of_pocket = len(max_player_id_on_board(g));
+		if(g->mapped != NULL)
+			mapped_advise_sequential(g->mapped, true);
 	 	if(size_of_pocket>1){
-	 		return print_board_with_space(g, size_of_pocket);
+	 		board = print_board_with_space(g, size_of_pocket);
 		 }
 		 else{
-			return print_board_without_space(g);
+			board = print_board_without_space(g);
 		 }
+		if(g->mapped != NULL)
+			mapped_advise_sequential(g->mapped, false);
 	}
-	else
+	unlock_game(g);
+	return board;
+ }
+/** @brief czyta kolejne pole wiersza napisu opisującego planszę
+ * @param[in,out] text 	- wskaźnik na miejsce w napisie, przesuwany za pole
+ * @param[in] tokens 	- true jeżeli pola są oddzielone spacjami
+ * @param[out] owner 	- id gracza na polu lub 0 dla pustego pola
+ *
+ * @return true jeżeli pole jest poprawne, false wpp
+ */
+static bool parse_board_field(const char** text, bool tokens, uint32_t* owner){
+	const char* p = *text;
+	if(*p == '.'){
+		*owner = 0;
+		p++;
+	} else if(!tokens){
+		if(*p < '1' || *p > '9')
+			return false;
+		*owner = *p-'0';
+		p++;
+	} else{
+		if(*p < '1' || *p > '9')
+			return false;
+		uint64_t value = 0;
+		while(*p >= '0' && *p <= '9' && value <= UINT32_MAX){
+			value = 10*value+(*p-'0');
+			p++;
+		}
+		if(value > UINT32_MAX)
+			return false;
+		*owner = value;
+	}
+	if(tokens && *p != ' ' && *p != '\n' && *p != '\0')
+		return false;
+	*text = p;
+	return true;
+}
+
+/** @brief czyta wiersz napisu opisującego planszę razem z kończącym go znakiem nowej linii
+ * @param[in,out] text 	- wskaźnik na początek wiersza, przesuwany za wiersz
+ * @param[in] tokens 	- true jeżeli pola są oddzielone spacjami
+ * @param[out] row 	- id graczy na polach wiersza lub NULL, gdy tylko liczymy pola
+ * @param[in] width 	- rozmiar tablicy row
+ *
+ * @return liczba pól wiersza lub UINT64_MAX, jeżeli wiersz jest niepoprawny
+ * albo ma więcej niż width pól
+ */
+static uint64_t parse_board_row(const char** text, bool tokens, uint32_t* row,
+				uint64_t width){
+	uint64_t length = 0;
+	while(true){
+		while(tokens && **text == ' ')
+			(*text)++;
+		if(**text == '\n' || **text == '\0')
+			break;
+		uint32_t owner;
+		if(!parse_board_field(text, tokens, &owner) || (row != NULL && length == width))
+			return UINT64_MAX;
+		if(row != NULL)
+			row[length] = owner;
+		length++;
+	}
+	if(**text == '\n')
+		(*text)++;
+	return length;
+}
+
+/** @brief Odczytuje układ pionków z napisu opisującego planszę.
+ * Czyta napis w postaci zwracanej przez @ref gamma_board. Jeśli napis
+ * zawiera spację, pola są liczbami lub kropkami oddzielonymi spacjami,
+ * wpp każde pole to jeden znak. Wynik nadaje się dla @ref gamma_load_board.
+ * Funkcja wywołująca musi zwolnić zwróconą tablicę.
+ * @param[in] text    – napis opisujący planszę,
+ * @param[out] width  – szerokość planszy,
+ * @param[out] height – wysokość planszy.
+ * @return Wskaźnik na zaalokowaną tablicę długości width * height z numerem
+ * gracza na polu (x, y) pod indeksem y * width + x lub NULL, gdy napis
+ * jest niepoprawny, wiersze mają różne długości lub nie udało się
+ * zaalokować pamięci.
+ */
+uint32_t* gamma_parse_board(const char* text, uint32_t* width, uint32_t* height){
+	if(text == NULL || width == NULL || height == NULL)
+		return NULL;
+	bool tokens = strchr(text, ' ') != NULL;
+	uint64_t h = 0;
+	for(const char* p = text;*p != '\0';p++){
+		if(*p == '\n' || p[1] == '\0')
+			h++;
+	}
+	const char* p = text;
+	uint64_t w = parse_board_row(&p, tokens, NULL, 0);
+	if(w == 0 || w > UINT32_MAX || h > UINT32_MAX)
 		return NULL;
- }
\ No newline at end of file
+	uint32_t* owners = malloc(w*h*sizeof(uint32_t));
+	if(owners == NULL)
+		return NULL;
+	p = text;
+	for(uint64_t i=h;i-- > 0;){
+		if(parse_board_row(&p, tokens, owners+i*w, w) != w){
+			free(owners);
+			return NULL;
+		}
+	}
+	*width = w;
+	*height = h;
+	return owners;
+}
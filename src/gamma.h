@@ -10,6 +10,7 @@
 #define GAMMA_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /**
@@ -52,13 +53,248 @@ uint32_t get_no_players(gamma_t* g);
 gamma_t* gamma_new(uint32_t width, uint32_t height,
                    uint32_t players, uint32_t areas);
 
+/**
+ * Układ pól planszy w pamięci. Plansza jest podzielona na kafelki 64 x 64 pola,
+ * układ opisuje kolejność pól wewnątrz kafelka.
+ */
+typedef enum{
+	GAMMA_LAYOUT_ROWS, 	///< pola zapisane wierszami
+	GAMMA_LAYOUT_MORTON, 	///< pola zapisane w porządku Mortona (krzywa Z), sąsiedzi
+				///< w pionie leżą zwykle blisko siebie w pamięci
+} gamma_layout_t;
+
+/**
+ * Alokator pamięci stanu gry podany przez użytkownika. Funkcje dostają
+ * pole context jako pierwszy argument. Długości bloków podajemy również
+ * przy powiększaniu i zwalnianiu, więc alokator nie musi ich pamiętać.
+ */
+typedef struct{
+	void* (*alloc)(void* context, size_t size); 	///< zwraca wyzerowany blok lub NULL
+	void* (*realloc)(void* context, void* ptr, size_t old_size,
+			 size_t size); 			///< powiększa blok, dopisana część nie musi być
+							///< wyzerowana; przy błędzie zwraca NULL i zostawia blok
+	void (*free)(void* context, void* ptr, size_t size); ///< zwalnia blok, NULL jeżeli bloki
+							///< zwalniamy razem z całym alokatorem
+	void* context; 					///< dane przekazywane funkcjom alokatora
+} gamma_allocator_t;
+
+/**
+ * Struktura z dodatkowymi parametrami tworzenia gry.
+ */
+typedef struct{
+	gamma_layout_t layout; 	///< układ pól planszy w pamięci
+	bool huge_pages; 	///< true jeżeli plansza i tablice graczy mają leżeć
+				///< na dużych stronach (transparent huge pages)
+	const gamma_allocator_t* allocator; ///< alokator stanu gry lub NULL dla malloc i free
+	bool arena; 		///< true jeżeli cały stan gry ma leżeć w jednej arenie
+				///< zwalnianej naraz przez @ref gamma_delete
+} gamma_params_t;
+
+/** @brief Tworzy strukturę przechowującą stan gry z dodatkowymi parametrami.
+ * Działa jak @ref gamma_new, a @p params wybiera sposób przechowywania planszy.
+ * Wywołanie z @p params równym NULL jest równoważne @ref gamma_new, które
+ * używa układu GAMMA_LAYOUT_ROWS. Duże strony przyspieszają przeszukiwanie
+ * dużych plansz, ale każdy zajęty fragment planszy zajmuje wtedy 2 MiB;
+ * włącza je też zmienna środowiskowa GAMMA_HUGE_PAGES=1, która dotyczy
+ * również pamięci pomocniczej przeszukiwań. Duże strony dotyczą tylko gier
+ * bez własnego alokatora i areny. Arena pobiera pamięć z alokatora gry
+ * coraz większymi porcjami, nie zwalnia pojedynczych bloków, a
+ * @ref gamma_delete oddaje wszystkie porcje naraz. Pamięć pomocnicza
+ * przeszukiwań, wspólna dla gier w jednym wątku, zawsze pochodzi z malloc.
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz,
+ * @param[in] params  – dodatkowe parametry lub NULL.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
+ */
+gamma_t* gamma_new_ex(uint32_t width, uint32_t height,
+                      uint32_t players, uint32_t areas,
+                      const gamma_params_t* params);
+
+/** @brief Otwiera grę, której stan przechowujemy w pliku odwzorowanym w pamięci.
+ * Plansza i tablice graczy leżą w pliku @p path, więc gra może być większa
+ * od pamięci operacyjnej, a system sprowadza do niej tylko używane strony.
+ * Jeżeli plik nie istnieje lub jest pusty, tworzy w nim nową grę tak jak
+ * @ref gamma_new_ex. W przeciwnym razie otwiera grę zapisaną w pliku przez
+ * @ref gamma_delete bez czytania planszy; parametry równe 0 są wtedy
+ * pomijane, pozostałe muszą zgadzać się z zapisanymi, a @p params jest
+ * ignorowany. Niepustego pliku, którego nie udało się otworzyć lub który
+ * nie zawiera poprawnej gry, nie zmienia. Plik zależy od architektury
+ * komputera, który go utworzył. Pola huge_pages, allocator i arena
+ * parametrów nie dotyczą gry w pliku.
+ * @param[in] path    – ścieżka do pliku,
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz,
+ * @param[in] params  – dodatkowe parametry nowej gry lub NULL.
+ * @return Wskaźnik na strukturę przechowującą stan gry lub NULL, gdy nie
+ * udało się otworzyć pliku lub zaalokować pamięci, plik nie zawiera
+ * poprawnie zamkniętej gry lub któryś z parametrów jest niepoprawny.
+ */
+gamma_t* gamma_open_mapped(const char* path, uint32_t width, uint32_t height,
+                           uint32_t players, uint32_t areas,
+                           const gamma_params_t* params);
+
+/** @brief Zapisuje obraz stanu gry.
+ * Obraz w wersjonowanym formacie binarnym zawiera nagłówek z wymiarami,
+ * liczbą graczy i obszarów, tablice graczy, kolory obszarów i zajęte
+ * fragmenty planszy 64 x 64 pola razem z kolorami pól, więc
+ * @ref gamma_load nie powtarza ruchów ani nie przelicza obszarów.
+ * Obraz zależy od architektury komputera, który go zapisał.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] fd      – deskryptor pliku, potoku lub gniazda otwartego do zapisu.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy @p g jest NULL,
+ * wystąpił błąd zapisu lub zabrakło pamięci.
+ */
+bool gamma_save(gamma_t *g, int fd);
+
+/** @brief Odtwarza grę z obrazu stanu gry zapisanego przez @ref gamma_save.
+ * Czyta dokładnie jeden obraz, więc kolejne obrazy mogą leżeć w tym samym
+ * pliku lub przychodzić tym samym potokiem.
+ * @param[in] fd      – deskryptor pliku, potoku lub gniazda ustawiony na
+ *                      początku obrazu,
+ * @param[in] params  – dodatkowe parametry lub NULL; układ planszy
+ *                      pochodzi z obrazu.
+ * @return Wskaźnik na strukturę przechowującą stan gry lub NULL, gdy obraz
+ * nie jest poprawny, wystąpił błąd odczytu lub nie udało się zaalokować pamięci.
+ */
+gamma_t* gamma_load(int fd, const gamma_params_t* params);
+
 /** @brief Usuwa strukturę przechowującą stan gry.
  * Usuwa z pamięci strukturę wskazywaną przez @p g.
  * Nic nie robi, jeśli wskaźnik ten ma wartość NULL.
+ * Stan gry otwartej przez @ref gamma_open_mapped zapisuje w pliku, pomijając
+ * błędy zapisu (sprawdza je @ref gamma_close_mapped), a grę utworzoną przez
+ * @ref gamma_pool_game oddaje do jej puli.
  * @param[in] g       – wskaźnik na usuwaną strukturę.
  */
 void gamma_delete(gamma_t *g);
 
+/** @brief Zamyka grę otwartą przez @ref gamma_open_mapped i zgłasza błąd zapisu.
+ * Działa jak @ref gamma_delete, ale sprawdza, czy stan gry trafił na dysk.
+ * Jeżeli nie udało się powiększyć pliku o opisy fragmentów planszy, gra
+ * pozostaje otwarta i można spróbować ponownie lub ją usunąć; plik nie
+ * zawiera wtedy poprawnie zamkniętej gry.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli gra jest zamknięta i zapisana na dysku,
+ * a @p false, gdy @p g nie jest grą w pliku, nie udało się powiększyć pliku
+ * (gra pozostaje otwarta) lub zapis na dysk się nie powiódł (gra jest zamknięta).
+ */
+bool gamma_close_mapped(gamma_t *g);
+
+/** @brief Przygotowuje strukturę stanu gry do nowej rozgrywki.
+ * Doprowadza grę @p g do stanu takiego jak po @ref gamma_new z podanymi
+ * parametrami, ale używa ponownie jej pamięci: zeruje tylko fragmenty
+ * planszy zajęte w poprzedniej rozgrywce i nie przydziela pamięci, gdy nowa
+ * gra nie ma więcej graczy ani większego katalogu planszy niż poprzednia.
+ * Układ planszy i sposób przechowywania gry (@ref gamma_params_t) się nie
+ * zmieniają. Gra w arenie zwalnia zastąpione tablice dopiero w @ref gamma_delete.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy któryś
+ * z parametrów jest niepoprawny lub nie udało się zaalokować pamięci -
+ * stan gry się wtedy nie zmienia.
+ */
+bool gamma_reset(gamma_t *g, uint32_t width, uint32_t height,
+                 uint32_t players, uint32_t areas);
+
+/** @brief Pakuje planszę nieużywanej gry.
+ * Zapisuje planszę w zwartej postaci: każdy fragment 64 x 64 pola koduje
+ * słownikiem występujących w nim graczy, a pole numerem w słowniku na
+ * najmniejszej potrzebnej liczbie bitów. Zwalnia pamięć planszy oraz kolorów
+ * obszarów. Kolejne wywołanie funkcji czytającej
+ * planszę (@ref gamma_move, @ref gamma_golden_move, @ref gamma_free_fields,
+ * @ref gamma_golden_possible, @ref gamma_players_status, @ref gamma_board)
+ * rozpakowuje ją bez udziału wywołującego. Gier otwartych przez
+ * @ref gamma_open_mapped i gier w arenie nie pakujemy.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli plansza jest spakowana, a @p false, gdy
+ * @p g jest NULL, gra leży w pliku lub w arenie albo zabrakło pamięci -
+ * stan gry się wtedy nie zmienia.
+ */
+bool gamma_compact(gamma_t *g);
+
+/** @brief Pakuje planszę gry nieużywanej od poprzedniego wywołania.
+ * Wywoływana dla każdej gry co N sekund pakuje przez @ref gamma_compact gry,
+ * na których przez ostatnie N sekund nie wywołano żadnej funkcji czytającej
+ * planszę. Sama nie mierzy czasu, więc nie spowalnia ruchów.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli plansza jest spakowana, a @p false wpp.
+ */
+bool gamma_compact_idle(gamma_t *g);
+
+/** @brief Wczytuje układ pionków na planszę gry.
+ * Zastępuje planszę gry zadanym układem i odtwarza kolory obszarów oraz
+ * liczby pól i obszarów graczy jednym etykietowaniem spójnych składowych,
+ * w czasie liniowym względem rozmiaru planszy, równolegle w pasach planszy.
+ * Gracze nie mają po wczytaniu wykonanego złotego ruchu.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] owners  – numer gracza na polu (x, y) pod indeksem
+ *                      y * width + x lub 0 dla pustego pola.
+ * @return Wartość @p true, jeśli się udało, a @p false, gdy któryś
+ * z parametrów jest niepoprawny, numer gracza przekracza liczbę graczy,
+ * gracz ma więcej obszarów niż maksymalna ich liczba lub zabrakło
+ * pamięci - stan gry się wtedy nie zmienia.
+ */
+bool gamma_load_board(gamma_t *g, const uint32_t *owners);
+
+/**
+ * Struktura puli gier. Gry puli leżą w blokach pogrupowanych według długości,
+ * więc wiele małych gier zajmuje zwarty obszar pamięci. @ref gamma_delete
+ * oddaje grę z puli do puli w czasie stałym, a kolejna gra podobnego rozmiaru
+ * używa jej pamięci ponownie.
+ */
+typedef struct gamma_pool gamma_pool_t;
+
+/** @brief Tworzy pulę gier.
+ * @param[in] params  – dodatkowe parametry gier puli lub NULL; pola
+ *                      huge_pages i arena są pomijane, a alokator, jeżeli
+ *                      jest podany, dostarcza pamięć całej puli.
+ * @return Wskaźnik na pulę lub NULL, gdy nie udało się zaalokować pamięci
+ * lub któryś z parametrów jest niepoprawny.
+ */
+gamma_pool_t* gamma_pool_new(const gamma_params_t* params);
+
+/** @brief Tworzy grę w puli.
+ * Działa jak @ref gamma_new. Jeżeli w puli czeka usunięta gra o podobnej
+ * liczbie kafelków planszy, czyści ją jak @ref gamma_reset zamiast
+ * przydzielać pamięć.
+ * @param[in,out] pool – pula gier,
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz.
+ * @return Wskaźnik na grę lub NULL, gdy nie udało się zaalokować pamięci
+ * lub któryś z parametrów jest niepoprawny.
+ */
+gamma_t* gamma_pool_game(gamma_pool_t* pool, uint32_t width, uint32_t height,
+                         uint32_t players, uint32_t areas);
+
+/** @brief Podaje pamięć zajmowaną przez pulę gier.
+ * @param[in] pool    – pula gier,
+ * @param[out] games  – liczba gier puli, używanych i usuniętych, lub NULL,
+ * @param[out] idle   – liczba usuniętych gier czekających w puli lub NULL.
+ * @return Liczba bajtów pobranych przez pulę lub zero, gdy @p pool jest NULL.
+ */
+uint64_t gamma_pool_memory(gamma_pool_t* pool, uint64_t* games, uint64_t* idle);
+
+/** @brief Usuwa pulę gier razem z czekającymi w niej usuniętymi grami.
+ * Wszystkie gry puli muszą być wcześniej usunięte przez @ref gamma_delete.
+ * Nic nie robi, jeśli wskaźnik ten ma wartość NULL.
+ * @param[in] pool    – wskaźnik na usuwaną pulę.
+ */
+void gamma_pool_delete(gamma_pool_t* pool);
+
 /** @brief Wykonuje ruch.
  * Ustawia pionek gracza @p player na polu (@p x, @p y).
  * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
@@ -69,10 +305,34 @@ void gamma_delete(gamma_t *g);
  * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
  *                      @p height z funkcji @ref gamma_new.
  * @return Wartość @p true, jeśli ruch został wykonany, a @p false,
- * gdy ruch jest nielegalny lub któryś z parametrów jest niepoprawny.
+ * gdy ruch jest nielegalny, któryś z parametrów jest niepoprawny
+ * lub zabrakło pamięci - stan gry się wtedy nie zmienia.
  */
 bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
 
+/**
+ * Współrzędne pola planszy.
+ */
+typedef struct{
+	uint32_t x; 	///< numer kolumny
+	uint32_t y; 	///< numer wiersza
+} gamma_coord_t;
+
+/** @brief Wykonuje kolejno ruchy jednego gracza.
+ * Daje takie same wyniki jak @ref gamma_move wywołane po kolei dla każdego
+ * pola, ale sprawdza grę i gracza raz dla wszystkich ruchów.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia niewiększa od wartości
+ *                      @p players z funkcji @ref gamma_new,
+ * @param[in] coords  – tablica długości @p n z polami kolejnych ruchów,
+ * @param[in] n       – liczba ruchów,
+ * @param[out] results – tablica długości @p n, pod indeksem i zapisujemy
+ *                      1, jeśli i-ty ruch został wykonany, a 0 wpp.
+ * @return Liczba wykonanych ruchów.
+ */
+uint64_t gamma_move_batch(gamma_t *g, uint32_t player, const gamma_coord_t *coords,
+                          uint64_t n, uint8_t *results);
+
 /** @brief Wykonuje złoty ruch.
  * Ustawia pionek gracza @p player na polu (@p x, @p y) zajętym przez innego
  * gracza, usuwając pionek innego gracza.
@@ -84,11 +344,43 @@ bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
  * @param[in] y       – numer wiersza, liczba nieujemna mniejsza od wartości
  *                      @p height z funkcji @ref gamma_new.
  * @return Wartość @p true, jeśli ruch został wykonany, a @p false,
- * gdy gracz wykorzystał już swój złoty ruch, ruch jest nielegalny
- * lub któryś z parametrów jest niepoprawny.
+ * gdy gracz wykorzystał już swój złoty ruch, ruch jest nielegalny,
+ * któryś z parametrów jest niepoprawny lub zabrakło pamięci.
  */
 bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
 
+/** @brief Przygotowuje grę do równoległych zapytań.
+ * Rozpakowuje planszę spakowaną przez @ref gamma_compact i oznacza grę jako
+ * używaną. Od tej chwili do następnej zmiany stanu gry funkcje zapytań
+ * (@ref gamma_busy_fields, @ref gamma_free_fields, @ref gamma_golden_possible,
+ * @ref gamma_players_status, @ref gamma_board i
+ * @ref length_of_max_player_id_on_board) niczego w strukturze gry nie
+ * zapisują, więc można je wywoływać równolegle z wielu wątków. Nie wolno
+ * wtedy równocześnie wykonywać ruchów ani pakować gry.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli gra jest gotowa, a @p false, gdy @p g jest
+ * NULL lub zabrakło pamięci na rozpakowanie planszy.
+ */
+bool gamma_prepare_queries(gamma_t *g);
+
+/** @brief Włącza tryb współbieżny gry.
+ * Przygotowuje grę jak @ref gamma_prepare_queries i dodaje do niej zamek
+ * czytelników i pisarza. Od tej chwili z wielu wątków naraz można wywoływać
+ * zapytania (@ref gamma_busy_fields, @ref gamma_free_fields,
+ * @ref gamma_golden_possible, @ref gamma_players_status, @ref gamma_board
+ * i @ref length_of_max_player_id_on_board), które wykonują się równolegle,
+ * oraz ruchy (@ref gamma_move, @ref gamma_move_batch i @ref gamma_golden_move),
+ * które wykonują się pojedynczo i czekają na koniec trwających zapytań.
+ * Czekający ruch wstrzymuje nowe zapytania, więc zapytania nie zagłodzą ruchów.
+ * @ref gamma_compact i @ref gamma_compact_idle nie pakują takiej gry.
+ * Pozostałych funkcji, w tym @ref gamma_delete, nie wolno wywoływać równolegle
+ * z innymi. Samą funkcję trzeba wywołać, zanim inne wątki zaczną używać gry.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry.
+ * @return Wartość @p true, jeśli tryb jest włączony, a @p false, gdy @p g
+ * jest NULL lub zabrakło pamięci.
+ */
+bool gamma_enable_concurrency(gamma_t *g);
+
 /** @brief Podaje liczbę pól zajętych przez gracza.
  * Podaje liczbę pól zajętych przez gracza @p player.
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
@@ -122,6 +414,25 @@ uint64_t gamma_free_fields(gamma_t *g, uint32_t player);
  */
 bool gamma_golden_possible(gamma_t *g, uint32_t player);
 
+/**
+ * Struktura opisująca możliwości ruchu jednego gracza.
+ */
+typedef struct{
+	uint64_t free_fields; 	///< wynik gamma_free_fields dla gracza
+	bool golden_possible; 	///< wynik gamma_golden_possible dla gracza
+} gamma_player_status_t;
+
+/** @brief Podaje liczbę wolnych pól i możliwość złotego ruchu dla wszystkich graczy.
+ * Wyniki są takie same jak gamma_free_fields i gamma_golden_possible wywołane
+ * dla każdego gracza, ale plansza jest przeglądana raz, równolegle porcjami kafelków.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] out    – tablica długości @ref get_no_players, pod indeksem
+ *                      i - 1 zapisujemy wynik dla gracza i.
+ * @return Wartość @p true, jeśli udało się policzyć wyniki, a @p false,
+ * gdy któryś z parametrów jest niepoprawny lub nie udało się zaalokować pamięci.
+ */
+bool gamma_players_status(gamma_t* g, gamma_player_status_t* out);
+
 /** @brief zwraca długość napisu, jaki zajmuje największy gracz do wypisania
  * param[in] g 	- wskaźnik na strukturę przechowującą stan gry
  *
@@ -129,6 +440,50 @@ bool gamma_golden_possible(gamma_t *g, uint32_t player);
  */
 uint32_t length_of_max_player_id_on_board(gamma_t* g);
 
+/**
+ * Struktura z podziałem pamięci gry na kategorie, w bajtach.
+ */
+typedef struct{
+	uint64_t board; 	///< kafelki planszy 64 x 64 pola, również wyzerowane
+				///< i zachowane przez @ref gamma_reset, lub plansza
+				///< spakowana przez @ref gamma_compact
+	uint64_t directory; 	///< katalog kafelków planszy
+	uint64_t players; 	///< tablice graczy
+	uint64_t areas; 	///< tablice kolorów obszarów
+	uint64_t state; 	///< struktura stanu gry
+	uint64_t overhead; 	///< nieużywana pamięć areny gry
+	uint64_t scratch; 	///< pamięć pomocnicza przeszukiwań wywołującego wątku,
+				///< wspólna dla wszystkich gier tego wątku
+} gamma_memory_t;
+
+/** @brief Podaje pamięć zajmowaną przez grę.
+ * Liczy długości bloków przydzielonych na stan gry, bez nagłówków
+ * alokatora. Plansza na dużych stronach zajmuje całe duże strony.
+ * Pamięć pomocnicza przeszukiwań jest wspólna dla wszystkich gier wątku,
+ * więc podajemy ją osobno i nie wliczamy do wyniku.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] out    – podział pamięci na kategorie lub NULL.
+ * @return Liczba bajtów zajmowanych przez grę lub zero, gdy @p g jest NULL.
+ */
+uint64_t gamma_memory_usage(gamma_t* g, gamma_memory_t* out);
+
+/** @brief Szacuje z góry pamięć gry, zanim zostanie utworzona.
+ * Podaje pamięć gry utworzonej przez @ref gamma_new, w której zajęto
+ * wszystkie pola, a liczba obszarów jest największa możliwa. Wynik
+ * @ref gamma_memory_usage dla takiej gry nigdy go nie przekracza.
+ * @param[in] width   – szerokość planszy, liczba dodatnia,
+ * @param[in] height  – wysokość planszy, liczba dodatnia,
+ * @param[in] players – liczba graczy, liczba dodatnia,
+ * @param[in] areas   – maksymalna liczba obszarów,
+ *                      jakie może zająć jeden gracz,
+ * @param[out] out    – podział pamięci na kategorie lub NULL.
+ * @return Górne ograniczenie liczby bajtów lub zero, gdy któryś z parametrów
+ * jest niepoprawny.
+ */
+uint64_t gamma_estimate_memory(uint32_t width, uint32_t height,
+                               uint32_t players, uint32_t areas,
+                               gamma_memory_t* out);
+
 /** @brief Daje napis opisujący stan planszy.
  * Alokuje w pamięci bufor, w którym umieszcza napis zawierający tekstowy
  * opis aktualnego stanu planszy. Przykład znajduje się w pliku gamma_test.c.
@@ -139,4 +494,19 @@ uint32_t length_of_max_player_id_on_board(gamma_t* g);
  */
 char* gamma_board(gamma_t *g);
 
+/** @brief Odczytuje układ pionków z napisu opisującego planszę.
+ * Czyta napis w postaci zwracanej przez @ref gamma_board. Jeśli napis
+ * zawiera spację, pola są liczbami lub kropkami oddzielonymi spacjami,
+ * wpp każde pole to jeden znak. Wynik nadaje się dla @ref gamma_load_board.
+ * Funkcja wywołująca musi zwolnić zwróconą tablicę.
+ * @param[in] text    – napis opisujący planszę,
+ * @param[out] width  – szerokość planszy,
+ * @param[out] height – wysokość planszy.
+ * @return Wskaźnik na zaalokowaną tablicę długości width * height z numerem
+ * gracza na polu (x, y) pod indeksem y * width + x lub NULL, gdy napis
+ * jest niepoprawny, wiersze mają różne długości lub nie udało się
+ * zaalokować pamięci.
+ */
+uint32_t* gamma_parse_board(const char *text, uint32_t *width, uint32_t *height);
+
 #endif /* GAMMA_H */
@@ -0,0 +1,1155 @@
+/** @file
+ * Pomiary wydajności silnika gry gamma
+ *
+ * Każdy pomiar uruchamiamy osobno, podając jego nazwę jako jedyny argument,
+ * np. GAMMA_THREADS=8 ./gamma_bench golden_scan
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z clock_gettime()
+ */
+#define _XOPEN_SOURCE 700
+/** @brief makro potrzebne do korzystania z syscall()
+ */
+#define _DEFAULT_SOURCE
+
+#include "gamma.h"
+#include "bmserver.h"
+#include "shmchannel.h"
+#include "threadpool.h"
+
+/* CMake w wersji release wyłącza asercje. */
+#ifdef NDEBUG
+  #undef NDEBUG
+#endif
+
+#include <assert.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <malloc.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+/* Możliwe wyniki pomiaru */
+#define PASS 0
+#define WRONG_TEST 2
+
+/* Liczba elementów tablicy x */
+#define SIZE(x) (sizeof(x) / sizeof(x)[0])
+
+/** FUNKCJE POMOCNICZE **/
+
+/* Zwraca aktualny czas w sekundach. */
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Zwraca zajętą pamięć rezydentną procesu w MiB. */
+static double resident_mib(void) {
+  long pages = 0;
+  FILE *statm = fopen("/proc/self/statm", "r");
+  if (statm != NULL) {
+    if (fscanf(statm, "%*s %ld", &pages) != 1)
+      pages = 0;
+    fclose(statm);
+  }
+  return pages * (double)sysconf(_SC_PAGESIZE) / (1 << 20);
+}
+
+/* Zwraca pamięć procesu odwzorowaną dużymi stronami w MiB. */
+static double huge_pages_mib(void) {
+  long kib = 0;
+  char line[256];
+  FILE *smaps = fopen("/proc/self/smaps_rollup", "r");
+  if (smaps != NULL) {
+    while (fgets(line, sizeof(line), smaps) != NULL)
+      if (sscanf(line, "AnonHugePages: %ld kB", &kib) == 1)
+        break;
+    fclose(smaps);
+  }
+  return kib / 1024.0;
+}
+
+/* Konfiguracja licznika chybień w buforze TLB danych przy odczycie. */
+#define DTLB_READ_MISSES                                                       \
+  (PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |            \
+   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+/* Otwiera i uruchamia licznik sprzętowy zadanego rodzaju dla bieżącego
+ * wątku. Zwraca -1, jeżeli system nie udostępnia liczników sprzętowych. */
+static int counter_start(uint32_t type, uint64_t config) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (fd >= 0)
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  return fd;
+}
+
+/* Zatrzymuje licznik otwarty przez counter_start i zwraca jego wartość
+ * lub -1, jeżeli licznik nie jest dostępny. */
+static double counter_stop(int fd) {
+  if (fd < 0)
+    return -1;
+  long long count = -1;
+  ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  if (read(fd, &count, sizeof(count)) != sizeof(count))
+    count = -1;
+  close(fd);
+  return count;
+}
+
+/* Wypisuje wynik pomiaru. */
+static void report(const char *name, const char *unit, double value) {
+  printf("%s: threads = %" PRIu32 ", %.3f %s\n",
+         name, thread_pool_size(), value, unit);
+}
+
+/** POMIARY **/
+
+/* Mierzy czas pełnego przeszukania planszy przez gamma_golden_possible.
+ * Gracz 1 zajął już wszystkie obszary i nie sąsiaduje z żadnym polem gracza 2,
+ * więc złoty ruch nie jest możliwy i trzeba sprawdzić każde pole. */
+static int golden_scan(void) {
+  const uint32_t size = 2000;
+  const int queries = 20;
+  gamma_t *g = gamma_new(size, size, 2, 1);
+  assert(g != NULL);
+
+  for (uint32_t y = 0; y < size - 2; ++y)
+    for (uint32_t x = 0; x < size; ++x)
+      assert(gamma_move(g, 2, x, y));
+  assert(gamma_move(g, 1, size - 1, size - 1));
+
+  double start = now();
+  for (int i = 0; i < queries; ++i)
+    assert(!gamma_golden_possible(g, 1));
+  report("golden_scan", "ms per query", (now() - start) * 1e3 / queries);
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Mierzy czas złotych ruchów wewnątrz jednego dużego obszaru. Obszar pozostaje
+ * spójny, więc przeszukiwania sąsiadów usuwanego pola szybko się spotykają. */
+static int golden_big_area(void) {
+  const uint32_t size = 2000;
+  const uint32_t players = 102;
+  gamma_t *g = gamma_new(size, size, players, 1);
+  assert(g != NULL);
+
+  for (uint32_t y = 0; y < size; ++y)
+    for (uint32_t x = 0; x < size; ++x)
+      assert(gamma_move(g, 2, x, y));
+
+  double start = now();
+  for (uint32_t p = 3; p <= players; ++p)
+    assert(gamma_golden_move(g, p, 10 * p, size / 2));
+  report("golden_big_area", "us per golden move",
+         (now() - start) * 1e6 / (players - 2));
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Mierzy czas ruchów dołączających pojedyncze pole do bardzo dużego obszaru.
+ * Połączony obszar przejmuje kolor większego z łączonych obszarów, więc
+ * przemalowujemy tylko pojedyncze pole, a nie cały wiersz. */
+static int merge_into_big_area(void) {
+  const uint32_t size = 2000;
+  gamma_t *g = gamma_new(size, size, 1, size + 1);
+  assert(g != NULL);
+
+  for (uint32_t x = 0; x < size; ++x)
+    assert(gamma_move(g, 1, x, 0));
+  for (uint32_t x = 0; x < size; x += 2)
+    assert(gamma_move(g, 1, x, 2));
+
+  double start = now();
+  for (uint32_t x = 0; x < size; x += 2)
+    assert(gamma_move(g, 1, x, 1));
+  report("merge_into_big_area", "us per move", (now() - start) * 1e6 / (size / 2));
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Mierzy czas złotych ruchów odcinających krótki koniec długiego obszaru.
+ * Nowy kolor dostaje tylko mniejszy fragment, a rozmiar pozostałej części
+ * obliczamy bez jej przeglądania. */
+static int split_off_tail(void) {
+  const uint32_t size = 2000;
+  const uint32_t players = 1001;
+  gamma_t *g = gamma_new(size, size, players, size);
+  assert(g != NULL);
+
+  for (uint32_t y = 0; y < size; ++y)
+    assert(gamma_move(g, 1, 0, y));
+  for (uint32_t x = 1; x < size; ++x)
+    assert(gamma_move(g, 1, x, 0));
+
+  double start = now();
+  for (uint32_t p = 2; p <= players; ++p)
+    assert(gamma_golden_move(g, p, size + 1 - 2 * (p - 1), 0));
+  report("split_off_tail", "us per golden move",
+         (now() - start) * 1e6 / (players - 1));
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Mierzy najdroższy przypadek: złote ruchy przecinające w połowie obszar
+ * zajmujący trzecią część planszy na przemian ze zwykłymi ruchami, które
+ * łączą obie połowy z powrotem. Obszar to wąż z co trzeciego wiersza
+ * planszy połączonych na zmianę na lewym i prawym brzegu. Cięcie w środku
+ * węża przemalowuje mniejszą z połówek, a połączenie przemalowuje jedną
+ * z nich, więc obie operacje przeglądają około 670 tysięcy pól. Przed
+ * cięciem gracz 1 zajmuje pola na lewo i prawo pod ciętym polem, więc ruch
+ * na pole pod nim łączy połówki. */
+static int split_big_area(void) {
+  const uint32_t size = 2000, rounds = 20, row = size / 6 * 3;
+  gamma_t *g = gamma_new(size, size, rounds + 1, 2);
+  assert(g != NULL);
+
+  for (uint32_t y = 0; y < size; y += 3) {
+    for (uint32_t x = 0; x < size; ++x)
+      assert(gamma_move(g, 1, x, y));
+    uint32_t end = y / 3 % 2 == 0 ? size - 1 : 0;
+    for (uint32_t k = 1; k < 3 && y + 3 < size; ++k)
+      assert(gamma_move(g, 1, end, y + k));
+  }
+  uint64_t area = gamma_busy_fields(g, 1);
+
+  double cuts = 0, joins = 0;
+  for (uint32_t i = 0; i < rounds; ++i) {
+    uint32_t x = size / 2 - 2 * rounds + 4 * i;
+    assert(gamma_move(g, 1, x - 1, row + 1) && gamma_move(g, 1, x + 1, row + 1));
+    double start = now();
+    assert(gamma_golden_move(g, i + 2, x, row));
+    double middle = now();
+    assert(gamma_move(g, 1, x, row + 1));
+    joins += now() - middle;
+    cuts += middle - start;
+  }
+  assert(gamma_busy_fields(g, 1) == area + 2 * rounds);
+  report("split_big_area", "us per cut", cuts * 1e6 / rounds);
+  report("split_big_area", "us per join", joins * 1e6 / rounds);
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Gra, w której każdy z graczy zajął jeden poziomy pas planszy
+ * i wykorzystał już jedyny dozwolony obszar. */
+static gamma_t *striped_game(uint32_t size, uint32_t players) {
+  gamma_t *g = gamma_new(size, size, players, 1);
+  assert(g != NULL);
+  for (uint32_t y = 0; y < size; ++y)
+    for (uint32_t x = 0; x < size; ++x)
+      assert(gamma_move(g, y * players / size + 1, x, y));
+  return g;
+}
+
+/* Mierzy wyliczenie liczby wolnych pól i możliwości złotego ruchu
+ * zapytaniami o każdego gracza osobno, tak jak robił to tryb interaktywny. */
+static int players_status_serial(void) {
+  const uint32_t size = 1000, players = 128;
+  gamma_t *g = striped_game(size, players);
+
+  double start = now();
+  uint64_t free_fields = 0;
+  uint32_t golden = 0;
+  for (uint32_t p = 1; p <= players; ++p) {
+    free_fields += gamma_free_fields(g, p);
+    golden += gamma_golden_possible(g, p);
+  }
+  assert(free_fields == 0 && golden == players);
+  report("players_status_serial", "ms", (now() - start) * 1e3);
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Mierzy to samo wyliczenie wykonane jednym wywołaniem gamma_players_status. */
+static int players_status_shared(void) {
+  const uint32_t size = 1000, players = 128;
+  gamma_t *g = striped_game(size, players);
+  gamma_player_status_t status[players];
+
+  const int queries = 10;
+  double start = now();
+  for (int i = 0; i < queries; ++i)
+    assert(gamma_players_status(g, status));
+  report("players_status_shared", "ms per query", (now() - start) * 1e3 / queries);
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Mierzy zapytania o pojedynczego gracza w grze ze 100000 graczy, z których
+ * każdy ma jedno pole. Odpowiedzi zależą od sum po wszystkich graczach. */
+static int many_players_queries(void) {
+  const uint32_t width = 1000, height = 100, players = 100000;
+  const uint32_t queries = 100000;
+  gamma_t *g = gamma_new(width, height, players, 2);
+  assert(g != NULL);
+  for (uint32_t p = 1; p <= players; ++p)
+    assert(gamma_move(g, p, p % width, p / width % height));
+
+  double start = now();
+  uint64_t free_fields = 0;
+  for (uint32_t i = 0; i < queries; ++i)
+    free_fields += gamma_free_fields(g, i % players + 1);
+  assert(free_fields == 0);
+  report("many_players_queries", "us per gamma_free_fields",
+         (now() - start) * 1e6 / queries);
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Mierzy utworzenie gry na planszy 20000 x 20000 i pierwszy ruch na niej.
+ * Pusta plansza składa się z samych zer, więc gamma_new nie zapisuje pamięci
+ * proporcjonalnej do rozmiaru planszy. */
+static int big_board_startup(void) {
+  const uint32_t size = 20000, players = 4;
+  double memory_before = resident_mib();
+  double start = now();
+  gamma_t *g = gamma_new(size, size, players, 10);
+  assert(g != NULL);
+  report("big_board_startup", "ms per gamma_new", (now() - start) * 1e3);
+  start = now();
+  assert(gamma_move(g, 1, size / 2, size / 2));
+  assert(gamma_free_fields(g, 2) == (uint64_t)size * size - 1);
+  report("big_board_startup", "ms to first move", (now() - start) * 1e3);
+  report("big_board_startup", "MiB resident", resident_mib() - memory_before);
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Mierzy grę na planszy 1000000 x 1000000, na której gracze zajmują milion pól
+ * w skupiskach. Pamięć zależy od liczby zajętych kafelków, a nie od rozmiaru
+ * planszy. */
+static int sparse_open_world(void) {
+  const uint32_t size = 1000000, players = 1000, moves = 1000000;
+  double memory_before = resident_mib();
+  gamma_t *g = gamma_new(size, size, players, 100);
+  assert(g != NULL);
+
+  srand(1);
+  uint32_t x = size / 2, y = size / 2, placed = 0;
+  double start = now();
+  for (uint32_t i = 0; i < moves; ++i) {
+    if (i % 10000 == 0) {
+      x = rand() % size;
+      y = rand() % size;
+    }
+    x = (x + rand() % 3 + size - 1) % size;
+    y = (y + rand() % 3 + size - 1) % size;
+    placed += gamma_move(g, i / 10000 % players + 1, x, y);
+  }
+  report("sparse_open_world", "us per move", (now() - start) * 1e6 / moves);
+  report("sparse_open_world", "MiB resident",
+         resident_mib() - memory_before);
+  report("sparse_open_world", "MiB by gamma_memory_usage",
+         gamma_memory_usage(g, NULL) / (double)(1 << 20));
+
+  gamma_player_status_t *status = malloc(players * sizeof(gamma_player_status_t));
+  assert(status != NULL);
+  start = now();
+  assert(gamma_players_status(g, status));
+  report("sparse_open_world", "ms per gamma_players_status", (now() - start) * 1e3);
+  assert(status[0].free_fields > 0 && placed > 0);
+  free(status);
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Wypisuje czas i liczbę chybień w pamięci podręcznej na jedną operację. */
+static void report_layout(const char *name, const char *unit, double seconds,
+                          double misses, uint32_t operations) {
+  report(name, unit, seconds * 1e6 / operations);
+  if (misses >= 0)
+    report(name, "cache misses per operation", misses / operations);
+}
+
+/* Mierzy ruchy łączące pionowe kolumny z rosnącym obszarem. Każde połączenie
+ * przemalowuje całą kolumnę, przechodząc planszę w pionie. */
+static void vertical_snakes_in(const char *name, gamma_layout_t layout) {
+  const uint32_t size = 2000;
+  const gamma_params_t params = {layout, false, NULL, false};
+  gamma_t *g = gamma_new_ex(size, size, 1, size / 2 + 1, &params);
+  assert(g != NULL);
+
+  for (uint32_t x = 0; x < size; x += 2)
+    for (uint32_t y = 1; y < size; ++y)
+      assert(gamma_move(g, 1, x, y));
+
+  int counter = counter_start(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  double start = now();
+  for (uint32_t x = 0; x < size; ++x)
+    assert(gamma_move(g, 1, x, 0));
+  double seconds = now() - start;
+  report_layout(name, "us per move", seconds,
+                counter_stop(counter), size);
+
+  gamma_delete(g);
+}
+
+static int vertical_snakes(void) {
+  vertical_snakes_in("vertical_snakes/rows", GAMMA_LAYOUT_ROWS);
+  vertical_snakes_in("vertical_snakes/morton", GAMMA_LAYOUT_MORTON);
+  return PASS;
+}
+
+/* Mierzy złote ruchy odcinające pionowe zęby grzebienia od jego poziomego
+ * grzbietu. Odcięty ząb jest przeszukiwany i przemalowywany w pionie. */
+static void vertical_splits_in(const char *name, gamma_layout_t layout) {
+  const uint32_t size = 2000, teeth = size / 4;
+  const gamma_params_t params = {layout, false, NULL, false};
+  gamma_t *g = gamma_new_ex(size, size, teeth + 1, teeth + 1, &params);
+  assert(g != NULL);
+
+  for (uint32_t x = 0; x < size; ++x)
+    assert(gamma_move(g, 1, x, 0));
+  for (uint32_t x = 0; x < size; x += 4)
+    for (uint32_t y = 1; y < size; ++y)
+      assert(gamma_move(g, 1, x, y));
+
+  int counter = counter_start(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  double start = now();
+  for (uint32_t p = 2; p <= teeth + 1; ++p)
+    assert(gamma_golden_move(g, p, 4 * (p - 2), 1));
+  double seconds = now() - start;
+  report_layout(name, "us per golden move", seconds,
+                counter_stop(counter), teeth);
+
+  gamma_delete(g);
+}
+
+static int vertical_splits(void) {
+  vertical_splits_in("vertical_splits/rows", GAMMA_LAYOUT_ROWS);
+  vertical_splits_in("vertical_splits/morton", GAMMA_LAYOUT_MORTON);
+  return PASS;
+}
+
+/* Mierzy ponowne otwarcie gry zapisanej w pliku odwzorowanym w pamięci
+ * i pierwsze zapytanie po nim. Otwarcie nie czyta planszy, tylko odbudowuje
+ * katalog kafelków, więc kosztuje ułamek rozgrywania ruchów od nowa. */
+static int mapped_reopen(void) {
+  const char *path = "gamma_bench_mapped.tmp";
+  const uint32_t size = 1000000, players = 100, moves = 200000;
+  remove(path);
+  gamma_t *g = gamma_open_mapped(path, size, size, players, 100, NULL);
+  assert(g != NULL);
+
+  srand(1);
+  uint32_t x = size / 2, y = size / 2;
+  double start = now();
+  for (uint32_t i = 0; i < moves; ++i) {
+    if (i % 10000 == 0) {
+      x = rand() % size;
+      y = rand() % size;
+    }
+    x = (x + rand() % 3 + size - 1) % size;
+    y = (y + rand() % 3 + size - 1) % size;
+    gamma_move(g, i / 2000 % players + 1, x, y);
+  }
+  report("mapped_reopen", "ms to play moves", (now() - start) * 1e3);
+  uint64_t busy = gamma_busy_fields(g, 1);
+  start = now();
+  gamma_delete(g);
+  report("mapped_reopen", "ms to close", (now() - start) * 1e3);
+
+  start = now();
+  g = gamma_open_mapped(path, 0, 0, 0, 0, NULL);
+  assert(g != NULL);
+  report("mapped_reopen", "ms to reopen", (now() - start) * 1e3);
+  start = now();
+  assert(gamma_busy_fields(g, 1) == busy);
+  gamma_golden_possible(g, 1);
+  report("mapped_reopen", "ms to first golden_possible", (now() - start) * 1e3);
+
+  gamma_delete(g);
+  remove(path);
+  return PASS;
+}
+
+/* Mierzy pełne przeszukania planszy 3000 x 3000 w zwykłej pamięci i na
+ * dużych stronach: liczenie wolnych pól gracza, który zajął już wszystkie
+ * obszary, gamma_golden_possible i wypisywanie planszy. */
+static void huge_pages_scan_in(const char *name, bool huge_pages) {
+  const uint32_t size = 3000;
+  const int queries = 5;
+  const gamma_params_t params = {GAMMA_LAYOUT_ROWS, huge_pages, NULL, false};
+  double huge_before = huge_pages_mib();
+  gamma_t *g = gamma_new_ex(size, size, 2, 1, &params);
+  assert(g != NULL);
+
+  for (uint32_t y = 0; y < size - 2; ++y)
+    for (uint32_t x = 0; x < size; ++x)
+      assert(gamma_move(g, 2, x, y));
+  assert(gamma_move(g, 1, size - 1, size - 1));
+  report(name, "MiB on huge pages", huge_pages_mib() - huge_before);
+
+  int counter = counter_start(PERF_TYPE_HW_CACHE, DTLB_READ_MISSES);
+  double start = now();
+  for (int i = 0; i < queries; ++i)
+    assert(gamma_free_fields(g, 1) == 2);
+  double seconds = now() - start;
+  report(name, "ms per gamma_free_fields", seconds * 1e3 / queries);
+  report(name, "Mfields per second", (double)size * size * queries / seconds / 1e6);
+  double misses = counter_stop(counter);
+  if (misses >= 0)
+    report(name, "dTLB misses per gamma_free_fields", misses / queries);
+
+  counter = counter_start(PERF_TYPE_HW_CACHE, DTLB_READ_MISSES);
+  start = now();
+  for (int i = 0; i < queries; ++i)
+    assert(!gamma_golden_possible(g, 1));
+  report(name, "ms per gamma_golden_possible", (now() - start) * 1e3 / queries);
+  misses = counter_stop(counter);
+  if (misses >= 0)
+    report(name, "dTLB misses per gamma_golden_possible", misses / queries);
+
+  start = now();
+  char *board = gamma_board(g);
+  assert(board != NULL);
+  report(name, "ms per gamma_board", (now() - start) * 1e3);
+  free(board);
+
+  gamma_delete(g);
+}
+
+static int huge_pages_scan(void) {
+  huge_pages_scan_in("huge_pages_scan/off", false);
+  huge_pages_scan_in("huge_pages_scan/on", true);
+  return PASS;
+}
+
+/* Mierzy usuwanie gry z planszą 3000 x 3000, w której zajęto po kilka pól
+ * w każdym kafelku, na stercie i w arenie. */
+static void arena_delete_in(const char *name, bool arena) {
+  const uint32_t size = 3000;
+  const gamma_params_t params = {GAMMA_LAYOUT_ROWS, false, NULL, arena};
+  double start = now();
+  gamma_t *g = gamma_new_ex(size, size, 4, 10000, &params);
+  assert(g != NULL);
+  for (uint32_t y = 0; y < size; y += 16)
+    for (uint32_t x = 0; x < size; x += 16)
+      assert(gamma_move(g, (x + y) / 16 % 4 + 1, x, y));
+  report(name, "ms to fill", (now() - start) * 1e3);
+
+  start = now();
+  gamma_delete(g);
+  report(name, "ms per gamma_delete", (now() - start) * 1e3);
+}
+
+static int arena_delete(void) {
+  arena_delete_in("arena_delete/heap", false);
+  arena_delete_in("arena_delete/arena", true);
+  return PASS;
+}
+
+/* Rozgrywa krótką grę: każdy gracz wykonuje ruchy na losowe pola, aż zajętych
+ * zostanie około połowy planszy. */
+static void play_short_game(gamma_t *g, uint32_t size, uint32_t players) {
+  for (uint32_t i = 0; i < size * size / 2; ++i)
+    gamma_move(g, i % players + 1, rand() % size, rand() % size);
+}
+
+/* Mierzy liczbę krótkich gier na sekundę na planszy size x size, gdy każda
+ * gra dostaje nową strukturę z gamma_new i gdy jedna struktura jest
+ * czyszczona przez gamma_reset. */
+static void reset_games_in(const char *name, uint32_t size, int games) {
+  const uint32_t players = 4, areas = 10;
+  char label[64];
+  srand(5);
+  double start = now();
+  for (int i = 0; i < games; ++i) {
+    gamma_t *g = gamma_new(size, size, players, areas);
+    assert(g != NULL);
+    play_short_game(g, size, players);
+    gamma_delete(g);
+  }
+  snprintf(label, sizeof(label), "%s/new", name);
+  report(label, "games per second", games / (now() - start));
+
+  srand(5);
+  start = now();
+  gamma_t *g = gamma_new(size, size, players, areas);
+  assert(g != NULL);
+  for (int i = 0; i < games; ++i) {
+    assert(gamma_reset(g, size, size, players, areas));
+    play_short_game(g, size, players);
+  }
+  gamma_delete(g);
+  snprintf(label, sizeof(label), "%s/reset", name);
+  report(label, "games per second", games / (now() - start));
+}
+
+static int reset_games(void) {
+  reset_games_in("reset_games/10x10", 10, 200000);
+  reset_games_in("reset_games/100x100", 100, 2000);
+  return PASS;
+}
+
+/* Mierzy poczekalnię z wieloma małymi grami 10 x 10 z kilkoma ruchami: pamięć
+ * na grę i czas utworzenia i usunięcia gry w puli gier i na stercie oraz
+ * pamięć zajmowaną przez usuniętą grę czekającą w puli. Pula idzie pierwsza,
+ * bo sterta zatrzymuje zwolnioną pamięć i zaniżyłaby pomiar drugiej części. */
+static int pool_lobby(void) {
+  enum { GAMES = 2000, CHURN = 200000 };
+  static gamma_t *g[GAMES];
+  const uint32_t size = 10, players = 4, areas = 5;
+
+  gamma_pool_t *pool = gamma_pool_new(NULL);
+  assert(pool != NULL);
+  double memory_before = resident_mib();
+  double start = now();
+  for (int i = 0; i < GAMES; ++i) {
+    g[i] = gamma_pool_game(pool, size, size, players, areas);
+    assert(g[i] != NULL);
+    for (uint32_t p = 1; p <= players; ++p)
+      assert(gamma_move(g[i], p, p, i % size));
+  }
+  report("pool_lobby/pool", "us per game created", (now() - start) * 1e6 / GAMES);
+  report("pool_lobby/pool", "KiB resident per game",
+         (resident_mib() - memory_before) * 1024 / GAMES);
+  uint64_t games, idle;
+  report("pool_lobby/pool", "KiB reserved per game",
+         gamma_pool_memory(pool, &games, &idle) / 1024.0 / games);
+  start = now();
+  for (int i = 0; i < GAMES; ++i)
+    gamma_delete(g[i]);
+  report("pool_lobby/pool", "us per game deleted", (now() - start) * 1e6 / GAMES);
+  uint64_t memory = gamma_pool_memory(pool, &games, &idle);
+  assert(idle == GAMES);
+  report("pool_lobby/pool", "KiB reserved per idle game", memory / 1024.0 / idle);
+  start = now();
+  for (int i = 0; i < CHURN; ++i)
+    gamma_delete(gamma_pool_game(pool, size, size, players, areas));
+  report("pool_lobby/pool", "us per gamma_pool_game and gamma_delete",
+         (now() - start) * 1e6 / CHURN);
+  gamma_pool_delete(pool);
+
+  memory_before = resident_mib();
+  start = now();
+  for (int i = 0; i < GAMES; ++i) {
+    g[i] = gamma_new(size, size, players, areas);
+    assert(g[i] != NULL);
+    for (uint32_t p = 1; p <= players; ++p)
+      assert(gamma_move(g[i], p, p, i % size));
+  }
+  report("pool_lobby/heap", "us per game created", (now() - start) * 1e6 / GAMES);
+  report("pool_lobby/heap", "KiB resident per game",
+         (resident_mib() - memory_before) * 1024 / GAMES);
+  start = now();
+  for (int i = 0; i < GAMES; ++i)
+    gamma_delete(g[i]);
+  report("pool_lobby/heap", "us per game deleted", (now() - start) * 1e6 / GAMES);
+  start = now();
+  for (int i = 0; i < CHURN; ++i)
+    gamma_delete(gamma_new(size, size, players, areas));
+  report("pool_lobby/heap", "us per gamma_new and gamma_delete",
+         (now() - start) * 1e6 / CHURN);
+  return PASS;
+}
+
+/* Mierzy pamięć wielu nieużywanych gier 500 x 500 z zapełnioną w połowie
+ * planszą przed i po spakowaniu oraz czas spakowania i rozpakowania gry.
+ * Sterta zatrzymuje zwolnione kafelki, więc przed pomiarem oddajemy je
+ * systemowi przez malloc_trim. */
+static int idle_games(void) {
+  enum { GAMES = 100, MOVES = 125000 };
+  static gamma_t *g[GAMES];
+  const uint32_t size = 500, players = 4, areas = 2000;
+
+  double memory_before = resident_mib();
+  uint64_t used = 0;
+  srand(41);
+  for (int i = 0; i < GAMES; ++i) {
+    g[i] = gamma_new(size, size, players, areas);
+    assert(g[i] != NULL);
+    for (int move = 0; move < MOVES; ++move)
+      gamma_move(g[i], rand() % players + 1, rand() % size, rand() % size);
+    used += gamma_memory_usage(g[i], NULL);
+  }
+  report("idle_games/active", "MiB resident", resident_mib() - memory_before);
+  report("idle_games/active", "KiB per game by gamma_memory_usage",
+         used / 1024.0 / GAMES);
+  double start = now();
+  for (int i = 0; i < GAMES; ++i) {
+    assert(!gamma_compact_idle(g[i]));
+    assert(gamma_compact_idle(g[i]));
+  }
+  report("idle_games", "ms per gamma_compact", (now() - start) * 1e3 / GAMES);
+#ifdef __GLIBC__
+  malloc_trim(0);
+#endif
+  used = 0;
+  for (int i = 0; i < GAMES; ++i)
+    used += gamma_memory_usage(g[i], NULL);
+  report("idle_games/packed", "MiB resident", resident_mib() - memory_before);
+  report("idle_games/packed", "KiB per game by gamma_memory_usage",
+         used / 1024.0 / GAMES);
+  start = now();
+  for (int i = 0; i < GAMES; ++i)
+    assert(gamma_free_fields(g[i], 1) > 0);
+  report("idle_games", "ms per rehydration", (now() - start) * 1e3 / GAMES);
+  for (int i = 0; i < GAMES; ++i)
+    gamma_delete(g[i]);
+  return PASS;
+}
+
+/* Mierzy zapis i odczyt obrazu gry 10000 x 10000 z zapełnioną planszą
+ * w porównaniu z rozegraniem wszystkich jej ruchów od nowa. */
+static int snapshot_save_load(void) {
+  const char *path = "gamma_bench_snapshot.tmp";
+  const uint32_t size = 10000, players = 100;
+
+  double start = now();
+  gamma_t *g = striped_game(size, players);
+  report("snapshot_save_load", "s to play moves", now() - start);
+  int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  assert(fd >= 0);
+  start = now();
+  assert(gamma_save(g, fd));
+  double seconds = now() - start;
+  off_t bytes = lseek(fd, 0, SEEK_CUR);
+  report("snapshot_save_load", "s to save", seconds);
+  report("snapshot_save_load", "MiB per second saved", bytes / seconds / (1 << 20));
+  assert(lseek(fd, 0, SEEK_SET) == 0);
+  start = now();
+  gamma_t *loaded = gamma_load(fd, NULL);
+  seconds = now() - start;
+  assert(loaded != NULL);
+  report("snapshot_save_load", "s to load", seconds);
+  report("snapshot_save_load", "MiB per second loaded", bytes / seconds / (1 << 20));
+  assert(gamma_busy_fields(loaded, 1) == gamma_busy_fields(g, 1));
+  assert(!gamma_move(loaded, 1, 0, 0));
+  close(fd);
+  remove(path);
+  gamma_delete(g);
+  gamma_delete(loaded);
+  return PASS;
+}
+
+/* Mierzy wczytanie układu pionków planszy 10000 x 10000 przez
+ * gamma_load_board w porównaniu z rozegraniem jego ruchów od nowa,
+ * dla pasów graczy i dla losowego układu z milionami małych obszarów. */
+static int load_board_position(void) {
+  const uint32_t size = 10000, players = 100;
+  uint64_t fields = (uint64_t)size * size;
+  uint32_t *owners = malloc(fields * sizeof(uint32_t));
+  assert(owners != NULL);
+
+  double start = now();
+  gamma_t *g = striped_game(size, players);
+  report("load_board_position", "s to play striped moves", now() - start);
+  gamma_delete(g);
+  for (uint64_t i = 0; i < fields; ++i)
+    owners[i] = i / size * players / size + 1;
+  g = gamma_new(size, size, players, 1);
+  assert(g != NULL);
+  start = now();
+  assert(gamma_load_board(g, owners));
+  report("load_board_position", "s to load striped", now() - start);
+  assert(!gamma_move(g, 1, 0, 0) && gamma_busy_fields(g, 1) == fields / players);
+  gamma_delete(g);
+
+  srand(43);
+  for (uint64_t i = 0; i < fields; ++i)
+    owners[i] = rand() % 5;
+  g = gamma_new(size, size, 4, size * size);
+  assert(g != NULL);
+  start = now();
+  assert(gamma_load_board(g, owners));
+  double seconds = now() - start;
+  report("load_board_position", "s to load random", seconds);
+  report("load_board_position", "M fields per second", fields / seconds / 1e6);
+  gamma_delete(g);
+  free(owners);
+  return PASS;
+}
+
+/* Gra i liczniki pomiaru concurrent_reads. */
+typedef struct {
+  gamma_t *g;
+  uint32_t size, players;
+  int queries;
+  atomic_int readers_left;
+  uint64_t moves;
+} shared_game;
+
+/* Czytelnik w concurrent_reads: pyta o wolne pola kolejnych graczy. */
+static void *read_game(void *arg) {
+  shared_game *s = arg;
+  uint64_t sum = 0;
+  for (int i = 0; i < s->queries; ++i)
+    sum += gamma_free_fields(s->g, i % s->players + 1);
+  assert(sum > 0);
+  atomic_fetch_sub(&s->readers_left, 1);
+  return NULL;
+}
+
+/* Pisarz w concurrent_reads: wykonuje ruchy, dopóki czytelnicy pytają. */
+static void *write_game(void *arg) {
+  shared_game *s = arg;
+  while (atomic_load(&s->readers_left) > 0) {
+    gamma_move(s->g, rand() % s->players + 1, rand() % s->size, rand() % s->size);
+    s->moves++;
+  }
+  return NULL;
+}
+
+/* Mierzy przepustowość zapytań gry w trybie współbieżnym przy rosnącej
+ * liczbie czytelników, z których każdy zadaje tyle samo zapytań
+ * gamma_free_fields, gdy jeden pisarz wykonuje w tym czasie ruchy. Gracze
+ * zajęli już wszystkie obszary, więc każde zapytanie przegląda ich pola.
+ * Na koniec porównuje koszt zamka z zapytaniem na zwykłej grze. */
+static int concurrent_reads(void) {
+  enum { MAX_READERS = 8 };
+  static shared_game s = {.size = 500, .players = 4, .queries = 200};
+  s.g = gamma_new(s.size, s.size, s.players, 8);
+  assert(s.g != NULL);
+  srand(50);
+  for (int i = 0; i < 200000; ++i)
+    gamma_move(s.g, rand() % s.players + 1, rand() % s.size, rand() % s.size);
+  assert(gamma_enable_concurrency(s.g));
+
+  for (int readers = 1; readers <= MAX_READERS; readers *= 2) {
+    pthread_t reader[MAX_READERS], writer;
+    atomic_store(&s.readers_left, readers);
+    s.moves = 0;
+    double start = now();
+    for (int i = 0; i < readers; ++i)
+      assert(pthread_create(&reader[i], NULL, read_game, &s) == 0);
+    assert(pthread_create(&writer, NULL, write_game, &s) == 0);
+    for (int i = 0; i < readers; ++i)
+      assert(pthread_join(reader[i], NULL) == 0);
+    assert(pthread_join(writer, NULL) == 0);
+    double seconds = now() - start;
+    char name[64];
+    snprintf(name, sizeof(name), "concurrent_reads/%d", readers);
+    report(name, "queries per second", readers * s.queries / seconds);
+    report(name, "moves per second", s.moves / seconds);
+  }
+
+  const int queries = 1000000;
+  gamma_t *plain = gamma_new(s.size, s.size, s.players, 8);
+  assert(plain != NULL);
+  gamma_t *games[] = {plain, s.g};
+  const char *names[] = {"concurrent_reads/plain", "concurrent_reads/locked"};
+  for (int k = 0; k < 2; ++k) {
+    uint64_t sum = 0;
+    double start = now();
+    for (int i = 0; i < queries; ++i)
+      sum += gamma_busy_fields(games[k], i % s.players + 1);
+    report(names[k], "ns per gamma_busy_fields", (now() - start) * 1e9 / queries);
+    assert(k == 0 ? sum == 0 : sum > 0);
+  }
+  gamma_delete(plain);
+  gamma_delete(s.g);
+  return PASS;
+}
+
+/* Wątek serwera w pomiarze server_latency. */
+static void *run_server(void *server) {
+  server_run(server);
+  return NULL;
+}
+
+/* Łączy się z serwerem gier na gnieździe path. */
+static int connect_client(const char *path) {
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  strcpy(address.sun_path, path);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  assert(fd != -1);
+  assert(connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0);
+  return fd;
+}
+
+/* Wysyła cały napis przez gniazdo. */
+static void send_all(int fd, const char *text, size_t length) {
+  while (length > 0) {
+    ssize_t n = send(fd, text, length, 0);
+    assert(n > 0);
+    text += n;
+    length -= n;
+  }
+}
+
+/* Porównuje czasy dla qsort. */
+static int compare_doubles(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+/* Lokalny generator obciążenia serwera gier: CLIENTS połączeń gra w GAMES gier
+ * po GAMES / CLIENTS na połączenie. W każdej rundzie każde połączenie wysyła
+ * jedną komendę na każdą swoją grę (głównie ruchy, co dziesiąta to zapytanie),
+ * a opóźnienie komendy liczymy od wysłania jej porcji do nadejścia odpowiedzi.
+ * Na koniec jedno połączenie wysyła ruchy pojedynczo, czekając na odpowiedź,
+ * co mierzy opóźnienie komendy bez kolejki. */
+static int server_latency(void) {
+  enum { GAMES = 10000, CLIENTS = 100, ROUNDS = 50, PER_CLIENT = GAMES / CLIENTS };
+  const uint32_t size = 20, players = 4, areas = 3;
+  static int fd[CLIENTS];
+  static double sent_at[CLIENTS], latency[GAMES * ROUNDS];
+  static char batch[PER_CLIENT * 32];
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/gamma_bench_%d.sock", (int)getpid());
+
+  game_server *server = server_open(path);
+  assert(server != NULL);
+  pthread_t thread;
+  assert(pthread_create(&thread, NULL, run_server, server) == 0);
+  for (int c = 0; c < CLIENTS; ++c)
+    fd[c] = connect_client(path);
+
+  srand(48);
+  uint64_t answers = 0;
+  double start = 0;
+  for (int round = -1; round < ROUNDS; ++round) {
+    if (round == 0)
+      start = now();
+    for (int c = 0; c < CLIENTS; ++c) {
+      size_t length = 0;
+      for (int i = 0; i < PER_CLIENT; ++i) {
+        int id = c * PER_CLIENT + i;
+        if (round < 0)
+          length += sprintf(batch + length, "%d B %u %u %u %u\n",
+                            id, size, size, players, areas);
+        else if (i % 10 == 0)
+          length += sprintf(batch + length, "%d %c %d\n",
+                            id, "bfq"[rand() % 3], rand() % players + 1);
+        else
+          length += sprintf(batch + length, "%d m %d %d %d\n", id,
+                            rand() % players + 1, rand() % size, rand() % size);
+      }
+      sent_at[c] = now();
+      send_all(fd[c], batch, length);
+    }
+    int waiting = CLIENTS;
+    int left[CLIENTS];
+    struct pollfd polled[CLIENTS];
+    for (int c = 0; c < CLIENTS; ++c) {
+      left[c] = PER_CLIENT;
+      polled[c] = (struct pollfd){.fd = fd[c], .events = POLLIN};
+    }
+    while (waiting > 0) {
+      assert(poll(polled, CLIENTS, -1) > 0);
+      for (int c = 0; c < CLIENTS; ++c) {
+        if (!(polled[c].revents & POLLIN))
+          continue;
+        char buffer[4096];
+        ssize_t n = recv(fd[c], buffer, sizeof(buffer), 0);
+        assert(n > 0);
+        double arrived = now();
+        for (ssize_t j = 0; j < n; ++j) {
+          if (buffer[j] != '\n')
+            continue;
+          left[c]--;
+          if (round >= 0)
+            latency[answers++] = arrived - sent_at[c];
+        }
+        assert(left[c] >= 0);
+        if (left[c] == 0) {
+          polled[c].fd = -1;
+          waiting--;
+        }
+      }
+    }
+  }
+  report("server_latency", "commands per second", answers / (now() - start));
+  qsort(latency, answers, sizeof(double), compare_doubles);
+  report("server_latency", "us p50 per command", latency[answers / 2] * 1e6);
+  report("server_latency", "us p99 per command", latency[answers * 99 / 100] * 1e6);
+
+  enum { PINGS = 20000 };
+  static double round_trip[PINGS];
+  for (int i = 0; i < PINGS; ++i) {
+    int length = sprintf(batch, "%d m %d %d %d\n", i % PER_CLIENT,
+                         rand() % players + 1, rand() % size, rand() % size);
+    double begin = now();
+    send_all(fd[0], batch, length);
+    char answer[64];
+    ssize_t n = 0;
+    while (n == 0 || answer[n - 1] != '\n') {
+      ssize_t got = recv(fd[0], answer + n, sizeof(answer) - n, 0);
+      assert(got > 0);
+      n += got;
+    }
+    round_trip[i] = now() - begin;
+  }
+  qsort(round_trip, PINGS, sizeof(double), compare_doubles);
+  report("server_latency/single", "us p50 per command", round_trip[PINGS / 2] * 1e6);
+  report("server_latency/single", "us p99 per command", round_trip[PINGS * 99 / 100] * 1e6);
+
+  double begin = now();
+  for (int c = 0; c < CLIENTS; ++c) {
+    size_t length = 0;
+    for (int i = 0; i < PER_CLIENT; ++i)
+      length += sprintf(batch + length, "%d D\n", c * PER_CLIENT + i);
+    send_all(fd[c], batch, length);
+    shutdown(fd[c], SHUT_WR);
+  }
+  for (int c = 0; c < CLIENTS; ++c) {
+    char buffer[4096];
+    while (recv(fd[c], buffer, sizeof(buffer), 0) > 0)
+      ;
+    close(fd[c]);
+  }
+  report("server_latency", "us per game deleted", (now() - begin) * 1e6 / GAMES);
+  server_stop(server);
+  pthread_join(thread, NULL);
+  server_close(server);
+  return PASS;
+}
+
+/* Bot na kanale w pamięci współdzielonej: proces potomny obsługuje kanał,
+ * a ten proces gra ruchami w GAMES gier. Mierzymy ruch wysyłany przez shm_call
+ * z czekaniem na odpowiedź, ruchy wysyłane porcjami po WINDOW bez czekania
+ * oraz te same ruchy wywoływane wprost przez gamma_move. */
+static int shm_latency(void) {
+  enum { GAMES = 1000, MOVES = 200000, WINDOW = 512 };
+  const uint32_t size = 20, players = 4, areas = 3;
+  char name[64];
+  snprintf(name, sizeof(name), "/gamma_bench_%d", (int)getpid());
+  shm_channel *c = shm_channel_create(name);
+  assert(c != NULL);
+  pid_t child = fork();
+  assert(child != -1);
+  if (child == 0)
+    _exit(shm_serve(c) ? 0 : 1);
+
+  for (uint32_t id = 0; id < GAMES; ++id) {
+    shm_request r = {ShmNew, id, {size, size, players, areas}};
+    assert(shm_call(c, &r) == 1);
+  }
+  static shm_request moves[MOVES];
+  static double round_trip[MOVES];
+  srand(49);
+  for (int i = 0; i < MOVES; ++i)
+    moves[i] = (shm_request){ShmMove, rand() % GAMES,
+                             {rand() % players + 1, rand() % size, rand() % size}};
+
+  uint64_t accepted = 0;
+  double start = now();
+  for (int i = 0; i < MOVES / 2; ++i) {
+    double begin = now();
+    accepted += shm_call(c, &moves[i]);
+    round_trip[i] = now() - begin;
+  }
+  report("shm_latency/call", "ns per move", (now() - start) * 1e9 / (MOVES / 2));
+  qsort(round_trip, MOVES / 2, sizeof(double), compare_doubles);
+  report("shm_latency/call", "ns p50 per move", round_trip[MOVES / 4] * 1e9);
+  report("shm_latency/call", "ns p99 per move", round_trip[MOVES / 2 * 99 / 100] * 1e9);
+
+  start = now();
+  for (int i = MOVES / 2; i < MOVES; i += WINDOW) {
+    int n = MOVES - i < WINDOW ? MOVES - i : WINDOW;
+    for (int j = 0; j < n; ++j)
+      shm_send(c, &moves[i + j]);
+    for (int j = 0; j < n; ++j)
+      accepted += shm_receive(c);
+  }
+  report("shm_latency/window", "ns per move", (now() - start) * 1e9 / (MOVES / 2));
+
+  for (uint32_t id = 0; id < GAMES; ++id) {
+    shm_request r = {ShmDelete, id, {0}};
+    assert(shm_call(c, &r) == 1);
+  }
+  shm_request close_request = {ShmClose, 0, {0}};
+  assert(shm_call(c, &close_request) == 1);
+  int status;
+  assert(waitpid(child, &status, 0) == child);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  shm_channel_close(c);
+
+  static gamma_t *games[GAMES];
+  for (int id = 0; id < GAMES; ++id) {
+    games[id] = gamma_new(size, size, players, areas);
+    assert(games[id] != NULL);
+  }
+  uint64_t direct = 0;
+  start = now();
+  for (int i = 0; i < MOVES; ++i)
+    direct += gamma_move(games[moves[i].game], moves[i].args[0],
+                         moves[i].args[1], moves[i].args[2]);
+  report("shm_latency/direct", "ns per move", (now() - start) * 1e9 / MOVES);
+  assert(direct == accepted);
+  for (int id = 0; id < GAMES; ++id)
+    gamma_delete(games[id]);
+  return PASS;
+}
+
+/** URUCHAMIANIE POMIARÓW **/
+
+typedef struct {
+  char const *name;
+  int (*function)(void);
+} bench_list_t;
+
+#define BENCH(t) {#t, t}
+
+static const bench_list_t bench_list[] = {
+  BENCH(golden_scan),
+  BENCH(golden_big_area),
+  BENCH(merge_into_big_area),
+  BENCH(split_off_tail),
+  BENCH(split_big_area),
+  BENCH(players_status_serial),
+  BENCH(players_status_shared),
+  BENCH(many_players_queries),
+  BENCH(big_board_startup),
+  BENCH(sparse_open_world),
+  BENCH(vertical_snakes),
+  BENCH(vertical_splits),
+  BENCH(mapped_reopen),
+  BENCH(huge_pages_scan),
+  BENCH(arena_delete),
+  BENCH(reset_games),
+  BENCH(pool_lobby),
+  BENCH(idle_games),
+  BENCH(snapshot_save_load),
+  BENCH(load_board_position),
+  BENCH(concurrent_reads),
+  BENCH(server_latency),
+  BENCH(shm_latency),
+};
+
+int main(int argc, char *argv[]) {
+  if (argc != 2)
+    return WRONG_TEST;
+
+  for (size_t i = 0; i < SIZE(bench_list); ++i)
+    if (strcmp(argv[1], bench_list[i].name) == 0)
+      return bench_list[i].function();
+
+  return WRONG_TEST;
+}
@@ -1,15 +1,123 @@
+/** @brief makro potrzebne do korzystania z sigaction()
+ */
+#define _XOPEN_SOURCE 700
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "logic.h"
+#include "bmbinary.h"
+#include "bmserver.h"
+#include "bmtagged.h"
+#include "shmchannel.h"
 
-int main(){
+/** @brief serwer zatrzymywany przez stop_serving
+ */
+static game_server* serving;
+
+/** @brief obsługa SIGINT i SIGTERM w trybie serwera
+ * param[in] signal 	- numer sygnału
+ */
+static void stop_serving(int signal){
+	(void)signal;
+	server_stop(serving);
+}
+
+/** @brief prowadzi serwer gier na gnieździe uniksowym do SIGINT lub SIGTERM
+ * param[in] path 	- ścieżka gniazda
+ *
+ * @return kod wyjścia programu
+ */
+static int serve(const char* path){
+	serving = server_open(path);
+	if(serving == NULL){
+		perror(path);
+		return 1;
+	}
+	struct sigaction action = {.sa_handler = stop_serving};
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	bool success = server_run(serving);
+	server_close(serving);
+	return success? 0 : 1;
+}
+
+/** @brief kanał zatrzymywany przez stop_channel
+ */
+static shm_channel* channel;
+
+/** @brief obsługa SIGINT i SIGTERM w trybie kanału w pamięci współdzielonej
+ * param[in] signal 	- numer sygnału
+ */
+static void stop_channel(int signal){
+	(void)signal;
+	shm_channel_stop(channel);
+}
+
+/** @brief obsługuje bota przez kanał w pamięci współdzielonej do jego
+ * zamknięcia lub SIGINT, SIGTERM
+ * param[in] name 	- nazwa obszaru pamięci współdzielonej
+ *
+ * @return kod wyjścia programu
+ */
+static int serve_channel(const char* name){
+	channel = shm_channel_create(name);
+	if(channel == NULL){
+		perror(name);
+		return 1;
+	}
+	struct sigaction action = {.sa_handler = stop_channel};
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	bool success = shm_serve(channel);
+	shm_channel_close(channel);
+	return success? 0 : 1;
+}
+
+/** @brief zamienia stdin na stdout w formacie wskazanym przez opcję
+ * param[in] option 	- --to-binary, --to-text lub --responses-to-text
+ *
+ * @return kod wyjścia programu
+ */
+static int convert(const char* option){
+	bool success;
+	if(strcmp(option, "--to-binary") == 0){
+		success = text_to_binary(stdin, stdout);
+	} else if(strcmp(option, "--to-text") == 0){
+		success = binary_to_text(stdin, stdout);
+	} else if(strcmp(option, "--responses-to-text") == 0){
+		success = responses_to_text(stdin, stdout);
+	} else{
+		fprintf(stderr, "usage: gamma [--to-binary | --to-text | --responses-to-text | --serve path | --shm name]\n");
+		return 1;
+	}
+	return success? 0 : 1;
+}
+
+int main(int argc, char* argv[]){
+
+	if(argc == 3 && strcmp(argv[1], "--serve") == 0)
+		return serve(argv[2]);
+	if(argc == 3 && strcmp(argv[1], "--shm") == 0)
+		return serve_channel(argv[2]);
+	if(argc > 1)
+		return convert(argv[1]);
+	if(binary_input(stdin)){
+		play_binary(stdin, stdout);
+		return 0;
+	}
 
 	game_and_mode* gm = malloc(sizeof(game_and_mode));
 	int line = 0;
 
 	if(gm != NULL){
 		if(set_game_and_mode(gm, &line)){
-			if(gm->game != NULL){
+			if(gm->mod == Tagged){
+				play_tagged(&line);
+				free(gm);
+			} else if(gm->game != NULL){
 				if(gm->mod == Batch){
 					play_batch(gm->game, &line);
 					gamma_delete(gm->game);
@@ -1,3 +1,6 @@
+/* Makro potrzebne do korzystania z fileno(), lseek() i ftruncate(). */
+#define _XOPEN_SOURCE 700
+
 /* Ten plik włączamy na początku i dwa razy, aby sprawdzić, czy zawiera
  * wszystko, co jest potrzebne. */
 #include "gamma.h"
@@ -13,6 +16,26 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "bmbinary.h"
+#include "bmparser.h"
+#include "bmpipeline.h"
+#include "bmserver.h"
+#include "bmtagged.h"
+#include "alloc.h"
+#include "logic.h"
+#include "shmchannel.h"
+#include "gametable.h"
 
 /** FUNKCJE POMOCNE PRZY DEBUGOWANIU TESTÓW **/
 
@@ -468,6 +491,1919 @@ static int golden_possible(void) {
   return PASS;
 }
 
+/* Testuje gamma_golden_possible na planszy na tyle dużej, że jest przeszukiwana
+ * równolegle, oraz to, że sprawdzanie nie zmienia stanu planszy. */
+static int golden_possible_big(void) {
+  const uint32_t size = 300;
+  gamma_t *g = gamma_new(size, size, 3, 1);
+  assert(g != NULL);
+
+  for (uint32_t y = 0; y < size - 4; ++y)
+    for (uint32_t x = 0; x < size; ++x)
+      assert(gamma_move(g, 2, x, y));
+  assert(gamma_move(g, 2, size / 2, size - 4));
+  assert(gamma_move(g, 2, size / 2, size - 3));
+  assert(gamma_move(g, 2, size / 2, size - 2));
+  assert(gamma_move(g, 1, size / 2 - 1, size - 3));
+
+  char *before = gamma_board(g);
+  assert(before != NULL);
+  assert(!gamma_golden_possible(g, 1));
+  assert(gamma_golden_possible(g, 3));
+  char *after = gamma_board(g);
+  assert(after != NULL);
+  assert(strcmp(before, after) == 0);
+  free(before);
+  free(after);
+
+  assert(gamma_move(g, 1, size / 2 - 1, size - 2));
+  assert(gamma_golden_possible(g, 1));
+  assert(!gamma_golden_move(g, 1, size / 2, size - 3));
+  assert(gamma_golden_move(g, 1, size / 2, size - 2));
+  assert(!gamma_golden_possible(g, 1));
+  assert(gamma_busy_fields(g, 2) == (size - 4) * size + 2);
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Testuje złoty ruch rozcinający obszar na cztery części oraz liczenie
+ * obszarów po takim rozcięciu. */
+static int golden_split(void) {
+  gamma_t *g = gamma_new(5, 5, 2, 3);
+  assert(g != NULL);
+
+  assert(gamma_move(g, 1, 2, 2));
+  assert(gamma_move(g, 1, 1, 2));
+  assert(gamma_move(g, 1, 3, 2));
+  assert(gamma_move(g, 1, 2, 1));
+  assert(gamma_move(g, 1, 2, 3));
+  assert(!gamma_golden_move(g, 2, 2, 2));
+  assert(gamma_golden_move(g, 2, 1, 2));
+
+  gamma_delete(g);
+  g = gamma_new(5, 5, 2, 4);
+  assert(g != NULL);
+
+  assert(gamma_move(g, 1, 2, 2));
+  assert(gamma_move(g, 1, 1, 2));
+  assert(gamma_move(g, 1, 3, 2));
+  assert(gamma_move(g, 1, 2, 1));
+  assert(gamma_move(g, 1, 2, 3));
+  assert(gamma_golden_move(g, 2, 2, 2));
+  assert(gamma_busy_fields(g, 1) == 4);
+  assert(gamma_free_fields(g, 1) == 8);
+  assert(!gamma_move(g, 1, 0, 0));
+  assert(gamma_move(g, 1, 1, 1));
+  assert(gamma_move(g, 1, 4, 4));
+  assert(!gamma_move(g, 1, 0, 4));
+  assert(gamma_move(g, 1, 1, 3));
+  assert(gamma_move(g, 1, 0, 4));
+  assert(gamma_busy_fields(g, 1) == 8);
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Liczy obszary gracza na planszy modelowej o polach board[y * width + x],
+ * przeszukując ją w głąb. */
+static uint32_t model_areas(const uint32_t *board, uint32_t width,
+                            uint32_t height, uint32_t player) {
+  static const int dx[] = {1, -1, 0, 0}, dy[] = {0, 0, 1, -1};
+  bool *seen = calloc((size_t)width * height, sizeof(bool));
+  uint32_t *stack = malloc((size_t)width * height * sizeof(uint32_t));
+  assert(seen != NULL && stack != NULL);
+  uint32_t areas = 0;
+  for (uint32_t i = 0; i < width * height; ++i) {
+    if (board[i] != player || seen[i])
+      continue;
+    ++areas;
+    uint32_t top = 0;
+    stack[top++] = i;
+    seen[i] = true;
+    while (top > 0) {
+      int cx = stack[--top] % width, cy = stack[top] / width;
+      for (int d = 0; d < 4; ++d) {
+        int nx = cx + dx[d], ny = cy + dy[d];
+        if (nx >= 0 && nx < (int)width && ny >= 0 && ny < (int)height &&
+            board[ny * width + nx] == player && !seen[ny * width + nx]) {
+          seen[ny * width + nx] = true;
+          stack[top++] = ny * width + nx;
+        }
+      }
+    }
+  }
+  free(seen);
+  free(stack);
+  return areas;
+}
+
+/* Rozgrywa losowe ruchy i złote ruchy na jednej grze i porównuje ich wyniki
+ * z modelem. Jeżeli walk jest prawdą, gracz stawia zwykle pionek obok
+ * swojego ostatniego pionka, więc jego obszary są długimi wężami, które
+ * złote ruchy często przecinają. */
+static void random_area_game(uint32_t width, uint32_t height, uint32_t players,
+                             uint32_t areas, int moves, bool walk) {
+  uint32_t *board = calloc((size_t)width * height, sizeof(uint32_t));
+  uint64_t busy[players + 1];
+  bool golden_used[players + 1];
+  uint32_t last[players + 1][2];
+  assert(board != NULL);
+  memset(busy, 0, sizeof(busy));
+  memset(golden_used, 0, sizeof(golden_used));
+  for (uint32_t p = 0; p <= players; ++p) {
+    last[p][0] = rand() % width;
+    last[p][1] = rand() % height;
+  }
+  gamma_t *g = gamma_new(width, height, players, areas);
+  assert(g != NULL);
+
+  for (int move = 0; move < moves; ++move) {
+    uint32_t player = rand() % players + 1;
+    uint32_t x = rand() % width, y = rand() % height;
+    if (walk && rand() % 8 != 0) {
+      x = (last[player][0] + width + (rand() % 2 ? rand() % 3 - 1 : 0)) % width;
+      y = (last[player][1] + height + rand() % 3 - 1) % height;
+    }
+    uint32_t *field = &board[y * width + x];
+    uint32_t owner = *field;
+    bool legal;
+    if (rand() % 4 == 0) {
+      legal = !golden_used[player] && owner != 0 && owner != player;
+      if (legal) {
+        *field = player;
+        legal = model_areas(board, width, height, player) <= areas &&
+                model_areas(board, width, height, owner) <= areas;
+        if (legal) {
+          golden_used[player] = true;
+          --busy[owner];
+          ++busy[player];
+        }
+        else
+          *field = owner;
+      }
+      assert(gamma_golden_move(g, player, x, y) == legal);
+    }
+    else {
+      legal = owner == 0;
+      if (legal) {
+        *field = player;
+        legal = model_areas(board, width, height, player) <= areas;
+        if (legal) {
+          ++busy[player];
+          last[player][0] = x;
+          last[player][1] = y;
+        }
+        else
+          *field = 0;
+      }
+      assert(gamma_move(g, player, x, y) == legal);
+    }
+  }
+
+  uint64_t empty = (uint64_t)width * height;
+  for (uint32_t p = 1; p <= players; ++p)
+    empty -= busy[p];
+  for (uint32_t p = 1; p <= players; ++p) {
+    assert(gamma_busy_fields(g, p) == busy[p]);
+    if (model_areas(board, width, height, p) < areas)
+      assert(gamma_free_fields(g, p) == empty);
+  }
+  gamma_delete(g);
+  free(board);
+}
+
+/* Porównuje wyniki losowych ruchów i złotych ruchów z prostym modelem,
+ * który po każdej zmianie liczy obszary od nowa. Sprawdza łączenie obszarów
+ * i rozcinanie ich złotym ruchem, na małych planszach jednego kafelka
+ * i na planszach wielu kafelków, na których obszary przechodzą przez
+ * granice kafelków. */
+static int random_areas(void) {
+  srand(42);
+  for (int game = 0; game < 1000; ++game)
+    random_area_game(12, 10, 6, 4, 400, false);
+  for (int game = 0; game < 3; ++game) {
+    random_area_game(130, 70, 250, 6, 20000, true);
+    random_area_game(70, 130, 250, 6, 20000, true);
+  }
+  return PASS;
+}
+
+/* Sprawdza, czy gamma_players_status zwraca to samo, co gamma_free_fields
+ * i gamma_golden_possible wywołane dla każdego gracza osobno. */
+static bool status_matches(gamma_t *g, uint32_t players) {
+  gamma_player_status_t status[players];
+  assert(gamma_players_status(g, status));
+  for (uint32_t p = 1; p <= players; ++p)
+    if (status[p - 1].free_fields != gamma_free_fields(g, p) ||
+        status[p - 1].golden_possible != gamma_golden_possible(g, p))
+      return false;
+  return true;
+}
+
+/* Testuje gamma_players_status na losowych grach, również na planszy
+ * na tyle dużej, że jest przeglądana równolegle. */
+static int players_status(void) {
+  static const uint32_t sizes[][4] = {
+    {7, 5, 5, 2}, {12, 10, 9, 3}, {300, 300, 7, 2},
+  };
+  srand(7);
+  assert(!gamma_players_status(NULL, NULL));
+  for (size_t i = 0; i < SIZE(sizes); ++i) {
+    uint32_t width = sizes[i][0], height = sizes[i][1];
+    uint32_t players = sizes[i][2], areas = sizes[i][3];
+    for (int game = 0; game < 20; ++game) {
+      gamma_t *g = gamma_new(width, height, players, areas);
+      assert(g != NULL);
+      assert(status_matches(g, players));
+      for (int move = 0; move < 400; ++move) {
+        uint32_t player = rand() % players + 1;
+        uint32_t x = rand() % width, y = rand() % height;
+        if (rand() % 8 == 0)
+          gamma_golden_move(g, player, x, y);
+        else
+          gamma_move(g, player, x, y);
+        if (move % 50 == 0)
+          assert(status_matches(g, players));
+      }
+      assert(status_matches(g, players));
+      gamma_delete(g);
+    }
+  }
+  return PASS;
+}
+
+/* Testuje złoty ruch zabierający graczowi jedyne pole - gracz przestaje
+ * być liczony wśród graczy mających pola na planszy. */
+static int golden_last_field(void) {
+  gamma_t *g = gamma_new(3, 3, 3, 1);
+  assert(g != NULL);
+
+  assert(!gamma_golden_possible(g, 2));
+  assert(gamma_move(g, 1, 0, 0));
+  assert(gamma_golden_possible(g, 2));
+  assert(!gamma_golden_possible(g, 1));
+  assert(gamma_golden_move(g, 2, 0, 0));
+  assert(gamma_busy_fields(g, 1) == 0);
+  assert(gamma_busy_fields(g, 2) == 1);
+  assert(!gamma_golden_possible(g, 2));
+  assert(gamma_golden_possible(g, 3));
+  assert(gamma_golden_possible(g, 1));
+  assert(gamma_free_fields(g, 1) == 8);
+  assert(gamma_free_fields(g, 2) == 2);
+  assert(gamma_move(g, 3, 2, 2));
+  assert(gamma_golden_possible(g, 1));
+  assert(!gamma_golden_possible(g, 2));
+
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Testuje ogromną, prawie pustą planszę - pola na brzegach kafelków
+ * i w odległych rogach planszy oraz wypisywanie planszy z pustymi kafelkami. */
+static int sparse_board(void) {
+  const uint32_t size = UINT32_MAX;
+  gamma_t *g = gamma_new(size, size, 3, 2);
+  assert(g != NULL);
+
+  assert(gamma_move(g, 1, 63, 63));
+  assert(gamma_move(g, 1, 64, 63));
+  assert(gamma_move(g, 1, 64, 64));
+  assert(gamma_move(g, 2, size - 1, size - 1));
+  assert(gamma_move(g, 2, 0, size - 1));
+  assert(!gamma_move(g, 2, 0, 0));
+  assert(gamma_move(g, 3, 0, 0));
+  assert(gamma_busy_fields(g, 1) == 3);
+  assert(gamma_free_fields(g, 1) == (uint64_t)size * size - 6);
+  assert(gamma_free_fields(g, 2) == 4);
+  assert(gamma_golden_possible(g, 1));
+
+  assert(!gamma_golden_move(g, 2, 64, 63));
+  assert(gamma_golden_move(g, 3, 64, 63));
+  assert(gamma_busy_fields(g, 1) == 2);
+  assert(gamma_free_fields(g, 1) == 5);
+  assert(gamma_free_fields(g, 2) == 4);
+  assert(!gamma_golden_possible(g, 3));
+
+  gamma_player_status_t status[3];
+  assert(gamma_players_status(g, status));
+  for (uint32_t p = 1; p <= 3; ++p) {
+    assert(status[p - 1].free_fields == gamma_free_fields(g, p));
+    assert(status[p - 1].golden_possible == gamma_golden_possible(g, p));
+  }
+  gamma_delete(g);
+
+  g = gamma_new(130, 2, 12, 3);
+  assert(g != NULL);
+  assert(gamma_move(g, 1, 63, 0));
+  assert(gamma_move(g, 12, 129, 1));
+  char *board = gamma_board(g);
+  assert(board != NULL);
+  assert(strlen(board) == 2 * (130 * 3 - 1 + 1));
+  assert(strncmp(board + 129 * 3, "12\n", 3) == 0);
+  assert(strncmp(board + 130 * 3 + 63 * 3, "1 ", 2) == 0);
+  free(board);
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Rozgrywa te same losowe gry na planszach o różnych układach pól w pamięci
+ * i sprawdza, że wyniki wszystkich funkcji są takie same. */
+static int morton_layout(void) {
+  const uint32_t width = 150, height = 90, players = 5, areas = 6;
+  const gamma_params_t rows = {GAMMA_LAYOUT_ROWS, false, NULL, false};
+  const gamma_params_t morton = {GAMMA_LAYOUT_MORTON, false, NULL, false};
+  const gamma_params_t wrong = {(gamma_layout_t)7, false, NULL, false};
+  assert(gamma_new_ex(width, height, players, areas, &wrong) == NULL);
+  assert(gamma_new_ex(0, height, players, areas, &morton) == NULL);
+
+  srand(7);
+  for (int game = 0; game < 20; ++game) {
+    gamma_t *a = gamma_new_ex(width, height, players, areas, &rows);
+    gamma_t *b = gamma_new_ex(width, height, players, areas, &morton);
+    assert(a != NULL && b != NULL);
+    for (int move = 0; move < 5000; ++move) {
+      uint32_t player = rand() % players + 1;
+      uint32_t x = rand() % width, y = rand() % height;
+      if (rand() % 50 == 0)
+        assert(gamma_golden_move(a, player, x, y) ==
+               gamma_golden_move(b, player, x, y));
+      else
+        assert(gamma_move(a, player, x, y) == gamma_move(b, player, x, y));
+    }
+    for (uint32_t p = 1; p <= players; ++p) {
+      assert(gamma_busy_fields(a, p) == gamma_busy_fields(b, p));
+      assert(gamma_free_fields(a, p) == gamma_free_fields(b, p));
+      assert(gamma_golden_possible(a, p) == gamma_golden_possible(b, p));
+    }
+    char *board_a = gamma_board(a), *board_b = gamma_board(b);
+    assert(board_a != NULL && board_b != NULL);
+    assert(strcmp(board_a, board_b) == 0);
+    free(board_a);
+    free(board_b);
+    gamma_delete(a);
+    gamma_delete(b);
+  }
+  return PASS;
+}
+
+/* Wykonuje te same losowe ruchy w obu grach i porównuje ich wyniki. */
+static void play_random_moves(gamma_t *a, gamma_t *b, uint32_t width,
+                              uint32_t height, uint32_t players, int moves) {
+  for (int move = 0; move < moves; ++move) {
+    uint32_t player = rand() % players + 1;
+    uint32_t x = rand() % width, y = rand() % height;
+    if (rand() % 50 == 0)
+      assert(gamma_golden_move(a, player, x, y) ==
+             gamma_golden_move(b, player, x, y));
+    else
+      assert(gamma_move(a, player, x, y) == gamma_move(b, player, x, y));
+  }
+}
+
+/* Porównuje grę w pliku odwzorowanym w pamięci, zamykaną i otwieraną ponownie,
+ * z grą w zwykłej pamięci. */
+static int mapped_board(void) {
+  const char *path = "gamma_test_mapped.tmp";
+  const uint32_t width = 200, height = 130, players = 4, areas = 5;
+  const gamma_params_t morton = {GAMMA_LAYOUT_MORTON, false, NULL, false};
+  remove(path);
+  assert(gamma_open_mapped(path, 0, height, players, areas, NULL) == NULL);
+
+  srand(11);
+  gamma_t *a = gamma_new_ex(width, height, players, areas, &morton);
+  gamma_t *b = gamma_open_mapped(path, width, height, players, areas, &morton);
+  assert(a != NULL && b != NULL);
+  for (int round = 0; round < 4; ++round) {
+    play_random_moves(a, b, width, height, players, 4000);
+    gamma_delete(b);
+    assert(gamma_open_mapped(path, width + 1, 0, 0, 0, NULL) == NULL);
+    b = gamma_open_mapped(path, 0, 0, 0, 0, NULL);
+    assert(b != NULL);
+    for (uint32_t p = 1; p <= players; ++p) {
+      assert(gamma_busy_fields(a, p) == gamma_busy_fields(b, p));
+      assert(gamma_free_fields(a, p) == gamma_free_fields(b, p));
+      assert(gamma_golden_possible(a, p) == gamma_golden_possible(b, p));
+    }
+    char *board_a = gamma_board(a), *board_b = gamma_board(b);
+    assert(board_a != NULL && board_b != NULL);
+    assert(strcmp(board_a, board_b) == 0);
+    free(board_a);
+    free(board_b);
+  }
+  gamma_delete(a);
+  gamma_delete(b);
+  remove(path);
+  return PASS;
+}
+
+/* Zwraca sumę kontrolną zawartości pliku i wpisuje jego długość pod size. */
+static uint64_t file_checksum(const char *path, long *size) {
+  FILE *f = fopen(path, "rb");
+  assert(f != NULL);
+  uint64_t sum = 0;
+  int c;
+  *size = 0;
+  while ((c = getc(f)) != EOF) {
+    sum = sum * 31 + c;
+    ++*size;
+  }
+  fclose(f);
+  return sum;
+}
+
+/* Testuje, czy nieudane ponowne otwarcie gry w pliku zostawia plik w spokoju.
+ * Proces potomny ogranicza pamięć wirtualną tak, żeby odwzorowanie pliku się
+ * nie powiodło. */
+static int mapped_reopen_failure(void) {
+  const char *path = "gamma_test_reopen.tmp";
+  const uint32_t tiles = 48, size = 64 * tiles;
+  remove(path);
+  gamma_t *g = gamma_open_mapped(path, size, size, 2, tiles * tiles, NULL);
+  assert(g != NULL);
+  for (uint32_t y = 0; y < tiles; ++y)
+    for (uint32_t x = 0; x < tiles; ++x)
+      assert(gamma_move(g, 1, 64 * x, 64 * y));
+  gamma_delete(g);
+  long length;
+  uint64_t sum = file_checksum(path, &length);
+  assert(length > (32 << 20));
+
+  pid_t child = fork();
+  assert(child != -1);
+  if (child == 0) {
+    long pages = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == NULL || fscanf(statm, "%ld", &pages) != 1)
+      _exit(1);
+    fclose(statm);
+    rlim_t limit = (rlim_t)pages * sysconf(_SC_PAGESIZE) + (16 << 20);
+    struct rlimit rl = {limit, limit};
+    if (setrlimit(RLIMIT_AS, &rl) != 0)
+      _exit(1);
+    _exit(gamma_open_mapped(path, size, size, 2, tiles * tiles, NULL) == NULL ? 0 : 1);
+  }
+  int status;
+  assert(waitpid(child, &status, 0) == child);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  long reopened_length;
+  assert(file_checksum(path, &reopened_length) == sum);
+  assert(reopened_length == length);
+  g = gamma_open_mapped(path, 0, 0, 0, 0, NULL);
+  assert(g != NULL);
+  assert(gamma_busy_fields(g, 1) == tiles * tiles);
+  gamma_delete(g);
+  remove(path);
+  return PASS;
+}
+
+/* Testuje zgłaszanie błędu zapisu przez gamma_close_mapped. Proces potomny
+ * ogranicza długość pliku do bieżącej i zajmuje kolejne fragmenty planszy,
+ * aż plik się zapełni, więc opisy fragmentów się w nim nie mieszczą. Gra
+ * zostaje wtedy otwarta i po zniesieniu ograniczenia daje się zamknąć.
+ * Opisy 3072 fragmentów są dłuższe niż jeden fragment, więc nie zmieszczą
+ * się w miejscu, którego zabrakło na kolejny fragment. */
+static int mapped_close_failure(void) {
+  const char *path = "gamma_test_close.tmp";
+  const uint32_t tiles = 64, size = 64 * tiles;
+  remove(path);
+  gamma_t *plain = gamma_new(10, 10, 2, 2);
+  assert(plain != NULL);
+  assert(!gamma_close_mapped(NULL));
+  assert(!gamma_close_mapped(plain));
+  gamma_delete(plain);
+
+  pid_t child = fork();
+  assert(child != -1);
+  if (child == 0) {
+    gamma_t *g = gamma_open_mapped(path, size, size, 2, tiles * tiles, NULL);
+    if (g == NULL)
+      _exit(1);
+    uint64_t moves = 0;
+    for (; moves < tiles * tiles * 3 / 4; ++moves)
+      if (!gamma_move(g, 1, 64 * (moves % tiles), 64 * (moves / tiles)))
+        _exit(1);
+    struct stat st;
+    struct rlimit rl;
+    if (stat(path, &st) != 0 || getrlimit(RLIMIT_FSIZE, &rl) != 0)
+      _exit(1);
+    rlim_t unlimited = rl.rlim_cur;
+    rl.rlim_cur = st.st_size;
+    signal(SIGXFSZ, SIG_IGN);
+    if (setrlimit(RLIMIT_FSIZE, &rl) != 0)
+      _exit(1);
+    while (moves < tiles * tiles &&
+           gamma_move(g, 1, 64 * (moves % tiles), 64 * (moves / tiles)))
+      ++moves;
+    if (moves == tiles * tiles || gamma_close_mapped(g) ||
+        gamma_busy_fields(g, 1) != moves)
+      _exit(1);
+    rl.rlim_cur = unlimited;
+    if (setrlimit(RLIMIT_FSIZE, &rl) != 0 || !gamma_close_mapped(g))
+      _exit(1);
+    _exit(0);
+  }
+  int status;
+  assert(waitpid(child, &status, 0) == child);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  gamma_t *g = gamma_open_mapped(path, 0, 0, 0, 0, NULL);
+  assert(g != NULL);
+  assert(gamma_busy_fields(g, 1) > tiles * tiles * 3 / 4);
+  assert(gamma_close_mapped(g));
+  remove(path);
+  return PASS;
+}
+
+/* Zapisuje w pliku liczbę długości length na położeniu offset. */
+static void write_at(const char *path, long offset, uint64_t value, size_t length) {
+  FILE *f = fopen(path, "r+b");
+  assert(f != NULL);
+  assert(fseek(f, offset, SEEK_SET) == 0);
+  assert(fwrite(&value, length, 1, f) == 1);
+  assert(fclose(f) == 0);
+}
+
+/* Czyta z pliku liczbę długości length z położenia offset. */
+static uint64_t read_at(const char *path, long offset, size_t length) {
+  uint64_t value = 0;
+  FILE *f = fopen(path, "rb");
+  assert(f != NULL);
+  assert(fseek(f, offset, SEEK_SET) == 0);
+  assert(fread(&value, length, 1, f) == 1);
+  fclose(f);
+  return value;
+}
+
+/* Testuje odrzucanie pliku gry z uszkodzonym nagłówkiem lub tablicami graczy.
+ * Położenia pól nagłówka odpowiadają strukturze mapped_header w gamma.c. */
+static int mapped_corrupt_header(void) {
+  const char *path = "gamma_test_corrupt.tmp";
+  const uint32_t width = 100, height = 80, players = 3, areas = 4;
+  struct {
+    long offset;
+    size_t length;
+    uint64_t value;
+  } corruptions[] = {
+    {72, 4, players + 1},                   /* no_players_with_fields */
+    {64, 8, (uint64_t)width * height + 1},  /* total_busy_fields */
+    {76, 4, 1000},                          /* no_free > no_labels */
+    {80, 4, 0},                             /* no_labels = labels_capacity */
+  };
+  remove(path);
+  gamma_t *g = gamma_open_mapped(path, width, height, players, areas, NULL);
+  assert(g != NULL);
+  srand(33);
+  for (int i = 0; i < 3000; ++i)
+    gamma_move(g, rand() % players + 1, rand() % width, rand() % height);
+  assert(gamma_close_mapped(g));
+  corruptions[3].value = read_at(path, 84, 4);
+
+  for (size_t i = 0; i < SIZE(corruptions); ++i) {
+    uint64_t saved = read_at(path, corruptions[i].offset, corruptions[i].length);
+    write_at(path, corruptions[i].offset, corruptions[i].value, corruptions[i].length);
+    assert(gamma_open_mapped(path, 0, 0, 0, 0, NULL) == NULL);
+    write_at(path, corruptions[i].offset, saved, corruptions[i].length);
+  }
+  long areas_used = read_at(path, 48, 8) + sizeof(uint32_t);
+  uint64_t saved = read_at(path, areas_used, 4);
+  write_at(path, areas_used, areas + 1, 4);
+  assert(gamma_open_mapped(path, 0, 0, 0, 0, NULL) == NULL);
+  write_at(path, areas_used, saved, 4);
+
+  g = gamma_open_mapped(path, 0, 0, 0, 0, NULL);
+  assert(g != NULL);
+  assert(gamma_busy_fields(g, 1) > 0);
+  assert(gamma_close_mapped(g));
+  remove(path);
+  return PASS;
+}
+
+/* Porównuje grę, której plansza leży na dużych stronach, z grą w zwykłej
+ * pamięci. Plansza ma więcej kafelków, niż mieści jedna duża strona. */
+static int huge_pages(void) {
+  const uint32_t width = 1000, height = 600, players = 6, areas = 40;
+  const gamma_params_t huge = {GAMMA_LAYOUT_ROWS, true, NULL, false};
+
+  srand(13);
+  gamma_t *a = gamma_new(width, height, players, areas);
+  gamma_t *b = gamma_new_ex(width, height, players, areas, &huge);
+  assert(a != NULL && b != NULL);
+  play_random_moves(a, b, width, height, players, 30000);
+  for (uint32_t p = 1; p <= players; ++p) {
+    assert(gamma_busy_fields(a, p) == gamma_busy_fields(b, p));
+    assert(gamma_free_fields(a, p) == gamma_free_fields(b, p));
+    assert(gamma_golden_possible(a, p) == gamma_golden_possible(b, p));
+  }
+  char *board_a = gamma_board(a), *board_b = gamma_board(b);
+  assert(board_a != NULL && board_b != NULL);
+  assert(strcmp(board_a, board_b) == 0);
+  free(board_a);
+  free(board_b);
+  gamma_delete(a);
+  gamma_delete(b);
+  return PASS;
+}
+
+/* Alokator testowy: liczy przydzieloną pamięć i odmawia przydziału,
+ * po którym przekroczyłby limit. */
+typedef struct {
+  uint64_t used, limit, blocks;
+} test_budget;
+
+static void *budget_alloc(void *context, size_t size) {
+  test_budget *budget = context;
+  if (size > budget->limit - budget->used)
+    return NULL;
+  void *ptr = calloc(1, size);
+  if (ptr != NULL) {
+    budget->used += size;
+    budget->blocks++;
+  }
+  return ptr;
+}
+
+static void *budget_realloc(void *context, void *ptr, size_t old_size,
+                            size_t size) {
+  test_budget *budget = context;
+  if (size > old_size && size - old_size > budget->limit - budget->used)
+    return NULL;
+  void *new_ptr = realloc(ptr, size);
+  if (new_ptr != NULL) {
+    budget->used = budget->used - old_size + size;
+    if (ptr == NULL)
+      budget->blocks++;
+  }
+  return new_ptr;
+}
+
+static void budget_free(void *context, void *ptr, size_t size) {
+  test_budget *budget = context;
+  assert(budget->used >= size && budget->blocks > 0);
+  budget->used -= size;
+  budget->blocks--;
+  free(ptr);
+}
+
+/* Największy blok, o który poproszono largest_alloc lub largest_realloc. */
+static uint64_t largest_request;
+
+static void *largest_alloc(void *context, size_t size) {
+  if (size > largest_request)
+    largest_request = size;
+  return budget_alloc(context, size);
+}
+
+static void *largest_realloc(void *context, void *ptr, size_t old_size,
+                             size_t size) {
+  if (size > largest_request)
+    largest_request = size;
+  return budget_realloc(context, ptr, old_size, size);
+}
+
+/* Porównuje grę z własnym alokatorem, któremu przed każdym ruchem kończy się
+ * pamięć, z grą na stercie. Ruch, któremu zabrakło pamięci, nie może zmienić
+ * stanu gry i musi się udać po zwiększeniu limitu. */
+static int allocator_failures(void) {
+  const uint32_t width = 300, height = 200, players = 5, areas = 8;
+  test_budget budget = {0, 0, 0};
+  const gamma_allocator_t alloc = {budget_alloc, budget_realloc, budget_free,
+                                   &budget};
+  const gamma_params_t params = {GAMMA_LAYOUT_ROWS, false, &alloc, false};
+  const gamma_allocator_t broken = {budget_alloc, NULL, budget_free, &budget};
+  const gamma_params_t wrong = {GAMMA_LAYOUT_ROWS, false, &broken, false};
+
+  assert(gamma_new_ex(width, height, players, areas, &params) == NULL);
+  assert(budget.used == 0 && budget.blocks == 0);
+  budget.limit = UINT64_MAX;
+  assert(gamma_new_ex(width, height, players, areas, &wrong) == NULL);
+
+  srand(17);
+  gamma_t *a = gamma_new(width, height, players, areas);
+  gamma_t *b = gamma_new_ex(width, height, players, areas, &params);
+  assert(a != NULL && b != NULL);
+  int failures = 0;
+  for (int move = 0; move < 20000; ++move) {
+    uint32_t player = rand() % players + 1;
+    uint32_t x = rand() % width, y = rand() % height;
+    bool golden = rand() % 50 == 0;
+    bool expected = golden ? gamma_golden_move(a, player, x, y)
+                           : gamma_move(a, player, x, y);
+    budget.limit = budget.used;
+    bool result = golden ? gamma_golden_move(b, player, x, y)
+                         : gamma_move(b, player, x, y);
+    budget.limit = UINT64_MAX;
+    if (result != expected) {
+      assert(expected && !result);
+      failures++;
+      result = golden ? gamma_golden_move(b, player, x, y)
+                      : gamma_move(b, player, x, y);
+    }
+    assert(result == expected);
+  }
+  assert(failures > 0);
+  for (uint32_t p = 1; p <= players; ++p) {
+    assert(gamma_busy_fields(a, p) == gamma_busy_fields(b, p));
+    assert(gamma_free_fields(a, p) == gamma_free_fields(b, p));
+    assert(gamma_golden_possible(a, p) == gamma_golden_possible(b, p));
+  }
+  char *board_a = gamma_board(a), *board_b = gamma_board(b);
+  assert(board_a != NULL && board_b != NULL);
+  assert(strcmp(board_a, board_b) == 0);
+  free(board_a);
+  free(board_b);
+  gamma_delete(a);
+  gamma_delete(b);
+  assert(budget.used == 0 && budget.blocks == 0);
+  return PASS;
+}
+
+/* Porównuje grę w arenie z grą na stercie. Arena pobiera z alokatora
+ * niewiele dużych porcji i oddaje je wszystkie przy usuwaniu gry. */
+static int arena_game(void) {
+  const uint32_t width = 500, height = 400, players = 6, areas = 20;
+  test_budget budget = {0, UINT64_MAX, 0};
+  const gamma_allocator_t alloc = {budget_alloc, budget_realloc, budget_free,
+                                   &budget};
+  const gamma_params_t arena = {GAMMA_LAYOUT_MORTON, false, &alloc, true};
+  const gamma_params_t heap_arena = {GAMMA_LAYOUT_ROWS, false, NULL, true};
+
+  srand(19);
+  gamma_t *a = gamma_new(width, height, players, areas);
+  gamma_t *b = gamma_new_ex(width, height, players, areas, &arena);
+  assert(a != NULL && b != NULL);
+  play_random_moves(a, b, width, height, players, 40000);
+  for (uint32_t p = 1; p <= players; ++p) {
+    assert(gamma_busy_fields(a, p) == gamma_busy_fields(b, p));
+    assert(gamma_free_fields(a, p) == gamma_free_fields(b, p));
+    assert(gamma_golden_possible(a, p) == gamma_golden_possible(b, p));
+  }
+  char *board_a = gamma_board(a), *board_b = gamma_board(b);
+  assert(board_a != NULL && board_b != NULL);
+  assert(strcmp(board_a, board_b) == 0);
+  free(board_a);
+  free(board_b);
+  assert(budget.blocks > 0 && budget.blocks < 16);
+  gamma_delete(b);
+  assert(budget.used == 0 && budget.blocks == 0);
+
+  b = gamma_new_ex(width, height, players, areas, &heap_arena);
+  assert(b != NULL);
+  assert(gamma_move(b, 1, 0, 0));
+  assert(gamma_busy_fields(b, 1) == 1);
+  gamma_delete(a);
+  gamma_delete(b);
+  return PASS;
+}
+
+/* Sprawdza, czy bajty pod adresem block są zerami. */
+static bool zeroed(const void *block, size_t size) {
+  const unsigned char *bytes = block;
+  for (size_t i = 0; i < size; ++i)
+    if (bytes[i] != 0)
+      return false;
+  return true;
+}
+
+/* Zmniejsza w miejscu ostatni blok areny i sprawdza, czy kolejne bloki
+ * areny i ten sam blok powiększony z powrotem są wyzerowane. */
+static int arena_blocks(void) {
+  arena *a = arena_new(&heap_allocator);
+  assert(a != NULL);
+  allocator alloc = arena_allocator(a);
+  for (size_t shrunk = 0; shrunk <= 100; shrunk += 25) {
+    unsigned char *block = allocator_alloc(&alloc, 200);
+    assert(block != NULL && zeroed(block, 200));
+    memset(block, 0xff, 200);
+    assert(allocator_realloc(&alloc, block, 200, shrunk) == block);
+    assert(allocator_realloc(&alloc, block, shrunk, 200) == block);
+    assert(zeroed(block + shrunk, 200 - shrunk));
+    memset(block, 0xff, 200);
+    assert(allocator_realloc(&alloc, block, 200, shrunk) == block);
+    void *next = allocator_alloc(&alloc, 300);
+    assert(next != NULL && zeroed(next, 300));
+  }
+  arena_delete(a);
+  return PASS;
+}
+
+/* Rozgrywa kolejne gry w jednej strukturze czyszczonej przez gamma_reset
+ * i porównuje je z nowymi grami. Wymiary zmieniają rozmiar katalogu kafelków
+ * i jego rodzaj, a liczba graczy rośnie i maleje. */
+static int reset_game(void) {
+  const struct {
+    uint32_t width, height, players, areas;
+    int moves;
+  } games[] = {
+    {10, 10, 2, 3, 200},       {300, 200, 5, 8, 20000},
+    {40, 30, 3, 2, 2000},      {250, 210, 9, 6, 20000},
+    {40000, 40000, 4, 300, 1000}, {40000, 40000, 2, 500, 1000},
+    {70, 90, 7, 4, 5000},
+  };
+  const gamma_params_t morton = {GAMMA_LAYOUT_MORTON, false, NULL, false};
+
+  srand(23);
+  gamma_t *b = gamma_new_ex(10, 10, 2, 3, &morton);
+  assert(b != NULL);
+  assert(!gamma_reset(NULL, 10, 10, 2, 3));
+  assert(!gamma_reset(b, 0, 10, 2, 3));
+  assert(!gamma_reset(b, 10, 10, 2, 0));
+  for (size_t i = 0; i < sizeof(games) / sizeof(games[0]); ++i) {
+    uint32_t width = games[i].width, height = games[i].height;
+    uint32_t players = games[i].players;
+    assert(gamma_reset(b, width, height, players, games[i].areas));
+    assert(gamma_free_fields(b, 1) == (uint64_t)width * height);
+    gamma_t *a = gamma_new(width, height, players, games[i].areas);
+    assert(a != NULL);
+    play_random_moves(a, b, width, height, players, games[i].moves);
+    for (uint32_t p = 1; p <= players; ++p) {
+      assert(gamma_busy_fields(a, p) == gamma_busy_fields(b, p));
+      assert(gamma_free_fields(a, p) == gamma_free_fields(b, p));
+      assert(gamma_golden_possible(a, p) == gamma_golden_possible(b, p));
+    }
+    assert(gamma_busy_fields(b, players + 1) == 0);
+    if ((uint64_t)width * height <= 100000) {
+      char *board_a = gamma_board(a), *board_b = gamma_board(b);
+      assert(board_a != NULL && board_b != NULL);
+      assert(strcmp(board_a, board_b) == 0);
+      free(board_a);
+      free(board_b);
+    }
+    gamma_delete(a);
+  }
+  gamma_delete(b);
+  return PASS;
+}
+
+/* Trzyma wiele gier różnych rozmiarów w jednej puli i porównuje je z grami na
+ * stercie. Usunięte gry wracają do puli i są używane ponownie, a cała pamięć
+ * puli wraca do alokatora przy jej usuwaniu. */
+static int pool_games(void) {
+  static const gamma_param_t game[] = {
+    {10, 10, 2, 3},
+    {100, 70, 4, 6},
+    {7, 130, 3, 2},
+    {300, 300, 5, 9},
+  };
+  enum { GAMES = 40 };
+  static gamma_t *a[GAMES][SIZE(game)], *b[GAMES][SIZE(game)];
+  test_budget budget = {0, UINT64_MAX, 0};
+  const gamma_allocator_t alloc = {budget_alloc, budget_realloc, budget_free,
+                                   &budget};
+  const gamma_params_t params = {GAMMA_LAYOUT_ROWS, false, &alloc, false};
+  uint64_t games, idle;
+
+  gamma_pool_t *pool = gamma_pool_new(&params);
+  assert(pool != NULL);
+  assert(gamma_pool_game(pool, 0, 10, 2, 3) == NULL);
+  srand(29);
+  for (int round = 0; round < 3; ++round) {
+    for (size_t i = round == 0 ? 0 : GAMES / 2; i < GAMES; ++i) {
+      for (size_t j = 0; j < SIZE(game); ++j) {
+        a[i][j] = gamma_new(game[j].width, game[j].height, game[j].players,
+                            game[j].areas);
+        b[i][j] = gamma_pool_game(pool, game[j].width, game[j].height,
+                                  game[j].players, game[j].areas);
+        assert(a[i][j] != NULL && b[i][j] != NULL);
+      }
+    }
+    for (size_t i = 0; i < GAMES; ++i) {
+      for (size_t j = 0; j < SIZE(game); ++j) {
+        play_random_moves(a[i][j], b[i][j], game[j].width, game[j].height,
+                          game[j].players, 200);
+        for (uint32_t p = 1; p <= game[j].players; ++p) {
+          assert(gamma_busy_fields(a[i][j], p) == gamma_busy_fields(b[i][j], p));
+          assert(gamma_free_fields(a[i][j], p) == gamma_free_fields(b[i][j], p));
+        }
+      }
+    }
+    for (size_t i = GAMES / 2; i < GAMES; ++i) {
+      for (size_t j = 0; j < SIZE(game); ++j) {
+        gamma_delete(a[i][j]);
+        gamma_delete(b[i][j]);
+      }
+    }
+    assert(gamma_pool_memory(pool, &games, &idle) > 0);
+    assert(games == GAMES * SIZE(game));
+    assert(idle == GAMES / 2 * SIZE(game));
+  }
+  for (size_t i = 0; i < GAMES / 2; ++i) {
+    for (size_t j = 0; j < SIZE(game); ++j) {
+      char *board_a = gamma_board(a[i][j]), *board_b = gamma_board(b[i][j]);
+      assert(board_a != NULL && board_b != NULL);
+      assert(strcmp(board_a, board_b) == 0);
+      free(board_a);
+      free(board_b);
+      gamma_delete(a[i][j]);
+      gamma_delete(b[i][j]);
+    }
+  }
+  gamma_pool_memory(pool, &games, &idle);
+  assert(idle == games);
+  gamma_pool_delete(pool);
+  assert(budget.used == 0 && budget.blocks == 0);
+  gamma_pool_delete(NULL);
+  return PASS;
+}
+
+/* Sprawdza podział pamięci gry na kategorie i oszacowanie pamięci gry
+ * z całkowicie zajętą planszą. */
+static int memory_usage(void) {
+  const uint32_t width = 150, height = 130, players = 3, areas = 10000;
+  const gamma_params_t arena = {GAMMA_LAYOUT_ROWS, false, NULL, true};
+  gamma_memory_t m, e;
+
+  assert(gamma_memory_usage(NULL, NULL) == 0);
+  assert(gamma_estimate_memory(0, height, players, areas, NULL) == 0);
+  uint64_t estimate = gamma_estimate_memory(width, height, players, areas, &e);
+  assert(estimate == e.board + e.directory + e.players + e.areas + e.state);
+
+  gamma_t *g = gamma_new(width, height, players, areas);
+  assert(g != NULL);
+  uint64_t empty = gamma_memory_usage(g, &m);
+  assert(empty == m.board + m.directory + m.players + m.areas + m.state);
+  assert(m.board == 0 && m.overhead == 0);
+  assert(gamma_move(g, 1, 0, 0));
+  assert(gamma_memory_usage(g, &m) > empty);
+  assert(m.board > 0 && m.board * 9 == e.board);
+  for (uint32_t y = 0; y < height; ++y)
+    for (uint32_t x = 0; x < width; ++x)
+      gamma_move(g, (x + 2 * y) % players + 1, x, y);
+  assert(gamma_busy_fields(g, 1) + gamma_busy_fields(g, 2) +
+             gamma_busy_fields(g, 3) == (uint64_t)width * height);
+  assert(gamma_memory_usage(g, &m) <= estimate);
+  assert(m.board == e.board && m.directory <= e.directory);
+  assert(m.areas <= e.areas && m.players == e.players);
+  assert(gamma_free_fields(g, 1) == 0);
+  gamma_delete(g);
+
+  g = gamma_new_ex(width, height, players, areas, &arena);
+  assert(g != NULL);
+  assert(gamma_move(g, 1, 0, 0));
+  uint64_t total = gamma_memory_usage(g, &m);
+  assert(m.overhead > 0);
+  assert(total == m.board + m.directory + m.players + m.areas + m.state +
+                  m.overhead);
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Pakuje grę między kolejnymi porcjami ruchów i porównuje ją z grą, której
+ * nie pakujemy, również z kafelkami zajętymi przez wielu graczy. Rozpakowanie, któremu zabrakło pamięci, zostawia grę
+ * spakowaną, a gamma_compact_idle pakuje tylko gry nieużywane. */
+static int compact_game(void) {
+  const struct {
+    uint32_t width, height, players, areas;
+    int moves;
+  } games[] = {
+    {10, 10, 2, 3, 200},
+    {300, 200, 5, 8, 20000},
+    {130, 70, 3, 40, 5000},
+    {40000, 40000, 4, 300, 1000},
+    {100, 90, 40, 5, 20000},
+  };
+  const gamma_params_t morton = {GAMMA_LAYOUT_MORTON, false, NULL, false};
+  const gamma_params_t arena = {GAMMA_LAYOUT_ROWS, false, NULL, true};
+  test_budget budget = {0, UINT64_MAX, 0};
+  const gamma_allocator_t alloc = {budget_alloc, budget_realloc, budget_free,
+                                   &budget};
+  const gamma_params_t limited = {GAMMA_LAYOUT_ROWS, false, &alloc, false};
+  gamma_memory_t m;
+
+  assert(!gamma_compact(NULL) && !gamma_compact_idle(NULL));
+  srand(31);
+  for (size_t i = 0; i < SIZE(games); ++i) {
+    uint32_t width = games[i].width, height = games[i].height;
+    uint32_t players = games[i].players;
+    gamma_t *a = gamma_new(width, height, players, games[i].areas);
+    gamma_t *b = gamma_new_ex(width, height, players, games[i].areas,
+                              i % 2 == 0 ? &morton : &limited);
+    assert(a != NULL && b != NULL);
+    for (int round = 0; round < 4; ++round) {
+      play_random_moves(a, b, width, height, players, games[i].moves);
+      uint64_t unpacked = gamma_memory_usage(b, NULL);
+      assert(gamma_compact(b) && gamma_compact(b));
+      assert(gamma_memory_usage(b, &m) < unpacked);
+      assert(m.directory == 0 && m.areas == 0);
+      for (uint32_t p = 1; p <= players; ++p) {
+        assert(gamma_busy_fields(a, p) == gamma_busy_fields(b, p));
+        assert(gamma_golden_possible(a, p) == gamma_golden_possible(b, p));
+        assert(gamma_free_fields(a, p) == gamma_free_fields(b, p));
+      }
+      if ((uint64_t)width * height <= 100000) {
+        assert(gamma_compact(b));
+        char *board_a = gamma_board(a), *board_b = gamma_board(b);
+        assert(board_a != NULL && board_b != NULL);
+        assert(strcmp(board_a, board_b) == 0);
+        free(board_a);
+        free(board_b);
+      }
+    }
+    if (i % 2 == 1) {
+      assert(gamma_compact(b));
+      budget.limit = budget.used;
+      assert(!gamma_move(b, 1, 0, 0) && !gamma_golden_possible(b, 1));
+      assert(gamma_board(b) == NULL);
+      budget.limit = UINT64_MAX;
+      assert(gamma_move(a, 1, 0, 0) == gamma_move(b, 1, 0, 0));
+    }
+    assert(gamma_compact_idle(b) == false);
+    assert(gamma_compact_idle(b) == true);
+    assert(gamma_reset(b, width, height, players, games[i].areas));
+    assert(gamma_free_fields(b, 1) == (uint64_t)width * height);
+    assert(gamma_move(b, 1, 0, 0));
+    gamma_delete(a);
+    gamma_delete(b);
+  }
+  assert(budget.used == 0 && budget.blocks == 0);
+
+  gamma_t *g = gamma_new_ex(10, 10, 2, 3, &arena);
+  assert(g != NULL);
+  assert(!gamma_compact(g) && !gamma_compact_idle(g));
+  assert(gamma_move(g, 1, 0, 0));
+  gamma_delete(g);
+  return PASS;
+}
+
+/* Zapisuje dwie gry jedną za drugą w pliku, odtwarza je i porównuje
+ * z oryginałami, również po kolejnych ruchach, które korzystają
+ * z odtworzonych kolorów obszarów. Uszkodzony obraz nie daje gry. */
+static int snapshot_game(void) {
+  const uint32_t width = 300, height = 200, players = 5, areas = 8;
+  const gamma_params_t morton = {GAMMA_LAYOUT_MORTON, false, NULL, false};
+  const gamma_params_t arena = {GAMMA_LAYOUT_ROWS, false, NULL, true};
+  FILE *file = tmpfile(), *broken = tmpfile();
+  assert(file != NULL && broken != NULL);
+  int fd = fileno(file), broken_fd = fileno(broken);
+
+  srand(37);
+  gamma_t *a = gamma_new(width, height, players, areas);
+  gamma_t *c = gamma_new_ex(10, 10, 2, 3, &morton);
+  assert(a != NULL && c != NULL);
+  gamma_t *copy = gamma_new(width, height, players, areas);
+  play_random_moves(a, copy, width, height, players, 20000);
+  gamma_delete(copy);
+  assert(gamma_move(c, 1, 4, 4) && gamma_golden_move(c, 2, 4, 4));
+  assert(!gamma_save(NULL, fd) && !gamma_save(a, -1));
+  assert(gamma_compact(a));
+  assert(gamma_save(a, fd) && gamma_save(c, fd));
+  off_t size = lseek(fd, 0, SEEK_CUR);
+  assert(lseek(fd, 0, SEEK_SET) == 0);
+  gamma_t *b = gamma_load(fd, NULL);
+  gamma_t *d = gamma_load(fd, &arena);
+  assert(b != NULL && d != NULL);
+  assert(lseek(fd, 0, SEEK_CUR) == size);
+  assert(gamma_load(fd, NULL) == NULL);
+  for (int round = 0; round < 2; ++round) {
+    for (uint32_t p = 1; p <= players; ++p) {
+      assert(gamma_busy_fields(a, p) == gamma_busy_fields(b, p));
+      assert(gamma_free_fields(a, p) == gamma_free_fields(b, p));
+      assert(gamma_golden_possible(a, p) == gamma_golden_possible(b, p));
+    }
+    char *board_a = gamma_board(a), *board_b = gamma_board(b);
+    assert(board_a != NULL && board_b != NULL);
+    assert(strcmp(board_a, board_b) == 0);
+    free(board_a);
+    free(board_b);
+    play_random_moves(a, b, width, height, players, 20000);
+  }
+  char *board_c = gamma_board(c), *board_d = gamma_board(d);
+  assert(board_c != NULL && board_d != NULL);
+  assert(strcmp(board_c, board_d) == 0);
+  free(board_c);
+  free(board_d);
+  assert(!gamma_golden_possible(d, 2) && gamma_golden_possible(d, 1));
+
+  assert(gamma_save(a, broken_fd));
+  assert(ftruncate(broken_fd, lseek(broken_fd, 0, SEEK_CUR) - 1) == 0);
+  assert(lseek(broken_fd, 0, SEEK_SET) == 0);
+  assert(gamma_load(broken_fd, NULL) == NULL);
+  assert(lseek(fd, 1, SEEK_SET) == 1);
+  assert(gamma_load(fd, NULL) == NULL);
+
+  /* Pole gracza spoza gry w poprawnym poza tym obrazie. Jedyny kafelek
+   * zajmuje koniec obrazu, a pole (0, 0) jest jego pierwszym polem. */
+  gamma_t *e = gamma_new(10, 10, 2, 3);
+  assert(e != NULL && gamma_move(e, 1, 0, 0));
+  assert(ftruncate(broken_fd, 0) == 0 && lseek(broken_fd, 0, SEEK_SET) == 0);
+  assert(gamma_save(e, broken_fd));
+  gamma_delete(e);
+  off_t end = lseek(broken_fd, 0, SEEK_CUR);
+  uint32_t tile_side, player = 70000;
+  assert(pread(broken_fd, &tile_side, sizeof(tile_side), 12) == 4);
+  off_t first = end - (off_t)tile_side * tile_side * 2 * sizeof(uint32_t);
+  assert(lseek(broken_fd, 0, SEEK_SET) == 0);
+  e = gamma_load(broken_fd, NULL);
+  assert(e != NULL && gamma_busy_fields(e, 1) == 1);
+  gamma_delete(e);
+  assert(pwrite(broken_fd, &player, sizeof(player), first) == 4);
+  assert(lseek(broken_fd, 0, SEEK_SET) == 0);
+  assert(gamma_load(broken_fd, NULL) == NULL);
+
+  /* Kolorów jest najwyżej tyle, ile pól planszy, więc nagłówek z większą
+   * ich liczbą jest odrzucany, zanim poprosimy o pamięć na tablicę kolorów. */
+  player = 1;
+  assert(pwrite(broken_fd, &player, sizeof(player), first) == 4);
+  test_budget budget = {0, UINT64_MAX, 0};
+  const gamma_allocator_t largest = {largest_alloc, largest_realloc,
+                                     budget_free, &budget};
+  const gamma_params_t watched = {GAMMA_LAYOUT_ROWS, false, &largest, false};
+  const uint32_t labels[] = {101, UINT32_MAX - 1};
+  for (size_t i = 0; i < SIZE(labels); ++i) {
+    assert(pwrite(broken_fd, &labels[i], sizeof(labels[i]), 48) == 4);
+    assert(lseek(broken_fd, 0, SEEK_SET) == 0);
+    largest_request = 0;
+    assert(gamma_load(broken_fd, &watched) == NULL);
+    assert(largest_request < (1 << 20) && budget.used == 0);
+  }
+  fclose(file);
+  fclose(broken);
+  gamma_delete(a);
+  gamma_delete(b);
+  gamma_delete(c);
+  gamma_delete(d);
+  return PASS;
+}
+
+/* Wczytuje układ pionków gry zbudowanej ruchami, odczytany z napisu
+ * gamma_board, i porównuje obie gry, również po kolejnych ruchach, które
+ * korzystają z odtworzonych kolorów obszarów. Niepoprawny układ nie
+ * zmienia gry. */
+static int load_board(void) {
+  const struct {
+    uint32_t width, height, players, areas;
+    int moves;
+  } games[] = {
+    {10, 10, 2, 3, 200},
+    {300, 200, 5, 8, 20000},
+    {130, 300, 3, 40, 30000},
+    {64, 129, 2, 2000, 6000},
+    {100, 90, 40, 5, 20000},
+  };
+  const gamma_params_t morton = {GAMMA_LAYOUT_MORTON, false, NULL, false};
+  uint32_t width, height;
+
+  srand(41);
+  for (size_t i = 0; i < SIZE(games); ++i) {
+    uint32_t players = games[i].players;
+    gamma_t *a = gamma_new(games[i].width, games[i].height, players,
+                           games[i].areas);
+    gamma_t *b = gamma_new_ex(games[i].width, games[i].height, players,
+                              games[i].areas, i % 2 == 0 ? &morton : NULL);
+    assert(a != NULL && b != NULL);
+    assert(!gamma_load_board(NULL, NULL) && !gamma_load_board(b, NULL));
+    assert(gamma_move(b, 1, 0, 0));
+    if (i % 2 == 1)
+      assert(gamma_compact(b));
+    for (int move = 0; move < games[i].moves; ++move)
+      gamma_move(a, rand() % players + 1, rand() % games[i].width,
+                 rand() % games[i].height);
+    char *board_a = gamma_board(a);
+    assert(board_a != NULL);
+    uint32_t *owners = gamma_parse_board(board_a, &width, &height);
+    assert(owners != NULL);
+    assert(width == games[i].width && height == games[i].height);
+    assert(gamma_load_board(b, owners));
+    free(owners);
+    for (int round = 0; round < 2; ++round) {
+      for (uint32_t p = 1; p <= players; ++p) {
+        assert(gamma_busy_fields(a, p) == gamma_busy_fields(b, p));
+        assert(gamma_free_fields(a, p) == gamma_free_fields(b, p));
+        assert(gamma_golden_possible(a, p) == gamma_golden_possible(b, p));
+      }
+      char *board_b = gamma_board(b);
+      assert(board_b != NULL);
+      assert(strcmp(board_a, board_b) == 0);
+      free(board_a);
+      free(board_b);
+      play_random_moves(a, b, width, height, players, games[i].moves);
+      board_a = gamma_board(a);
+      assert(board_a != NULL);
+    }
+    free(board_a);
+    gamma_delete(a);
+    gamma_delete(b);
+  }
+
+  /* Puste pola w kolejnych pasach kafelków muszą mieć kolor 0, co sprawdza
+   * wczytanie obrazu stanu gry. */
+  gamma_t *g = gamma_new(4, 130, 2, 200);
+  assert(g != NULL);
+  uint32_t *owners = calloc(4 * 130, sizeof(uint32_t));
+  assert(owners != NULL);
+  for (uint32_t k = 0; k < 4 * 130; ++k)
+    owners[k] = k % 3 == 0 ? 0 : (k / 4) % 2 + 1;
+  assert(gamma_load_board(g, owners));
+  free(owners);
+  FILE *file = tmpfile();
+  assert(file != NULL && gamma_save(g, fileno(file)));
+  assert(lseek(fileno(file), 0, SEEK_SET) == 0);
+  gamma_t *copy = gamma_load(fileno(file), NULL);
+  assert(copy != NULL);
+  assert(gamma_busy_fields(copy, 1) == gamma_busy_fields(g, 1));
+  gamma_delete(copy);
+  gamma_delete(g);
+  fclose(file);
+
+  g = gamma_new(3, 2, 2, 1);
+  assert(g != NULL);
+  assert(gamma_move(g, 1, 1, 1));
+  owners = gamma_parse_board("1.2\n.1.\n", &width, &height);
+  assert(owners != NULL && width == 3 && height == 2);
+  assert(owners[0] == 0 && owners[1] == 1 && owners[3] == 1 && owners[5] == 2);
+  assert(!gamma_load_board(g, owners));
+  owners[3] = 3;
+  owners[4] = 1;
+  assert(!gamma_load_board(g, owners));
+  char *board = gamma_board(g);
+  assert(board != NULL && strcmp(board, ".1.\n...\n") == 0);
+  free(board);
+  owners[3] = 1;
+  assert(gamma_load_board(g, owners));
+  assert(gamma_busy_fields(g, 1) == 3 && gamma_busy_fields(g, 2) == 1);
+  assert(!gamma_move(g, 2, 0, 0) && gamma_move(g, 1, 0, 0));
+  free(owners);
+  gamma_delete(g);
+
+  owners = gamma_parse_board("12 .\n.  3\n", &width, &height);
+  assert(owners != NULL && width == 2 && height == 2);
+  assert(owners[0] == 0 && owners[1] == 3 && owners[2] == 12 && owners[3] == 0);
+  free(owners);
+  assert(gamma_parse_board("", &width, &height) == NULL);
+  assert(gamma_parse_board("1.\n1\n", &width, &height) == NULL);
+  assert(gamma_parse_board("1x\n", &width, &height) == NULL);
+  assert(gamma_parse_board("0.\n", &width, &height) == NULL);
+  assert(gamma_parse_board("12 .\n3\n", &width, &height) == NULL);
+  assert(gamma_parse_board("1\n\n", &width, &height) == NULL);
+  return PASS;
+}
+
+/* Porównuje ruchy wykonane przez gamma_move_batch z tymi samymi ruchami
+ * wykonanymi po kolei przez gamma_move, również dla błędnych parametrów. */
+static int move_batch(void) {
+  const uint32_t width = 200, height = 130, players = 4, areas = 6;
+  enum { MOVES = 1000 };
+  gamma_coord_t coords[MOVES];
+  uint8_t results[MOVES], expected[MOVES];
+
+  srand(47);
+  gamma_t *a = gamma_new(width, height, players, areas);
+  gamma_t *b = gamma_new(width, height, players, areas);
+  assert(a != NULL && b != NULL);
+  assert(gamma_move_batch(NULL, 1, coords, 0, results) == 0);
+  for (int round = 0; round < 40; ++round) {
+    uint32_t player = rand() % (players + 2);
+    uint64_t done = 0;
+    for (int i = 0; i < MOVES; ++i) {
+      coords[i].x = rand() % (width + 2);
+      coords[i].y = rand() % (height + 2);
+      expected[i] = gamma_move(a, player, coords[i].x, coords[i].y);
+      done += expected[i];
+    }
+    assert(gamma_move_batch(b, player, coords, MOVES, results) == done);
+    assert(memcmp(results, expected, MOVES) == 0);
+    for (uint32_t p = 1; p <= players; ++p)
+      assert(gamma_busy_fields(a, p) == gamma_busy_fields(b, p));
+  }
+  char *board_a = gamma_board(a), *board_b = gamma_board(b);
+  assert(board_a != NULL && board_b != NULL);
+  assert(strcmp(board_a, board_b) == 0);
+  free(board_a);
+  free(board_b);
+  gamma_delete(a);
+  gamma_delete(b);
+  return PASS;
+}
+
+/* Wyniki zapytań o wszystkich graczy, liczone przez concurrent_queries. */
+typedef struct {
+  gamma_t *g;
+  uint32_t players;
+  uint64_t busy[6], free[6];
+  bool golden[6];
+  char *board;
+} query_answers;
+
+/* Liczy zapytania o wszystkich graczy i porównuje je z oczekiwanymi. */
+static void *check_queries(void *arg) {
+  query_answers *expected = arg;
+  for (int round = 0; round < 20; ++round) {
+    for (uint32_t p = 1; p <= expected->players; ++p) {
+      if (gamma_busy_fields(expected->g, p) != expected->busy[p] ||
+          gamma_free_fields(expected->g, p) != expected->free[p] ||
+          gamma_golden_possible(expected->g, p) != expected->golden[p])
+        return arg;
+    }
+    char *board = gamma_board(expected->g);
+    bool same = board != NULL && strcmp(board, expected->board) == 0;
+    free(board);
+    if (!same)
+      return arg;
+  }
+  return NULL;
+}
+
+/* Testuje, czy zapytania na grze przygotowanej przez gamma_prepare_queries
+ * można wywoływać równolegle. */
+static int concurrent_queries(void) {
+  enum { THREADS = 4 };
+  query_answers expected = {.players = 5};
+  pthread_t threads[THREADS];
+
+  srand(46);
+  expected.g = gamma_new(300, 200, expected.players, 3);
+  assert(expected.g != NULL);
+  assert(!gamma_prepare_queries(NULL));
+  for (int i = 0; i < 30000; ++i)
+    gamma_move(expected.g, rand() % 5 + 1, rand() % 300, rand() % 200);
+  for (int i = 0; i < 200; ++i)
+    gamma_golden_move(expected.g, rand() % 4 + 1, rand() % 300, rand() % 200);
+  for (uint32_t p = 1; p <= expected.players; ++p) {
+    expected.busy[p] = gamma_busy_fields(expected.g, p);
+    expected.free[p] = gamma_free_fields(expected.g, p);
+    expected.golden[p] = gamma_golden_possible(expected.g, p);
+  }
+  expected.board = gamma_board(expected.g);
+  assert(expected.board != NULL);
+
+  gamma_compact(expected.g);
+  assert(gamma_prepare_queries(expected.g));
+  for (int i = 0; i < THREADS; ++i)
+    assert(pthread_create(&threads[i], NULL, check_queries, &expected) == 0);
+  for (int i = 0; i < THREADS; ++i) {
+    void *failed;
+    assert(pthread_join(threads[i], &failed) == 0);
+    assert(failed == NULL);
+  }
+  free(expected.board);
+  gamma_delete(expected.g);
+  return PASS;
+}
+
+/* Ruchy i wyniki wątku piszącego w concurrent_moves. */
+typedef struct {
+  gamma_t *g;
+  uint32_t moves[4000][3];
+  bool results[4000];
+  atomic_bool done;
+} move_script;
+
+/* Wykonuje ruchy skryptu, co pięćdziesiąty złoty. */
+static void *apply_moves(void *arg) {
+  move_script *script = arg;
+  for (int i = 0; i < 4000; ++i) {
+    uint32_t *m = script->moves[i];
+    script->results[i] = i % 50 == 0 ? gamma_golden_move(script->g, m[0], m[1], m[2])
+                                     : gamma_move(script->g, m[0], m[1], m[2]);
+  }
+  atomic_store(&script->done, true);
+  return NULL;
+}
+
+/* Zadaje zapytania w trakcie ruchów i co najmniej 20 razy; liczba zajętych pól na planszy nie może
+ * maleć, a wyniki nie mogą przekraczać rozmiaru planszy. */
+static void *query_during_moves(void *arg) {
+  move_script *script = arg;
+  uint64_t last = 0;
+  gamma_player_status_t status[5];
+  for (int round = 0; round < 20 || !atomic_load(&script->done); ++round) {
+    char *board = gamma_board(script->g);
+    if (board == NULL)
+      return arg;
+    uint64_t busy = 0;
+    for (char *c = board; *c != '\0'; ++c)
+      busy += *c != '.' && *c != '\n';
+    free(board);
+    if (busy < last)
+      return arg;
+    last = busy;
+    for (uint32_t p = 1; p <= 5; ++p) {
+      if (gamma_busy_fields(script->g, p) > 60 * 40 ||
+          gamma_free_fields(script->g, p) > 60 * 40)
+        return arg;
+      gamma_golden_possible(script->g, p);
+    }
+    if (!gamma_players_status(script->g, status))
+      return arg;
+  }
+  return NULL;
+}
+
+/* Testuje tryb współbieżny: jeden wątek wykonuje ruchy, a kilka innych zadaje
+ * w tym czasie zapytania. Ruchy muszą dać takie same wyniki jak wykonane
+ * po kolei na zwykłej grze. */
+static int concurrent_moves(void) {
+  enum { THREADS = 4 };
+  static move_script script;
+  pthread_t writer, readers[THREADS];
+
+  srand(50);
+  for (int i = 0; i < 4000; ++i) {
+    script.moves[i][0] = rand() % 5 + 1;
+    script.moves[i][1] = rand() % 60;
+    script.moves[i][2] = rand() % 40;
+  }
+  script.g = gamma_new(60, 40, 5, 4);
+  assert(script.g != NULL);
+  assert(!gamma_enable_concurrency(NULL));
+  assert(gamma_enable_concurrency(script.g));
+  assert(gamma_enable_concurrency(script.g));
+  assert(!gamma_compact(script.g));
+  assert(!gamma_compact_idle(script.g));
+  atomic_init(&script.done, false);
+  for (int i = 0; i < THREADS; ++i)
+    assert(pthread_create(&readers[i], NULL, query_during_moves, &script) == 0);
+  assert(pthread_create(&writer, NULL, apply_moves, &script) == 0);
+  assert(pthread_join(writer, NULL) == 0);
+  for (int i = 0; i < THREADS; ++i) {
+    void *failed;
+    assert(pthread_join(readers[i], &failed) == 0);
+    assert(failed == NULL);
+  }
+
+  gamma_t *serial = gamma_new(60, 40, 5, 4);
+  assert(serial != NULL);
+  for (int i = 0; i < 4000; ++i) {
+    uint32_t *m = script.moves[i];
+    bool result = i % 50 == 0 ? gamma_golden_move(serial, m[0], m[1], m[2])
+                              : gamma_move(serial, m[0], m[1], m[2]);
+    assert(result == script.results[i]);
+  }
+  char *expected = gamma_board(serial);
+  char *board = gamma_board(script.g);
+  assert(expected != NULL && board != NULL);
+  assert(strcmp(expected, board) == 0);
+  free(expected);
+  free(board);
+  gamma_delete(serial);
+  gamma_delete(script.g);
+  return PASS;
+}
+
+/* Rozgrywa w procesie potomnym tryb wsadowy na wejściu z pliku input,
+ * potokowo lub zwykłym play_batch, i zapisuje stdout i stderr w plikach. */
+static void run_batch(const char *input, const char *out, const char *err,
+                      bool pipelined) {
+  pid_t child = fork();
+  assert(child != -1);
+  if (child == 0) {
+    if (freopen(input, "r", stdin) == NULL ||
+        freopen(out, "w", stdout) == NULL || freopen(err, "w", stderr) == NULL)
+      _exit(1);
+    gamma_t *g = gamma_new(30, 20, 4, 6);
+    int line = 1;
+    if (g == NULL)
+      _exit(1);
+    unsetenv("GAMMA_PIPELINE");
+    if (pipelined) {
+      if (!play_batch_pipelined(g, &line))
+        _exit(1);
+    } else {
+      play_batch(g, &line);
+    }
+    gamma_delete(g);
+    fflush(stdout);
+    fflush(stderr);
+    _exit(0);
+  }
+  int status;
+  assert(waitpid(child, &status, 0) == child);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+/* Wczytuje cały plik do pamięci i zapisuje jego długość w length. */
+static char *read_file(const char *path, long *length) {
+  FILE *f = fopen(path, "rb");
+  assert(f != NULL);
+  assert(fseek(f, 0, SEEK_END) == 0);
+  *length = ftell(f);
+  rewind(f);
+  char *data = malloc(*length + 1);
+  assert(data != NULL);
+  assert(fread(data, 1, *length, f) == (size_t)*length);
+  fclose(f);
+  return data;
+}
+
+/* Porównuje potokowy tryb wsadowy ze zwykłym bajt po bajcie, zarówno
+ * odpowiedzi, jak i komunikaty ERROR. Wejście zawiera ruchy, komendy M,
+ * komentarze, linie niepoprawne, długie ciągi zapytań i ostatnią linię bez
+ * znaku nowej linii. */
+static int pipelined_batch(void) {
+  const char *input = "gamma_test_batch.in";
+  const char *outputs[2] = {"gamma_test_batch.out", "gamma_test_pipe.out"};
+  const char *errors[2] = {"gamma_test_batch.err", "gamma_test_pipe.err"};
+  static const char *const queries[] = {"b %d\n", "f %d\n", "q %d\n"};
+  static const char *const invalid[] = {"m 1 x 0\n", "z\n", "b\n",
+                                        "f 99999999999\n", "p 1\n",
+                                        "m 1 2 3 4\n"};
+
+  FILE *in = fopen(input, "w");
+  assert(in != NULL);
+  srand(45);
+  for (int i = 0; i < 3000; ++i) {
+    int kind = rand() % 100;
+    if (kind < 40) {
+      fprintf(in, "m %d %d %d\n", rand() % 6, rand() % 32, rand() % 22);
+    } else if (kind < 45) {
+      fprintf(in, "g %d %d %d\n", rand() % 6, rand() % 32, rand() % 22);
+    } else if (kind < 50) {
+      int n = rand() % 4 + 1;
+      fprintf(in, "M %d %d", rand() % 5, n);
+      for (int k = 0; k < n; ++k)
+        fprintf(in, " %d %d", rand() % 32, rand() % 22);
+      fputc('\n', in);
+    } else if (kind < 55) {
+      fputs(rand() % 2 ? "# komentarz\n" : "\n", in);
+    } else if (kind < 60) {
+      fputs(invalid[rand() % SIZE(invalid)], in);
+    } else if (kind < 62) {
+      fputs("p\n", in);
+    } else {
+      for (int k = rand() % 80 + 20; k > 0; --k)
+        fprintf(in, queries[rand() % SIZE(queries)], rand() % 6);
+    }
+  }
+  fputs("q 1", in);
+  assert(fclose(in) == 0);
+
+  for (int pipelined = 0; pipelined < 2; ++pipelined)
+    run_batch(input, outputs[pipelined], errors[pipelined], pipelined);
+  const char *const *files[2] = {outputs, errors};
+  for (int f = 0; f < 2; ++f) {
+    long serial_length, pipelined_length;
+    char *serial = read_file(files[f][0], &serial_length);
+    char *pipelined = read_file(files[f][1], &pipelined_length);
+    assert(serial_length > 0 && serial_length == pipelined_length);
+    assert(memcmp(serial, pipelined, serial_length) == 0);
+    free(serial);
+    free(pipelined);
+    remove(files[f][0]);
+    remove(files[f][1]);
+  }
+  remove(input);
+  return PASS;
+}
+
+static void *serve_channel(void *arg) {
+  return shm_serve(arg) ? arg : NULL;
+}
+
+static void *receive_response(void *arg) {
+  static uint64_t value;
+  value = shm_receive(arg);
+  return &value;
+}
+
+/* Wysyła żądanie kanałem i porównuje odpowiedź z wynikiem funkcji z gamma.h
+ * na grze wzorcowej. */
+static void check_call(shm_channel *c, gamma_t *g, uint32_t op, uint32_t game,
+                       uint32_t a0, uint32_t a1, uint32_t a2) {
+  shm_request r = {op, game, {a0, a1, a2, 0}};
+  uint64_t expected = 0;
+  if (op == ShmMove)
+    expected = gamma_move(g, a0, a1, a2);
+  else if (op == ShmGoldenMove)
+    expected = gamma_golden_move(g, a0, a1, a2);
+  else if (op == ShmBusyFields)
+    expected = gamma_busy_fields(g, a0);
+  else if (op == ShmFreeFields)
+    expected = gamma_free_fields(g, a0);
+  else if (op == ShmGoldenPossible)
+    expected = gamma_golden_possible(g, a0);
+  assert(shm_call(c, &r) == expected);
+}
+
+/* Obsługuje kanał w osobnym wątku i porównuje odpowiedzi na żądania każdego
+ * rodzaju z wywołaniami funkcji z gamma.h, również dla powtórzonego
+ * utworzenia gry, nieistniejącej gry i usuniętej gry. Żądania wysłane
+ * naraz dostają odpowiedzi w kolejności wysłania, a shm_channel_stop budzi
+ * bota czekającego na odpowiedź, której nikt nie wyśle. */
+static int shm_channel_ops(void) {
+  enum { GAME = 7, PIPELINED = 3 * SHM_CHANNEL_CAPACITY / 4 };
+  char name[64];
+  snprintf(name, sizeof(name), "/gamma_test_%d", (int)getpid());
+  shm_channel *server = shm_channel_create(name);
+  assert(server != NULL && shm_channel_create(name) == NULL);
+  shm_channel *client = shm_channel_open(name);
+  assert(client != NULL);
+  pthread_t thread;
+  assert(pthread_create(&thread, NULL, serve_channel, server) == 0);
+
+  shm_request r = {ShmNew, GAME, {20, 15, 3, 4}};
+  assert(shm_call(client, &r) == 1);
+  assert(shm_call(client, &r) == 0);
+  r = (shm_request){ShmNew, GAME + 1, {0, 15, 3, 4}};
+  assert(shm_call(client, &r) == 0);
+  r = (shm_request){ShmDelete, GAME + 1, {0}};
+  assert(shm_call(client, &r) == 0);
+  r = (shm_request){ShmMove, GAME + 1, {1, 0, 0}};
+  assert(shm_call(client, &r) == 0);
+  r = (shm_request){ShmBusyFields, GAME + 1, {1}};
+  assert(shm_call(client, &r) == 0);
+  r = (shm_request){ShmClose + 1, GAME, {1}};
+  assert(shm_call(client, &r) == 0);
+
+  gamma_t *g = gamma_new(20, 15, 3, 4);
+  assert(g != NULL);
+  srand(49);
+  for (int i = 0; i < 3000; ++i)
+    check_call(client, g, rand() % 5 + ShmMove, GAME, rand() % 5,
+               rand() % 22, rand() % 17);
+
+  uint64_t expected[PIPELINED];
+  for (int i = 0; i < PIPELINED; ++i) {
+    uint32_t player = rand() % 4, x = rand() % 20, y = rand() % 15;
+    if (i % 2 == 0) {
+      r = (shm_request){ShmMove, GAME, {player, x, y}};
+      expected[i] = gamma_move(g, player, x, y);
+    } else {
+      r = (shm_request){ShmFreeFields, GAME, {player}};
+      expected[i] = gamma_free_fields(g, player);
+    }
+    shm_send(client, &r);
+  }
+  for (int i = 0; i < PIPELINED; ++i)
+    assert(shm_receive(client) == expected[i]);
+  gamma_delete(g);
+
+  r = (shm_request){ShmDelete, GAME, {0}};
+  assert(shm_call(client, &r) == 1);
+  assert(shm_call(client, &r) == 0);
+  r = (shm_request){ShmBusyFields, GAME, {1}};
+  assert(shm_call(client, &r) == 0);
+  r = (shm_request){ShmClose, 0, {0}};
+  assert(shm_call(client, &r) == 1);
+  void *served;
+  assert(pthread_join(thread, &served) == 0);
+  assert(served == server);
+
+  assert(pthread_create(&thread, NULL, receive_response, client) == 0);
+  struct timespec pause = {0, 50000000};
+  nanosleep(&pause, NULL);
+  shm_channel_stop(server);
+  void *value;
+  assert(pthread_join(thread, &value) == 0);
+  assert(*(uint64_t *)value == 0);
+  shm_channel_close(client);
+  shm_channel_close(server);
+  assert(shm_channel_open(name) == NULL);
+  return PASS;
+}
+
+/* Wykonuje linie trybu z identyfikatorami gier i porównuje odpowiedzi
+ * i komunikaty o błędach z oczekiwanymi. Każda odpowiedź i każda linia
+ * planszy zaczyna się identyfikatorem gry, a błędem są: nieznana gra,
+ * powtórne utworzenie gry, niepoprawny identyfikator i identyfikator
+ * większy niż UINT32_MAX. */
+static int tagged_commands(void) {
+  static const char *const lines[] = {
+    "1 B 3 2 2 2\n", "1 B 3 2 2 2\n", "2 B 0 2 2 2\n", "1 m 1 0 0\n",
+    "1 m 2 1 0\n", "1 g 2 0 0\n", "1 b 2\n", "1 f 1\n", "1 q 1\n",
+    "1 p\n", "1 M 1 2 2 1 0 1\n", "9 b 1\n", "x b 1\n",
+    "4294967296 B 3 2 2 2\n", "1 D\n", "1 b 1\n", "1 D\n",
+    "4294967295 B 1 1 1 1\n", "4294967295 p\n", "1b 1\n", "4294967295 x\n",
+  };
+  static const char expected_out[] =
+    "1 OK\n1 1\n1 1\n1 1\n1 2\n1 4\n1 1\n1 ...\n1 22.\n1 11\n1 OK\n"
+    "4294967295 OK\n4294967295 .\n";
+  static const char expected_errors[] =
+    "ERROR 2\nERROR 3\nERROR 12\nERROR 13\nERROR 14\nERROR 16\n"
+    "ERROR 17\nERROR 20\nERROR 21\n";
+  char *out_text = NULL, *errors_text = NULL;
+  size_t out_length, errors_length;
+  FILE *out = open_memstream(&out_text, &out_length);
+  FILE *errors = open_memstream(&errors_text, &errors_length);
+  tagged_games *t = tagged_games_new();
+  assert(out != NULL && errors != NULL && t != NULL);
+
+  for (size_t i = 0; i < SIZE(lines); ++i) {
+    char buffer[64];
+    strcpy(buffer, lines[i]);
+    execute_tagged_line(t, buffer, i + 1, out, errors);
+  }
+  tagged_games_delete(t);
+  assert(fclose(out) == 0 && fclose(errors) == 0);
+  assert(strcmp(out_text, expected_out) == 0);
+  assert(strcmp(errors_text, expected_errors) == 0);
+  free(out_text);
+  free(errors_text);
+  return PASS;
+}
+
+/* Zwraca miejsce, pod którym w tablicy jest gra o identyfikatorze id. */
+static uint64_t game_table_slot(const game_table *t, uint32_t id) {
+  uint64_t slot = 0;
+  while (t->games[slot] == NULL || t->ids[slot] != id)
+    ++slot;
+  return slot;
+}
+
+/* Przeplata dodawanie, wyszukiwanie i usuwanie gier z tablicy gier, również
+ * dla identyfikatorów o tym samym miejscu startowym, i porównuje wyniki
+ * z tablicą wzorcową. Tablica rośnie w trakcie testu, a usuwanie ze środka
+ * ciągu kolizji przesuwa następne gry. */
+static int game_table_ops(void) {
+  enum { COLLIDING = 100, IDS = 600 };
+  static char games[IDS];
+  gamma_t *expected[IDS] = {NULL};
+  uint32_t ids[IDS];
+  game_table t;
+  uint64_t size = 0;
+
+  /* Miejsce startowe gry w pustej tablicy to jej jedyne zajęte miejsce. */
+  game_table_init(&t);
+  uint64_t home = UINT64_MAX;
+  for (uint32_t id = 0, n = 0; n < COLLIDING; ++id) {
+    assert(game_table_put(&t, id, (gamma_t *)games));
+    uint64_t slot = game_table_slot(&t, id);
+    assert(game_table_remove(&t, id) == (gamma_t *)games);
+    if (home == UINT64_MAX)
+      home = slot;
+    if (slot == home)
+      ids[n++] = id;
+  }
+  assert(t.size == 0 && t.capacity == 64);
+  for (uint32_t k = COLLIDING; k < IDS; ++k)
+    ids[k] = UINT32_MAX - k * 7919;
+
+  for (uint32_t k = 0; k < COLLIDING; ++k) {
+    assert(game_table_get(&t, ids[k]) == NULL);
+    expected[k] = (gamma_t *)&games[k];
+    assert(game_table_put(&t, ids[k], expected[k]));
+    ++size;
+    for (uint32_t j = 0; j <= k; ++j)
+      assert(game_table_get(&t, ids[j]) == expected[j]);
+  }
+  assert(t.capacity > 64 && t.size == size);
+  for (uint32_t k = 1; k < COLLIDING; k += 3) {
+    assert(game_table_remove(&t, ids[k]) == expected[k]);
+    assert(game_table_remove(&t, ids[k]) == NULL);
+    expected[k] = NULL;
+    --size;
+    for (uint32_t j = 0; j < COLLIDING; ++j)
+      assert(game_table_get(&t, ids[j]) == expected[j]);
+  }
+
+  srand(43);
+  for (int op = 0; op < 50000; ++op) {
+    uint32_t k = rand() % IDS;
+    switch (rand() % 3) {
+      case 0:
+        if (expected[k] == NULL) {
+          expected[k] = (gamma_t *)&games[k];
+          assert(game_table_put(&t, ids[k], expected[k]));
+          ++size;
+        }
+        break;
+      case 1:
+        assert(game_table_get(&t, ids[k]) == expected[k]);
+        break;
+      default:
+        assert(game_table_remove(&t, ids[k]) == expected[k]);
+        size -= expected[k] != NULL;
+        expected[k] = NULL;
+    }
+    assert(t.size == size && 2 * t.size <= t.capacity);
+    if (op % 1000 == 0)
+      for (uint32_t j = 0; j < IDS; ++j)
+        assert(game_table_get(&t, ids[j]) == expected[j]);
+  }
+  for (uint32_t k = 0; k < IDS; ++k)
+    assert(game_table_remove(&t, ids[k]) == expected[k]);
+  assert(t.size == 0);
+  game_table_free(&t);
+  assert(t.capacity == 0 && game_table_get(&t, 0) == NULL);
+  return PASS;
+}
+
+/* Zamienia length bajtów data funkcją convert i zapisuje wynik w result,
+ * zakończony zerem. Zwraca liczbę bajtów wyniku lub -1, gdy convert zwróci
+ * false. */
+static long convert_stream(bool (*convert)(FILE *, FILE *), const char *data,
+                           size_t length, char *result, size_t capacity) {
+  FILE *in = tmpfile(), *out = tmpfile();
+  assert(in != NULL && out != NULL);
+  assert(fwrite(data, 1, length, in) == length);
+  rewind(in);
+  long n = convert(in, out) ? ftell(out) : -1;
+  rewind(out);
+  if (n >= 0)
+    assert((size_t)n < capacity && fread(result, 1, n, out) == (size_t)n);
+  result[n >= 0 ? n : 0] = '\0';
+  fclose(in);
+  fclose(out);
+  return n;
+}
+
+/* Zamienia komendy tekstowe na binarne i z powrotem. Linie ignorowane
+ * wracają jako komentarze, a niepoprawne jako komenda '?'. Binarny strumień
+ * z liczbą dłuższą niż 64 bity jest niepoprawny. */
+static int binary_commands(void) {
+  static const char text[] = "B 5 5 2 3\n# komentarz\n\n# drugi\n"
+                             "m 1 0 0\nm 1 x 0\nM 2 2 1 1 2 2\nI\n#\n"
+                             "b 1\nq 2\nf 1\ng 2 0 0\np\nm 2 4294967296 0\n";
+  static const char expected[] = "B 5 5 2 3\n#\n#\n#\n"
+                                 "m 1 0 0\n?\nM 2 2 1 1 2 2\n?\n#\n"
+                                 "b 1\nq 2\nf 1\ng 2 0 0\np\nm 2 4294967296 0\n";
+  char binary[256], again[256], back[256];
+
+  long n = convert_stream(text_to_binary, text, strlen(text), binary,
+                          sizeof(binary));
+  assert(n > BINARY_MAGIC_LENGTH);
+  assert(memcmp(binary, BINARY_MAGIC, BINARY_MAGIC_LENGTH) == 0);
+  assert(convert_stream(binary_to_text, binary, n, back, sizeof(back)) ==
+         (long)strlen(expected));
+  assert(strcmp(back, expected) == 0);
+  assert(convert_stream(text_to_binary, back, strlen(back), again,
+                        sizeof(again)) == n);
+  assert(memcmp(binary, again, n) == 0);
+
+  /* Rekord b z liczbą 10 bajtów: największą możliwą, za dużą o jeden bit
+   * i dłuższą o jeden bajt. */
+  char record[BINARY_MAGIC_LENGTH + 12];
+  memcpy(record, BINARY_MAGIC, BINARY_MAGIC_LENGTH);
+  record[BINARY_MAGIC_LENGTH] = Busy;
+  memset(record + BINARY_MAGIC_LENGTH + 1, 0xff, 11);
+  record[BINARY_MAGIC_LENGTH + 10] = 1;
+  assert(convert_stream(binary_to_text, record, BINARY_MAGIC_LENGTH + 11, back,
+                        sizeof(back)) > 0);
+  assert(strcmp(back, "b 18446744073709551615\n") == 0);
+  record[BINARY_MAGIC_LENGTH + 10] = 2;
+  assert(convert_stream(binary_to_text, record, BINARY_MAGIC_LENGTH + 11, back,
+                        sizeof(back)) == -1);
+  record[BINARY_MAGIC_LENGTH + 10] = (char)0x81;
+  record[BINARY_MAGIC_LENGTH + 11] = 0;
+  assert(convert_stream(binary_to_text, record, BINARY_MAGIC_LENGTH + 12, back,
+                        sizeof(back)) == -1);
+  assert(convert_stream(binary_to_text, record, BINARY_MAGIC_LENGTH + 5, back,
+                        sizeof(back)) == -1);
+  return PASS;
+}
+
+static void *run_server(void *arg) {
+  assert(server_run(arg));
+  return NULL;
+}
+
+/* Łączy się z serwerem, wysyła mu data, kończy pisanie i zwraca liczbę
+ * bajtów odpowiedzi zapisanych w answers. */
+static size_t ask_server(const char *path, const char *data, size_t length,
+                         char *answers, size_t capacity) {
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  strcpy(address.sun_path, path);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  assert(fd != -1);
+  assert(connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0);
+  for (size_t sent = 0; sent < length;) {
+    ssize_t n = send(fd, data + sent, length - sent, MSG_NOSIGNAL);
+    if (n <= 0)
+      break;
+    sent += n;
+  }
+  shutdown(fd, SHUT_WR);
+  size_t received = 0;
+  ssize_t n;
+  while (received < capacity &&
+         (n = read(fd, answers + received, capacity - received)) > 0)
+    received += n;
+  close(fd);
+  return received;
+}
+
+/* Serwer wykonuje ostatnią linię klienta bez znaku nowej linii, tak jak tryb
+ * wsadowy na standardowym wejściu, a klienta, którego linia nie mieści się
+ * w limicie, rozłącza. */
+static int server_input(void) {
+  char path[64], answers[64];
+  snprintf(path, sizeof(path), "/tmp/gamma_test_%d.sock", (int)getpid());
+  game_server *s = server_open(path);
+  assert(s != NULL);
+  pthread_t thread;
+  assert(pthread_create(&thread, NULL, run_server, s) == 0);
+
+  const char *commands = "1 B 5 5 2 3\n1 m 1 0 0";
+  size_t n = ask_server(path, commands, strlen(commands), answers,
+                        sizeof(answers));
+  assert(n == 13 && memcmp(answers, "1 OK\nERROR 2\n", n) == 0);
+  n = ask_server(path, "# koniec", 8, answers, sizeof(answers));
+  assert(n == 0);
+
+  size_t length = 3 << 20;
+  char *line = malloc(length);
+  assert(line != NULL);
+  memset(line, '1', length - 1);
+  line[length - 1] = '\n';
+  assert(ask_server(path, line, length, answers, sizeof(answers)) == 0);
+  free(line);
+
+  server_stop(s);
+  assert(pthread_join(thread, NULL) == 0);
+  server_close(s);
+  return PASS;
+}
+
 /* Testuje liczenie obszarów jednego gracza. */
 static int areas(void) {
   gamma_t *g = gamma_new(31, 37, 1, 42);
@@ -776,6 +2712,36 @@ static const test_list_t test_list[] = {
   TEST(normal_move),
   TEST(golden_move),
   TEST(golden_possible),
+  TEST(golden_possible_big),
+  TEST(golden_split),
+  TEST(random_areas),
+  TEST(players_status),
+  TEST(golden_last_field),
+  TEST(sparse_board),
+  TEST(morton_layout),
+  TEST(mapped_board),
+  TEST(mapped_reopen_failure),
+  TEST(mapped_close_failure),
+  TEST(mapped_corrupt_header),
+  TEST(huge_pages),
+  TEST(allocator_failures),
+  TEST(arena_game),
+  TEST(arena_blocks),
+  TEST(reset_game),
+  TEST(pool_games),
+  TEST(memory_usage),
+  TEST(compact_game),
+  TEST(snapshot_game),
+  TEST(load_board),
+  TEST(move_batch),
+  TEST(concurrent_queries),
+  TEST(concurrent_moves),
+  TEST(pipelined_batch),
+  TEST(shm_channel_ops),
+  TEST(game_table_ops),
+  TEST(tagged_commands),
+  TEST(binary_commands),
+  TEST(server_input),
   TEST(areas),
   TEST(tree),
   TEST(border),
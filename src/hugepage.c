@@ -0,0 +1,79 @@
+/** @file
+ * Implementacja interfejsu hugepage.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z madvise() i MAP_ANONYMOUS
+ */
+#define _DEFAULT_SOURCE
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "hugepage.h"
+
+/** @brief zaokrągla liczbę w górę do wielokrotności rozmiaru dużej strony
+ * param[in] n 	- zaokrąglana liczba
+ *
+ * @return najmniejsza wielokrotność HUGE_PAGE_SIZE niemniejsza od n
+ */
+static uint64_t round_to_huge_page(uint64_t n){
+	return (n+HUGE_PAGE_SIZE-1) & ~(HUGE_PAGE_SIZE-1);
+}
+
+/** @brief sprawdza, czy duże strony włączono zmienną środowiskową
+ *
+ * @return true jeżeli GAMMA_HUGE_PAGES jest ustawiona na wartość różną od 0, false wpp
+ */
+bool huge_pages_requested(void){
+	char* env = getenv("GAMMA_HUGE_PAGES");
+	return env != NULL && strtol(env, NULL, 10) != 0;
+}
+
+/** @brief przydziela wyzerowany blok wyrównany do HUGE_PAGE_SIZE i oznacza go MADV_HUGEPAGE
+ * Odwzorowuje o jedną dużą stronę więcej i oddaje systemowi nadmiar z obu stron.
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL, jeżeli nie udało się go przydzielić
+ */
+void* huge_alloc(uint64_t size){
+	size = round_to_huge_page(size);
+	uint64_t mapped = size+HUGE_PAGE_SIZE;
+	char* raw = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(raw == MAP_FAILED)
+		return NULL;
+	char* aligned = (char*)round_to_huge_page((uintptr_t)raw);
+	if(aligned != raw)
+		munmap(raw, aligned-raw);
+	munmap(aligned+size, raw+mapped-(aligned+size));
+#ifdef MADV_HUGEPAGE
+	madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+	return aligned;
+}
+
+/** @brief zwalnia blok przydzielony przez huge_alloc
+ * param[in] ptr 	- wskaźnik na blok lub NULL
+ * param[in] size 	- długość bloku podana przy przydziale
+ */
+void huge_free(void* ptr, uint64_t size){
+	if(ptr != NULL)
+		munmap(ptr, round_to_huge_page(size));
+}
+
+/** @brief oznacza MADV_HUGEPAGE pełne duże strony leżące wewnątrz bloku
+ * param[in] ptr 	- wskaźnik na blok
+ * param[in] size 	- długość bloku w bajtach
+ */
+void huge_advise(void* ptr, uint64_t size){
+#ifdef MADV_HUGEPAGE
+	uintptr_t begin = round_to_huge_page((uintptr_t)ptr);
+	uintptr_t end = ((uintptr_t)ptr+size) & ~(HUGE_PAGE_SIZE-1);
+	if(begin < end)
+		madvise((void*)begin, end-begin, MADV_HUGEPAGE);
+#else
+	(void)ptr;
+	(void)size;
+#endif
+}
@@ -0,0 +1,50 @@
+/** @file
+ * Interfejs alokacji pamięci na dużych stronach (transparent huge pages)
+ *
+ * Pełne przeszukania dużych plansz odwołują się do tysięcy stron po 4 KiB
+ * i nie mieszczą się w TLB. Bloki przydzielone tutaj są wyrównane do 2 MiB
+ * i oznaczone MADV_HUGEPAGE, więc system może je odwzorować dużymi stronami.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef HUGEPAGE_H
+#define HUGEPAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief rozmiar dużej strony
+ */
+#define HUGE_PAGE_SIZE ((uint64_t)1 << 21)
+
+/** @brief sprawdza, czy duże strony włączono zmienną środowiskową
+ *
+ * @return true jeżeli GAMMA_HUGE_PAGES jest ustawiona na wartość różną od 0, false wpp
+ */
+bool huge_pages_requested(void);
+
+/** @brief przydziela wyzerowany blok wyrównany do HUGE_PAGE_SIZE i oznacza go MADV_HUGEPAGE
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL, jeżeli nie udało się go przydzielić
+ */
+void* huge_alloc(uint64_t size);
+
+/** @brief zwalnia blok przydzielony przez huge_alloc
+ * param[in] ptr 	- wskaźnik na blok lub NULL
+ * param[in] size 	- długość bloku podana przy przydziale
+ */
+void huge_free(void* ptr, uint64_t size);
+
+/** @brief oznacza MADV_HUGEPAGE pełne duże strony leżące wewnątrz bloku
+ * Pozwala używać dużych stron w blokach przydzielonych przez malloc,
+ * mniejsze bloki pomija.
+ * param[in] ptr 	- wskaźnik na blok
+ * param[in] size 	- długość bloku w bajtach
+ */
+void huge_advise(void* ptr, uint64_t size);
+
+#endif
@@ -256,16 +256,30 @@ static bool player_has_action(gamma_t* game, uint32_t curP){
 }
 
 /** @brief sprawdza czy jakikolwiek gracz może wykonać jeszcze jakikolwiek ruch
- * param[in] game - struktura przechowująca stan gry
+ * stan wszystkich graczy liczymy jednym przejściem planszy (gamma_players_status),
+ * a jeżeli zabraknie pamięci, pytamy o graczy po kolei
+ * param[in] game 	- struktura przechowująca stan gry
+ * param[in] curP 	- aktualny numer gracza, którego jest tura
+ * param[out] current 	- true jeżeli gracz curP może wykonać ruch, false wpp
  *
  * @return true jeżeli jakiś gracz może wykonać ruch, false wpp
  */
-static bool any_player_has_action(gamma_t* game){
-	for(uint32_t i=1;i<=get_no_players(game);i++){
-		if(player_has_action(game, i))
-			return true;
+static bool any_player_has_action(gamma_t* game, uint32_t curP, bool* current){
+	uint32_t no_players = get_no_players(game);
+	bool any = false;
+	gamma_player_status_t* status = malloc(no_players*sizeof(gamma_player_status_t));
+	if(status != NULL && gamma_players_status(game, status)){
+		for(uint32_t i=0;i<no_players && !any;i++)
+			any = status[i].free_fields != 0 || status[i].golden_possible;
+		*current = status[curP-1].free_fields != 0 || status[curP-1].golden_possible;
+		free(status);
+		return any;
 	}
-	return false;
+	free(status);
+	*current = player_has_action(game, curP);
+	for(uint32_t i=1;i<=no_players && !any;i++)
+		any = player_has_action(game, i);
+	return any;
 }
 
 /** @brief wczytuje znak i wykonuje odpowiednią akcję, ustawia running na false
@@ -279,8 +293,9 @@ static bool any_player_has_action(gamma_t* game){
  */
 void action(gamma_t* game, uint32_t* curX, uint32_t* curY, 
 			uint32_t* curP, bool* running){
-	*running = any_player_has_action(game);
-	if(*running && player_has_action(game, *curP)){
+	bool current;
+	*running = any_player_has_action(game, *curP, &current);
+	if(*running && current){
 		char k = getchar();
 	    if (k == '\033'){
 	        k = getchar();
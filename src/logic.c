@@ -18,6 +18,7 @@
 #include "gamma.h"
 #include "bmparser.h"
 #include "bmexecuter.h"
+#include "bmpipeline.h"
 #include "logic.h"
 #include "interactive.h"
 
@@ -26,7 +27,7 @@
  * param[in] line 	- przetwarzana linia tekstu
  * @return true jeżeli dana linia ma być zignorowana, false wpp
  */
-static bool ignore_line(char* line){
+bool ignore_line(char* line){
 	if(line != NULL && strlen(line) > 0){
 		return line[0] == '#' || (line[0] == '\n' && strlen(line) == 1);
 	} else{
@@ -110,6 +111,8 @@ bool set_game_and_mode(game_and_mode* gm, int* line){
  * param[in] line 	- numer przetwarzanej lini
  */
 void play_batch(gamma_t* game, int* line){
+	if(pipeline_requested() && play_batch_pipelined(game, line))
+		return;
 	char* buffer = malloc(1);
 	size_t buffsize = 1;
 	if(buffer != NULL){
@@ -142,6 +145,10 @@ void play_batch(gamma_t* game, int* line){
 						print_command* com = parse_print_command(buffer);
 						execute_print_command(com, game, *line);
 						free(com);
+					} else if(com_type == BulkMove){
+						bulk_move_command* com = parse_bulk_move_command(buffer);
+						execute_bulk_move_command(com, game, *line);
+						free(com);
 					} else if(com_type == Unknown){
 						 errLine(*line);
 					} else{
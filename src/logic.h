@@ -11,16 +11,17 @@
 
 #include "gamma.h"
 
-/** @brief typ mówiący o trybie, w którym ma być rozgrywana rozgrywka
+/** @brief typ mówiący o trybie, w którym ma być rozgrywana rozgrywka,
+ * Tagged to tryb wsadowy wielu gier o identyfikatorach
  */
-enum mode{Batch, Interactive};
+enum mode{Batch, Interactive, Tagged};
 
 
 /** @brief struktura przechowująca stan gry 
  * i informacje o trybie, w którym będzie rozgrywana rozgrywka
  */
 typedef struct{
-	gamma_t* game; ///< struktura przechowująca stan gry
+	gamma_t* game; ///< struktura przechowująca stan gry, NULL w trybie Tagged
 	enum mode mod; ///< zmienna mówiąca o trybie przeprowadzaniej rozgrywki
 } game_and_mode;
 
@@ -46,6 +47,12 @@ void play_batch(gamma_t* game, int* line);
  */
 void play_interactive(gamma_t* game);
 
+/** @brief sprawdza, czy dana linia inputu ma być zignorowana
+ * param[in] line 	- przetwarzana linia tekstu
+ * @return true jeżeli dana linia ma być zignorowana, false wpp
+ */
+bool ignore_line(char* line);
+
 /** @brief wypisuje komunikat zabija proces
  * param[in] str 	- komunikat jaki ma zostać wypisany przed zabiciem procesu 
  */
@@ -0,0 +1,276 @@
+/** @file
+ * Implementacja interfejsu mapped.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z ftruncate(), sysconf() i posix_madvise()
+ */
+#define _XOPEN_SOURCE 700
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mapped.h"
+
+/** @brief najmniejsza długość fragmentu, o który powiększamy plik
+ */
+#define MAPPED_MIN_GROWTH (1 << 20)
+
+/** @brief wyrównanie bloków przydzielanych w pliku
+ */
+#define MAPPED_ALIGNMENT 64
+
+/** @brief zaokrągla liczbę w górę do wielokrotności rozmiaru strony
+ * param[in] n 	- zaokrąglana liczba
+ *
+ * @return najmniejsza wielokrotność rozmiaru strony niemniejsza od n
+ */
+static uint64_t round_to_page(uint64_t n){
+	uint64_t page = sysconf(_SC_PAGESIZE);
+	return (n+page-1)/page*page;
+}
+
+/** @brief inicjuje opis pliku, który nie jest jeszcze otwarty
+ * param[out] m 	- inicjowany opis
+ */
+static void mapped_init(mapped_file* m){
+	m->fd = -1;
+	m->used = 0;
+	m->size = 0;
+	m->extents = NULL;
+	m->no_extents = 0;
+	m->extents_capacity = 0;
+}
+
+/** @brief odwzorowuje w pamięci fragment pliku i dopisuje go do listy fragmentów
+ * param[in,out] m 	- opis odwzorowanego pliku
+ * param[in] offset 	- położenie fragmentu w pliku, wielokrotność rozmiaru strony
+ * param[in] size 	- długość fragmentu
+ *
+ * @return true jeżeli się udało, false wpp
+ */
+static bool add_extent(mapped_file* m, uint64_t offset, uint64_t size){
+	if(m->no_extents == m->extents_capacity){
+		uint32_t capacity = m->extents_capacity == 0? 8 : 2*m->extents_capacity;
+		mapped_extent* extents = realloc(m->extents, capacity*sizeof(mapped_extent));
+		if(extents == NULL)
+			return false;
+		m->extents = extents;
+		m->extents_capacity = capacity;
+	}
+	void* address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, offset);
+	if(address == MAP_FAILED)
+		return false;
+	mapped_extent* e = &m->extents[m->no_extents++];
+	e->address = address;
+	e->offset = offset;
+	e->size = size;
+	return true;
+}
+
+/** @brief powiększa plik tak, żeby zmieścił się w nim blok zadanej długości
+ * Nowy fragment jest co najmniej tak długi jak dotychczasowy plik, a przydział
+ * zaczyna się od jego początku, bo bloki nie mogą przekraczać granic fragmentów.
+ * Jeżeli odwzorowanie się nie powiedzie, plik zostaje dłuższy, ale jego koniec
+ * nie jest uznany za przydzielony.
+ * param[in,out] m 	- opis odwzorowanego pliku
+ * param[in] size 	- długość bloku
+ *
+ * @return true jeżeli się udało, false wpp
+ */
+static bool grow(mapped_file* m, uint64_t size){
+	uint64_t extent = m->size > size? m->size : size;
+	if(extent < MAPPED_MIN_GROWTH)
+		extent = MAPPED_MIN_GROWTH;
+	extent = round_to_page(extent);
+	if(ftruncate(m->fd, m->size+extent) != 0)
+		return false;
+	if(!add_extent(m, m->size, extent))
+		return false;
+	m->used = m->size;
+	m->size += extent;
+	return true;
+}
+
+/** @brief tworzy pusty plik lub otwiera istniejący pusty plik
+ * Plik nie jest otwierany z O_TRUNC, więc grę zapisaną w nim w międzyczasie
+ * przez inny proces zostawiamy w spokoju.
+ * param[out] m 	- opis odwzorowanego pliku
+ * param[in] path 	- ścieżka do pliku
+ *
+ * @return true jeżeli się udało, false jeżeli plik nie jest pusty lub nie udało się go otworzyć
+ */
+bool mapped_create(mapped_file* m, const char* path){
+	mapped_init(m);
+	m->fd = open(path, O_RDWR | O_CREAT, 0644);
+	if(m->fd < 0)
+		return false;
+	struct stat st;
+	if(fstat(m->fd, &st) != 0 || st.st_size != 0){
+		mapped_close(m);
+		return false;
+	}
+	return true;
+}
+
+/** @brief otwiera niepusty plik i odwzorowuje w pamięci całą jego zawartość
+ * Cały plik jest uznawany za przydzielony, wywołujący może zmienić pole used.
+ * param[out] m 	- opis odwzorowanego pliku
+ * param[in] path 	- ścieżka do pliku
+ *
+ * @return MappedOpened jeżeli się udało, MappedMissing jeżeli pliku nie ma lub
+ * jest pusty, MappedFailed po każdym innym błędzie
+ */
+mapped_status mapped_open(mapped_file* m, const char* path){
+	mapped_init(m);
+	m->fd = open(path, O_RDWR);
+	if(m->fd < 0)
+		return errno == ENOENT? MappedMissing : MappedFailed;
+	struct stat st;
+	mapped_status status = MappedFailed;
+	if(fstat(m->fd, &st) == 0)
+		status = st.st_size == 0? MappedMissing : MappedOpened;
+	if(status == MappedOpened){
+		m->size = round_to_page(st.st_size);
+		m->used = st.st_size;
+		if(!add_extent(m, 0, m->size))
+			status = MappedFailed;
+	}
+	if(status != MappedOpened)
+		mapped_close(m);
+	return status;
+}
+
+/** @brief wydłuża plik otwarty przez mapped_open do całej odwzorowanej ostatniej strony
+ * param[in,out] m 	- opis odwzorowanego pliku
+ *
+ * @return true jeżeli się udało, false wpp
+ */
+bool mapped_fill_pages(mapped_file* m){
+	struct stat st;
+	return fstat(m->fd, &st) == 0 &&
+	       ((uint64_t)st.st_size == m->size || ftruncate(m->fd, m->size) == 0);
+}
+
+/** @brief przydziela wyzerowany blok pamięci w pliku, w razie potrzeby powiększa plik
+ * param[in,out] m 	- opis odwzorowanego pliku
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok wyrównany do 64 bajtów lub NULL, jeżeli nie udało się powiększyć pliku
+ */
+void* mapped_alloc(mapped_file* m, uint64_t size){
+	uint64_t start = (m->used+MAPPED_ALIGNMENT-1) & ~(uint64_t)(MAPPED_ALIGNMENT-1);
+	if(m->no_extents == 0 || start+size > m->size){
+		if(!grow(m, size))
+			return NULL;
+		start = m->used;
+	}
+	mapped_extent* e = &m->extents[m->no_extents-1];
+	char* block = e->address+(start-e->offset);
+	memset(block, 0, size);
+	m->used = start+size;
+	return block;
+}
+
+/** @brief przydziela wyzerowany blok w pliku, funkcja alokatora pliku
+ * param[in] context 	- opis odwzorowanego pliku
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL
+ */
+static void* mapped_allocator_alloc(void* context, size_t size){
+	return mapped_alloc(context, size);
+}
+
+/** @brief przepisuje blok w pliku do nowego, dłuższego bloku, funkcja alokatora pliku
+ * param[in] context 	- opis odwzorowanego pliku
+ * param[in] ptr 	- powiększany blok lub NULL
+ * param[in] old_size 	- dotychczasowa długość bloku w bajtach
+ * param[in] size 	- nowa długość bloku w bajtach
+ *
+ * @return wskaźnik na nowy blok lub NULL
+ */
+static void* mapped_allocator_realloc(void* context, void* ptr, size_t old_size, size_t size){
+	void* block = mapped_alloc(context, size);
+	if(block != NULL && ptr != NULL)
+		memcpy(block, ptr, old_size < size? old_size : size);
+	return block;
+}
+
+/** @brief zwraca alokator przydzielający bloki w pliku
+ * param[in] m 	- opis odwzorowanego pliku
+ *
+ * @return alokator pliku
+ */
+allocator mapped_allocator(mapped_file* m){
+	allocator r = {mapped_allocator_alloc, mapped_allocator_realloc, NULL, m};
+	return r;
+}
+
+/** @brief zwraca położenie w pliku bloku przydzielonego przez mapped_alloc
+ * param[in] m 	- opis odwzorowanego pliku
+ * param[in] ptr 	- wskaźnik na blok
+ *
+ * @return położenie bloku w pliku
+ */
+uint64_t mapped_offset(const mapped_file* m, const void* ptr){
+	const char* p = ptr;
+	for(uint32_t i=0;i<m->no_extents;i++){
+		const mapped_extent* e = &m->extents[i];
+		if(p >= e->address && p < e->address+e->size)
+			return e->offset+(p-e->address);
+	}
+	return 0;
+}
+
+/** @brief zwraca adres bloku leżącego w pliku na zadanym położeniu
+ * param[in] m 		- opis odwzorowanego pliku
+ * param[in] offset 	- położenie bloku w pliku
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL, jeżeli blok nie leży w całości w jednym fragmencie
+ */
+void* mapped_pointer(const mapped_file* m, uint64_t offset, uint64_t size){
+	for(uint32_t i=0;i<m->no_extents;i++){
+		const mapped_extent* e = &m->extents[i];
+		if(offset >= e->offset && offset-e->offset <= e->size &&
+		   size <= e->size-(offset-e->offset))
+			return e->address+(offset-e->offset);
+	}
+	return NULL;
+}
+
+/** @brief przekazuje systemowi wskazówkę, że plik będzie czytany sekwencyjnie
+ * param[in] m 		- opis odwzorowanego pliku
+ * param[in] sequential - true przed przeglądaniem całego pliku, false po jego zakończeniu
+ */
+void mapped_advise_sequential(const mapped_file* m, bool sequential){
+	int advice = sequential? POSIX_MADV_SEQUENTIAL : POSIX_MADV_NORMAL;
+	for(uint32_t i=0;i<m->no_extents;i++)
+		posix_madvise(m->extents[i].address, m->extents[i].size, advice);
+}
+
+/** @brief zapisuje zmiany na dysk, kończy odwzorowanie i zamyka plik
+ * param[in,out] m 	- opis odwzorowanego pliku
+ *
+ * @return true jeżeli zapis się powiódł, false wpp
+ */
+bool mapped_close(mapped_file* m){
+	bool success = true;
+	for(uint32_t i=0;i<m->no_extents;i++){
+		if(msync(m->extents[i].address, m->extents[i].size, MS_SYNC) != 0)
+			success = false;
+		munmap(m->extents[i].address, m->extents[i].size);
+	}
+	if(m->fd >= 0 && close(m->fd) != 0)
+		success = false;
+	free(m->extents);
+	mapped_init(m);
+	return success;
+}
@@ -0,0 +1,123 @@
+/** @file
+ * Interfejs pamięci gry odwzorowanej z pliku
+ *
+ * Pamięć przydzielamy narastająco od początku pliku. Gdy brakuje miejsca,
+ * powiększamy plik i odwzorowujemy jego nowy fragment osobno, więc raz
+ * przydzielone bloki nigdy nie zmieniają adresu. Zwalnianie bloków nie jest
+ * możliwe, system sprowadza do pamięci tylko używane strony pliku.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef MAPPED_H
+#define MAPPED_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "alloc.h"
+
+/** @brief Struktura opisująca jeden odwzorowany fragment pliku.
+ */
+typedef struct{
+	char* address; 		///< adres początku fragmentu w pamięci
+	uint64_t offset; 	///< położenie początku fragmentu w pliku
+	uint64_t size; 		///< długość fragmentu w bajtach
+} mapped_extent;
+
+/** @brief Struktura opisująca plik odwzorowany w pamięci.
+ */
+typedef struct{
+	int fd; 			///< deskryptor pliku
+	uint64_t used; 			///< pierwszy nieprzydzielony bajt pliku
+	uint64_t size; 			///< rozmiar pliku, wielokrotność rozmiaru strony
+	mapped_extent* extents; 	///< odwzorowane fragmenty pliku w kolejności położenia
+	uint32_t no_extents; 		///< liczba odwzorowanych fragmentów
+	uint32_t extents_capacity; 	///< rozmiar tablicy extents
+} mapped_file;
+
+/** @brief wynik mapped_open
+ */
+typedef enum{
+	MappedOpened, 	///< plik jest otwarty i odwzorowany
+	MappedMissing, 	///< pliku nie ma lub jest pusty, można go utworzyć
+	MappedFailed 	///< nie udało się otworzyć lub odwzorować niepustego pliku
+} mapped_status;
+
+/** @brief tworzy pusty plik lub otwiera istniejący pusty plik
+ * Niepustego pliku nie zmienia.
+ * param[out] m 	- opis odwzorowanego pliku
+ * param[in] path 	- ścieżka do pliku
+ *
+ * @return true jeżeli się udało, false jeżeli plik nie jest pusty lub nie udało się go otworzyć
+ */
+bool mapped_create(mapped_file* m, const char* path);
+
+/** @brief otwiera niepusty plik i odwzorowuje w pamięci całą jego zawartość
+ * Cały plik jest uznawany za przydzielony, wywołujący może zmienić pole used.
+ * Funkcja nie zmienia pliku; jeżeli jego długość nie jest wielokrotnością
+ * rozmiaru strony, wywołujący musi przed przydziałami wywołać mapped_fill_pages.
+ * param[out] m 	- opis odwzorowanego pliku
+ * param[in] path 	- ścieżka do pliku
+ *
+ * @return MappedOpened jeżeli się udało, MappedMissing jeżeli pliku nie ma lub
+ * jest pusty, MappedFailed po każdym innym błędzie
+ */
+mapped_status mapped_open(mapped_file* m, const char* path);
+
+/** @brief wydłuża plik otwarty przez mapped_open do całej odwzorowanej ostatniej strony
+ * param[in,out] m 	- opis odwzorowanego pliku
+ *
+ * @return true jeżeli się udało, false wpp
+ */
+bool mapped_fill_pages(mapped_file* m);
+
+/** @brief przydziela wyzerowany blok pamięci w pliku, w razie potrzeby powiększa plik
+ * param[in,out] m 	- opis odwzorowanego pliku
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok wyrównany do 64 bajtów lub NULL, jeżeli nie udało się powiększyć pliku
+ */
+void* mapped_alloc(mapped_file* m, uint64_t size);
+
+/** @brief zwraca alokator przydzielający bloki w pliku
+ * Powiększany blok przepisujemy w nowe miejsce, a funkcja free jest równa NULL,
+ * bo bloków w pliku nie da się zwolnić.
+ * param[in] m 	- opis odwzorowanego pliku
+ *
+ * @return alokator pliku
+ */
+allocator mapped_allocator(mapped_file* m);
+
+/** @brief zwraca położenie w pliku bloku przydzielonego przez mapped_alloc
+ * param[in] m 	- opis odwzorowanego pliku
+ * param[in] ptr 	- wskaźnik na blok
+ *
+ * @return położenie bloku w pliku
+ */
+uint64_t mapped_offset(const mapped_file* m, const void* ptr);
+
+/** @brief zwraca adres bloku leżącego w pliku na zadanym położeniu
+ * param[in] m 		- opis odwzorowanego pliku
+ * param[in] offset 	- położenie bloku w pliku
+ * param[in] size 	- długość bloku w bajtach
+ *
+ * @return wskaźnik na blok lub NULL, jeżeli blok nie leży w całości w jednym fragmencie
+ */
+void* mapped_pointer(const mapped_file* m, uint64_t offset, uint64_t size);
+
+/** @brief przekazuje systemowi wskazówkę, że plik będzie czytany sekwencyjnie
+ * param[in] m 		- opis odwzorowanego pliku
+ * param[in] sequential - true przed przeglądaniem całego pliku, false po jego zakończeniu
+ */
+void mapped_advise_sequential(const mapped_file* m, bool sequential);
+
+/** @brief zapisuje zmiany na dysk, kończy odwzorowanie i zamyka plik
+ * param[in,out] m 	- opis odwzorowanego pliku
+ *
+ * @return true jeżeli zapis się powiódł, false wpp
+ */
+bool mapped_close(mapped_file* m);
+
+#endif
@@ -0,0 +1,55 @@
+/** @file
+ * Implementacja interfejsu rwlock.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z pthread_rwlockattr_setkind_np()
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <pthread.h>
+#include "rwlock.h"
+
+/** @brief Struktura zamka
+ */
+struct rw_lock{
+	pthread_rwlock_t lock; 	///< zamek pthread preferujący pisarzy
+};
+
+rw_lock* rw_lock_new(void){
+	rw_lock* l = malloc(sizeof(rw_lock));
+	if(l == NULL)
+		return NULL;
+	pthread_rwlockattr_t attr;
+	pthread_rwlockattr_init(&attr);
+	pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+	int error = pthread_rwlock_init(&l->lock, &attr);
+	pthread_rwlockattr_destroy(&attr);
+	if(error != 0){
+		free(l);
+		return NULL;
+	}
+	return l;
+}
+
+void rw_lock_delete(rw_lock* l){
+	if(l == NULL)
+		return;
+	pthread_rwlock_destroy(&l->lock);
+	free(l);
+}
+
+void rw_lock_read(rw_lock* l){
+	pthread_rwlock_rdlock(&l->lock);
+}
+
+void rw_lock_write(rw_lock* l){
+	pthread_rwlock_wrlock(&l->lock);
+}
+
+void rw_lock_unlock(rw_lock* l){
+	pthread_rwlock_unlock(&l->lock);
+}
@@ -0,0 +1,45 @@
+/** @file
+ * Interfejs zamka czytelników i pisarza gry w trybie współbieżnym
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+/** @brief Struktura zamka, który wpuszcza naraz wielu czytelników albo
+ * jednego pisarza. Czekający pisarz wstrzymuje nowych czytelników, więc
+ * ciągły strumień zapytań nie zagłodzi ruchów.
+ */
+typedef struct rw_lock rw_lock;
+
+/** @brief tworzy zamek
+ *
+ * @return zamek lub NULL jeżeli zabrakło pamięci
+ */
+rw_lock* rw_lock_new(void);
+
+/** @brief usuwa zamek, którego nikt nie trzyma
+ * param[in] l 	- zamek lub NULL
+ */
+void rw_lock_delete(rw_lock* l);
+
+/** @brief zajmuje zamek do czytania, czekając na pisarzy
+ * Wątek trzymający zamek nie może zająć go ponownie.
+ * param[in,out] l 	- zamek
+ */
+void rw_lock_read(rw_lock* l);
+
+/** @brief zajmuje zamek do pisania, czekając na wszystkich
+ * param[in,out] l 	- zamek
+ */
+void rw_lock_write(rw_lock* l);
+
+/** @brief zwalnia zamek zajęty przez rw_lock_read lub rw_lock_write
+ * param[in,out] l 	- zamek
+ */
+void rw_lock_unlock(rw_lock* l);
+
+#endif
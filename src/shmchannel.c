@@ -0,0 +1,326 @@
+/** @file
+ * Implementacja interfejsu shmchannel.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z shm_open() i syscall()
+ */
+#define _DEFAULT_SOURCE
+#include <fcntl.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include "shmchannel.h"
+#include "gametable.h"
+
+/** @brief wartość rozpoznawcza obszaru kanału, "GMSH"
+ */
+#define SHM_CHANNEL_MAGIC 0x48534d47u
+
+/** @brief wersja układu obszaru kanału
+ */
+#define SHM_CHANNEL_VERSION 1u
+
+/** @brief liczba sprawdzeń indeksu przed zaśnięciem na futeksie
+ */
+#define SHM_SPINS 1024
+
+/** @brief Struktura indeksów jednego pierścienia
+ * Każda strona czeka na swoim liczniku zdarzeń: konsument na elementy,
+ * producent na wolne miejsce. Licznik zwiększa druga strona, gdy widzi
+ * ustawioną flagę oczekiwania, oraz shm_channel_stop.
+ */
+typedef struct{
+	_Alignas(64) atomic_uint head; 	///< liczba włożonych elementów, pisze producent
+	atomic_uint item_waiting; 	///< 1 jeżeli konsument czeka na element
+	atomic_uint item_events; 	///< futeks konsumenta
+	_Alignas(64) atomic_uint tail; 	///< liczba wyjętych elementów, pisze konsument
+	atomic_uint space_waiting; 	///< 1 jeżeli producent czeka na miejsce
+	atomic_uint space_events; 	///< futeks producenta
+} shm_ring;
+
+/** @brief Struktura obszaru pamięci współdzielonej kanału
+ */
+typedef struct{
+	atomic_uint magic; 		///< SHM_CHANNEL_MAGIC, zapisywane na końcu inicjacji
+	uint32_t version; 		///< SHM_CHANNEL_VERSION
+	uint32_t capacity; 		///< SHM_CHANNEL_CAPACITY
+	atomic_uint stop; 		///< 1 po shm_channel_stop
+	shm_ring requests; 		///< indeksy pierścienia żądań
+	shm_ring responses; 		///< indeksy pierścienia odpowiedzi
+	shm_request request_slots[SHM_CHANNEL_CAPACITY]; 	///< żądania
+	shm_response response_slots[SHM_CHANNEL_CAPACITY]; 	///< odpowiedzi
+} shm_region;
+
+/** @brief Struktura kanału otwartego w tym procesie
+ */
+struct shm_channel{
+	shm_region* region; 	///< odwzorowany obszar
+	char* name; 		///< nazwa obszaru do usunięcia przez twórcę, NULL u bota
+};
+
+/** @brief zasypia, dopóki futeks ma wartość value
+ * param[in] word 	- futeks
+ * param[in] value 	- wartość, przy której zasypiamy
+ */
+static void futex_wait(atomic_uint* word, unsigned value){
+	syscall(SYS_futex, word, FUTEX_WAIT, value, NULL, NULL, 0);
+}
+
+/** @brief budzi wszystkich śpiących na futeksie, także w innych procesach
+ * param[in] word 	- futeks
+ */
+static void futex_wake(atomic_uint* word){
+	syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/** @brief sprawdza, czy konsument może wyjąć element
+ * param[in] r 	- pierścień
+ *
+ * @return true jeżeli pierścień nie jest pusty, false wpp
+ */
+static bool has_item(shm_ring* r){
+	return atomic_load(&r->head) != atomic_load_explicit(&r->tail, memory_order_relaxed);
+}
+
+/** @brief sprawdza, czy producent może włożyć element
+ * param[in] r 	- pierścień
+ *
+ * @return true jeżeli w pierścieniu jest wolne miejsce, false wpp
+ */
+static bool has_space(shm_ring* r){
+	unsigned head = atomic_load_explicit(&r->head, memory_order_relaxed);
+	return head-atomic_load(&r->tail) < SHM_CHANNEL_CAPACITY;
+}
+
+/** @brief czeka, aż ready(r) będzie prawdą lub kanał zostanie zatrzymany
+ * Licznik zdarzeń czytamy przed sprawdzeniem warunku, więc zmiana, która
+ * nastąpi po sprawdzeniu, zmieni też licznik i futex_wait nie zaśnie.
+ * param[in] c 			- kanał
+ * param[in,out] r 		- pierścień
+ * param[in,out] waiting 	- flaga oczekiwania tej strony
+ * param[in,out] events 	- licznik zdarzeń tej strony
+ * param[in] ready 		- warunek, na który czekamy
+ *
+ * @return true jeżeli warunek jest spełniony, false jeżeli kanał zatrzymano
+ */
+static bool wait_for(shm_channel* c, shm_ring* r, atomic_uint* waiting,
+		     atomic_uint* events, bool (*ready)(shm_ring*)){
+	for(int i=0;i<SHM_SPINS;i++){
+		if(ready(r))
+			return true;
+	}
+	bool flague = ready(r);
+	while(!flague && !atomic_load(&c->region->stop)){
+		atomic_store(waiting, 1);
+		unsigned observed = atomic_load(events);
+		flague = ready(r);
+		if(!flague && !atomic_load(&c->region->stop))
+			futex_wait(events, observed);
+		flague = ready(r);
+	}
+	atomic_store(waiting, 0);
+	return flague;
+}
+
+/** @brief budzi drugą stronę, jeżeli na nas czeka
+ * Wywołujemy ją po zmianie indeksu. Zerujemy flagę, więc kolejne zmiany
+ * przed obudzeniem się drugiej strony obywają się bez wywołań systemowych.
+ * param[in,out] waiting 	- flaga oczekiwania drugiej strony
+ * param[in,out] events 	- licznik zdarzeń drugiej strony
+ */
+static void wake(atomic_uint* waiting, atomic_uint* events){
+	if(atomic_load(waiting) && atomic_exchange(waiting, 0)){
+		atomic_fetch_add(events, 1);
+		futex_wake(events);
+	}
+}
+
+/** @brief odwzorowuje obszar kanału z deskryptora
+ * param[in] fd 	- deskryptor obszaru, zamykany przez funkcję
+ *
+ * @return kanał lub NULL jeżeli się nie udało
+ */
+static shm_channel* map_channel(int fd){
+	shm_channel* c = malloc(sizeof(shm_channel));
+	void* region = mmap(NULL, sizeof(shm_region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(c == NULL || region == MAP_FAILED){
+		free(c);
+		if(region != MAP_FAILED)
+			munmap(region, sizeof(shm_region));
+		return NULL;
+	}
+	c->region = region;
+	c->name = NULL;
+	return c;
+}
+
+shm_channel* shm_channel_create(const char* name){
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if(fd < 0)
+		return NULL;
+	shm_channel* c = NULL;
+	if(ftruncate(fd, sizeof(shm_region)) == 0)
+		c = map_channel(fd);
+	else
+		close(fd);
+	if(c != NULL)
+		c->name = strdup(name);
+	if(c == NULL || c->name == NULL){
+		shm_channel_close(c);
+		shm_unlink(name);
+		return NULL;
+	}
+	c->region->version = SHM_CHANNEL_VERSION;
+	c->region->capacity = SHM_CHANNEL_CAPACITY;
+	atomic_store(&c->region->magic, SHM_CHANNEL_MAGIC);
+	return c;
+}
+
+shm_channel* shm_channel_open(const char* name){
+	int fd = shm_open(name, O_RDWR, 0);
+	if(fd < 0)
+		return NULL;
+	struct stat st;
+	if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(shm_region)){
+		close(fd);
+		return NULL;
+	}
+	shm_channel* c = map_channel(fd);
+	if(c != NULL && (atomic_load(&c->region->magic) != SHM_CHANNEL_MAGIC ||
+	   c->region->version != SHM_CHANNEL_VERSION ||
+	   c->region->capacity != SHM_CHANNEL_CAPACITY)){
+		shm_channel_close(c);
+		return NULL;
+	}
+	return c;
+}
+
+void shm_channel_close(shm_channel* c){
+	if(c == NULL)
+		return;
+	if(c->region != NULL)
+		munmap(c->region, sizeof(shm_region));
+	if(c->name != NULL){
+		shm_unlink(c->name);
+		free(c->name);
+	}
+	free(c);
+}
+
+void shm_send(shm_channel* c, const shm_request* r){
+	shm_ring* ring = &c->region->requests;
+	if(!wait_for(c, ring, &ring->space_waiting, &ring->space_events, has_space))
+		return;
+	unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	c->region->request_slots[head % SHM_CHANNEL_CAPACITY] = *r;
+	atomic_store(&ring->head, head+1);
+	wake(&ring->item_waiting, &ring->item_events);
+}
+
+uint64_t shm_receive(shm_channel* c){
+	shm_ring* ring = &c->region->responses;
+	if(!wait_for(c, ring, &ring->item_waiting, &ring->item_events, has_item))
+		return 0;
+	unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+	uint64_t value = c->region->response_slots[tail % SHM_CHANNEL_CAPACITY].value;
+	atomic_store(&ring->tail, tail+1);
+	wake(&ring->space_waiting, &ring->space_events);
+	return value;
+}
+
+uint64_t shm_call(shm_channel* c, const shm_request* r){
+	shm_send(c, r);
+	return shm_receive(c);
+}
+
+/** @brief wykonuje jedno żądanie na grach kanału
+ * param[in,out] games 	- gry według identyfikatorów
+ * param[in,out] pool 	- pula, w której tworzymy gry
+ * param[in] r 		- żądanie
+ *
+ * @return wynik żądania
+ */
+static uint64_t execute_request(game_table* games, gamma_pool_t* pool, const shm_request* r){
+	const uint32_t* a = r->args;
+	if(r->op == ShmNew){
+		if(game_table_get(games, r->game) != NULL)
+			return 0;
+		gamma_t* g = gamma_pool_game(pool, a[0], a[1], a[2], a[3]);
+		if(g != NULL && game_table_put(games, r->game, g))
+			return 1;
+		gamma_delete(g);
+		return 0;
+	} else if(r->op == ShmDelete){
+		gamma_t* g = game_table_remove(games, r->game);
+		gamma_delete(g);
+		return g != NULL;
+	}
+	gamma_t* g = game_table_get(games, r->game);
+	if(g == NULL)
+		return 0;
+	switch(r->op){
+		case ShmMove:
+			return gamma_move(g, a[0], a[1], a[2]);
+		case ShmGoldenMove:
+			return gamma_golden_move(g, a[0], a[1], a[2]);
+		case ShmBusyFields:
+			return gamma_busy_fields(g, a[0]);
+		case ShmFreeFields:
+			return gamma_free_fields(g, a[0]);
+		case ShmGoldenPossible:
+			return gamma_golden_possible(g, a[0]);
+		default:
+			return 0;
+	}
+}
+
+bool shm_serve(shm_channel* c){
+	shm_region* region = c->region;
+	shm_ring* requests = &region->requests;
+	shm_ring* responses = &region->responses;
+	game_table games;
+	game_table_init(&games);
+	gamma_pool_t* pool = gamma_pool_new(NULL);
+	if(pool == NULL)
+		return false;
+	bool flague = true;
+	while(flague && wait_for(c, requests, &requests->item_waiting, &requests->item_events, has_item)){
+		unsigned tail = atomic_load_explicit(&requests->tail, memory_order_relaxed);
+		shm_request r = region->request_slots[tail % SHM_CHANNEL_CAPACITY];
+		atomic_store(&requests->tail, tail+1);
+		wake(&requests->space_waiting, &requests->space_events);
+		flague = r.op != ShmClose;
+		uint64_t value = flague? execute_request(&games, pool, &r) : 1;
+		if(!wait_for(c, responses, &responses->space_waiting, &responses->space_events, has_space))
+			break;
+		unsigned head = atomic_load_explicit(&responses->head, memory_order_relaxed);
+		region->response_slots[head % SHM_CHANNEL_CAPACITY].value = value;
+		atomic_store(&responses->head, head+1);
+		wake(&responses->item_waiting, &responses->item_events);
+	}
+	game_table_free(&games);
+	gamma_pool_delete(pool);
+	return true;
+}
+
+void shm_channel_stop(shm_channel* c){
+	shm_region* region = c->region;
+	atomic_store(&region->stop, 1);
+	atomic_uint* events[] = {&region->requests.item_events, &region->requests.space_events,
+				 &region->responses.item_events, &region->responses.space_events};
+	for(int i=0;i<4;i++){
+		atomic_fetch_add(events[i], 1);
+		futex_wake(events[i]);
+	}
+}
@@ -0,0 +1,120 @@
+/** @file
+ * Interfejs kanału w pamięci współdzielonej dla botów działających na tym
+ * samym komputerze co silnik
+ *
+ * Kanał to obszar shm_open z parą pierścieni: żądań od bota do silnika
+ * i odpowiedzi w przeciwnym kierunku. Żądania są binarne i odpowiadają
+ * jeden do jednego funkcjom z gamma.h, odpowiedź to wynik tej funkcji.
+ * Strony synchronizują się atomowymi indeksami, a zasypiają na futeksie
+ * dopiero, gdy pierścień jest pusty lub pełny, więc przy zapełnionym
+ * kanale wymiana nie wymaga wywołań systemowych. Kanał obsługuje jednego
+ * bota; bot może mieć naraz co najwyżej SHM_CHANNEL_CAPACITY żądań bez
+ * odebranej odpowiedzi.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef SHMCHANNEL_H
+#define SHMCHANNEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief liczba miejsc w każdym z pierścieni kanału, potęga dwójki
+ */
+#define SHM_CHANNEL_CAPACITY 1024
+
+/** @brief rodzaj żądania, każde odpowiada jednej funkcji z gamma.h
+ */
+enum shm_op{
+	ShmNew = 1, 		///< gamma_new(args[0], args[1], args[2], args[3]) dla gry game
+	ShmDelete, 		///< gamma_delete gry game
+	ShmMove, 		///< gamma_move(game, args[0], args[1], args[2])
+	ShmGoldenMove, 		///< gamma_golden_move(game, args[0], args[1], args[2])
+	ShmBusyFields, 		///< gamma_busy_fields(game, args[0])
+	ShmFreeFields, 		///< gamma_free_fields(game, args[0])
+	ShmGoldenPossible, 	///< gamma_golden_possible(game, args[0])
+	ShmClose 		///< kończy obsługę kanału
+};
+
+/** @brief Struktura żądania bota
+ */
+typedef struct{
+	uint32_t op; 		///< rodzaj żądania, wartość shm_op
+	uint32_t game; 		///< identyfikator gry
+	uint32_t args[4]; 	///< argumenty funkcji z gamma.h po wskaźniku na grę
+} shm_request;
+
+/** @brief Struktura odpowiedzi silnika
+ * Wynik funkcji z gamma.h, dla ShmNew i ShmDelete 1 jeżeli się udało.
+ * Żądanie dotyczące nieistniejącej gry lub nieznanego rodzaju daje 0, tak jak
+ * funkcje z gamma.h dla niepoprawnych parametrów.
+ */
+typedef struct{
+	uint64_t value; 	///< wynik żądania
+} shm_response;
+
+/** @brief Struktura kanału otwartego w tym procesie
+ */
+typedef struct shm_channel shm_channel;
+
+/** @brief tworzy kanał o nazwie name (jak w shm_open, np. "/gamma")
+ * param[in] name 	- nazwa obszaru pamięci współdzielonej, nie może istnieć
+ *
+ * @return kanał lub NULL jeżeli nie udało się utworzyć obszaru
+ */
+shm_channel* shm_channel_create(const char* name);
+
+/** @brief otwiera kanał utworzony przez shm_channel_create w innym procesie
+ * param[in] name 	- nazwa obszaru pamięci współdzielonej
+ *
+ * @return kanał lub NULL jeżeli obszar nie istnieje lub nie jest kanałem
+ */
+shm_channel* shm_channel_open(const char* name);
+
+/** @brief zamyka kanał w tym procesie, twórca usuwa też obszar
+ * param[in] c 	- kanał lub NULL
+ */
+void shm_channel_close(shm_channel* c);
+
+/** @brief wysyła żądanie, czekając na miejsce w pierścieniu żądań
+ * Wywołuje ją tylko bot. Po zatrzymaniu silnika żądanie przepada.
+ * param[in,out] c 	- kanał
+ * param[in] r 		- żądanie
+ */
+void shm_send(shm_channel* c, const shm_request* r);
+
+/** @brief odbiera odpowiedź na najstarsze żądanie bez odpowiedzi, czekając na nią
+ * Wywołuje ją tylko bot. Po zatrzymaniu silnika zwraca 0.
+ * param[in,out] c 	- kanał
+ *
+ * @return wynik żądania
+ */
+uint64_t shm_receive(shm_channel* c);
+
+/** @brief wysyła żądanie i czeka na odpowiedź
+ * param[in,out] c 	- kanał
+ * param[in] r 		- żądanie
+ *
+ * @return wynik żądania
+ */
+uint64_t shm_call(shm_channel* c, const shm_request* r);
+
+/** @brief wykonuje żądania kanału, aż dostanie ShmClose lub ktoś wywoła shm_channel_stop
+ * Wywołuje ją tylko silnik. Na końcu usuwa gry, których bot nie usunął.
+ * param[in,out] c 	- kanał
+ *
+ * @return true jeżeli obsługę zakończyło ShmClose lub shm_channel_stop,
+ * false jeżeli nie udało się utworzyć puli gier
+ */
+bool shm_serve(shm_channel* c);
+
+/** @brief prosi shm_serve o zakończenie
+ * Można ją wywołać z innego wątku lub z funkcji obsługi sygnału.
+ * param[in] c 	- kanał
+ */
+void shm_channel_stop(shm_channel* c);
+
+#endif
@@ -0,0 +1,159 @@
+/** @file
+ * Implementacja interfejsu spsc.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include "spsc.h"
+
+/** @brief liczba sprawdzeń indeksu przed zaśnięciem na zmiennej warunkowej
+ */
+#define SPSC_SPINS 256
+
+/** @brief liczba oddań procesora przed zaśnięciem na zmiennej warunkowej
+ */
+#define SPSC_YIELDS 16
+
+/** @brief sprawdza, czy producent może włożyć element
+ * param[in] r 	- kolejka
+ *
+ * @return true jeżeli w pierścieniu jest wolne miejsce, false wpp
+ */
+static bool has_space(spsc_ring* r){
+	size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+	return head-atomic_load_explicit(&r->tail, memory_order_acquire) <= r->mask;
+}
+
+/** @brief sprawdza, czy konsument może wyjąć element
+ * param[in] r 	- kolejka
+ *
+ * @return true jeżeli pierścień nie jest pusty, false wpp
+ */
+static bool has_item(spsc_ring* r){
+	size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+	return atomic_load_explicit(&r->head, memory_order_acquire) != tail;
+}
+
+/** @brief czeka, aż ready(r) będzie prawdą
+ * Najpierw krótko sprawdza indeksy, potem zasypia, ustawiwszy flagę waiting,
+ * którą druga strona sprawdza i zeruje po każdej zmianie swojego indeksu.
+ * param[in,out] r 		- kolejka
+ * param[in,out] waiting 	- flaga oczekiwania tej strony
+ * param[in] ready 		- warunek, na który czekamy
+ */
+static void wait_for(spsc_ring* r, atomic_bool* waiting, bool (*ready)(spsc_ring*)){
+	for(int i=0;i<SPSC_SPINS;i++){
+		if(ready(r))
+			return;
+	}
+	for(int i=0;i<SPSC_YIELDS;i++){
+		sched_yield();
+		if(ready(r))
+			return;
+	}
+	pthread_mutex_lock(&r->lock);
+	bool flague = ready(r);
+	while(!flague){
+		atomic_store(waiting, true);
+		atomic_thread_fence(memory_order_seq_cst);
+		flague = ready(r);
+		if(!flague)
+			pthread_cond_wait(&r->changed, &r->lock);
+		flague = ready(r);
+	}
+	atomic_store(waiting, false);
+	pthread_mutex_unlock(&r->lock);
+}
+
+/** @brief budzi drugą stronę, jeżeli na nas czeka
+ * Wywołujemy ją po zmianie indeksu; bariera gwarantuje, że druga strona
+ * zobaczy zmianę albo my zobaczymy jej flagę. Zerujemy flagę, więc kolejne
+ * zmiany przed obudzeniem się drugiej strony nie sięgają już po zamek.
+ * param[in,out] r 		- kolejka
+ * param[in,out] waiting 	- flaga oczekiwania drugiej strony
+ */
+static void wake(spsc_ring* r, atomic_bool* waiting){
+	atomic_thread_fence(memory_order_seq_cst);
+	if(atomic_load_explicit(waiting, memory_order_relaxed) && atomic_exchange(waiting, false)){
+		pthread_mutex_lock(&r->lock);
+		pthread_cond_signal(&r->changed);
+		pthread_mutex_unlock(&r->lock);
+	}
+}
+
+/** @brief tworzy pustą kolejkę
+ * param[out] r 		- kolejka
+ * param[in] capacity 		- liczba miejsc, potęga dwójki
+ * param[in] slot_size 		- długość elementu w bajtach
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+bool spsc_init(spsc_ring* r, size_t capacity, size_t slot_size){
+	r->slots = malloc(capacity*slot_size);
+	if(r->slots == NULL)
+		return false;
+	atomic_init(&r->head, 0);
+	atomic_init(&r->tail, 0);
+	atomic_init(&r->producer_waiting, false);
+	atomic_init(&r->consumer_waiting, false);
+	r->slot_size = slot_size;
+	r->mask = capacity-1;
+	pthread_mutex_init(&r->lock, NULL);
+	pthread_cond_init(&r->changed, NULL);
+	return true;
+}
+
+/** @brief zwalnia pamięć kolejki
+ * param[in,out] r 	- kolejka
+ */
+void spsc_destroy(spsc_ring* r){
+	pthread_cond_destroy(&r->changed);
+	pthread_mutex_destroy(&r->lock);
+	free(r->slots);
+	r->slots = NULL;
+}
+
+/** @brief wkłada kopię elementu do kolejki, czekając na wolne miejsce
+ * Wywołuje ją tylko wątek producenta.
+ * param[in,out] r 	- kolejka
+ * param[in] item 	- element długości slot_size
+ */
+void spsc_push(spsc_ring* r, const void* item){
+	wait_for(r, &r->producer_waiting, has_space);
+	size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+	memcpy(r->slots+(head & r->mask)*r->slot_size, item, r->slot_size);
+	atomic_store_explicit(&r->head, head+1, memory_order_release);
+	wake(r, &r->consumer_waiting);
+}
+
+/** @brief wyjmuje najstarszy element kolejki, czekając, aż się pojawi
+ * Wywołuje ją tylko wątek konsumenta.
+ * param[in,out] r 	- kolejka
+ * param[out] item 	- miejsce długości slot_size na element
+ */
+void spsc_pop(spsc_ring* r, void* item){
+	wait_for(r, &r->consumer_waiting, has_item);
+	size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+	memcpy(item, r->slots+(tail & r->mask)*r->slot_size, r->slot_size);
+	atomic_store_explicit(&r->tail, tail+1, memory_order_release);
+	wake(r, &r->producer_waiting);
+}
+
+/** @brief wyjmuje najstarszy element kolejki, jeżeli jakiś jest, bez czekania
+ * Wywołuje ją tylko wątek konsumenta.
+ * param[in,out] r 	- kolejka
+ * param[out] item 	- miejsce długości slot_size na element
+ *
+ * @return true jeżeli wyjęliśmy element, false jeżeli kolejka była pusta
+ */
+bool spsc_try_pop(spsc_ring* r, void* item){
+	if(!has_item(r))
+		return false;
+	spsc_pop(r, item);
+	return true;
+}
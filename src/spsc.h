@@ -0,0 +1,79 @@
+/** @file
+ * Interfejs kolejki jednego producenta i jednego konsumenta
+ *
+ * Kolejka jest pierścieniem elementów stałej długości. Producent i konsument
+ * synchronizują się tylko atomowymi indeksami; na zamku i zmiennej warunkowej
+ * czeka dopiero strona, która zastała pierścień pełny lub pusty.
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef SPSC_H
+#define SPSC_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+/** @brief długość linii pamięci podręcznej, na której leżą osobno indeksy
+ * producenta i konsumenta
+ */
+#define SPSC_LINE 64
+
+/** @brief Struktura kolejki jednego producenta i jednego konsumenta.
+ * Indeksy rosną bez ograniczeń, pozycję w pierścieniu wyznacza mask.
+ */
+typedef struct{
+	_Alignas(SPSC_LINE) atomic_size_t head; 	///< liczba elementów włożonych przez producenta
+	_Alignas(SPSC_LINE) atomic_size_t tail; 	///< liczba elementów wyjętych przez konsumenta
+	_Alignas(SPSC_LINE) unsigned char* slots; 	///< pierścień elementów
+	size_t slot_size; 			///< długość elementu w bajtach
+	size_t mask; 				///< liczba miejsc w pierścieniu - 1
+	atomic_bool producer_waiting; 		///< true jeżeli producent czeka na miejsce
+	atomic_bool consumer_waiting; 		///< true jeżeli konsument czeka na element
+	pthread_mutex_t lock; 			///< zamek oczekiwania
+	pthread_cond_t changed; 		///< sygnalizuje czekającej stronie zmianę indeksu
+} spsc_ring;
+
+/** @brief tworzy pustą kolejkę
+ * param[out] r 		- kolejka
+ * param[in] capacity 		- liczba miejsc, potęga dwójki
+ * param[in] slot_size 		- długość elementu w bajtach
+ *
+ * @return true jeżeli się udało, false jeżeli zabrakło pamięci
+ */
+bool spsc_init(spsc_ring* r, size_t capacity, size_t slot_size);
+
+/** @brief zwalnia pamięć kolejki
+ * param[in,out] r 	- kolejka
+ */
+void spsc_destroy(spsc_ring* r);
+
+/** @brief wkłada kopię elementu do kolejki, czekając na wolne miejsce
+ * Wywołuje ją tylko wątek producenta.
+ * param[in,out] r 	- kolejka
+ * param[in] item 	- element długości slot_size
+ */
+void spsc_push(spsc_ring* r, const void* item);
+
+/** @brief wyjmuje najstarszy element kolejki, czekając, aż się pojawi
+ * Wywołuje ją tylko wątek konsumenta.
+ * param[in,out] r 	- kolejka
+ * param[out] item 	- miejsce długości slot_size na element
+ */
+void spsc_pop(spsc_ring* r, void* item);
+
+/** @brief wyjmuje najstarszy element kolejki, jeżeli jakiś jest, bez czekania
+ * Wywołuje ją tylko wątek konsumenta.
+ * param[in,out] r 	- kolejka
+ * param[out] item 	- miejsce długości slot_size na element
+ *
+ * @return true jeżeli wyjęliśmy element, false jeżeli kolejka była pusta
+ */
+bool spsc_try_pop(spsc_ring* r, void* item);
+
+#endif
@@ -0,0 +1,171 @@
+/** @file
+ * Implementacja interfejsu threadpool.h
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+/** @brief makro potrzebne do korzystania z sysconf()
+ */
+#define _XOPEN_SOURCE 700
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "threadpool.h"
+
+/** @brief górne ograniczenie na liczbę wątków w puli
+ */
+#define MAX_POOL_SIZE 256
+
+/** @brief Struktura opisująca aktualnie wykonywane zadanie
+ */
+typedef struct{
+	thread_pool_task task; 		///< funkcja wykonywana dla każdego fragmentu
+	void* arg; 			///< argument przekazywany do task
+	uint32_t no_chunks; 		///< liczba fragmentów zadania
+	atomic_uint next_chunk; 	///< numer następnego nieprzydzielonego fragmentu
+	uint64_t generation; 		///< numer zadania, zwiększany przy każdym nowym zadaniu
+	uint32_t active; 		///< liczba wątków puli pracujących nad zadaniem
+} pool_job;
+
+/** @brief inicjalizuje pulę wątków dokładnie raz
+ */
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+/** @brief liczba wątków biorących udział w zadaniu (wliczając wywołujący)
+ */
+static uint32_t pool_size = 1;
+/** @brief zamek chroniący pole job
+ */
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+/** @brief zamek zajmowany przez wątek, który zlecił zadanie puli
+ */
+static pthread_mutex_t pool_busy = PTHREAD_MUTEX_INITIALIZER;
+/** @brief sygnalizuje wątkom puli pojawienie się nowego zadania
+ */
+static pthread_cond_t job_ready = PTHREAD_COND_INITIALIZER;
+/** @brief sygnalizuje zlecającemu zakończenie pracy przez wątki puli
+ */
+static pthread_cond_t job_done = PTHREAD_COND_INITIALIZER;
+/** @brief aktualnie wykonywane zadanie
+ */
+static pool_job job;
+
+/** @brief wykonuje kolejne nieprzydzielone fragmenty zadania
+ * param[in] task 		- funkcja wykonywana dla każdego fragmentu
+ * param[in] arg 		- argument przekazywany do task
+ * param[in] no_chunks 	- liczba fragmentów zadania
+ */
+static void work_on_chunks(thread_pool_task task, void* arg, uint32_t no_chunks){
+	while(true){
+		uint32_t chunk = atomic_fetch_add(&job.next_chunk, 1);
+		if(chunk >= no_chunks)
+			break;
+		task(arg, chunk);
+	}
+}
+
+/** @brief pętla wątku puli - czeka na zadania i je wykonuje
+ * param[in] unused 	- nieużywany argument wymagany przez pthread_create
+ *
+ * @return nigdy nie wraca
+ */
+static void* worker_loop(void* unused){
+	(void)unused;
+	uint64_t seen = 0;
+	pthread_mutex_lock(&pool_lock);
+	while(true){
+		while(job.generation == seen)
+			pthread_cond_wait(&job_ready, &pool_lock);
+		seen = job.generation;
+		thread_pool_task task = job.task;
+		void* arg = job.arg;
+		uint32_t no_chunks = job.no_chunks;
+		job.active++;
+		pthread_mutex_unlock(&pool_lock);
+
+		work_on_chunks(task, arg, no_chunks);
+
+		pthread_mutex_lock(&pool_lock);
+		job.active--;
+		if(job.active == 0)
+			pthread_cond_signal(&job_done);
+	}
+	return NULL;
+}
+
+/** @brief odczytuje żądaną liczbę wątków
+ *
+ * @return wartość GAMMA_THREADS jeżeli jest ustawiona, liczba procesorów wpp
+ */
+static uint32_t requested_pool_size(void){
+	char* env = getenv("GAMMA_THREADS");
+	long n = 0;
+	if(env != NULL)
+		n = strtol(env, NULL, 10);
+	if(n <= 0)
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+	if(n <= 0)
+		n = 1;
+	if(n > MAX_POOL_SIZE)
+		n = MAX_POOL_SIZE;
+	return n;
+}
+
+/** @brief tworzy wątki puli, zmniejsza pool_size jeżeli nie udało się ich utworzyć
+ */
+static void init_pool(void){
+	uint32_t requested = requested_pool_size();
+	atomic_init(&job.next_chunk, 0);
+	pool_size = 1;
+	for(uint32_t i=1;i<requested;i++){
+		pthread_t thread;
+		if(pthread_create(&thread, NULL, worker_loop, NULL) != 0)
+			break;
+		pthread_detach(thread);
+		pool_size++;
+	}
+}
+
+/** @brief zwraca liczbę wątków, które biorą udział w wykonywaniu zadań
+ *
+ * @return liczba wątków (wliczając wątek wywołujący), co najmniej 1
+ */
+uint32_t thread_pool_size(void){
+	pthread_once(&pool_once, init_pool);
+	return pool_size;
+}
+
+/** @brief wykonuje zadanie task dla fragmentów [0, no_chunks)
+ * param[in] task 		- funkcja wykonywana dla każdego fragmentu
+ * param[in] arg 		- wskaźnik przekazywany do task
+ * param[in] no_chunks 	- liczba fragmentów
+ */
+void thread_pool_run(thread_pool_task task, void* arg, uint32_t no_chunks){
+	if(thread_pool_size() == 1 || no_chunks <= 1 ||
+	   pthread_mutex_trylock(&pool_busy) != 0){
+		for(uint32_t i=0;i<no_chunks;i++)
+			task(arg, i);
+		return;
+	}
+
+	pthread_mutex_lock(&pool_lock);
+	while(job.active > 0)
+		pthread_cond_wait(&job_done, &pool_lock);
+	job.task = task;
+	job.arg = arg;
+	job.no_chunks = no_chunks;
+	atomic_store(&job.next_chunk, 0);
+	job.generation++;
+	pthread_cond_broadcast(&job_ready);
+	pthread_mutex_unlock(&pool_lock);
+
+	work_on_chunks(task, arg, no_chunks);
+
+	pthread_mutex_lock(&pool_lock);
+	while(job.active > 0)
+		pthread_cond_wait(&job_done, &pool_lock);
+	pthread_mutex_unlock(&pool_lock);
+	pthread_mutex_unlock(&pool_busy);
+}
@@ -0,0 +1,40 @@
+/** @file
+ * Interfejs puli wątków wykorzystywanej przy równoległym przeszukiwaniu planszy
+ *
+ * @author Jan Olszewski
+ * @copyright Uniwersytet Warszawski
+ * @date 18.10.2026
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** @brief typ zadania wykonywanego przez pulę wątków
+ * param[in] arg 	- wskaźnik przekazany do thread_pool_run
+ * param[in] chunk 	- numer fragmentu pracy, który ma zostać wykonany
+ */
+typedef void (*thread_pool_task)(void* arg, uint32_t chunk);
+
+/** @brief zwraca liczbę wątków, które biorą udział w wykonywaniu zadań
+ * Liczbę wątków można ustalić zmienną środowiskową GAMMA_THREADS,
+ * domyślnie jest to liczba dostępnych procesorów.
+ *
+ * @return liczba wątków (wliczając wątek wywołujący), co najmniej 1
+ */
+uint32_t thread_pool_size(void);
+
+/** @brief wykonuje zadanie task dla fragmentów [0, no_chunks)
+ * Fragmenty są rozdzielane dynamicznie pomiędzy wątki puli i wątek wywołujący.
+ * Funkcja wraca dopiero po wykonaniu wszystkich fragmentów. Jeżeli pula jest
+ * zajęta innym zadaniem lub ma tylko jeden wątek, to wszystkie fragmenty
+ * wykonuje wątek wywołujący.
+ * param[in] task 		- funkcja wykonywana dla każdego fragmentu
+ * param[in] arg 		- wskaźnik przekazywany do task
+ * param[in] no_chunks 	- liczba fragmentów
+ */
+void thread_pool_run(thread_pool_task task, void* arg, uint32_t no_chunks);
+
+#endif